@@ -0,0 +1,35 @@
+// ./bin/test_fast_gemm_codegen ./gemm_decomposition_2x2x2_7.txt learned_fast_gemm ./build/learned_fast_gemm.hpp
+//
+// Turns a bilinear decomposition, in the text format written by `save_bilinear_decomposition` in '../include/backend/fast_gemm.hpp',
+// into a fast gemm kernel header. The programs `gemm_optimization_nxn*.cc` save their learned decompositions this way, and
+// `./examples/gemm_decompositions/strassen_2x2x2_7.txt` is `strassen_decomposition()` saved this way. `make fast_gemm_codegen`
+// runs this program, writing to './build'; the shipped '../include/backend/fast_gemm_strassen.hpp' is only replaced by hand.
+#include "../include/backend/fast_gemm.hpp"
+#include "../include/utils/fmt.hpp"
+#include <fstream>
+#include <iostream>
+
+int main( int argc, char** argv )
+{
+    using namespace ceras;
+
+    if ( argc != 4 )
+    {
+        std::cout << "Usage: " << argv[0] << " decomposition.txt kernel_name output.hpp\n";
+        return 1;
+    }
+
+    auto const decomposition = round_bilinear_decomposition( load_bilinear_decomposition( argv[1] ) );
+    double const residual = brent_residual( decomposition );
+    std::cout << fmt::format( "Loaded a rank-{} decomposition of the {}x{}x{} product, Brent residual {}.\n", decomposition.rank, decomposition.n0, decomposition.n0, decomposition.n0, residual );
+    if ( residual > 1.0e-12 )
+    {
+        std::cout << "Not an exact decomposition, no kernel generated.\n";
+        return 1;
+    }
+    std::cout << fmt::format( "Error growth per level {} (classical {}), rounding depth per level {}.\n", fast_gemm_error_growth( decomposition ), decomposition.n0, fast_gemm_rounding_depth( decomposition ) );
+
+    std::ofstream{ argv[3] } << generate_fast_gemm_kernel( decomposition, argv[2] );
+    std::cout << "Kernel written to " << argv[3] << "\n";
+    return 0;
+}
@@ -146,10 +146,13 @@ int main( int argc, char** argv )
         if ( (current_error[0] > success_threshold) && (!found_flag) )
             return 0;
 
+        tensor<float> learned_a, learned_b, learned_c;
+
         {
             auto op = elementwise_product( tanh( alpha * a ), sigmoid( alpha * _a ) );
             auto _ = s.run( op );
             std::cout << "AA is \n" << _ << std::endl;
+            learned_a = _.deep_copy();
 
             send_message( fmt::format( "AA = {}\n", _ ) );
         }
@@ -158,6 +161,7 @@ int main( int argc, char** argv )
             auto op = elementwise_product( tanh( alpha * b ), sigmoid( alpha * _b ) );
             auto _ = s.run( op );
             std::cout << "BB is \n" << _ << std::endl;
+            learned_b = _.deep_copy();
 
             send_message( fmt::format( "BB = {}\n", _ ) );
         }
@@ -166,10 +170,21 @@ int main( int argc, char** argv )
             auto op = elementwise_product( tanh( alpha * c ), sigmoid( alpha * _c ) );
             auto _ = s.run( op );
             std::cout << "CC is \n" << _ << std::endl;
+            learned_c = _.deep_copy();
 
             send_message( fmt::format( "CC = {}\n", _ ) );
         }
 
+        // the learned coefficients rounded to the nearest half, saved for `./bin/test_fast_gemm_codegen` to turn into a kernel
+        {
+            auto const decomposition = round_bilinear_decomposition( bilinear_decomposition{ m, ops, { learned_a.begin(), learned_a.end() },
+                                                                                             { learned_b.begin(), learned_b.end() },
+                                                                                             { learned_c.begin(), learned_c.end() } } );
+            std::string const path = fmt::format( "./gemm_decomposition_{}x{}x{}_{}.txt", m, m, m, ops );
+            save_bilinear_decomposition( decomposition, path );
+            std::cout << fmt::format( "Rounded decomposition saved to {}, Brent residual {}.", path, brent_residual( decomposition ) ) << std::endl;
+        }
+
 
     }
 
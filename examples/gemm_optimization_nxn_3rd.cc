@@ -204,10 +204,13 @@ int main( int argc, char** argv )
             //return 0;
         }
 
+        tensor<float> learned_a, learned_b, learned_c;
+
         {
             auto op = ( elementwise_product( tanh( alpha * tanh_a_ ) * tanh( alpha * tanh__a ), sigmoid( alpha * sign_a ) ) );
             auto _ = s.run( op );
             std::cout << "AA is \n" << _ << std::endl;
+            learned_a = _.deep_copy();
 
             send_message( fmt::format( "AA = {}\n", _ ) );
         }
@@ -218,6 +221,7 @@ int main( int argc, char** argv )
             auto op = ( elementwise_product( tanh( alpha * tanh_b_ ) * tanh( alpha * tanh__b ), sigmoid( alpha * sign_b ) ) );
             auto _ = s.run( op );
             std::cout << "BB is \n" << _ << std::endl;
+            learned_b = _.deep_copy();
 
             send_message( fmt::format( "BB = {}\n", _ ) );
         }
@@ -228,10 +232,21 @@ int main( int argc, char** argv )
             auto op = ( elementwise_product( tanh( alpha * tanh__c ) * tanh( alpha * tanh_c_ ), sigmoid( alpha * sign_c ) ) );
             auto _ = s.run( op );
             std::cout << "CC is \n" << _ << std::endl;
+            learned_c = _.deep_copy();
 
             send_message( fmt::format( "CC = {}\n", _ ) );
         }
 
+        // the learned coefficients rounded to the nearest half, saved for `./bin/test_fast_gemm_codegen` to turn into a kernel
+        {
+            auto const decomposition = round_bilinear_decomposition( bilinear_decomposition{ m, ops, { learned_a.begin(), learned_a.end() },
+                                                                                             { learned_b.begin(), learned_b.end() },
+                                                                                             { learned_c.begin(), learned_c.end() } } );
+            std::string const path = fmt::format( "./gemm_decomposition_{}x{}x{}_{}.txt", m, m, m, ops );
+            save_bilinear_decomposition( decomposition, path );
+            std::cout << fmt::format( "Rounded decomposition saved to {}, Brent residual {}.", path, brent_residual( decomposition ) ) << std::endl;
+        }
+
     }
 
     return 0;
@@ -189,11 +189,14 @@ int main( int argc, char** argv )
             //return 0;
         }
 
+        tensor<float> learned_a, learned_b, learned_c;
+
         {
             auto op = ( elementwise_product( tanh( alpha * tanh_a_ ), sigmoid( alpha * sigmoid_a_ ) ) *
                         elementwise_product( tanh( alpha * tanh__a ), sigmoid( alpha * sigmoid__a ) ) );
             auto _ = s.run( op );
             std::cout << "AA is \n" << _ << std::endl;
+            learned_a = _.deep_copy();
 
             send_message( fmt::format( "AA = {}\n", _ ) );
         }
@@ -203,6 +206,7 @@ int main( int argc, char** argv )
                         elementwise_product( tanh( alpha * tanh__b ), sigmoid( alpha * sigmoid__b ) ) );
             auto _ = s.run( op );
             std::cout << "BB is \n" << _ << std::endl;
+            learned_b = _.deep_copy();
 
             send_message( fmt::format( "BB = {}\n", _ ) );
         }
@@ -212,10 +216,21 @@ int main( int argc, char** argv )
                          elementwise_product( tanh( alpha * tanh_c_ ), sigmoid( alpha * sigmoid_c_ ) ) );
             auto _ = s.run( op );
             std::cout << "CC is \n" << _ << std::endl;
+            learned_c = _.deep_copy();
 
             send_message( fmt::format( "CC = {}\n", _ ) );
         }
 
+        // the learned coefficients rounded to the nearest half, saved for `./bin/test_fast_gemm_codegen` to turn into a kernel
+        {
+            auto const decomposition = round_bilinear_decomposition( bilinear_decomposition{ m, ops, { learned_a.begin(), learned_a.end() },
+                                                                                             { learned_b.begin(), learned_b.end() },
+                                                                                             { learned_c.begin(), learned_c.end() } } );
+            std::string const path = fmt::format( "./gemm_decomposition_{}x{}x{}_{}.txt", m, m, m, ops );
+            save_bilinear_decomposition( decomposition, path );
+            std::cout << fmt::format( "Rounded decomposition saved to {}, Brent residual {}.", path, brent_residual( decomposition ) ) << std::endl;
+        }
+
     }
 
 #if 0
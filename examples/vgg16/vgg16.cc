@@ -2,6 +2,8 @@
 #include "../../include/utils/range.hpp"
 #include "../../include/utils/better_assert.hpp"
 
+#include <malloc.h>
+
 #include <fstream>
 #include <string>
 #include <vector>
@@ -41,6 +43,23 @@ int main()
 
     auto m = model{ input, output }; // define a model
     m.summary( "./examples/vgg16/vgg16.dot" );
+
+    // the activations and the gradients of a sample, sharing an arena against each in a buffer of its own
+    auto& s = get_default_session<tensor<float>>();
+    auto& plan = s.plan( output );
+    for ( bool training : { false, true } )
+    {
+        auto const& memory = plan_memory( plan, training );
+        std::cout << ( training ? "training" : "inference" ) << ": planned peak " << memory.arena_size_ << " bytes, naive peak " << memory.naive_size_ << " bytes" << std::endl;
+    }
+
+    // a training pass of a sample with the buffers of the operators, then with the arena allocated; the heap bytes in use after each
+    auto const& in_use = []() { auto const& info = mallinfo2(); return info.uordblks + info.hblkhd; };
+    auto const& pass = [&]() { s.run( output ); plan.backward( ones<float>( {1, 1000} ) ); return in_use(); };
+    s.bind( input, random<float>( {1, 224, 224, 3} ) );
+    std::cout << "operator buffers: " << pass() << " bytes in use" << std::endl;
+    auto const& memory = allocate_memory( plan );
+    std::cout << "arena of " << memory.arena_size_ << " bytes: " << pass() << " bytes in use" << std::endl;
     //m.save_weights( "./examples/vgg16/vgg16.weights" ); // <- slow lzw compression, need optimizing
 
 
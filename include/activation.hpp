@@ -89,27 +89,32 @@ namespace ceras
     template <Expression Ex>
     auto constexpr softmax( Ex const& ex ) noexcept
     {
-        return make_unary_operator( []<Tensor Tsor>( Tsor const& input ) noexcept
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                     {
                                         better_assert( !input.empty(), "softmax forward: input tensor is empty!" );
-                                        Tsor x = deep_copy( input );
+                                        Tsor& x = context_cast<Tsor>( forward_cache );
+                                        x.resize( input.shape() );
                                         std::size_t const last_dim = *(x.shape().rbegin());
                                         std::size_t const rest_dim = x.size() / last_dim;
                                         for ( auto idx : range( rest_dim ) )
                                         {
                                             auto [begin, end] = std::make_tuple( x.begin()+idx*last_dim, x.begin()+(idx+1)*last_dim );
-                                            typename Tsor::value_type const mx = *std::max_element( begin, end );
-                                            for_each( begin, end, [mx]( auto & v ){ v = std::exp( v-mx ); } );
+                                            auto const row = input.begin() + idx*last_dim;
+                                            typename Tsor::value_type const mx = *std::max_element( row, row+last_dim );
+                                            vectorized_map( &*row, &*begin, last_dim, [mx]( auto v ){ return vmath::exp( v - vmath::constant<decltype(v)>( mx ) ); } ); // written from the input, no copy of it
                                             typename Tsor::value_type const sum = std::accumulate( begin, end, typename Tsor::value_type{0} );
                                             for_each( begin, end, [sum]( auto & v ){ v /= sum; } );
                                         }
                                         return x;
                                     },
-                                    []<Tensor Tsor>( Tsor const&, Tsor const& output, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const&, Tsor const& output, Tsor const& grad ) noexcept
                                     {
                                         better_assert( !has_nan( grad ), "backprop: upcoming gradient for activation softmax contains NaN" );
-                                        Tsor ans = grad;
-                                        for_each( ans.begin(), ans.end(), output.begin(), []( auto& a, auto o ) { a *= o * ( typename Tsor::value_type{1} - o ); } );
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( grad.shape() );
+                                        for_each( grad.begin(), grad.end(), output.begin(), ans.begin(), []( auto g, auto o, auto& a ) { a = g * o * ( typename Tsor::value_type{1} - o ); } );
                                         return ans;
                                     },
                                     "softmax"
@@ -140,10 +145,13 @@ namespace ceras
                                         value_type const alpha = 1.67326;
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
                                         // if x >= 0:  \lambda x
                                         // if x <  0:  \lambda \alpha (exp(x) - 1)
-                                        ans.map( [lambda, alpha](auto& x){ x = (x >= value_type{0}) ? (lambda * x) : (lambda * alpha * (std::exp(x) - value_type{1})); } );
+                                        vectorized_map( input.data(), ans.data(), input.size(), [lambda, alpha]( auto x )
+                                        {
+                                            typedef decltype(x) pack;
+                                            return select( x < vmath::constant<pack>( 0 ), vmath::constant<pack>( lambda * alpha ) * ( vmath::exp( x ) - vmath::constant<pack>( 1 ) ), vmath::constant<pack>( lambda ) * x );
+                                        } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
@@ -155,7 +163,11 @@ namespace ceras
                                         ans.resize( input.shape() ); // 1 / ( 1 + exp(-x) )
                                         // if x >= 0: \lambda
                                         // if x <  0: \lambda \alpha exp( x )
-                                        for_each( ans.begin(), ans.end(), input.begin(), grad.begin(), [lambda, alpha]( auto& a, auto i, auto g ){ a = (i >= value_type{0}) ? (g * lambda) : (g * lambda * alpha * std::exp(i)); } );
+                                        vectorized_map( input.data(), grad.data(), ans.data(), input.size(), [lambda, alpha]( auto i, auto g )
+                                        {
+                                            typedef decltype(i) pack;
+                                            return g * select( i < vmath::constant<pack>( 0 ), vmath::constant<pack>( lambda * alpha ) * vmath::exp( i ), vmath::constant<pack>( lambda ) );
+                                        } );
                                         return ans;
                                     },
                                     "selu"
@@ -183,15 +195,19 @@ namespace ceras
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
-                                        ans.map( [](auto& x){ x = std::log(1.0+std::exp(x)); } ); // ln( 1+e^x )
+                                        // ln( 1+e^x ), as max(x, 0) + ln( 1+e^{-|x|} ) not to overflow
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x )
+                                        {
+                                            typedef decltype(x) pack;
+                                            return max( x, vmath::constant<pack>( 0 ) ) + vmath::log( vmath::constant<pack>( 1 ) + vmath::exp( -abs( x ) ) );
+                                        } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         Tsor& ans = context_cast<Tsor>( backward_cache );
                                         ans.resize( input.shape() ); // 1 / ( 1 + exp(-x) )
-                                        for_each( ans.begin(), ans.end(), input.begin(), grad.begin(), []( auto& a, auto i, auto g ){ a = g / ( typename Tsor::value_type{1} - std::exp(-i) ); } );
+                                        vectorized_map( input.data(), grad.data(), ans.data(), input.size(), []( auto i, auto g ){ return g * vmath::sigmoid( i ); } );
                                         return ans;
                                     },
                                     "softplus"
@@ -220,8 +236,7 @@ namespace ceras
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
-                                        ans.map( [](auto& x){ x /= typename Tsor::value_type{1} + std::abs(x); } ); //  x / ( 1+|x| )
+                                        for_each( ans.begin(), ans.end(), input.begin(), []( auto& a, auto x ){ a = x / ( typename Tsor::value_type{1} + std::abs(x) ); } ); //  x / ( 1+|x| )
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
@@ -251,13 +266,11 @@ namespace ceras
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
-        return make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
+        return with_elementwise_kernel( make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
-                                        //auto ans = input.deep_copy();
-                                        ans.map( [](auto& x){ x = 1.0 / (1.0+std::exp(-x)); } );
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ){ return vmath::sigmoid( x ); } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const&, Tsor const& output, Tsor const& grad ) noexcept
@@ -269,7 +282,9 @@ namespace ceras
                                         return ans;
                                     },
                                     "sigmoid"
-                )( ex );
+                )( ex ),
+                []( auto x ) noexcept { return vmath::sigmoid( x ); },
+                []( auto, auto o, auto g ) noexcept { return g * o * ( vmath::constant<decltype(o)>( 1.0f ) - o ); } );
     }
 
 
@@ -297,16 +312,19 @@ namespace ceras
 
             auto make_backward() const noexcept
             {
-                return []<Tensor Tsor>( Tsor const& input, Tsor const& output, Tsor const& grad ) noexcept
+                return []( std::shared_ptr<std::any> backward_cache ) noexcept
                 {
-                    better_assert( input.size(), "relu::backward: empty input." );
-                    better_assert( output.size(), "relu::backward: empty output." );
-                    better_assert( grad.size(), "relu::backward: empty grad." );
-                    typedef typename Tsor::value_type value_type;
-                    Tsor ans = grad; // shallow copy
-                    //for_each( ans.begin(), ans.end(), input.begin(), []( auto& v, auto x ){ if ( x <= value_type{0} ) v = value_type{0}; } );
-                    for_each( ans.begin(), ans.end(), input.begin(), []( auto& v, auto x ){  v *= ( x > value_type{0} ); } );
-                    return ans;
+                    return [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const& output, Tsor const& grad ) noexcept
+                    {
+                        better_assert( input.size(), "relu::backward: empty input." );
+                        better_assert( output.size(), "relu::backward: empty output." );
+                        better_assert( grad.size(), "relu::backward: empty grad." );
+                        typedef typename Tsor::value_type value_type;
+                        Tsor& ans = context_cast<Tsor>( backward_cache ); // not in grad, which may be shared with the other operand of a plus
+                        ans.resize( grad.shape() );
+                        for_each( ans.begin(), ans.end(), grad.begin(), input.begin(), []( auto& v, auto g, auto x ){  v = g * ( x > value_type{0} ); } );
+                        return ans;
+                    };
                 };
             }
         }; // relu_context
@@ -328,7 +346,10 @@ namespace ceras
     auto relu( Ex const& ex ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
-        return make_unary_operator( relu_context{}.make_forward()( forward_cache ), relu_context{}.make_backward(), "relu")( ex );
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return with_elementwise_kernel( make_unary_operator( relu_context{}.make_forward()( forward_cache ), relu_context{}.make_backward()( backward_cache ), "relu")( ex ),
+                                        []( auto x ) noexcept { auto const zero = vmath::constant<decltype(x)>( 0.0f ); return select( zero < x, x, zero ); },
+                                        []( auto x, auto, auto g ) noexcept { auto const zero = vmath::constant<decltype(x)>( 0.0f ); return select( zero < x, g, zero ); } );
     }
 
 
@@ -353,13 +374,16 @@ namespace ceras
 
             auto make_backward() const noexcept
             {
-                return []<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                return []( std::shared_ptr<std::any> backward_cache ) noexcept
                 {
-                    typedef typename Tsor::value_type value_type;
-                    Tsor ans = grad; // shallow copy
-                    //const typename Tsor::value_type zero{0};
-                    for_each( ans.begin(), ans.end(), input.begin(), []( auto& v, auto x ){ if ( (x <= value_type{0}) || (x >= value_type{6}) ) v = value_type{0}; } );
-                    return ans;
+                    return [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                    {
+                        typedef typename Tsor::value_type value_type;
+                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                        ans.resize( grad.shape() );
+                        for_each( ans.begin(), ans.end(), grad.begin(), input.begin(), []( auto& v, auto g, auto x ){ v = ( (x <= value_type{0}) || (x >= value_type{6}) ) ? value_type{0} : g; } );
+                        return ans;
+                    };
                 };
             }
         }; // relu6_context
@@ -381,7 +405,8 @@ namespace ceras
     auto relu6( Ex const& ex ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
-        return make_unary_operator( relu6_context{}.make_forward()( forward_cache ), relu6_context{}.make_backward(), "relu6")( ex );
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return make_unary_operator( relu6_context{}.make_forward()( forward_cache ), relu6_context{}.make_backward()( backward_cache ), "relu6")( ex );
     }
 
 
@@ -404,6 +429,7 @@ namespace ceras
         return [factor]<Expression Ex>( Ex const& ex ) noexcept
         {
             std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
             return make_unary_operator( [factor, forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                         {
                                             Tsor& ans = context_cast<Tsor>( forward_cache );
@@ -411,15 +437,17 @@ namespace ceras
                                             for_each( ans.begin(), ans.end(), input.begin(), [factor]( auto& v_out, auto v_in ){ v_out = std::max( T{v_in}, T{factor*v_in} ); } );
                                             return ans;
                                         },
-                                        [factor]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                        [factor, backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                         {
                                             typedef typename Tsor::value_type value_type;
-                                            Tsor ans = grad;// OK for shallow copy
-                                            for_each( ans.begin(), ans.end(), input.begin(), [factor]( value_type& v_back, value_type const v_in ){ v_back = (v_in > value_type{0}) ? v_back : factor*v_back; } );
+                                            Tsor& ans = context_cast<Tsor>( backward_cache );
+                                            ans.resize( grad.shape() );
+                                            for_each( ans.begin(), ans.end(), grad.begin(), input.begin(), [factor]( value_type& v_back, value_type const g, value_type const v_in ){ v_back = (v_in > value_type{0}) ? g : factor*g; } );
                                             return ans;
                                         },
                                         "leaky_relu",
-                                        make_argumented_unary_operator_serializer( factor )
+                                        identity_output_shape_calculator{},
+                                        make_argumented_operator_serializer( factor )
                     )( ex );
         };
     }
@@ -457,23 +485,32 @@ namespace ceras
         return [alpha]<Expression Ex>( Ex const& ex ) noexcept
         {
             std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
             return make_unary_operator( [alpha, forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                         {
-                                            typedef typename Tsor::value_type value_type;
                                             Tsor& ans = context_cast<Tsor>( forward_cache );
                                             ans.resize( input.shape()  );
-                                            for_each( ans.begin(), ans.end(), input.begin(), [alpha]( auto& v_out, auto v_in ){ v_out = (v_in > value_type{0}) ? v_in : (alpha * (std::exp(v_in) - value_type{1})); } );
+                                            vectorized_map( input.data(), ans.data(), input.size(), [alpha]( auto x )
+                                            {
+                                                typedef decltype(x) pack;
+                                                return select( vmath::constant<pack>( 0 ) < x, x, vmath::constant<pack>( alpha ) * ( vmath::exp( x ) - vmath::constant<pack>( 1 ) ) );
+                                            } );
                                             return ans;
                                         },
-                                        [alpha]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                        [alpha, backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                         {
-                                            typedef typename Tsor::value_type value_type;
-                                            Tsor ans = grad;// OK for shallow copy
-                                            for_each( ans.begin(), ans.end(), input.begin(), [alpha]( value_type& v_back, value_type const v_in ){ v_back = (v_in >= value_type{0}) ? v_back : alpha*std::exp(v_back); } );
+                                            Tsor& ans = context_cast<Tsor>( backward_cache );
+                                            ans.resize( input.shape() );
+                                            vectorized_map( input.data(), grad.data(), ans.data(), input.size(), [alpha]( auto x, auto g )
+                                            {
+                                                typedef decltype(x) pack;
+                                                return select( x < vmath::constant<pack>( 0 ), vmath::constant<pack>( alpha ) * vmath::exp( x ) * g, g );
+                                            } );
                                             return ans;
                                         },
                                         "elu",
-                                        make_argumented_unary_operator_serializer( alpha )
+                                        identity_output_shape_calculator{},
+                                        make_argumented_operator_serializer( alpha )
                     )( ex );
         };
     }
@@ -493,21 +530,22 @@ namespace ceras
     auto inline exponential( Ex const& ex ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
 
         return make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
-                                        ans.map( [](auto& x){ x = std::exp(x); } ); // exp(x)
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ){ return vmath::exp( x ); } ); // exp(x)
                                         better_assert( !has_nan( ans ), "exponential operator forward output contains nan." );
                                         better_assert( !has_inf( ans ), "exponential operator forward output contains inf." );
                                         return ans;
                                     },
-                                    []<Tensor Tsor>( Tsor const&, Tsor const& output, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const&, Tsor const& output, Tsor const& grad ) noexcept
                                     {
-                                        Tsor ans = grad;
-                                        for_each( ans.begin(), ans.end(), output.begin(), []( auto& a, auto o ){ a *= o; } );
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( grad.shape() );
+                                        for_each( ans.begin(), ans.end(), grad.begin(), output.begin(), []( auto& a, auto g, auto o ){ a = g * o; } );
                                         return ans;
                                     },
                                     "exponentional"
@@ -529,21 +567,22 @@ namespace ceras
     auto inline hard_sigmoid( Ex const& ex ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
 
         return make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                     {
                                         typedef typename Tsor::value_type value_type;
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
-                                        ans.map([](auto& x) { x = ( x > value_type{1} )  ? value_type{1} : ( x < value_type{-1} ) ? value_type{0} : (x+value_type{1})/value_type{2}; });
+                                        for_each( ans.begin(), ans.end(), input.begin(), []( auto& a, auto x ) { a = ( x > value_type{1} )  ? value_type{1} : ( x < value_type{-1} ) ? value_type{0} : (x+value_type{1})/value_type{2}; } );
                                         return ans;
                                     },
-                                    []<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         typedef typename Tsor::value_type value_type;
-                                        Tsor ans = grad;
-                                        for_each( ans.begin(), ans.end(), input.begin(), []( auto& a, auto x ) { a = ((x > value_type{1}) || (x < value_type{-1})) ? value_type{0} : (a / value_type{2}); } );
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( grad.shape() );
+                                        for_each( ans.begin(), ans.end(), grad.begin(), input.begin(), []( auto& a, auto g, auto x ) { a = ((x > value_type{1}) || (x < value_type{-1})) ? value_type{0} : (g / value_type{2}); } );
                                         return ans;
                                     },
                                     "hard_sigmoid"
@@ -554,9 +593,8 @@ namespace ceras
     /// @brief Gaussian Error function, an unary operator.
     /// GAUSSIAN ERROR LINEAR UNITS (GELUS) https://arxiv.org/pdf/1606.08415.pdf
     /// $f(x) = 0.5x (1 + tanh[\sqrt{2/\pi}(x + 0.044715x^3)])$
-    /// $df = x ( 1 + tanh[\sqrt{2/\pi}(x + 0.044715x^3)] ) +  \sqrt(2/\pi) x sech^2[\sqrt(2/\pi) x (1+0.44715x^2) (1+0.134145x^2) ]$
-    /// where $sec^2(x) = 1 - tanh^2(x)$
-    /// derivative generated using service from https://www.symbolab.com/solver/derivative-calculator
+    /// $df = 0.5 (1 + tanh[u]) + 0.5 x sech^2[u] \sqrt{2/\pi}(1 + 0.134145x^2)$, with $u = \sqrt{2/\pi}(x + 0.044715x^3)$
+    /// where $sech^2(x) = 1 - tanh^2(x)$, evaluated with $0.5 (1 + tanh[u]) = sigmoid(2u)$
     ///
     /// @param ex An input operator.
     ///
@@ -569,39 +607,21 @@ namespace ceras
     template <Expression Ex>
     auto inline gelu( Ex const& ex ) noexcept
     {
-        auto _gelu = []<typename T>( T x )
-        {
-            auto const ans = 0.5 * x * ( 1.0 + std::tanh( 0.79788456080286535588 * x * ( 1.0 + 0.044715*x*x ) ) );
-            return static_cast<T>( ans );
-        };
-        auto sech_2 = []( auto x )
-        {
-            return 1.0 - std::pow( std::tanh(x), 2 );
-        };
-        auto _dgelu = [sech_2]<typename T>( T x )
-        {
-            auto const sq_2_pi_x = 0.79788456080286535588 * x;
-            auto const _xx = x * x;
-            auto const ans = 0.5 * ( 1.0 + std::tanh( sq_2_pi_x * ( 1.0 + 0.044715 * _xx ) ) ) + sq_2_pi_x * sech_2( sq_2_pi_x * (1.0 + 0.044715 * _xx ) * ( 1.0 + 0.134145 * _xx) );
-            return static_cast<T>( ans );
-        };
-
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
 
-        return make_unary_operator( [forward_cache, _gelu]<Tensor Tsor>( Tsor const& input ) noexcept
+        return make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                     {
-                                        //typedef typename Tsor::value_type value_type;
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        std::copy( input.begin(), input.end(), ans.begin() );
-                                        ans.map([_gelu](auto& x) { x = _gelu(x); });
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ){ return vmath::gelu( x ); } );
                                         return ans;
                                     },
-                                    [_dgelu]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
-                                        //typedef typename Tsor::value_type value_type;
-                                        Tsor ans = grad;
-                                        for_each( ans.begin(), ans.end(), [&_dgelu]( auto& x ) {  x = _dgelu(x); } );
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( input.shape() );
+                                        vectorized_map( input.data(), grad.data(), ans.data(), input.size(), []( auto x, auto g ){ return g * vmath::gelu_derivative( x ); } );
                                         return ans;
                                     },
                                     "gelu"
@@ -673,7 +693,7 @@ namespace ceras
     template< Expression Ex >
     auto mish( Ex const& ex ) noexcept
     {
-        return ex*tanh(softplus(ex));
+        return hadamard_product( ex, tanh(softplus(ex)) );
     }
 
 
@@ -688,7 +708,7 @@ namespace ceras
     template< Expression Ex >
     auto lisht( Ex const& ex ) noexcept
     {
-        return ex*tanh(ex);
+        return hadamard_product( ex, tanh(ex) );
     }
 
 }//namespace ceras
@@ -0,0 +1,296 @@
+#ifndef BROADCAST_HPP_INCLUDED_ZKWQPLMRTYSNVBXAHGDJEIUOCFKWQMZNRTLYPSBVXGHADJKEIUQCFW
+#define BROADCAST_HPP_INCLUDED_ZKWQPLMRTYSNVBXAHGDJEIUOCFKWQMZNRTLYPSBVXGHADJKEIUQCFW
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "../utils/better_assert.hpp"
+#include "../utils/for_each.hpp"
+#include "../utils/half_float.hpp"
+#include "../utils/parallel.hpp"
+
+//
+// A broadcasting engine for binary element-wise operations, `out = func( lhs, rhs )`.
+//
+// The operands are never expanded to the output shape. Each operand is walked through its strides, a broadcasted dimension
+// having a stride of 0, after
+//
+//   1. dropping the dimensions of size 1 of the output,
+//   2. merging the adjacent dimensions that are contiguous for both operands.
+//
+// Two operands of the same shape end up with a single dimension, and a bias of shape [R, C, CH] added to activations of
+// shape [BS, R, C, CH] with two: [BS] of strides {R*C*CH, 0} and [R*C*CH] of strides {1, 1}.
+// The innermost dimension is a unit-stride or a stride-0 loop free of aliasing, vectorized by the compiler;
+// the outer dimensions are split into row ranges over the thread pool.
+//
+
+namespace ceras
+{
+
+    ///
+    /// @brief Tests whether two shapes broadcast together, following the numpy rules.
+    ///
+    inline bool broadcastable( std::vector<size_t> const& shape_a, std::vector<size_t> const& shape_b ) noexcept
+    {
+        for ( auto ia = shape_a.rbegin(), ib = shape_b.rbegin(); (ia != shape_a.rend()) && (ib != shape_b.rend()); ++ia, ++ib )
+            if ( (*ia != *ib) && (*ia != 1) && (*ib != 1) )
+                return false;
+        return true;
+    }
+
+    namespace broadcast_private
+    {
+        // the output walked as nested loops, the last one being the inner loop
+        struct broadcast_layout
+        {
+            std::vector<size_t> shape_;
+            std::vector<std::ptrdiff_t> lhs_strides_;
+            std::vector<std::ptrdiff_t> rhs_strides_;
+        };
+
+        // the row-major strides of an operand aligned to the trailing dimensions of the output, 0 along the broadcasted dimensions
+        inline std::vector<std::ptrdiff_t> operand_strides( std::vector<size_t> const& shape, std::vector<size_t> const& out_shape )
+        {
+            std::vector<std::ptrdiff_t> ans( out_shape.size(), 0 );
+            std::ptrdiff_t stride = 1;
+            for ( size_t idx = 0; idx != shape.size(); ++idx )
+            {
+                size_t const dim = shape[shape.size()-1-idx];
+                size_t const out_dim = out_shape[out_shape.size()-1-idx];
+                better_assert( (dim == out_dim) || (dim == 1), "broadcasting: expecting dimension ", out_dim, " or 1, but got ", dim );
+                ans[out_shape.size()-1-idx] = ( dim == 1 ) ? 0 : stride;
+                stride *= static_cast<std::ptrdiff_t>( dim );
+            }
+            return ans;
+        }
+
+        inline broadcast_layout make_broadcast_layout( std::vector<size_t> const& lhs_shape, std::vector<size_t> const& rhs_shape, std::vector<size_t> const& out_shape )
+        {
+            better_assert( (lhs_shape.size() <= out_shape.size()) && (rhs_shape.size() <= out_shape.size()), "broadcasting: operands have more dimensions than the output." );
+            auto const& lhs_strides = operand_strides( lhs_shape, out_shape );
+            auto const& rhs_strides = operand_strides( rhs_shape, out_shape );
+
+            broadcast_layout ans;
+            for ( size_t idx = 0; idx != out_shape.size(); ++idx )
+            {
+                if ( out_shape[idx] == 1 )
+                    continue;
+
+                if ( !ans.shape_.empty() ) // merges with the previous dimension if it steps over this one for both operands
+                {
+                    auto const dim = static_cast<std::ptrdiff_t>( out_shape[idx] );
+                    if ( (ans.lhs_strides_.back() == lhs_strides[idx] * dim) && (ans.rhs_strides_.back() == rhs_strides[idx] * dim) )
+                    {
+                        ans.shape_.back() *= out_shape[idx];
+                        ans.lhs_strides_.back() = lhs_strides[idx];
+                        ans.rhs_strides_.back() = rhs_strides[idx];
+                        continue;
+                    }
+                }
+
+                ans.shape_.push_back( out_shape[idx] );
+                ans.lhs_strides_.push_back( lhs_strides[idx] );
+                ans.rhs_strides_.push_back( rhs_strides[idx] );
+            }
+
+            if ( ans.shape_.empty() ) // a single element
+            {
+                ans.shape_.push_back( 1 );
+                ans.lhs_strides_.push_back( 0 );
+                ans.rhs_strides_.push_back( 0 );
+            }
+            return ans;
+        }
+
+        // out[0:n] = func( lhs[0:n:lhs_stride], rhs[0:n:rhs_stride] ), with the common strides of 1 and 0 as separate loops
+        template< typename T, typename Function >
+        void broadcast_inner( T const* __restrict__ lhs, std::ptrdiff_t lhs_stride, T const* __restrict__ rhs, std::ptrdiff_t rhs_stride, T* __restrict__ out, size_t n, Function const& func ) noexcept
+        {
+            if ( (lhs_stride == 1) && (rhs_stride == 1) )
+            {
+                #pragma GCC ivdep
+                for ( size_t idx = 0; idx < n; ++idx )
+                    out[idx] = func( lhs[idx], rhs[idx] );
+            }
+            else if ( (lhs_stride == 1) && (rhs_stride == 0) )
+            {
+                T const y = *rhs;
+                #pragma GCC ivdep
+                for ( size_t idx = 0; idx < n; ++idx )
+                    out[idx] = func( lhs[idx], y );
+            }
+            else if ( (lhs_stride == 0) && (rhs_stride == 1) )
+            {
+                T const x = *lhs;
+                #pragma GCC ivdep
+                for ( size_t idx = 0; idx < n; ++idx )
+                    out[idx] = func( x, rhs[idx] );
+            }
+            else
+            {
+                for ( size_t idx = 0; idx < n; ++idx )
+                    out[idx] = func( lhs[idx*lhs_stride], rhs[idx*rhs_stride] );
+            }
+        }
+
+        // the inner loops of the rows [row_first, row_last), the rows being indexed over all the outer dimensions
+        template< typename T, typename Function >
+        void broadcast_rows( broadcast_layout const& layout, T const* lhs, T const* rhs, T* out, size_t row_first, size_t row_last, Function const& func ) noexcept
+        {
+            size_t const outer_dims = layout.shape_.size() - 1;
+            size_t const inner = layout.shape_.back();
+            std::ptrdiff_t const lhs_inner_stride = layout.lhs_strides_.back();
+            std::ptrdiff_t const rhs_inner_stride = layout.rhs_strides_.back();
+
+            // the index of the first row over the outer dimensions, and the offsets of the operands
+            std::vector<size_t> index( outer_dims, 0 );
+            std::ptrdiff_t lhs_offset = 0;
+            std::ptrdiff_t rhs_offset = 0;
+            for ( size_t dim = outer_dims, row = row_first; dim-- > 0; )
+            {
+                index[dim] = row % layout.shape_[dim];
+                row /= layout.shape_[dim];
+                lhs_offset += static_cast<std::ptrdiff_t>( index[dim] ) * layout.lhs_strides_[dim];
+                rhs_offset += static_cast<std::ptrdiff_t>( index[dim] ) * layout.rhs_strides_[dim];
+            }
+
+            for ( size_t row = row_first; row != row_last; ++row )
+            {
+                broadcast_inner( lhs + lhs_offset, lhs_inner_stride, rhs + rhs_offset, rhs_inner_stride, out + row * inner, inner, func );
+
+                for ( size_t dim = outer_dims; dim-- > 0; ) // next row
+                {
+                    lhs_offset += layout.lhs_strides_[dim];
+                    rhs_offset += layout.rhs_strides_[dim];
+                    if ( ++index[dim] != layout.shape_[dim] )
+                        break;
+                    index[dim] = 0;
+                    lhs_offset -= layout.lhs_strides_[dim] * static_cast<std::ptrdiff_t>( layout.shape_[dim] );
+                    rhs_offset -= layout.rhs_strides_[dim] * static_cast<std::ptrdiff_t>( layout.shape_[dim] );
+                }
+            }
+        }
+
+    }//namespace broadcast_private
+
+    ///
+    /// @brief `out = func( lhs, rhs )` element-wise, with `lhs` and `rhs` broadcasted to `out_shape` in place.
+    ///
+    /// @param lhs The row-major elements of the left operand, of shape `lhs_shape`.
+    /// @param rhs The row-major elements of the right operand, of shape `rhs_shape`.
+    /// @param out The row-major elements of the output, of shape `out_shape`, not overlapping `lhs` or `rhs`.
+    /// @param func A binary function of two elements, returning the output element.
+    ///
+    /// Example code:
+    /// \code{.cpp}
+    /// std::vector<float> x( 2*3*4 ), bias( 4 ), y( 2*3*4 );
+    /// broadcast_binary( x.data(), {2, 3, 4}, bias.data(), {4,}, y.data(), {2, 3, 4}, []( float a, float b ){ return a + b; } );
+    /// \endcode
+    ///
+    template< typename T, typename Function >
+    void broadcast_binary( T const* lhs, std::vector<size_t> const& lhs_shape, T const* rhs, std::vector<size_t> const& rhs_shape,
+                           T* out, std::vector<size_t> const& out_shape, Function const& func )
+    {
+        auto const& layout = broadcast_private::make_broadcast_layout( lhs_shape, rhs_shape, out_shape );
+        size_t const inner = layout.shape_.back();
+        size_t const rows = std::accumulate( layout.shape_.begin(), layout.shape_.end()-1, 1UL, []( size_t x, size_t y ){ return x*y; } );
+        size_t const total = rows * inner;
+
+        if ( (parallel_mode == 0) || (total < for_each_parallel_threshold) || (thread_pool::instance().size() <= 1) )
+        {
+            broadcast_private::broadcast_rows( layout, lhs, rhs, out, 0, rows, func );
+            return;
+        }
+
+        // tasks of at least a quarter of the threshold, about four per thread, as in `for_each`
+        size_t const tasks = std::min( 4 * thread_pool::instance().size(), total / (for_each_parallel_threshold / 4) );
+        if ( rows < tasks ) // a few long rows, split along the inner dimension
+        {
+            size_t const pieces = ( tasks + rows - 1 ) / rows;
+            size_t const piece = ( inner + pieces - 1 ) / pieces;
+            parallel( [&]( size_t task )
+            {
+                size_t const row = task / pieces;
+                size_t const first = ( task % pieces ) * piece;
+                size_t const last = std::min( inner, first + piece );
+                if ( first >= last ) return;
+                std::ptrdiff_t lhs_offset = 0;
+                std::ptrdiff_t rhs_offset = 0;
+                for ( size_t dim = layout.shape_.size() - 1, index = row; dim-- > 0; index /= layout.shape_[dim] )
+                {
+                    lhs_offset += static_cast<std::ptrdiff_t>( index % layout.shape_[dim] ) * layout.lhs_strides_[dim];
+                    rhs_offset += static_cast<std::ptrdiff_t>( index % layout.shape_[dim] ) * layout.rhs_strides_[dim];
+                }
+                lhs_offset += static_cast<std::ptrdiff_t>( first ) * layout.lhs_strides_.back();
+                rhs_offset += static_cast<std::ptrdiff_t>( first ) * layout.rhs_strides_.back();
+                broadcast_private::broadcast_inner( lhs + lhs_offset, layout.lhs_strides_.back(), rhs + rhs_offset, layout.rhs_strides_.back(), out + row * inner + first, last - first, func );
+            }, size_t{0}, rows * pieces, 1 );
+            return;
+        }
+
+        size_t const rows_per_task = ( rows + tasks - 1 ) / tasks;
+        parallel( [&]( size_t task )
+        {
+            size_t const first = task * rows_per_task;
+            size_t const last = std::min( rows, first + rows_per_task );
+            if ( first < last )
+                broadcast_private::broadcast_rows( layout, lhs, rhs, out, first, last, func );
+        }, size_t{0}, tasks, 1 );
+    }
+
+    ///
+    /// @brief Sums `in` over the dimensions along which `out_shape` is broadcasted to `in_shape`, the adjoint of `broadcast_binary`.
+    ///
+    /// @param in The row-major elements of the input, of shape `in_shape`.
+    /// @param out The row-major elements of the output, of shape `out_shape`, not overlapping `in`.
+    ///
+    /// The sums of a 16-bit type are accumulated in float, and rounded once.
+    ///
+    template< typename T, typename U >
+    void broadcast_sum( T const* in, std::vector<size_t> const& in_shape, U* __restrict__ out, std::vector<size_t> const& out_shape )
+    {
+        if constexpr( Half_Float<U> )
+        {
+            std::vector<float> sums( std::accumulate( out_shape.begin(), out_shape.end(), 1UL, []( size_t x, size_t y ){ return x*y; } ) );
+            broadcast_sum( in, in_shape, sums.data(), out_shape );
+            std::copy( sums.begin(), sums.end(), out );
+            return;
+        }
+
+        auto const& layout = broadcast_private::make_broadcast_layout( out_shape, in_shape, in_shape );
+        size_t const outer_dims = layout.shape_.size() - 1;
+        size_t const inner = layout.shape_.back();
+        size_t const rows = std::accumulate( layout.shape_.begin(), layout.shape_.end()-1, 1UL, []( size_t x, size_t y ){ return x*y; } );
+        std::ptrdiff_t const out_inner_stride = layout.lhs_strides_.back();
+
+        std::fill_n( out, std::accumulate( out_shape.begin(), out_shape.end(), 1UL, []( size_t x, size_t y ){ return x*y; } ), U{0} );
+
+        // the rows in order, several rows accumulating into the same output row, hence on the calling thread
+        std::vector<size_t> index( outer_dims, 0 );
+        std::ptrdiff_t out_offset = 0;
+        for ( size_t row = 0; row != rows; ++row )
+        {
+            T const* __restrict__ in_row = in + row * inner;
+            U* __restrict__ out_row = out + out_offset;
+            if ( out_inner_stride == 0 )
+                *out_row += std::reduce( in_row, in_row + inner, U{0} );
+            else
+            {
+                #pragma GCC ivdep
+                for ( size_t idx = 0; idx < inner; ++idx )
+                    out_row[idx] += in_row[idx];
+            }
+
+            for ( size_t dim = outer_dims; dim-- > 0; ) // next row
+            {
+                out_offset += layout.lhs_strides_[dim];
+                if ( ++index[dim] != layout.shape_[dim] )
+                    break;
+                index[dim] = 0;
+                out_offset -= layout.lhs_strides_[dim] * static_cast<std::ptrdiff_t>( layout.shape_[dim] );
+            }
+        }
+    }
+
+}//namespace ceras
+
+#endif//BROADCAST_HPP_INCLUDED_ZKWQPLMRTYSNVBXAHGDJEIUOCFKWQMZNRTLYPSBVXGHADJKEIUQCFW
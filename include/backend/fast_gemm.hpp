@@ -0,0 +1,520 @@
+#ifndef FAST_GEMM_HPP_INCLUDED_PLOKMIJNUHBYGVTFCRDXESZWAQPLOKMIJNUHBYGVTFCRDXESZWAQ
+#define FAST_GEMM_HPP_INCLUDED_PLOKMIJNUHBYGVTFCRDXESZWAQPLOKMIJNUHBYGVTFCRDXESZWAQ
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "../utils/better_assert.hpp"
+#include "../utils/enumerate.hpp"
+#include "../utils/fmt.hpp"
+#include "../utils/parallel.hpp"
+#include "../utils/range.hpp"
+#include "./gemm.hpp"
+
+//
+// Fast (Strassen-like) matrix multiplication from bilinear decompositions.
+//
+// A rank-R decomposition of the n0 x n0 x n0 matrix product is a triple of coefficient matrices a [n0*n0 x R],
+// b [n0*n0 x R] and c [R x n0*n0], with the blocks of A, B and C numbered row by row, such that
+//
+//      S_r = sum_i a[i][r] A_i,   U_r = sum_j b[j][r] B_j,   P_r = S_r * U_r,   C_l = sum_r c[r][l] P_r
+//
+// computes C = A * B with R block products instead of n0^3. These are the tensors the programs
+// `examples/gemm_optimization_nxn*.cc` learn, round and save with `save_bilinear_decomposition`; the Strassen
+// decomposition saved this way is `examples/gemm_decompositions/strassen_2x2x2_7.txt`.
+//
+// `generate_fast_gemm_kernel` turns a decomposition into a kernel: a struct whose `step` is one level of the
+// algorithm written out as straight-line code, with the zero coefficients dropped, the single-term sums replaced
+// by the blocks themselves and the first product of a C block written in place. `fast_gemm` recurses with such
+// a kernel until the blocks are smaller than a cutoff, and finishes with the blocked classical gemm.
+//
+// Error bound. Every entry of C computed in floating point is the exact bilinear form with each of its terms
+// perturbed by at most d roundings, so that |C - fl(C)| <= gamma(d) * D, with gamma(d) = d u / (1 - d u), u the
+// unit roundoff, and D the result of the algorithm run on |A|, |B| with |a|, |b|, |c|. Per level
+//
+//      D(K) <= e * D(K/n0) + (n0-1),     e = max_l sum_r |c[r][l]| * |a[:,r]|_1 * |b[:,r]|_1,
+//
+// in units of max|A| * max|B|, D(K) = K at the classical leaves, and the depth d grows by the additions of a level
+// (`rounding_depth`) plus the n0-1 updates of a peeled remainder. For Strassen's algorithm e = 12, against n0 = 2
+// for the classical one, which is the well known n^log2(12) growth. `fast_gemm_error_bound` evaluates this bound.
+//
+
+namespace ceras
+{
+
+    ///
+    /// @brief A bilinear decomposition of the `n0 x n0 x n0` matrix product of rank `rank`, see the comment at the top of this file.
+    ///
+    struct bilinear_decomposition
+    {
+        size_t n0;
+        size_t rank;
+        std::vector<double> a; ///< [n0*n0 x rank], the combinations of the blocks of A
+        std::vector<double> b; ///< [n0*n0 x rank], the combinations of the blocks of B
+        std::vector<double> c; ///< [rank x n0*n0], the combinations of the products forming the blocks of C
+    }; // struct bilinear_decomposition
+
+    ///
+    /// @brief Strassen's rank-7 decomposition of the 2x2x2 product.
+    ///
+    inline bilinear_decomposition strassen_decomposition()
+    {
+        //                        P0  P1  P2  P3  P4  P5  P6
+        return bilinear_decomposition{ 2, 7,
+        {
+                                   1,  0,  1,  0,  1, -1,  0, // A00
+                                   0,  0,  0,  0,  1,  0,  1, // A01
+                                   0,  1,  0,  0,  0,  1,  0, // A10
+                                   1,  1,  0,  1,  0,  0, -1, // A11
+        },
+        {
+                                   1,  1,  0, -1,  0,  1,  0, // B00
+                                   0,  0,  1,  0,  0,  1,  0, // B01
+                                   0,  0,  0,  1,  0,  0,  1, // B10
+                                   1,  0, -1,  0,  1,  0,  1, // B11
+        },
+        {
+                                // C00 C01 C10 C11
+                                   1,  0,  0,  1, // P0
+                                   0,  0,  1, -1, // P1
+                                   0,  1,  0,  1, // P2
+                                   1,  0,  1,  0, // P3
+                                  -1,  1,  0,  0, // P4
+                                   0,  0,  0,  1, // P5
+                                   1,  0,  0,  0, // P6
+        } };
+    }
+
+    ///
+    /// @brief Reads a decomposition from a text file: `n0 rank`, followed by the entries of a, b and c, row by row. Lines starting with '#' are comments.
+    ///
+    inline bilinear_decomposition load_bilinear_decomposition( std::string const& path )
+    {
+        std::ifstream ifs{ path };
+        better_assert( ifs.good(), "load_bilinear_decomposition: failed to open ", path );
+
+        std::stringstream content;
+        for ( std::string line; std::getline( ifs, line ); )
+            if ( !line.starts_with( "#" ) )
+                content << line << "\n";
+
+        bilinear_decomposition ans;
+        content >> ans.n0 >> ans.rank;
+        ans.a.resize( ans.n0 * ans.n0 * ans.rank );
+        ans.b.resize( ans.n0 * ans.n0 * ans.rank );
+        ans.c.resize( ans.n0 * ans.n0 * ans.rank );
+        for ( auto* coefficients : { &ans.a, &ans.b, &ans.c } )
+            for ( auto& x : *coefficients )
+                content >> x;
+        better_assert( !content.fail(), "load_bilinear_decomposition: incomplete decomposition in ", path );
+        return ans;
+    }
+
+    ///
+    /// @brief Writes a decomposition in the format read by `load_bilinear_decomposition`.
+    ///
+    inline void save_bilinear_decomposition( bilinear_decomposition const& decomposition, std::string const& path )
+    {
+        std::ofstream ofs{ path };
+        better_assert( ofs.good(), "save_bilinear_decomposition: failed to open ", path );
+
+        size_t const blocks = decomposition.n0 * decomposition.n0;
+        ofs << "# bilinear decomposition: n0 rank, then a [n0*n0 x rank], b [n0*n0 x rank] and c [rank x n0*n0]\n";
+        ofs << decomposition.n0 << " " << decomposition.rank << "\n";
+        ofs << std::setprecision( 17 );
+        for ( auto const* coefficients : { &decomposition.a, &decomposition.b } )
+            for ( auto i : range( blocks ) )
+            {
+                for ( auto r : range( decomposition.rank ) )
+                    ofs << (*coefficients)[i*decomposition.rank+r] << " ";
+                ofs << "\n";
+            }
+        for ( auto r : range( decomposition.rank ) )
+        {
+            for ( auto l : range( blocks ) )
+                ofs << decomposition.c[r*blocks+l] << " ";
+            ofs << "\n";
+        }
+    }
+
+    ///
+    /// @brief Rounds the coefficients of a learned decomposition to the nearest multiple of `1/denominator`, removing the training noise.
+    ///
+    inline bilinear_decomposition round_bilinear_decomposition( bilinear_decomposition decomposition, double denominator = 2.0 )
+    {
+        for ( auto* coefficients : { &decomposition.a, &decomposition.b, &decomposition.c } )
+            for ( auto& x : *coefficients )
+                x = std::round( x * denominator ) / denominator;
+        return decomposition;
+    }
+
+    ///
+    /// @brief The largest residual of the Brent equations, `sum_r a[i][r] b[j][r] c[r][l] = [A_i B_j contributes to C_l]`; zero for an exact decomposition.
+    ///
+    inline double brent_residual( bilinear_decomposition const& decomposition )
+    {
+        size_t const n0 = decomposition.n0;
+        size_t const blocks = n0 * n0;
+        size_t const rank = decomposition.rank;
+        double ans = 0.0;
+        for ( auto i : range( blocks ) )
+            for ( auto j : range( blocks ) )
+                for ( auto l : range( blocks ) )
+                {
+                    double sum = 0.0;
+                    for ( auto r : range( rank ) )
+                        sum += decomposition.a[i*rank+r] * decomposition.b[j*rank+r] * decomposition.c[r*blocks+l];
+                    // A_(p,q) * B_(s,t) contributes to C_(u,v) iff q == s, p == u and t == v
+                    double const expected = ( ( i % n0 == j / n0 ) && ( i / n0 == l / n0 ) && ( j % n0 == l % n0 ) ) ? 1.0 : 0.0;
+                    ans = std::max( ans, std::abs( sum - expected ) );
+                }
+        return ans;
+    }
+
+    ///
+    /// @brief The growth factor `e` of the error bound, see the comment at the top of this file.
+    ///
+    inline double fast_gemm_error_growth( bilinear_decomposition const& decomposition )
+    {
+        size_t const blocks = decomposition.n0 * decomposition.n0;
+        size_t const rank = decomposition.rank;
+        double ans = 0.0;
+        for ( auto l : range( blocks ) )
+        {
+            double sum = 0.0;
+            for ( auto r : range( rank ) )
+            {
+                double a_norm = 0.0, b_norm = 0.0;
+                for ( auto i : range( blocks ) )
+                {
+                    a_norm += std::abs( decomposition.a[i*rank+r] );
+                    b_norm += std::abs( decomposition.b[i*rank+r] );
+                }
+                sum += std::abs( decomposition.c[r*blocks+l] ) * a_norm * b_norm;
+            }
+            ans = std::max( ans, sum );
+        }
+        return ans;
+    }
+
+    ///
+    /// @brief The roundings added by a level of the algorithm to an entry of C: the longest sums of A blocks, of B blocks and of products, plus a scaling for each of them using a coefficient other than a power of 2.
+    ///
+    inline size_t fast_gemm_rounding_depth( bilinear_decomposition const& decomposition )
+    {
+        size_t const blocks = decomposition.n0 * decomposition.n0;
+        size_t const rank = decomposition.rank;
+        auto const& exact_scale = []( double x ){ int exponent; return std::abs( std::frexp( x, &exponent ) ) == 0.5; }; // +-2^k
+
+        size_t ans = 0;
+        for ( auto const& [coefficients, outer, inner, outer_stride, inner_stride] : { std::make_tuple( &decomposition.a, rank, blocks, 1UL, rank ),
+                                                                                       std::make_tuple( &decomposition.b, rank, blocks, 1UL, rank ),
+                                                                                       std::make_tuple( &decomposition.c, blocks, rank, 1UL, blocks ) } )
+        {
+            size_t longest = 0;
+            bool scaled = false;
+            for ( auto o : range( outer ) )
+            {
+                size_t terms = 0;
+                for ( auto i : range( inner ) )
+                {
+                    double const x = (*coefficients)[o*outer_stride+i*inner_stride];
+                    if ( x == 0.0 ) continue;
+                    ++terms;
+                    scaled = scaled || !exact_scale( x );
+                }
+                longest = std::max( longest, terms );
+            }
+            ans += ( longest > 0 ? longest - 1 : 0 ) + ( scaled ? 1 : 0 );
+        }
+        return ans;
+    }
+
+    namespace ceras_private
+    {
+
+        inline std::string fast_gemm_coefficient( double x )
+        {
+            std::ostringstream oss;
+            oss << std::setprecision( 17 ) << x;
+            return oss.str();
+        }
+
+    }//namespace ceras_private
+
+    ///
+    /// @brief Generates the C++ header of a fast gemm kernel from an exact decomposition.
+    ///
+    /// The header defines `struct name`, which can be passed to `fast_gemm`.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// auto const decomposition = ceras::round_bilinear_decomposition( ceras::load_bilinear_decomposition( "./gemm_decomposition_2x2x2_7.txt" ) );
+    /// std::ofstream{ "./build/learned_fast_gemm.hpp" } << ceras::generate_fast_gemm_kernel( decomposition, "learned_fast_gemm" );
+    /// @endcode
+    ///
+    inline std::string generate_fast_gemm_kernel( bilinear_decomposition const& decomposition, std::string const& name )
+    {
+        using namespace ceras_private;
+        size_t const n0 = decomposition.n0;
+        size_t const blocks = n0 * n0;
+        size_t const rank = decomposition.rank;
+        better_assert( brent_residual( decomposition ) < 1.0e-12, "generate_fast_gemm_kernel: not an exact decomposition, the residual is ", brent_residual( decomposition ) );
+
+        std::string guard = name;
+        std::transform( guard.begin(), guard.end(), guard.begin(), []( char ch ){ return static_cast<char>( std::toupper( ch ) ); } );
+        {
+            std::string suffix;
+            for ( std::uint64_t seed = 0xcbf29ce484222325ULL; auto ch : name + "fast_gemm_kernel" )
+            {
+                seed = ( seed ^ static_cast<std::uint64_t>( ch ) ) * 0x100000001b3ULL;
+                suffix += static_cast<char>( 'A' + ( seed >> 40 ) % 26 );
+            }
+            guard += "_HPP_INCLUDED_" + suffix;
+        }
+
+        std::ostringstream code;
+        code << "#ifndef " << guard << "\n";
+        code << "#define " << guard << "\n\n";
+        code << "// Generated by ceras::generate_fast_gemm_kernel from a rank-" << rank << " decomposition of the " << n0 << "x" << n0 << "x" << n0 << " product. Do not edit.\n\n";
+        code << "#include \"./fast_gemm.hpp\"\n\n";
+        code << "namespace ceras\n{\n\n";
+        code << "    struct " << name << "\n    {\n";
+        code << "        static constexpr size_t n0 = " << n0 << ";\n";
+        code << "        static constexpr size_t rank = " << rank << ";\n";
+        code << "        static constexpr double error_growth = " << fast_gemm_coefficient( fast_gemm_error_growth( decomposition ) ) << ";\n";
+        code << "        static constexpr size_t rounding_depth = " << fast_gemm_rounding_depth( decomposition ) << ";\n\n";
+        code << "        // One level: C <= op(A) * op(B), op(A) made of n0 x n0 blocks of [m x k], op(B) of [k x n] and C of [m x n].\n";
+        code << "        // S, U and P are workspaces of a block of A, of B and of C; multiply( a, lda, b, ldb, c, ldc ) computes a block product.\n";
+        code << "        template< typename T, typename Multiply >\n";
+        code << "        static void step( T const* A, size_t lda, bool a_transposed, T const* B, size_t ldb, bool b_transposed, T* C, size_t ldc,\n";
+        code << "                          size_t m, size_t k, size_t n, T* S, T* U, T* P, Multiply const& multiply )\n";
+        code << "        {\n";
+        code << "            auto const& a = [=]( size_t row, size_t col ){ return a_transposed ? A + col * k * lda + row * m : A + row * m * lda + col * k; };\n";
+        code << "            auto const& b = [=]( size_t row, size_t col ){ return b_transposed ? B + col * n * ldb + row * k : B + row * k * ldb + col * n; };\n";
+        code << "            auto const& c = [=]( size_t row, size_t col ){ return C + row * m * ldc + col * n; };\n";
+        code << "            size_t const a_rows = a_transposed ? k : m;\n";
+        code << "            size_t const a_cols = a_transposed ? m : k;\n";
+        code << "            size_t const b_rows = b_transposed ? n : k;\n";
+        code << "            size_t const b_cols = b_transposed ? k : n;\n";
+
+        std::vector<bool> written( blocks, false );
+        for ( auto r : range( rank ) )
+        {
+            // the operands: a block itself for a single term of coefficient 1, a sum in the workspace otherwise
+            auto const& operand = [&]( std::vector<double> const& coefficients, std::string const& matrix, std::string const& workspace, std::string const& ld,
+                                       std::string const& rows, std::string const& cols ) -> std::pair<std::string, std::string>
+            {
+                std::vector<std::pair<size_t, double>> terms;
+                for ( auto i : range( blocks ) )
+                    if ( coefficients[i*rank+r] != 0.0 )
+                        terms.emplace_back( i, coefficients[i*rank+r] );
+                better_assert( !terms.empty(), "generate_fast_gemm_kernel: product ", r, " has an empty operand" );
+
+                if ( terms.size() == 1 && terms[0].second == 1.0 )
+                    return { fmt::format( "{}( {}, {} )", matrix, terms[0].first / n0, terms[0].first % n0 ), ld };
+
+                code << "            fast_gemm_sum( " << workspace << ", " << cols << ", " << rows << ", " << cols << ", " << ld << ", {";
+                for ( auto const& [idx, x] : enumerate( terms ) )
+                    code << ( idx ? "," : "" ) << " { " << matrix << "( " << x.first / n0 << ", " << x.first % n0 << " ), T(" << fast_gemm_coefficient( x.second ) << ") }";
+                code << " } );\n";
+                return { workspace, cols };
+            };
+
+            code << "\n            // P" << r << "\n";
+            auto const [s, lds] = operand( decomposition.a, "a", "S", "lda", "a_rows", "a_cols" );
+            auto const [u, ldu] = operand( decomposition.b, "b", "U", "ldb", "b_rows", "b_cols" );
+
+            std::vector<std::pair<size_t, double>> targets;
+            for ( auto l : range( blocks ) )
+                if ( decomposition.c[r*blocks+l] != 0.0 )
+                    targets.emplace_back( l, decomposition.c[r*blocks+l] );
+
+            // the product goes straight into the first C block it initializes with coefficient 1, if any
+            auto const home = std::find_if( targets.begin(), targets.end(), [&]( auto const& t ){ return !written[t.first] && t.second == 1.0; } );
+            std::string product = "P";
+            std::string ldp = "n";
+            if ( home != targets.end() )
+            {
+                product = fmt::format( "c( {}, {} )", home->first / n0, home->first % n0 );
+                ldp = "ldc";
+                written[home->first] = true;
+            }
+            code << "            multiply( " << s << ", " << lds << ", " << u << ", " << ldu << ", " << product << ", " << ldp << " );\n";
+
+            for ( auto const& [l, x] : targets )
+            {
+                if ( home != targets.end() && l == home->first )
+                    continue;
+                code << "            fast_gemm_update( c( " << l / n0 << ", " << l % n0 << " ), ldc, m, n, " << product << ", " << ldp << ", T(" << fast_gemm_coefficient( x ) << "), "
+                     << ( written[l] ? "false" : "true" ) << " );\n";
+                written[l] = true;
+            }
+        }
+
+        code << "        }\n";
+        code << "    }; // struct " << name << "\n\n";
+        code << "}//namespace ceras\n\n";
+        code << "#endif//" << guard << "\n";
+        return code.str();
+    }
+
+    ///
+    /// @brief dst <= sum of x * src over the terms { src, x }; all the sources are [rows x cols] with row stride `ld_src`.
+    ///
+    template< typename T >
+    void fast_gemm_sum( T* __restrict__ dst, size_t ld_dst, size_t rows, size_t cols, size_t ld_src, std::initializer_list<std::pair<T const*, T>> terms )
+    {
+        parallel( [=]( size_t row )
+        {
+            T* __restrict__ d = dst + row * ld_dst;
+            auto itor = terms.begin();
+            {
+                T const* __restrict__ s = itor->first + row * ld_src;
+                T const x = itor->second;
+                for ( size_t col = 0; col != cols; ++col )
+                    d[col] = x * s[col];
+            }
+            for ( ++itor; itor != terms.end(); ++itor )
+            {
+                T const* __restrict__ s = itor->first + row * ld_src;
+                T const x = itor->second;
+                for ( size_t col = 0; col != cols; ++col )
+                    d[col] += x * s[col];
+            }
+        }, size_t{0}, rows, 64 );
+    }
+
+    ///
+    /// @brief dst <= x * src if `assign`, dst += x * src otherwise; both are [rows x cols].
+    ///
+    template< typename T >
+    void fast_gemm_update( T* __restrict__ dst, size_t ld_dst, size_t rows, size_t cols, T const* __restrict__ src, size_t ld_src, T x, bool assign )
+    {
+        parallel( [=]( size_t row )
+        {
+            T* __restrict__ d = dst + row * ld_dst;
+            T const* __restrict__ s = src + row * ld_src;
+            if ( assign )
+                for ( size_t col = 0; col != cols; ++col )
+                    d[col] = x * s[col];
+            else
+                for ( size_t col = 0; col != cols; ++col )
+                    d[col] += x * s[col];
+        }, size_t{0}, rows, 64 );
+    }
+
+    ///
+    /// @brief Fast gemm on strided matrices with a generated kernel, same arguments as blocked_gemm: C[M x N] <= op(A)[M x K] * op(B)[K x N].
+    ///
+    /// The kernel recurses while all of the three dimensions are at least `n0 * cutoff`; the trailing rows and columns not divisible
+    /// by `n0` are computed classically. The products below the cutoff go to parallel_gemm with the given blocking.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// ceras::fast_gemm<ceras::strassen_fast_gemm>( A, 2048, false, B, 2048, false, 2048, 2048, 2048, C, 2048, 512 );
+    /// @endcode
+    ///
+    template< typename Kernel, typename T > requires std::floating_point<T>
+    void fast_gemm( T const* A, size_t lda, bool a_transposed, T const* B, size_t ldb, bool b_transposed,
+                    size_t M, size_t K, size_t N, T* C, size_t ldc, size_t cutoff,
+                    gemm_blocking const& blocking = ceras_private::default_gemm_blocking<T>() )
+    {
+        constexpr size_t n0 = Kernel::n0;
+        if ( std::min( { M, K, N } ) < n0 * std::max( cutoff, size_t{1} ) )
+        {
+            parallel_gemm( A, lda, a_transposed, B, ldb, b_transposed, M, K, N, C, ldc, blocking );
+            return;
+        }
+
+        size_t const m = M / n0;
+        size_t const k = K / n0;
+        size_t const n = N / n0;
+        // workspaces for the operand sums and the product of a level, every element written before it is read
+        auto S = std::make_unique_for_overwrite<T[]>( m * k );
+        auto U = std::make_unique_for_overwrite<T[]>( k * n );
+        auto P = std::make_unique_for_overwrite<T[]>( m * n );
+        auto const& multiply = [&]( T const* a, size_t lda_, T const* b, size_t ldb_, T* c, size_t ldc_ )
+        {
+            fast_gemm<Kernel>( a, lda_, a_transposed, b, ldb_, b_transposed, m, k, n, c, ldc_, cutoff, blocking );
+        };
+        Kernel::step( A, lda, a_transposed, B, ldb, b_transposed, C, ldc, m, k, n, S.get(), U.get(), P.get(), multiply );
+
+        // the remainders of the dimensions not divisible by n0
+        size_t const M0 = m * n0;
+        size_t const K0 = k * n0;
+        size_t const N0 = n * n0;
+        if ( K0 != K ) // C[:M0, :N0] += op(A)[:M0, K0:] * op(B)[K0:, :N0]
+        {
+            parallel( [=]( size_t row )
+            {
+                T* __restrict__ c = C + row * ldc;
+                for ( size_t p = K0; p != K; ++p )
+                {
+                    T const x = a_transposed ? A[p*lda+row] : A[row*lda+p];
+                    if ( b_transposed )
+                        for ( size_t col = 0; col != N0; ++col )
+                            c[col] += x * B[col*ldb+p];
+                    else
+                        for ( size_t col = 0; col != N0; ++col )
+                            c[col] += x * B[p*ldb+col];
+                }
+            }, size_t{0}, M0, 64 );
+        }
+        if ( M0 != M ) // C[M0:, :] = op(A)[M0:, :] * op(B)
+            parallel_gemm( a_transposed ? A + M0 : A + M0 * lda, lda, a_transposed, B, ldb, b_transposed, M - M0, K, N, C + M0 * ldc, ldc, blocking );
+        if ( N0 != N ) // C[:M0, N0:] = op(A)[:M0, :] * op(B)[:, N0:]
+            parallel_gemm( A, lda, a_transposed, b_transposed ? B + N0 * ldb : B + N0, ldb, b_transposed, M0, K, N - N0, C + N0, ldc, blocking );
+    }
+
+    ///
+    /// @brief The number of levels `fast_gemm` recurses for a product of the given shape.
+    ///
+    template< typename Kernel >
+    size_t fast_gemm_levels( size_t M, size_t K, size_t N, size_t cutoff ) noexcept
+    {
+        size_t levels = 0;
+        for ( ; std::min( { M, K, N } ) >= Kernel::n0 * std::max( cutoff, size_t{1} ); ++levels )
+        {
+            M /= Kernel::n0;
+            K /= Kernel::n0;
+            N /= Kernel::n0;
+        }
+        return levels;
+    }
+
+    ///
+    /// @brief A bound of `max|C - fl(C)|` for `fast_gemm<Kernel>`, given `max|A|` and `max|B|`; see the comment at the top of this file.
+    ///
+    /// With a cutoff larger than the dimensions, this is the classical bound `gamma(K) * K * max|A| * max|B|`.
+    ///
+    template< typename Kernel, typename T > requires std::floating_point<T>
+    double fast_gemm_error_bound( size_t M, size_t K, size_t N, size_t cutoff, double max_abs_a, double max_abs_b ) noexcept
+    {
+        double magnitude = 0.0; // D, in units of max|A| * max|B|
+        size_t depth = 0;
+        {
+            std::vector<size_t> inner{ K }; // the inner dimension at each level
+            for ( [[maybe_unused]] auto _ : range( fast_gemm_levels<Kernel>( M, K, N, cutoff ) ) )
+                inner.push_back( inner.back() / Kernel::n0 );
+
+            magnitude = static_cast<double>( inner.back() );
+            depth = inner.back();
+            for ( size_t level = inner.size() - 1; level != 0; --level )
+            {
+                magnitude = Kernel::error_growth * magnitude + static_cast<double>( inner[level-1] - inner[level] * Kernel::n0 );
+                depth += Kernel::rounding_depth + Kernel::n0 - 1;
+            }
+            depth = std::max( depth, K ); // the peeled rows and columns are classical products of length K
+            magnitude = std::max( magnitude, static_cast<double>( K ) );
+        }
+
+        double const u = std::numeric_limits<T>::epsilon() / 2.0;
+        double const gamma = depth * u / ( 1.0 - depth * u );
+        return gamma * magnitude * max_abs_a * max_abs_b;
+    }
+
+}//namespace ceras
+
+#endif//FAST_GEMM_HPP_INCLUDED_PLOKMIJNUHBYGVTFCRDXESZWAQPLOKMIJNUHBYGVTFCRDXESZWAQ
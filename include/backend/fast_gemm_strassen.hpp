@@ -0,0 +1,76 @@
+#ifndef STRASSEN_FAST_GEMM_HPP_INCLUDED_QCDRXIITMYBNTXBXCMSPYWRGUQTRTFQQJU
+#define STRASSEN_FAST_GEMM_HPP_INCLUDED_QCDRXIITMYBNTXBXCMSPYWRGUQTRTFQQJU
+
+// Generated by ceras::generate_fast_gemm_kernel from a rank-7 decomposition of the 2x2x2 product. Do not edit.
+
+#include "./fast_gemm.hpp"
+
+namespace ceras
+{
+
+    struct strassen_fast_gemm
+    {
+        static constexpr size_t n0 = 2;
+        static constexpr size_t rank = 7;
+        static constexpr double error_growth = 12;
+        static constexpr size_t rounding_depth = 5;
+
+        // One level: C <= op(A) * op(B), op(A) made of n0 x n0 blocks of [m x k], op(B) of [k x n] and C of [m x n].
+        // S, U and P are workspaces of a block of A, of B and of C; multiply( a, lda, b, ldb, c, ldc ) computes a block product.
+        template< typename T, typename Multiply >
+        static void step( T const* A, size_t lda, bool a_transposed, T const* B, size_t ldb, bool b_transposed, T* C, size_t ldc,
+                          size_t m, size_t k, size_t n, T* S, T* U, T* P, Multiply const& multiply )
+        {
+            auto const& a = [=]( size_t row, size_t col ){ return a_transposed ? A + col * k * lda + row * m : A + row * m * lda + col * k; };
+            auto const& b = [=]( size_t row, size_t col ){ return b_transposed ? B + col * n * ldb + row * k : B + row * k * ldb + col * n; };
+            auto const& c = [=]( size_t row, size_t col ){ return C + row * m * ldc + col * n; };
+            size_t const a_rows = a_transposed ? k : m;
+            size_t const a_cols = a_transposed ? m : k;
+            size_t const b_rows = b_transposed ? n : k;
+            size_t const b_cols = b_transposed ? k : n;
+
+            // P0
+            fast_gemm_sum( S, a_cols, a_rows, a_cols, lda, { { a( 0, 0 ), T(1) }, { a( 1, 1 ), T(1) } } );
+            fast_gemm_sum( U, b_cols, b_rows, b_cols, ldb, { { b( 0, 0 ), T(1) }, { b( 1, 1 ), T(1) } } );
+            multiply( S, a_cols, U, b_cols, c( 0, 0 ), ldc );
+            fast_gemm_update( c( 1, 1 ), ldc, m, n, c( 0, 0 ), ldc, T(1), true );
+
+            // P1
+            fast_gemm_sum( S, a_cols, a_rows, a_cols, lda, { { a( 1, 0 ), T(1) }, { a( 1, 1 ), T(1) } } );
+            multiply( S, a_cols, b( 0, 0 ), ldb, c( 1, 0 ), ldc );
+            fast_gemm_update( c( 1, 1 ), ldc, m, n, c( 1, 0 ), ldc, T(-1), false );
+
+            // P2
+            fast_gemm_sum( U, b_cols, b_rows, b_cols, ldb, { { b( 0, 1 ), T(1) }, { b( 1, 1 ), T(-1) } } );
+            multiply( a( 0, 0 ), lda, U, b_cols, c( 0, 1 ), ldc );
+            fast_gemm_update( c( 1, 1 ), ldc, m, n, c( 0, 1 ), ldc, T(1), false );
+
+            // P3
+            fast_gemm_sum( U, b_cols, b_rows, b_cols, ldb, { { b( 0, 0 ), T(-1) }, { b( 1, 0 ), T(1) } } );
+            multiply( a( 1, 1 ), lda, U, b_cols, P, n );
+            fast_gemm_update( c( 0, 0 ), ldc, m, n, P, n, T(1), false );
+            fast_gemm_update( c( 1, 0 ), ldc, m, n, P, n, T(1), false );
+
+            // P4
+            fast_gemm_sum( S, a_cols, a_rows, a_cols, lda, { { a( 0, 0 ), T(1) }, { a( 0, 1 ), T(1) } } );
+            multiply( S, a_cols, b( 1, 1 ), ldb, P, n );
+            fast_gemm_update( c( 0, 0 ), ldc, m, n, P, n, T(-1), false );
+            fast_gemm_update( c( 0, 1 ), ldc, m, n, P, n, T(1), false );
+
+            // P5
+            fast_gemm_sum( S, a_cols, a_rows, a_cols, lda, { { a( 0, 0 ), T(-1) }, { a( 1, 0 ), T(1) } } );
+            fast_gemm_sum( U, b_cols, b_rows, b_cols, ldb, { { b( 0, 0 ), T(1) }, { b( 0, 1 ), T(1) } } );
+            multiply( S, a_cols, U, b_cols, P, n );
+            fast_gemm_update( c( 1, 1 ), ldc, m, n, P, n, T(1), false );
+
+            // P6
+            fast_gemm_sum( S, a_cols, a_rows, a_cols, lda, { { a( 0, 1 ), T(1) }, { a( 1, 1 ), T(-1) } } );
+            fast_gemm_sum( U, b_cols, b_rows, b_cols, ldb, { { b( 1, 0 ), T(1) }, { b( 1, 1 ), T(1) } } );
+            multiply( S, a_cols, U, b_cols, P, n );
+            fast_gemm_update( c( 0, 0 ), ldc, m, n, P, n, T(1), false );
+        }
+    }; // struct strassen_fast_gemm
+
+}//namespace ceras
+
+#endif//STRASSEN_FAST_GEMM_HPP_INCLUDED_QCDRXIITMYBNTXBXCMSPYWRGUQTRTFQQJU
@@ -0,0 +1,532 @@
+#ifndef GEMM_HPP_INCLUDED_QOWIEUTYRLKSJDFHGMZNXBCVPOIUYTREWQASDFGHJKLMNBVCXZLKJHG
+#define GEMM_HPP_INCLUDED_QOWIEUTYRLKSJDFHGMZNXBCVPOIUYTREWQASDFGHJKLMNBVCXZLKJHG
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "../utils/better_assert.hpp"
+#include "../utils/parallel.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+//
+// A cache-blocked CPU GEMM engine, following the classical Goto/BLIS layout:
+//
+//   for jc in [0, N) step NC                      <- columns of C/B, B panel sized for L3
+//     for pc in [0, K) step KC                    <- common dimension
+//       pack B[pc:pc+KC, jc:jc+NC]  into NR-wide micro-panels
+//       for ic in [0, M) step MC                  <- rows of C/A, A block sized for L2
+//         pack A[ic:ic+MC, pc:pc+KC] into MR-tall micro-panels
+//         for jr in [0, NC) step NR
+//           for ir in [0, MC) step MR
+//             micro_kernel( MR x NR tile of C )   <- register tile, B micro-panel resident in L1
+//
+// The transposition of A and B is resolved entirely in the packing routines, so that
+// every combination of `a_transposed`/`b_transposed` ends up in the same micro-kernel
+// reading unit-stride packed buffers.
+//
+
+namespace ceras
+{
+
+    ///
+    /// @brief Cache blocking parameters for the blocked gemm.
+    ///
+    /// `mc` rows of A and `kc` columns of A are packed into a block expected to reside in L2,
+    /// `kc` rows and `nc` columns of B are packed into a panel expected to reside in L3.
+    ///
+    struct gemm_blocking
+    {
+        size_t mc;
+        size_t kc;
+        size_t nc;
+    }; // struct gemm_blocking
+
+    namespace ceras_private
+    {
+
+        ///
+        /// @brief Register tile of the micro-kernel for type T.
+        ///
+        template< typename T >
+        struct gemm_micro_tile
+        {
+            static constexpr size_t mr = 4;
+            static constexpr size_t nr = 8;
+        };
+
+#if defined(__AVX512F__)
+        template<>
+        struct gemm_micro_tile<float>
+        {
+            static constexpr size_t mr = 8;
+            static constexpr size_t nr = 32; // 2 zmm registers per row, 16 accumulators in total
+        };
+
+        template<>
+        struct gemm_micro_tile<double>
+        {
+            static constexpr size_t mr = 8;
+            static constexpr size_t nr = 16;
+        };
+#elif defined(__AVX2__) && defined(__FMA__)
+        template<>
+        struct gemm_micro_tile<float>
+        {
+            static constexpr size_t mr = 6;
+            static constexpr size_t nr = 16; // 2 ymm registers per row, 12 accumulators in total
+        };
+
+        template<>
+        struct gemm_micro_tile<double>
+        {
+            static constexpr size_t mr = 6;
+            static constexpr size_t nr = 8;
+        };
+#endif
+
+        ///
+        /// @brief Default cache blocking for type T, tuned for a typical 32K L1/1M L2 core.
+        ///
+        template< typename T >
+        constexpr gemm_blocking default_gemm_blocking() noexcept
+        {
+            if constexpr( sizeof(T) <= 4 )
+                return gemm_blocking{ 192, 384, 4096 };
+            else
+                return gemm_blocking{ 96, 256, 2048 };
+        }
+
+        ///
+        /// @brief A grow-only, memory_alignment aligned scratch buffer, one per thread, holding the packed panels.
+        ///
+        template< typename T >
+        struct gemm_pack_buffer
+        {
+            T* data_ = nullptr;
+            size_t size_ = 0;
+
+            T* reserve( size_t n )
+            {
+                if ( n > size_ )
+                {
+                    std::free( data_ );
+                    size_t const bytes = ( ( n * sizeof(T) + memory_alignment - 1 ) / memory_alignment ) * memory_alignment;
+                    data_ = static_cast<T*>( std::aligned_alloc( memory_alignment, bytes ) );
+                    better_assert( data_ != nullptr, "gemm_pack_buffer: failed to allocate ", bytes, " bytes." );
+                    size_ = n;
+                }
+                return data_;
+            }
+
+            ~gemm_pack_buffer()
+            {
+                std::free( data_ );
+            }
+        }; // struct gemm_pack_buffer
+
+        ///
+        /// Packing `mc x kc` elements of A, starting from (ic, pc), into MR-tall micro-panels.
+        /// In each micro-panel the MR elements of a column are contiguous. Tails are zero-padded.
+        ///
+        template< typename T >
+        void pack_a( T const* A, size_t lda, bool a_transposed, size_t ic, size_t pc, size_t mc, size_t kc, T* __restrict__ packed )
+        {
+            constexpr size_t MR = gemm_micro_tile<T>::mr;
+            for ( size_t ir = 0; ir < mc; ir += MR )
+            {
+                size_t const mr = std::min( MR, mc - ir );
+                T* __restrict__ dst = packed + ir * kc;
+                if ( a_transposed ) // A stored as [K x M]: MR consecutive elements per column, contiguous
+                {
+                    T const* src = A + pc * lda + ic + ir;
+                    if ( mr == MR )
+                        for ( size_t p = 0; p != kc; ++p )
+                            std::copy_n( src + p * lda, MR, dst + p * MR );
+                    else
+                        for ( size_t p = 0; p != kc; ++p )
+                        {
+                            std::copy_n( src + p * lda, mr, dst + p * MR );
+                            std::fill_n( dst + p * MR + mr, MR - mr, T{0} );
+                        }
+                }
+                else // A stored as [M x K]: rows are contiguous, scatter them into the column-interleaved panel
+                {
+                    T const* src = A + ( ic + ir ) * lda + pc;
+                    for ( size_t i = 0; i != mr; ++i )
+                        for ( size_t p = 0; p != kc; ++p )
+                            dst[p * MR + i] = src[i * lda + p];
+                    for ( size_t i = mr; i != MR; ++i )
+                        for ( size_t p = 0; p != kc; ++p )
+                            dst[p * MR + i] = T{0};
+                }
+            }
+        }
+
+        ///
+        /// Packing `kc x nc` elements of B, starting from (pc, jc), into NR-wide micro-panels.
+        /// In each micro-panel the NR elements of a row are contiguous. Tails are zero-padded.
+        ///
+        template< typename T >
+        void pack_b( T const* B, size_t ldb, bool b_transposed, size_t pc, size_t jc, size_t kc, size_t nc, T* __restrict__ packed )
+        {
+            constexpr size_t NR = gemm_micro_tile<T>::nr;
+            for ( size_t jr = 0; jr < nc; jr += NR )
+            {
+                size_t const nr = std::min( NR, nc - jr );
+                T* __restrict__ dst = packed + jr * kc;
+                if ( b_transposed ) // B stored as [N x K]: gather NR rows into the row-interleaved panel
+                {
+                    T const* src = B + ( jc + jr ) * ldb + pc;
+                    for ( size_t j = 0; j != nr; ++j )
+                        for ( size_t p = 0; p != kc; ++p )
+                            dst[p * NR + j] = src[j * ldb + p];
+                    for ( size_t j = nr; j != NR; ++j )
+                        for ( size_t p = 0; p != kc; ++p )
+                            dst[p * NR + j] = T{0};
+                }
+                else // B stored as [K x N]: NR consecutive elements per row, contiguous
+                {
+                    T const* src = B + pc * ldb + jc + jr;
+                    if ( nr == NR )
+                        for ( size_t p = 0; p != kc; ++p )
+                            std::copy_n( src + p * ldb, NR, dst + p * NR );
+                    else
+                        for ( size_t p = 0; p != kc; ++p )
+                        {
+                            std::copy_n( src + p * ldb, nr, dst + p * NR );
+                            std::fill_n( dst + p * NR + nr, NR - nr, T{0} );
+                        }
+                }
+            }
+        }
+
+        ///
+        /// Portable micro-kernel: C[MR x NR] (+)= packed_a[kc x MR]' * packed_b[kc x NR].
+        /// Fixed trip counts allow the compiler to keep the accumulators in vector registers.
+        ///
+        template< typename T >
+        void micro_kernel( size_t kc, T const* __restrict__ a, T const* __restrict__ b, T* __restrict__ c, size_t ldc, bool accumulate )
+        {
+            constexpr size_t MR = gemm_micro_tile<T>::mr;
+            constexpr size_t NR = gemm_micro_tile<T>::nr;
+            T acc[MR][NR] = {};
+            for ( size_t p = 0; p != kc; ++p )
+            {
+                for ( size_t i = 0; i != MR; ++i )
+                    for ( size_t j = 0; j != NR; ++j )
+                        acc[i][j] += a[i] * b[j];
+                a += MR;
+                b += NR;
+            }
+            for ( size_t i = 0; i != MR; ++i )
+                for ( size_t j = 0; j != NR; ++j )
+                    c[i*ldc+j] = accumulate ? c[i*ldc+j] + acc[i][j] : acc[i][j];
+        }
+
+#if defined(__AVX512F__)
+        template<>
+        inline void micro_kernel<float>( size_t kc, float const* __restrict__ a, float const* __restrict__ b, float* __restrict__ c, size_t ldc, bool accumulate )
+        {
+            __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+            __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+            __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+            __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+            __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+            __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+            __m512 c60 = _mm512_setzero_ps(), c61 = _mm512_setzero_ps();
+            __m512 c70 = _mm512_setzero_ps(), c71 = _mm512_setzero_ps();
+
+            for ( size_t p = 0; p != kc; ++p )
+            {
+                __m512 const b0 = _mm512_load_ps( b );
+                __m512 const b1 = _mm512_load_ps( b + 16 );
+                __m512 av;
+                av = _mm512_set1_ps( a[0] ); c00 = _mm512_fmadd_ps( av, b0, c00 ); c01 = _mm512_fmadd_ps( av, b1, c01 );
+                av = _mm512_set1_ps( a[1] ); c10 = _mm512_fmadd_ps( av, b0, c10 ); c11 = _mm512_fmadd_ps( av, b1, c11 );
+                av = _mm512_set1_ps( a[2] ); c20 = _mm512_fmadd_ps( av, b0, c20 ); c21 = _mm512_fmadd_ps( av, b1, c21 );
+                av = _mm512_set1_ps( a[3] ); c30 = _mm512_fmadd_ps( av, b0, c30 ); c31 = _mm512_fmadd_ps( av, b1, c31 );
+                av = _mm512_set1_ps( a[4] ); c40 = _mm512_fmadd_ps( av, b0, c40 ); c41 = _mm512_fmadd_ps( av, b1, c41 );
+                av = _mm512_set1_ps( a[5] ); c50 = _mm512_fmadd_ps( av, b0, c50 ); c51 = _mm512_fmadd_ps( av, b1, c51 );
+                av = _mm512_set1_ps( a[6] ); c60 = _mm512_fmadd_ps( av, b0, c60 ); c61 = _mm512_fmadd_ps( av, b1, c61 );
+                av = _mm512_set1_ps( a[7] ); c70 = _mm512_fmadd_ps( av, b0, c70 ); c71 = _mm512_fmadd_ps( av, b1, c71 );
+                a += 8;
+                b += 32;
+            }
+
+            auto const& store = [ldc, accumulate, c]( size_t row, __m512 lo, __m512 hi )
+            {
+                float* dst = c + row * ldc;
+                if ( accumulate )
+                {
+                    lo = _mm512_add_ps( lo, _mm512_loadu_ps( dst ) );
+                    hi = _mm512_add_ps( hi, _mm512_loadu_ps( dst + 16 ) );
+                }
+                _mm512_storeu_ps( dst, lo );
+                _mm512_storeu_ps( dst + 16, hi );
+            };
+            store( 0, c00, c01 ); store( 1, c10, c11 ); store( 2, c20, c21 ); store( 3, c30, c31 );
+            store( 4, c40, c41 ); store( 5, c50, c51 ); store( 6, c60, c61 ); store( 7, c70, c71 );
+        }
+#elif defined(__AVX2__) && defined(__FMA__)
+        template<>
+        inline void micro_kernel<float>( size_t kc, float const* __restrict__ a, float const* __restrict__ b, float* __restrict__ c, size_t ldc, bool accumulate )
+        {
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+            __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+            __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+            __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+            for ( size_t p = 0; p != kc; ++p )
+            {
+                __m256 const b0 = _mm256_load_ps( b );
+                __m256 const b1 = _mm256_load_ps( b + 8 );
+                __m256 av;
+                av = _mm256_broadcast_ss( a + 0 ); c00 = _mm256_fmadd_ps( av, b0, c00 ); c01 = _mm256_fmadd_ps( av, b1, c01 );
+                av = _mm256_broadcast_ss( a + 1 ); c10 = _mm256_fmadd_ps( av, b0, c10 ); c11 = _mm256_fmadd_ps( av, b1, c11 );
+                av = _mm256_broadcast_ss( a + 2 ); c20 = _mm256_fmadd_ps( av, b0, c20 ); c21 = _mm256_fmadd_ps( av, b1, c21 );
+                av = _mm256_broadcast_ss( a + 3 ); c30 = _mm256_fmadd_ps( av, b0, c30 ); c31 = _mm256_fmadd_ps( av, b1, c31 );
+                av = _mm256_broadcast_ss( a + 4 ); c40 = _mm256_fmadd_ps( av, b0, c40 ); c41 = _mm256_fmadd_ps( av, b1, c41 );
+                av = _mm256_broadcast_ss( a + 5 ); c50 = _mm256_fmadd_ps( av, b0, c50 ); c51 = _mm256_fmadd_ps( av, b1, c51 );
+                a += 6;
+                b += 16;
+            }
+
+            auto const& store = [ldc, accumulate, c]( size_t row, __m256 lo, __m256 hi )
+            {
+                float* dst = c + row * ldc;
+                if ( accumulate )
+                {
+                    lo = _mm256_add_ps( lo, _mm256_loadu_ps( dst ) );
+                    hi = _mm256_add_ps( hi, _mm256_loadu_ps( dst + 8 ) );
+                }
+                _mm256_storeu_ps( dst, lo );
+                _mm256_storeu_ps( dst + 8, hi );
+            };
+            store( 0, c00, c01 ); store( 1, c10, c11 ); store( 2, c20, c21 );
+            store( 3, c30, c31 ); store( 4, c40, c41 ); store( 5, c50, c51 );
+        }
+#endif
+
+        ///
+        /// Run the micro-kernel on a possibly partial `mr x nr` tile of C.
+        /// Partial tiles are computed into a local buffer and copied back.
+        ///
+        template< typename T >
+        void macro_tile( size_t kc, T const* a, T const* b, T* c, size_t ldc, size_t mr, size_t nr, bool accumulate )
+        {
+            constexpr size_t MR = gemm_micro_tile<T>::mr;
+            constexpr size_t NR = gemm_micro_tile<T>::nr;
+            if ( mr == MR && nr == NR )
+            {
+                micro_kernel<T>( kc, a, b, c, ldc, accumulate );
+                return;
+            }
+
+            alignas( memory_alignment ) T tile[MR*NR];
+            micro_kernel<T>( kc, a, b, tile, NR, false );
+            for ( size_t i = 0; i != mr; ++i )
+                for ( size_t j = 0; j != nr; ++j )
+                    c[i*ldc+j] = accumulate ? c[i*ldc+j] + tile[i*NR+j] : tile[i*NR+j];
+        }
+
+    }//namespace ceras_private
+
+    ///
+    /// @brief The epilogue of a gemm that leaves C as it is.
+    ///
+    /// An epilogue is called as `epilogue( c, ldc, row, col, rows, cols )` on every `rows x cols` block of C, once the block holds its final value,
+    /// where `c` points to `C[row][col]`. The blocked engine calls it on each register tile right after the last update, while the tile is still in L1.
+    ///
+    struct gemm_no_epilogue
+    {
+        template< typename T >
+        constexpr void operator()( T*, size_t, size_t, size_t, size_t, size_t ) const noexcept {}
+    };
+
+    ///
+    /// @brief Blocked gemm on strided matrices: C[M x N] <= op(A)[M x K] * op(B)[K x N].
+    ///
+    /// @param A Pointer to A. If `a_transposed`, A is stored as [K x M], otherwise [M x K].
+    /// @param lda Leading dimension (row stride) of the storage of A.
+    /// @param B Pointer to B. If `b_transposed`, B is stored as [N x K], otherwise [K x N].
+    /// @param ldb Leading dimension (row stride) of the storage of B.
+    /// @param C Pointer to C, stored as [M x N] with row stride `ldc`.
+    /// @param blocking The cache blocking parameters.
+    /// @param epilogue Applied to C tile by tile, see `gemm_no_epilogue`.
+    ///
+    template< typename T, typename Epilogue = gemm_no_epilogue > requires std::floating_point<T>
+    void blocked_gemm( T const* A, size_t lda, bool a_transposed, T const* B, size_t ldb, bool b_transposed,
+                       size_t M, size_t K, size_t N, T* C, size_t ldc,
+                       gemm_blocking const& blocking = ceras_private::default_gemm_blocking<T>(),
+                       Epilogue const& epilogue = Epilogue{} )
+    {
+        using namespace ceras_private;
+        constexpr size_t MR = gemm_micro_tile<T>::mr;
+        constexpr size_t NR = gemm_micro_tile<T>::nr;
+
+        if ( M == 0 || N == 0 )
+            return;
+
+        if ( K == 0 )
+        {
+            for ( size_t i = 0; i != M; ++i )
+                std::fill_n( C + i * ldc, N, T{0} );
+            epilogue( C, ldc, 0, 0, M, N );
+            return;
+        }
+
+        // round the blocking to multiples of the register tile
+        size_t const MC = std::max( MR, blocking.mc / MR * MR );
+        size_t const KC = std::max( size_t{1}, blocking.kc );
+        size_t const NC = std::max( NR, blocking.nc / NR * NR );
+
+        thread_local gemm_pack_buffer<T> buffer_a;
+        thread_local gemm_pack_buffer<T> buffer_b;
+        T* packed_a = buffer_a.reserve( ( std::min( MC, M ) + MR ) * KC );
+        T* packed_b = buffer_b.reserve( ( std::min( NC, N ) + NR ) * KC );
+
+        for ( size_t jc = 0; jc < N; jc += NC )
+        {
+            size_t const nc = std::min( NC, N - jc );
+            for ( size_t pc = 0; pc < K; pc += KC )
+            {
+                size_t const kc = std::min( KC, K - pc );
+                bool const accumulate = ( pc != 0 );
+                bool const last_panel = ( pc + kc == K );
+                pack_b( B, ldb, b_transposed, pc, jc, kc, nc, packed_b );
+
+                for ( size_t ic = 0; ic < M; ic += MC )
+                {
+                    size_t const mc = std::min( MC, M - ic );
+                    pack_a( A, lda, a_transposed, ic, pc, mc, kc, packed_a );
+
+                    for ( size_t jr = 0; jr < nc; jr += NR )
+                    {
+                        size_t const nr = std::min( NR, nc - jr );
+                        for ( size_t ir = 0; ir < mc; ir += MR )
+                        {
+                            size_t const mr = std::min( MR, mc - ir );
+                            T* c = C + ( ic + ir ) * ldc + jc + jr;
+                            macro_tile( kc, packed_a + ir * kc, packed_b + jr * kc, c, ldc, mr, nr, accumulate );
+                            if ( last_panel )
+                                epilogue( c, ldc, ic + ir, jc + jr, mr, nr );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    ///
+    /// @brief Products below this number of multiply-adds per thread are not worth a thread.
+    ///
+    inline constexpr size_t gemm_parallel_work_per_thread = 1UL << 18;
+
+    ///
+    /// @brief Multi-threaded blocked gemm, same arguments as blocked_gemm.
+    ///
+    /// The output C[M x N] is split into a `tm x tn` grid of tiles aligned to the register tile, each tile
+    /// is an independent blocked_gemm on sub-matrices of A and B. Shapes too small to amortize the threading
+    /// overhead (see `gemm_parallel_work_per_thread`) stay on the calling thread.
+    ///
+    /// @param threads The maximum number of threads to use. Defaults to the size of the process-wide thread pool.
+    /// @param epilogue Applied to C tile by tile, see `gemm_no_epilogue`.
+    ///
+    template< typename T, typename Epilogue = gemm_no_epilogue > requires std::floating_point<T>
+    void parallel_gemm( T const* A, size_t lda, bool a_transposed, T const* B, size_t ldb, bool b_transposed,
+                        size_t M, size_t K, size_t N, T* C, size_t ldc,
+                        gemm_blocking const& blocking = ceras_private::default_gemm_blocking<T>(),
+                        size_t threads = thread_pool::instance().size(),
+                        Epilogue const& epilogue = Epilogue{} )
+    {
+        using namespace ceras_private;
+        constexpr size_t MR = gemm_micro_tile<T>::mr;
+        constexpr size_t NR = gemm_micro_tile<T>::nr;
+
+        size_t const row_tiles = ( M + MR - 1 ) / MR;
+        size_t const col_tiles = ( N + NR - 1 ) / NR;
+        size_t const work = M * K * N;
+        size_t const tasks = std::min( { std::max( size_t{1}, threads ), std::max( size_t{1}, work / gemm_parallel_work_per_thread ), row_tiles * col_tiles } );
+
+        if ( parallel_mode == 0 || tasks <= 1 )
+        {
+            blocked_gemm( A, lda, a_transposed, B, ldb, b_transposed, M, K, N, C, ldc, blocking, epilogue );
+            return;
+        }
+
+        // choosing the grid with the smallest tile perimeter, which minimizes the redundant packing of A and B
+        size_t tm = 1;
+        size_t tn = tasks;
+        {
+            double best = std::numeric_limits<double>::max();
+            for ( size_t r = 1; r <= tasks; ++r )
+            {
+                size_t const c = tasks / r;
+                if ( r > row_tiles || c > col_tiles || c == 0 ) continue;
+                double const cost = static_cast<double>(M) / r + static_cast<double>(N) / c;
+                if ( r * c == tasks && cost < best )
+                {
+                    best = cost;
+                    tm = r;
+                    tn = c;
+                }
+            }
+            if ( best == std::numeric_limits<double>::max() ) // no exact factorization fits, falling back to a 1D split along the longer side
+            {
+                tm = ( M >= N ) ? std::min( tasks, row_tiles ) : 1;
+                tn = ( M >= N ) ? 1 : std::min( tasks, col_tiles );
+            }
+        }
+
+        // tile boundaries, in units of the register tile
+        size_t const rows_per_tile = ( row_tiles + tm - 1 ) / tm * MR;
+        size_t const cols_per_tile = ( col_tiles + tn - 1 ) / tn * NR;
+
+        auto const& tile_job = [=]( size_t index )
+        {
+            size_t const i0 = ( index / tn ) * rows_per_tile;
+            size_t const j0 = ( index % tn ) * cols_per_tile;
+            if ( i0 >= M || j0 >= N ) return;
+            size_t const mt = std::min( rows_per_tile, M - i0 );
+            size_t const nt = std::min( cols_per_tile, N - j0 );
+
+            T const* a = a_transposed ? A + i0 : A + i0 * lda;
+            T const* b = b_transposed ? B + j0 * ldb : B + j0;
+            auto const& tile_epilogue = [&epilogue, i0, j0]( T* c, size_t ldc_, size_t row, size_t col, size_t rows, size_t cols )
+            {
+                epilogue( c, ldc_, i0 + row, j0 + col, rows, cols );
+            };
+            blocked_gemm( a, lda, a_transposed, b, ldb, b_transposed, mt, K, nt, C + i0 * ldc + j0, ldc, blocking, tile_epilogue );
+        };
+
+        parallel( tile_job, size_t{0}, tm * tn, 1 );
+    }
+
+    ///
+    /// @brief Reference gemm, the plain triple loop. C <= A * B, where A or A' is [m x n], B or B' is [n x k] and C is [m x k].
+    ///
+    template< typename T > requires std::floating_point<T>
+    void naive_gemm( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C )
+    {
+        std::fill_n( C, m*k, T{0} );
+        for ( size_t r = 0; r != m; ++r )
+            for ( size_t idx = 0; idx != n; ++idx )
+            {
+                T const a = a_transposed ? A[idx*m+r] : A[r*n+idx];
+                T* __restrict__ c_row = C + r * k;
+                if ( b_transposed )
+                    for ( size_t c = 0; c != k; ++c )
+                        c_row[c] += a * B[c*n+idx];
+                else
+                    for ( size_t c = 0; c != k; ++c )
+                        c_row[c] += a * B[idx*k+c];
+            }
+    }
+
+}//namespace ceras
+
+#endif//GEMM_HPP_INCLUDED_QOWIEUTYRLKSJDFHGMZNXBCVPOIUYTREWQASDFGHJKLMNBVCXZLKJHG
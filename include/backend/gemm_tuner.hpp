@@ -0,0 +1,561 @@
+#ifndef GEMM_TUNER_HPP_INCLUDED_MZNXBCVLAKSJDHFGPQOWIEURYTZMXNCBVLAKSJDHFGQPWOEIRUTY
+#define GEMM_TUNER_HPP_INCLUDED_MZNXBCVLAKSJDHFGPQOWIEURYTZMXNCBVLAKSJDHFGQPWOEIRUTY
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "../utils/fmt.hpp"
+#include "../utils/range.hpp"
+#include "../utils/thread_pool.hpp"
+#include "./cblas.hpp"
+#include "./fast_gemm_strassen.hpp"
+#include "./gemm.hpp"
+
+//
+// An autotuner picking the CPU gemm kernel and its cache blocking per shape bucket.
+//
+// Every dimension of a product C[m x k] = op(A)[m x n] * op(B)[n x k] falls into one of six buckets
+// (<= 8, <= 32, <= 128, <= 512, <= 2048, larger), and a bucket, together with the two transposition flags and
+// the value type, selects a plan: the kernel (naive, blocked, threaded, strassen or cblas), the blocking of the
+// blocked kernels and the recursion cutoff of the fast one. A plan is found by timing the candidates once, either through
+// an explicit `tune_gemm()` or, if `gemm_autotuning` is set in '../config.hpp', at the first product falling into its
+// bucket, and it is then kept in memory, so that a dispatch is a table look-up. A bucket without a plan uses the default
+// dispatch of `gemm`.
+//
+// The plans are also kept in a small text file, only if a path is given in `gemm_tuning_cache()`. The file of
+// `machine_gemm_tuning_cache()` is named after the machine -- instruction set, number of threads and cpu model -- so
+// that machines sharing a home directory keep their own plans.
+//
+
+namespace ceras
+{
+
+    ///
+    /// @brief The kernels the gemm autotuner chooses from.
+    ///
+    enum class gemm_kernel : std::uint8_t
+    {
+        naive = 1,  ///< the plain triple loop, `naive_gemm`
+        blocked,    ///< the cache-blocked engine on the calling thread, `blocked_gemm`
+        threaded,   ///< the cache-blocked engine on the thread pool, `parallel_gemm`
+        cblas,      ///< the linked BLAS library, only with `-DCBLAS`
+        strassen    ///< Strassen's algorithm over the threaded engine, `fast_gemm<strassen_fast_gemm>`, only with `gemm_fast_algorithms`
+    };
+
+    ///
+    /// @brief The kernel and the blocking chosen for a shape bucket.
+    ///
+    struct gemm_plan
+    {
+        gemm_kernel kernel;
+        gemm_blocking blocking;
+        size_t cutoff = 0; ///< the smallest block the fast kernels recurse into
+    }; // struct gemm_plan
+
+    namespace ceras_private
+    {
+
+        inline std::string gemm_kernel_name( gemm_kernel kernel )
+        {
+            switch ( kernel )
+            {
+                case gemm_kernel::naive : return "naive";
+                case gemm_kernel::blocked : return "blocked";
+                case gemm_kernel::threaded : return "threaded";
+                case gemm_kernel::cblas : return "cblas";
+                case gemm_kernel::strassen : return "strassen";
+            }
+            return "unknown";
+        }
+
+        inline std::optional<gemm_kernel> make_gemm_kernel( std::string const& name )
+        {
+            for ( auto kernel : { gemm_kernel::naive, gemm_kernel::blocked, gemm_kernel::threaded, gemm_kernel::cblas, gemm_kernel::strassen } )
+                if ( gemm_kernel_name( kernel ) == name )
+                    return kernel;
+            return {};
+        }
+
+        inline constexpr size_t gemm_tuning_buckets = 6;
+
+        // the dimension a bucket is tuned with when no product shape is given, also the largest dimension tuned at the first use
+        inline constexpr std::array<size_t, gemm_tuning_buckets> gemm_tuning_dims{ 8, 24, 96, 384, 1024, 2048 };
+
+        constexpr size_t gemm_tuning_bucket( size_t dim ) noexcept
+        {
+            return ( dim <= 8 ) ? 0 : ( dim <= 32 ) ? 1 : ( dim <= 128 ) ? 2 : ( dim <= 512 ) ? 3 : ( dim <= 2048 ) ? 4 : 5;
+        }
+
+        constexpr size_t gemm_tuning_index( size_t type, size_t m_bucket, size_t n_bucket, size_t k_bucket, bool a_transposed, bool b_transposed ) noexcept
+        {
+            return ( ( ( ( type * gemm_tuning_buckets + m_bucket ) * gemm_tuning_buckets + n_bucket ) * gemm_tuning_buckets + k_bucket ) * 2 + a_transposed ) * 2 + b_transposed;
+        }
+
+        template< typename T >
+        constexpr size_t gemm_tuning_index( size_t m, size_t n, size_t k, bool a_transposed, bool b_transposed ) noexcept
+        {
+            return gemm_tuning_index( std::is_same_v<T, double> ? 1 : 0, gemm_tuning_bucket( m ), gemm_tuning_bucket( n ), gemm_tuning_bucket( k ), a_transposed, b_transposed );
+        }
+
+        // if a plan fits in the fields of `encode_gemm_plan`, with a block of every dimension
+        constexpr bool encodable_gemm_plan( gemm_plan const& plan ) noexcept
+        {
+            return static_cast<std::uint64_t>( plan.kernel ) <= static_cast<std::uint64_t>( gemm_kernel::strassen ) &&
+                   plan.blocking.mc > 0 && plan.blocking.mc <= 0xfff && plan.blocking.kc > 0 && plan.blocking.kc <= 0xfff &&
+                   plan.blocking.nc > 0 && plan.blocking.nc <= 0xfffff && plan.cutoff <= 0xffff;
+        }
+
+        // a plan in a single word -- 4 bits of kernel, 12 of mc, 12 of kc, 20 of nc and 16 of cutoff -- 0 for a bucket not tuned yet,
+        // and for a plan out of these ranges, see `encodable_gemm_plan`
+        constexpr std::uint64_t encode_gemm_plan( gemm_plan const& plan ) noexcept
+        {
+            if ( !encodable_gemm_plan( plan ) )
+                return 0;
+            return static_cast<std::uint64_t>( plan.kernel ) | ( static_cast<std::uint64_t>( plan.blocking.mc & 0xfff ) << 4 ) |
+                   ( static_cast<std::uint64_t>( plan.blocking.kc & 0xfff ) << 16 ) | ( static_cast<std::uint64_t>( plan.blocking.nc & 0xfffff ) << 28 ) |
+                   ( static_cast<std::uint64_t>( plan.cutoff & 0xffff ) << 48 );
+        }
+
+        constexpr gemm_plan decode_gemm_plan( std::uint64_t code ) noexcept
+        {
+            return gemm_plan{ static_cast<gemm_kernel>( code & 0xf ), gemm_blocking{ ( code >> 4 ) & 0xfff, ( code >> 16 ) & 0xfff, ( code >> 28 ) & 0xfffff }, ( code >> 48 ) & 0xffff };
+        }
+
+        inline std::string gemm_tuning_signature()
+        {
+#if defined(__AVX512F__)
+            std::string isa = "avx512";
+#elif defined(__AVX2__) && defined(__FMA__)
+            std::string isa = "avx2";
+#else
+            std::string isa = "generic";
+#endif
+            std::string cpu_model;
+            {
+                std::ifstream cpuinfo{ "/proc/cpuinfo" };
+                std::string line;
+                while ( std::getline( cpuinfo, line ) )
+                    if ( line.starts_with( "model name" ) )
+                    {
+                        cpu_model = line;
+                        break;
+                    }
+            }
+            return fmt::format( "{}-{}t-{}-{}", isa, thread_pool::instance().size(), cblas_mode ? std::string{"cblas"} : std::string{"noblas"}, std::hash<std::string>{}( cpu_model ) % 1000000007UL );
+        }
+
+        inline std::string default_gemm_tuning_cache()
+        {
+            if ( char const* path = std::getenv( "CERAS_GEMM_TUNING_CACHE" ) )
+                return std::string{ path };
+            return std::string{};
+        }
+
+    }//namespace ceras_private
+
+    ///
+    /// @brief A file under `~/.ceras/` named after this machine, for the plans to be kept across the runs.
+    ///
+    /// @return The path, or an empty string if the home directory is not known.
+    ///
+    inline std::string machine_gemm_tuning_cache()
+    {
+        if ( char const* home = std::getenv( is_windows_platform ? "USERPROFILE" : "HOME" ) )
+            return ( std::filesystem::path{ home } / ".ceras" / ( "gemm_tuning-" + ceras_private::gemm_tuning_signature() + ".txt" ) ).string();
+        return std::string{};
+    }
+
+    ///
+    /// @brief The file keeping the tuned gemm plans.
+    ///
+    /// Defaults to `$CERAS_GEMM_TUNING_CACHE` if set, otherwise to an empty path, which keeps the plans in memory only:
+    /// nothing is written to the disk unless a path is given.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// ceras::gemm_tuning_cache() = "./gemm_tuning.txt";
+    /// ceras::gemm_tuning_cache() = ceras::machine_gemm_tuning_cache(); // or ~/.ceras/gemm_tuning-<this machine>.txt
+    /// ceras::load_gemm_tuning();
+    /// @endcode
+    ///
+    inline std::string& gemm_tuning_cache()
+    {
+        static std::string path = ceras_private::default_gemm_tuning_cache();
+        return path;
+    }
+
+    namespace ceras_private
+    {
+
+        ///
+        /// @brief The tuned plans of all the buckets, shared by the whole process.
+        ///
+        struct gemm_tuning_table
+        {
+            static constexpr size_t size = 2 * gemm_tuning_buckets * gemm_tuning_buckets * gemm_tuning_buckets * 4; // float/double x m x n x k x transpositions
+
+            std::array<std::atomic<std::uint64_t>, size> plans_{};
+            std::atomic<bool> tuning_{ false }; // a flag rather than a mutex: a thread waiting for the threaded candidate may run another gemm task itself
+            std::mutex file_mutex_;
+
+            gemm_tuning_table()
+            {
+                load( gemm_tuning_cache() );
+            }
+
+            static gemm_tuning_table& instance()
+            {
+                static gemm_tuning_table table;
+                return table;
+            }
+
+            std::optional<gemm_plan> find( size_t index ) const noexcept
+            {
+                std::uint64_t const code = plans_[index].load( std::memory_order_acquire );
+                if ( code == 0 )
+                    return {};
+                return decode_gemm_plan( code );
+            }
+
+            // false for a plan out of the ranges of `encode_gemm_plan`, not stored
+            bool store( size_t index, gemm_plan const& plan ) noexcept
+            {
+                std::uint64_t const code = encode_gemm_plan( plan );
+                if ( code == 0 )
+                    return false;
+                plans_[index].store( code, std::memory_order_release );
+                return true;
+            }
+
+            void clear() noexcept
+            {
+                for ( auto& plan : plans_ )
+                    plan.store( 0, std::memory_order_release );
+            }
+
+            // format: one plan per line, 'type m_bucket n_bucket k_bucket a_transposed b_transposed kernel mc kc nc cutoff'
+            bool load( std::string const& path )
+            {
+                if ( path.empty() )
+                    return false;
+
+                std::scoped_lock lock{ file_mutex_ };
+                std::ifstream ifs{ path };
+                if ( !ifs )
+                    return false;
+
+                std::string line;
+                while ( std::getline( ifs, line ) )
+                {
+                    if ( line.empty() || line[0] == '#' )
+                        continue;
+
+                    std::istringstream iss{ line };
+                    std::string type, kernel;
+                    size_t m_bucket, n_bucket, k_bucket, mc, kc, nc;
+                    bool a_transposed, b_transposed;
+                    if ( !( iss >> type >> m_bucket >> n_bucket >> k_bucket >> a_transposed >> b_transposed >> kernel >> mc >> kc >> nc ) )
+                        continue;
+                    size_t cutoff = 0;
+                    iss >> cutoff;
+                    auto const the_kernel = make_gemm_kernel( kernel );
+                    if ( !the_kernel || ( type != "float" && type != "double" ) || std::max( { m_bucket, n_bucket, k_bucket } ) >= gemm_tuning_buckets )
+                        continue;
+                    if ( *the_kernel == gemm_kernel::cblas && !cblas_mode )
+                        continue;
+                    // a plan out of range is skipped, as a line not parsed, rather than decoded to another blocking
+                    store( gemm_tuning_index( type == "double" ? 1 : 0, m_bucket, n_bucket, k_bucket, a_transposed, b_transposed ), gemm_plan{ *the_kernel, gemm_blocking{ mc, kc, nc }, cutoff } );
+                }
+                return true;
+            }
+
+            // written to a temporary file first, so that a concurrent process never reads half a cache
+            bool save( std::string const& path )
+            {
+                if ( path.empty() )
+                    return false;
+
+                std::scoped_lock lock{ file_mutex_ };
+                std::filesystem::path const file{ path };
+                std::error_code error;
+                if ( file.has_parent_path() )
+                    std::filesystem::create_directories( file.parent_path(), error );
+
+                std::filesystem::path const tmp{ path + ".tmp" };
+                {
+                    std::ofstream ofs{ tmp };
+                    if ( !ofs )
+                        return false;
+                    ofs << "# ceras gemm tuning cache: type m_bucket n_bucket k_bucket a_transposed b_transposed kernel mc kc nc cutoff\n";
+                    for ( auto type : range( 2UL ) )
+                        for ( auto m_bucket : range( gemm_tuning_buckets ) )
+                            for ( auto n_bucket : range( gemm_tuning_buckets ) )
+                                for ( auto k_bucket : range( gemm_tuning_buckets ) )
+                                    for ( bool a_transposed : { false, true } )
+                                        for ( bool b_transposed : { false, true } )
+                                            if ( auto const plan = find( gemm_tuning_index( type, m_bucket, n_bucket, k_bucket, a_transposed, b_transposed ) ); plan )
+                                                ofs << ( type ? "double" : "float" ) << " " << m_bucket << " " << n_bucket << " " << k_bucket << " "
+                                                    << a_transposed << " " << b_transposed << " " << gemm_kernel_name( plan->kernel ) << " "
+                                                    << plan->blocking.mc << " " << plan->blocking.kc << " " << plan->blocking.nc << " " << plan->cutoff << "\n";
+                    if ( !ofs )
+                        return false;
+                }
+                std::filesystem::rename( tmp, file, error );
+                return !error;
+            }
+        }; // struct gemm_tuning_table
+
+        // the best of a few runs, each run repeating `func` long enough to rise above the clock resolution
+        template< typename Function >
+        double gemm_tuning_seconds( Function const& func )
+        {
+            auto const& seconds = [&func]( size_t repeats )
+            {
+                auto const start = std::chrono::steady_clock::now();
+                for ( [[maybe_unused]] auto _ : range( repeats ) )
+                    func();
+                return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() / repeats;
+            };
+
+            double const first = seconds( 1 ); // also warms up the pack buffers and the workers
+            if ( first > 2.0e-2 ) // a large product: the warm-up is part of the measure
+                return std::min( first, seconds( 1 ) );
+            size_t const repeats = std::max( 1.0, std::min( 1000.0, 1.0e-4 / std::max( first, 1.0e-9 ) ) );
+            double best = seconds( repeats );
+            double total = best * repeats;
+            for ( size_t run = 1; run != 5 && ( run < 2 || total < 2.0e-2 ); ++run )
+            {
+                double const current = seconds( repeats );
+                best = std::min( best, current );
+                total += current * repeats;
+            }
+            return best;
+        }
+
+        // the blockings worth timing, after clamping them to the shape the way blocked_gemm does
+        template< typename T >
+        std::vector<gemm_blocking> gemm_tuning_blockings( size_t m, size_t n, size_t k )
+        {
+            constexpr size_t MR = gemm_micro_tile<T>::mr;
+            constexpr size_t NR = gemm_micro_tile<T>::nr;
+            gemm_blocking const base = default_gemm_blocking<T>();
+
+            std::vector<gemm_blocking> ans;
+            for ( size_t mc : { base.mc, base.mc / 2, base.mc * 3 / 2 } )
+                for ( size_t kc : { base.kc, base.kc * 2 / 3, base.kc * 4 / 3 } )
+                {
+                    gemm_blocking const blocking{ mc, kc, base.nc };
+                    auto const& effective = [=]( gemm_blocking const& b )
+                    {
+                        return std::make_tuple( std::min( std::max( MR, b.mc / MR * MR ), ( m + MR - 1 ) / MR * MR ),
+                                                std::min( b.kc, n ),
+                                                std::min( std::max( NR, b.nc / NR * NR ), ( k + NR - 1 ) / NR * NR ) );
+                    };
+                    if ( std::none_of( ans.begin(), ans.end(), [&]( gemm_blocking const& b ){ return effective( b ) == effective( blocking ); } ) )
+                        ans.push_back( blocking );
+                }
+            return ans;
+        }
+
+    }//namespace ceras_private
+
+    ///
+    /// @brief Runs a gemm with a given plan. C <= A * B, where A or A' is [m x n], B or B' is [n x k] and C is [m x k].
+    ///
+    /// @param epilogue Applied to C tile by tile by the blocked kernels, and over the whole of C after the others, see `gemm_no_epilogue`.
+    ///
+    template< typename T, typename Epilogue = gemm_no_epilogue > requires std::floating_point<T>
+    void run_gemm_plan( gemm_plan const& plan, T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C, Epilogue const& epilogue = Epilogue{} )
+    {
+        size_t const lda = a_transposed ? m : n;
+        size_t const ldb = b_transposed ? n : k;
+        switch ( plan.kernel )
+        {
+            case gemm_kernel::blocked :
+                blocked_gemm( A, lda, a_transposed, B, ldb, b_transposed, m, n, k, C, k, plan.blocking, epilogue );
+                return;
+            case gemm_kernel::strassen :
+                if ( gemm_fast_algorithms )
+                {
+                    fast_gemm<strassen_fast_gemm>( A, lda, a_transposed, B, ldb, b_transposed, m, n, k, C, k, plan.cutoff, plan.blocking );
+                    break;
+                }
+                [[fallthrough]];
+            case gemm_kernel::threaded :
+                parallel_gemm( A, lda, a_transposed, B, ldb, b_transposed, m, n, k, C, k, plan.blocking, thread_pool::instance().size(), epilogue );
+                return;
+            case gemm_kernel::cblas :
+                if constexpr( cblas_mode )
+                {
+                    cblas_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
+                    break;
+                }
+                [[fallthrough]];
+            default :
+                naive_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
+        }
+        epilogue( C, k, 0, 0, m, k );
+    }
+
+    namespace ceras_private
+    {
+        // times the candidate plans on a product of shape (m, n, k), and keeps the fastest as the plan of the bucket `index`
+        template< typename T > requires std::floating_point<T>
+        gemm_plan tune_gemm_bucket( size_t index, size_t m, size_t n, size_t k, bool a_transposed, bool b_transposed )
+        {
+            std::vector<T> A( std::max( m * n, size_t{1} ) );
+            std::vector<T> B( std::max( n * k, size_t{1} ) );
+            std::vector<T> C( std::max( m * k, size_t{1} ) );
+            for ( auto idx : range( A.size() ) ) A[idx] = static_cast<T>( idx % 17 ) / T{17};
+            for ( auto idx : range( B.size() ) ) B[idx] = static_cast<T>( idx % 13 ) / T{13};
+
+            gemm_plan best{ gemm_kernel::blocked, default_gemm_blocking<T>() };
+            double best_seconds = std::numeric_limits<double>::max();
+            auto const& time_plan = [&]( gemm_plan const& plan )
+            {
+                if ( !encodable_gemm_plan( plan ) ) // not to be kept in the table
+                    return;
+                double const seconds = gemm_tuning_seconds( [&](){ run_gemm_plan( plan, A.data(), a_transposed, B.data(), b_transposed, m, n, k, C.data() ); } );
+                if ( seconds < best_seconds )
+                {
+                    best_seconds = seconds;
+                    best = plan;
+                }
+            };
+
+            // the kernels first, with the default blocking
+            if ( m * n * k <= ( 1UL << 22 ) )
+                time_plan( gemm_plan{ gemm_kernel::naive, default_gemm_blocking<T>() } );
+            if constexpr( cblas_mode )
+                time_plan( gemm_plan{ gemm_kernel::cblas, default_gemm_blocking<T>() } );
+            time_plan( gemm_plan{ gemm_kernel::blocked, default_gemm_blocking<T>() } );
+            bool const threaded = parallel_mode && ( thread_pool::instance().size() > 1 ) && ( m * n * k >= 2 * gemm_parallel_work_per_thread );
+            if ( threaded )
+                time_plan( gemm_plan{ gemm_kernel::threaded, default_gemm_blocking<T>() } );
+
+            // then the blockings of the winning blocked kernel
+            if ( best.kernel == gemm_kernel::blocked || best.kernel == gemm_kernel::threaded )
+            {
+                gemm_kernel const kernel = best.kernel;
+                for ( auto const& blocking : gemm_tuning_blockings<T>( m, n, k ) | std::views::drop( 1 ) )
+                    time_plan( gemm_plan{ kernel, blocking } );
+            }
+
+            // and the fast algorithm over the best blocking, on the products large enough for a level of recursion, only if asked for
+            // as it is less accurate than the classical kernels, see `fast_gemm_error_bound` in './fast_gemm.hpp'
+            if ( gemm_fast_algorithms && ( best.kernel == gemm_kernel::blocked || best.kernel == gemm_kernel::threaded ) )
+            {
+                gemm_blocking const blocking = best.blocking;
+                for ( size_t cutoff : { 256UL, 512UL, 1024UL } )
+                    if ( fast_gemm_levels<strassen_fast_gemm>( m, n, k, cutoff ) > 0 )
+                        time_plan( gemm_plan{ gemm_kernel::strassen, blocking, cutoff } );
+            }
+
+            auto& table = gemm_tuning_table::instance();
+            table.store( index, best );
+            table.save( gemm_tuning_cache() );
+            return best;
+        }
+    }//namespace ceras_private
+
+    ///
+    /// @brief Times the candidate kernels and blockings on a product of the given shape, and keeps the fastest as the plan of its bucket.
+    ///
+    /// The plan is used by every later `gemm` of the same bucket, and saved to `gemm_tuning_cache()` if a path is set.
+    ///
+    /// @return The fastest plan.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// // tuning for the products of a Dense layer of 784 inputs and 512 outputs, batch size 128
+    /// ceras::tune_gemm<float>( 128, 784, 512 );             // forward
+    /// ceras::tune_gemm<float>( 128, 512, 784, false, true ); // gradient of the input
+    /// ceras::tune_gemm<float>( 784, 128, 512, true, false ); // gradient of the weights
+    /// @endcode
+    ///
+    template< typename T = float > requires std::floating_point<T>
+    gemm_plan tune_gemm( size_t m, size_t n, size_t k, bool a_transposed = false, bool b_transposed = false )
+    {
+        return ceras_private::tune_gemm_bucket<T>( ceras_private::gemm_tuning_index<T>( m, n, k, a_transposed, b_transposed ), m, n, k, a_transposed, b_transposed );
+    }
+
+    ///
+    /// @brief Tunes every shape bucket and transposition of type T, see `tune_gemm( m, n, k, a_transposed, b_transposed )`.
+    ///
+    /// Every dimension is tuned with a representative size of its bucket. This takes a few minutes, after which no gemm tunes at its first use.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// ceras::gemm_tuning_cache() = ceras::machine_gemm_tuning_cache();
+    /// ceras::tune_gemm(); // once per machine, the plans are cached on the disk
+    /// @endcode
+    ///
+    template< typename T = float > requires std::floating_point<T>
+    void tune_gemm()
+    {
+        using namespace ceras_private;
+        for ( auto m : gemm_tuning_dims )
+            for ( auto n : gemm_tuning_dims )
+                for ( auto k : gemm_tuning_dims )
+                    for ( bool a_transposed : { false, true } )
+                        for ( bool b_transposed : { false, true } )
+                            tune_gemm<T>( m, n, k, a_transposed, b_transposed );
+    }
+
+    ///
+    /// @brief The plan for a product of the given shape, tuned now if its bucket has no plan yet and `gemm_autotuning` is set.
+    ///
+    /// A first product is tuned with its dimensions capped to 2048, which bounds the cost of tuning a large product to a few seconds.
+    ///
+    /// @return The plan, or nothing if the bucket has no plan and is not tuned, for example while another thread is tuning.
+    ///
+    template< typename T > requires std::floating_point<T>
+    std::optional<gemm_plan> find_gemm_plan( size_t m, size_t n, size_t k, bool a_transposed, bool b_transposed )
+    {
+        using namespace ceras_private;
+        auto& table = gemm_tuning_table::instance();
+        size_t const index = gemm_tuning_index<T>( m, n, k, a_transposed, b_transposed );
+        if ( auto const plan = table.find( index ); plan || !gemm_autotuning )
+            return plan;
+
+        if ( table.tuning_.exchange( true, std::memory_order_acquire ) )
+            return {};
+        std::optional<gemm_plan> ans = table.find( index ); // tuned by another thread in the meantime
+        if ( !ans )
+        {
+            size_t const cap = gemm_tuning_dims.back();
+            ans = tune_gemm_bucket<T>( index, std::min( m, cap ), std::min( n, cap ), std::min( k, cap ), a_transposed, b_transposed ); // kept in the bucket of the uncapped shape
+        }
+        table.tuning_.store( false, std::memory_order_release );
+        return ans;
+    }
+
+    ///
+    /// @brief Forgets all the tuned plans, in memory only; the cache file is left as it is.
+    ///
+    inline void reset_gemm_tuning()
+    {
+        ceras_private::gemm_tuning_table::instance().clear();
+    }
+
+    ///
+    /// @brief Reads the plans saved in a cache file, replacing the plans of the same buckets.
+    ///
+    inline bool load_gemm_tuning( std::string const& path = gemm_tuning_cache() )
+    {
+        return ceras_private::gemm_tuning_table::instance().load( path );
+    }
+
+    ///
+    /// @brief Writes all the plans to a cache file.
+    ///
+    inline bool save_gemm_tuning( std::string const& path = gemm_tuning_cache() )
+    {
+        return ceras_private::gemm_tuning_table::instance().save( path );
+    }
+
+}//namespace ceras
+
+#endif//GEMM_TUNER_HPP_INCLUDED_MZNXBCVLAKSJDHFGPQOWIEURYTZMXNCBVLAKSJDHFGQPWOEIRUTY
@@ -0,0 +1,200 @@
+#ifndef HALF_PRECISION_HPP_INCLUDED_ZRKTNWQMXLPAVSGYDHEBUCOFJIZRKTNWQMXLPAVSGYDHEBUCOF
+#define HALF_PRECISION_HPP_INCLUDED_ZRKTNWQMXLPAVSGYDHEBUCOFJIZRKTNWQMXLPAVSGYDHEBUCOF
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "../utils/half_float.hpp"
+#include "./vectorized_math.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+//
+// Conversions between float and the 16-bit storage types, and the vectorized kernels over 16-bit buffers.
+//
+// A kernel over a `bfloat16` or a `float16` buffer converts a block of a few hundred elements to float on the stack, runs the
+// float kernel on the block, and rounds the results back, so the 16-bit values never take part in an arithmetic operation.
+//
+// The conversions are exact from 16 bits to float, and round to nearest, ties to even, from float to 16 bits. With AVX512-BF16
+// the float to bfloat16 conversion flushes the subnormal floats, below 1.2e-38, to zero, as the `-Ofast` of the Makefile
+// does for the floats anyway.
+//
+
+namespace ceras
+{
+
+    namespace half_precision_private
+    {
+
+#if defined(__AVX512F__)
+        // all the lanes, for the zero-masked forms of the intrinsics, see `pack_avx512::all` in './vectorized_math.hpp'
+        inline constexpr __mmask16 all_lanes = 0xffff;
+#endif
+
+        inline void convert_range( float const* __restrict__ in, bfloat16* __restrict__ out, size_t n ) noexcept
+        {
+            size_t idx = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+            for ( ; idx + 16 <= n; idx += 16 )
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + idx ), reinterpret_cast<__m256i>( _mm512_cvtneps_pbh( _mm512_loadu_ps( in + idx ) ) ) );
+#elif defined(__AVX512F__)
+            __m512i const one = _mm512_set1_epi32( 1 );
+            __m512i const bias = _mm512_set1_epi32( 0x7fff );
+            __m512i const quiet = _mm512_set1_epi32( 0x40 );
+            for ( ; idx + 16 <= n; idx += 16 )
+            {
+                __m512 const x = _mm512_loadu_ps( in + idx );
+                __m512i const u = _mm512_castps_si512( x );
+                __m512i const high = _mm512_maskz_srli_epi32( all_lanes, u, 16 );
+                __m512i bits = _mm512_maskz_srli_epi32( all_lanes, _mm512_add_epi32( u, _mm512_add_epi32( bias, _mm512_and_si512( high, one ) ) ), 16 );
+                bits = _mm512_mask_mov_epi32( bits, _mm512_cmp_ps_mask( x, x, _CMP_UNORD_Q ), _mm512_or_si512( high, quiet ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + idx ), _mm512_maskz_cvtepi32_epi16( all_lanes, bits ) );
+            }
+#elif defined(__AVX2__)
+            __m256i const one = _mm256_set1_epi32( 1 );
+            __m256i const bias = _mm256_set1_epi32( 0x7fff );
+            __m256i const quiet = _mm256_set1_epi32( 0x40 );
+            for ( ; idx + 8 <= n; idx += 8 )
+            {
+                __m256 const x = _mm256_loadu_ps( in + idx );
+                __m256i const u = _mm256_castps_si256( x );
+                __m256i const high = _mm256_srli_epi32( u, 16 );
+                __m256i bits = _mm256_srli_epi32( _mm256_add_epi32( u, _mm256_add_epi32( bias, _mm256_and_si256( high, one ) ) ), 16 );
+                bits = _mm256_blendv_epi8( bits, _mm256_or_si256( high, quiet ), _mm256_castps_si256( _mm256_cmp_ps( x, x, _CMP_UNORD_Q ) ) );
+                __m256i const packed = _mm256_permute4x64_epi64( _mm256_packus_epi32( bits, bits ), 0x08 );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( out + idx ), _mm256_castsi256_si128( packed ) );
+            }
+#endif
+            for ( ; idx < n; ++idx )
+                out[idx] = bfloat16{ in[idx] };
+        }
+
+        inline void convert_range( bfloat16 const* __restrict__ in, float* __restrict__ out, size_t n ) noexcept
+        {
+            size_t idx = 0;
+#if defined(__AVX512F__)
+            for ( ; idx + 16 <= n; idx += 16 )
+            {
+                __m512i const bits = _mm512_maskz_cvtepu16_epi32( all_lanes, _mm256_loadu_si256( reinterpret_cast<__m256i const*>( in + idx ) ) );
+                _mm512_storeu_ps( out + idx, _mm512_castsi512_ps( _mm512_maskz_slli_epi32( all_lanes, bits, 16 ) ) );
+            }
+#elif defined(__AVX2__)
+            for ( ; idx + 8 <= n; idx += 8 )
+            {
+                __m256i const bits = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<__m128i const*>( in + idx ) ) );
+                _mm256_storeu_ps( out + idx, _mm256_castsi256_ps( _mm256_slli_epi32( bits, 16 ) ) );
+            }
+#endif
+            for ( ; idx < n; ++idx )
+                out[idx] = static_cast<float>( in[idx] );
+        }
+
+        inline void convert_range( float const* __restrict__ in, float16* __restrict__ out, size_t n ) noexcept
+        {
+            size_t idx = 0;
+#if defined(__AVX512F__)
+            for ( ; idx + 16 <= n; idx += 16 )
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + idx ), _mm512_maskz_cvtps_ph( all_lanes, _mm512_loadu_ps( in + idx ), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC ) );
+#elif defined(__AVX2__) && defined(__F16C__)
+            for ( ; idx + 8 <= n; idx += 8 )
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( out + idx ), _mm256_cvtps_ph( _mm256_loadu_ps( in + idx ), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC ) );
+#endif
+            for ( ; idx < n; ++idx )
+                out[idx] = float16{ in[idx] };
+        }
+
+        inline void convert_range( float16 const* __restrict__ in, float* __restrict__ out, size_t n ) noexcept
+        {
+            size_t idx = 0;
+#if defined(__AVX512F__)
+            for ( ; idx + 16 <= n; idx += 16 )
+                _mm512_storeu_ps( out + idx, _mm512_maskz_cvtph_ps( all_lanes, _mm256_loadu_si256( reinterpret_cast<__m256i const*>( in + idx ) ) ) );
+#elif defined(__AVX2__) && defined(__F16C__)
+            for ( ; idx + 8 <= n; idx += 8 )
+                _mm256_storeu_ps( out + idx, _mm256_cvtph_ps( _mm_loadu_si128( reinterpret_cast<__m128i const*>( in + idx ) ) ) );
+#endif
+            for ( ; idx < n; ++idx )
+                out[idx] = static_cast<float>( in[idx] );
+        }
+
+        // the elements of a block of a 16-bit kernel, converted to float on the stack
+        inline constexpr size_t block_size = 256;
+
+    }//namespace half_precision_private
+
+    ///
+    /// @brief Converts `n` elements of `in` to the value type of `out`, rounding to nearest.
+    ///
+    /// The conversions between float and `bfloat16` or `float16` are vectorized and run on the thread pool for a large `n`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// std::vector<float> x( 1024, 3.14159f );
+    /// std::vector<bfloat16> y( 1024 );
+    /// convert( x.data(), y.data(), 1024 ); // 3.140625
+    /// @endcode
+    ///
+    template< typename S, typename D >
+    void convert( S const* in, D* out, size_t n ) noexcept
+    {
+        using namespace half_precision_private;
+        if constexpr( std::is_same_v<S, D> )
+            std::copy_n( in, n, out );
+        else if constexpr( ( std::is_same_v<S, float> && Half_Float<D> ) || ( Half_Float<S> && std::is_same_v<D, float> ) )
+            vmath::vmath_private::for_each_range( n, [=]( size_t first, size_t last ) noexcept { convert_range( in + first, out + first, last - first ); } );
+        else if constexpr( Half_Float<S> || Half_Float<D> ) // through float
+            for ( size_t idx = 0; idx != n; ++idx )
+                out[idx] = static_cast<D>( static_cast<float>( in[idx] ) );
+        else
+            std::transform( in, in + n, out, []( S value ) noexcept { return static_cast<D>( value ); } );
+    }
+
+    ///
+    /// @brief Applies `func` to the `n` elements of the 16-bit buffer `in`, writing to `out`, computing in float, see `vectorized_map` in './vectorized_math.hpp'.
+    ///
+    template< Half_Float T, typename Function >
+    void vectorized_map( T const* in, T* out, size_t n, Function const& func ) noexcept
+    {
+        using namespace half_precision_private;
+        vmath::vmath_private::for_each_range( n, [&]( size_t first, size_t last ) noexcept
+        {
+            alignas( memory_alignment ) float x[block_size];
+            alignas( memory_alignment ) float y[block_size];
+            for ( size_t idx = first; idx < last; idx += block_size )
+            {
+                size_t const size = std::min( block_size, last - idx );
+                convert_range( in + idx, x, size );
+                vmath::vmath_private::map_range( func, y, 0, size, static_cast<float const*>( x ) );
+                convert_range( y, out + idx, size );
+            }
+        } );
+    }
+
+    ///
+    /// @brief Applies `func` to the `n` pairs of elements of the 16-bit buffers `lhs` and `rhs`, writing to `out`, computing in float.
+    ///
+    template< Half_Float T, typename Function >
+    void vectorized_map( T const* lhs, T const* rhs, T* out, size_t n, Function const& func ) noexcept
+    {
+        using namespace half_precision_private;
+        vmath::vmath_private::for_each_range( n, [&]( size_t first, size_t last ) noexcept
+        {
+            alignas( memory_alignment ) float x[block_size];
+            alignas( memory_alignment ) float z[block_size];
+            alignas( memory_alignment ) float y[block_size];
+            for ( size_t idx = first; idx < last; idx += block_size )
+            {
+                size_t const size = std::min( block_size, last - idx );
+                convert_range( lhs + idx, x, size );
+                convert_range( rhs + idx, z, size );
+                vmath::vmath_private::map_range( func, y, 0, size, static_cast<float const*>( x ), static_cast<float const*>( z ) );
+                convert_range( y, out + idx, size );
+            }
+        } );
+    }
+
+}//namespace ceras
+
+#endif//HALF_PRECISION_HPP_INCLUDED_ZRKTNWQMXLPAVSGYDHEBUCOFJIZRKTNWQMXLPAVSGYDHEBUCOF
+
@@ -0,0 +1,303 @@
+#ifndef INT8_GEMM_HPP_INCLUDED_KXQMWTRZLBNVPSAYDGHOEUFJCIKXQMWTRZLBNVPSAYDGHOEUFJCI
+#define INT8_GEMM_HPP_INCLUDED_KXQMWTRZLBNVPSAYDGHOEUFJCIKXQMWTRZLBNVPSAYDGHOEUFJCI
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "../utils/aligned_allocator.hpp"
+#include "../utils/better_assert.hpp"
+#include "../utils/parallel.hpp"
+#include "./gemm.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+//
+// The integer kernels of the quantized inference: C[m x k] = ( A[m x n] - za ) * B[n x k], with A of `std::uint8_t`,
+// B of `std::int8_t` and C of `std::int32_t`.
+//
+// B, the weights, is packed once into panels of `nr` columns. In a panel the 4 consecutive values of a column along the
+// common dimension are contiguous, and the `nr` columns of such a group of 4 follow each other:
+//
+//   panel p, group g: B[4g:4g+4, p*nr:(p+1)*nr] stored as nr x 4 bytes
+//
+// which is the operand layout of the VNNI `vpdpbusd`, multiplying 4 unsigned bytes of A by 4 signed bytes of B and adding
+// the 4 products to a 32-bit lane. Without VNNI the AVX2 kernel widens the same bytes to 16 bits and adds the pairs of
+// products with `vpmaddwd`, which is exact where `vpmaddubsw` would saturate 255*127 + 255*127 to 32767.
+//
+// The zero point of A is taken out after the product, as `za * column_sum(B)`, so the kernels only see unsigned bytes.
+//
+
+namespace ceras
+{
+
+    namespace int8_gemm_private
+    {
+        // the register tile of the kernels, `mr` rows of A times a panel of `nr` columns of B
+#if defined(__AVX512VNNI__)
+        inline constexpr size_t mr = 4;
+        inline constexpr size_t nr = 64; // 4 zmm accumulators per row
+#elif defined(__AVX2__)
+        inline constexpr size_t mr = 6;
+        inline constexpr size_t nr = 8; // 2 ymm accumulators per row
+#else
+        inline constexpr size_t mr = 4;
+        inline constexpr size_t nr = 8;
+#endif
+
+        // the rows of C computed by a task, the panel of B staying in cache while they run over it
+        inline constexpr size_t mc = 8 * mr;
+
+        // the 4 bytes of A at column `4g` of a row, zero beyond the `n` columns
+        inline std::uint32_t load_group( std::uint8_t const* row, size_t g, size_t n ) noexcept
+        {
+            std::uint32_t ans = 0;
+            if ( 4 * g + 4 <= n )
+                std::memcpy( &ans, row + 4 * g, 4 );
+            else
+                for ( size_t r = 4 * g; r < n; ++r )
+                    ans |= static_cast<std::uint32_t>( row[r] ) << ( 8 * ( r - 4 * g ) );
+            return ans;
+        }
+
+        // calls `update( g, load )` on every group of 4 columns of A, `load( row )` reading the 4 bytes of the group in a row
+        template< typename Function >
+        void for_each_group( size_t n, Function const& update ) noexcept
+        {
+            size_t g = 0;
+            for ( ; 4 * g + 4 <= n; ++g ) // the whole groups, without a test on every load
+                update( g, [g]( std::uint8_t const* row ) noexcept { std::uint32_t ans; std::memcpy( &ans, row + 4 * g, 4 ); return ans; } );
+            if ( 4 * g < n )
+                update( g, [g, n]( std::uint8_t const* row ) noexcept { return load_group( row, g, n ); } );
+        }
+
+        ///
+        /// @brief `rows x nr` tile of the raw product of `rows` rows of A and a panel of B, without the zero point, to `tile`.
+        ///
+        template< size_t Rows >
+        void micro_kernel( std::uint8_t const* a, size_t lda, size_t n, std::int8_t const* __restrict__ b, std::int32_t* __restrict__ tile ) noexcept
+        {
+#if defined(__AVX512VNNI__)
+            __m512i acc[Rows][4];
+            for ( size_t i = 0; i != Rows; ++i )
+                for ( size_t j = 0; j != 4; ++j )
+                    acc[i][j] = _mm512_setzero_si512();
+            auto const& update = [&]( size_t g, auto const& load ) noexcept
+            {
+                std::int8_t const* bg = b + g * nr * 4;
+                __m512i const b0 = _mm512_load_si512( bg );
+                __m512i const b1 = _mm512_load_si512( bg + 64 );
+                __m512i const b2 = _mm512_load_si512( bg + 128 );
+                __m512i const b3 = _mm512_load_si512( bg + 192 );
+                for ( size_t i = 0; i != Rows; ++i )
+                {
+                    __m512i const ai = _mm512_set1_epi32( static_cast<int>( load( a + i * lda ) ) );
+                    acc[i][0] = _mm512_dpbusd_epi32( acc[i][0], ai, b0 );
+                    acc[i][1] = _mm512_dpbusd_epi32( acc[i][1], ai, b1 );
+                    acc[i][2] = _mm512_dpbusd_epi32( acc[i][2], ai, b2 );
+                    acc[i][3] = _mm512_dpbusd_epi32( acc[i][3], ai, b3 );
+                }
+            };
+            for_each_group( n, update );
+            for ( size_t i = 0; i != Rows; ++i )
+                for ( size_t j = 0; j != 4; ++j )
+                    _mm512_store_si512( tile + i * nr + 16 * j, acc[i][j] );
+#elif defined(__AVX2__)
+            // the lanes of `lo` hold the two half sums of the columns 0-3, the lanes of `hi` those of the columns 4-7
+            __m256i lo[Rows];
+            __m256i hi[Rows];
+            for ( size_t i = 0; i != Rows; ++i )
+                lo[i] = hi[i] = _mm256_setzero_si256();
+            auto const& update = [&]( size_t g, auto const& load ) noexcept
+            {
+                std::int8_t const* bg = b + g * nr * 4;
+                __m256i const b_lo = _mm256_cvtepi8_epi16( _mm_load_si128( reinterpret_cast<__m128i const*>( bg ) ) );
+                __m256i const b_hi = _mm256_cvtepi8_epi16( _mm_load_si128( reinterpret_cast<__m128i const*>( bg + 16 ) ) );
+                for ( size_t i = 0; i != Rows; ++i )
+                {
+                    __m128i const a4 = _mm_cvtepu8_epi16( _mm_cvtsi32_si128( static_cast<int>( load( a + i * lda ) ) ) );
+                    __m256i const ai = _mm256_broadcastq_epi64( a4 );
+                    lo[i] = _mm256_add_epi32( lo[i], _mm256_madd_epi16( ai, b_lo ) );
+                    hi[i] = _mm256_add_epi32( hi[i], _mm256_madd_epi16( ai, b_hi ) );
+                }
+            };
+            for_each_group( n, update );
+            for ( size_t i = 0; i != Rows; ++i ) // [c0 c1 c4 c5 | c2 c3 c6 c7] to [c0 .. c7]
+                _mm256_store_si256( reinterpret_cast<__m256i*>( tile + i * nr ), _mm256_permute4x64_epi64( _mm256_hadd_epi32( lo[i], hi[i] ), 0xd8 ) );
+#else
+            std::fill_n( tile, Rows * nr, std::int32_t{0} );
+            for ( size_t g = 0; g != ( n + 3 ) / 4; ++g )
+                for ( size_t i = 0; i != Rows; ++i )
+                {
+                    std::uint32_t const a4 = load_group( a + i * lda, g, n );
+                    for ( size_t j = 0; j != nr; ++j )
+                        for ( size_t r = 0; r != 4; ++r )
+                            tile[i * nr + j] += static_cast<std::int32_t>( ( a4 >> ( 8 * r ) ) & 0xffU ) * b[( g * nr + j ) * 4 + r];
+                }
+#endif
+        }
+
+        template< size_t Rows = mr >
+        void dispatch_micro_kernel( size_t rows, std::uint8_t const* a, size_t lda, size_t n, std::int8_t const* b, std::int32_t* tile ) noexcept
+        {
+            if constexpr( Rows > 1 )
+                if ( rows < Rows )
+                    return dispatch_micro_kernel<Rows-1>( rows, a, lda, n, b, tile );
+            micro_kernel<Rows>( a, lda, n, b, tile );
+        }
+
+    }//namespace int8_gemm_private
+
+    ///
+    /// @brief The right-hand side of an int8 gemm, packed once for `int8_gemm`.
+    ///
+    struct int8_packed_matrix
+    {
+        std::vector<std::int8_t, aligned_allocator<std::int8_t>> data_; // the panels, zero-padded to whole groups and panels
+        std::vector<std::int32_t> column_sums_; // the sum of every column, for the zero point of the left-hand side
+        size_t rows_ = 0;
+        size_t cols_ = 0;
+
+        size_t rows() const noexcept { return rows_; }
+        size_t cols() const noexcept { return cols_; }
+    }; // struct int8_packed_matrix
+
+    ///
+    /// @brief Packs B for `int8_gemm`.
+    ///
+    /// @param B Pointer to B. If `b_transposed`, B is stored as [k x n], otherwise [n x k].
+    /// @param n The rows of B, the common dimension of the product.
+    /// @param k The columns of B.
+    ///
+    inline int8_packed_matrix pack_int8( std::int8_t const* B, bool b_transposed, size_t n, size_t k )
+    {
+        using namespace int8_gemm_private;
+        size_t const groups = ( n + 3 ) / 4;
+        size_t const panels = ( k + nr - 1 ) / nr;
+
+        int8_packed_matrix ans;
+        ans.rows_ = n;
+        ans.cols_ = k;
+        ans.data_.assign( panels * groups * nr * 4, std::int8_t{0} );
+        ans.column_sums_.assign( k, std::int32_t{0} );
+        for ( size_t r = 0; r != n; ++r )
+            for ( size_t c = 0; c != k; ++c )
+            {
+                std::int8_t const value = b_transposed ? B[c * n + r] : B[r * k + c];
+                ans.data_[( ( c / nr * groups + r / 4 ) * nr + c % nr ) * 4 + r % 4] = value;
+                ans.column_sums_[c] += value;
+            }
+        return ans;
+    }
+
+    ///
+    /// @brief Integer gemm, C[m x k] <= ( A[m x n] - a_zero_point ) * B[n x k], in 32-bit.
+    ///
+    /// @param A Pointer to A, stored as [m x n] with row stride `n`.
+    /// @param m The rows of A.
+    /// @param B The packed B, see `pack_int8`.
+    /// @param a_zero_point The value of A standing for zero.
+    /// @param C Pointer to C, stored as [m x k].
+    /// @param epilogue Called as `epilogue( c, k, row, 0, rows, k )` on every block of whole rows of C once it is complete, while
+    ///                 it is still in cache, see `gemm_no_epilogue` in './gemm.hpp'. The block is left in C.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// std::vector<std::uint8_t> a( 128*256, 130 );
+    /// std::vector<std::int8_t> b( 256*64, -3 );
+    /// std::vector<std::int32_t> c( 128*64 );
+    /// auto const packed = pack_int8( b.data(), false, 256, 64 );
+    /// int8_gemm( a.data(), 128, packed, 128, c.data() ); // c[i] = 256 * 2 * (-3)
+    /// @endcode
+    ///
+    template< typename Epilogue = gemm_no_epilogue >
+    void int8_gemm( std::uint8_t const* A, size_t m, int8_packed_matrix const& B, std::int32_t a_zero_point, std::int32_t* C, Epilogue const& epilogue = Epilogue{} )
+    {
+        using namespace int8_gemm_private;
+        size_t const n = B.rows();
+        size_t const k = B.cols();
+        size_t const panel_size = ( ( n + 3 ) / 4 ) * nr * 4;
+
+        parallel( [&]( size_t block )
+        {
+            alignas( memory_alignment ) std::int32_t tile[mr * nr];
+            size_t const first = block * mc;
+            size_t const last = std::min( m, first + mc );
+            for ( size_t jc = 0; jc < k; jc += nr )
+            {
+                size_t const cols = std::min( nr, k - jc );
+                std::int8_t const* panel = B.data_.data() + ( jc / nr ) * panel_size;
+                std::int32_t const* column_sums = B.column_sums_.data() + jc;
+                for ( size_t ic = first; ic < last; ic += mr )
+                {
+                    size_t const rows = std::min( mr, last - ic );
+                    dispatch_micro_kernel( rows, A + ic * n, n, n, panel, tile );
+                    for ( size_t i = 0; i != rows; ++i )
+                    {
+                        std::int32_t* __restrict__ c = C + ( ic + i ) * k + jc;
+                        for ( size_t j = 0; j != cols; ++j )
+                            c[j] = tile[i * nr + j] - a_zero_point * column_sums[j];
+                    }
+                }
+            }
+            epilogue( C + first * k, k, first, size_t{0}, last - first, k );
+        }, size_t{0}, ( m + mc - 1 ) / mc, 1 );
+    }
+
+    ///
+    /// @brief Quantizes `n` floats, `out[i] = clamp( round( in[i] / scale ) + zero_point )` to the range of T, rounding to nearest even.
+    ///
+    /// The range of `std::int8_t` is taken as [-127, 127], symmetric around zero.
+    ///
+    template< typename T > requires std::same_as<T, std::int8_t> || std::same_as<T, std::uint8_t>
+    void quantize_range( float const* __restrict__ in, size_t n, float scale, std::int32_t zero_point, T* __restrict__ out ) noexcept
+    {
+        constexpr std::int32_t lowest = std::same_as<T, std::int8_t> ? -127 : 0;
+        constexpr std::int32_t highest = std::same_as<T, std::int8_t> ? 127 : 255;
+        float const inverse = 1.0f / scale;
+        size_t idx = 0;
+#if defined(__AVX512F__)
+        __m512 const inv = _mm512_set1_ps( inverse );
+        __m512i const zp = _mm512_set1_epi32( zero_point );
+        __m512i const lo = _mm512_set1_epi32( lowest );
+        __m512i const hi = _mm512_set1_epi32( highest );
+        for ( ; idx + 16 <= n; idx += 16 )
+        {
+            __mmask16 const all = 0xffff; // the zero-masked forms, see `pack_avx512::all` in './vectorized_math.hpp'
+            __m512i const q = _mm512_add_epi32( _mm512_maskz_cvtps_epi32( all, _mm512_mul_ps( _mm512_loadu_ps( in + idx ), inv ) ), zp );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( out + idx ), _mm512_maskz_cvtepi32_epi8( all, _mm512_maskz_min_epi32( all, _mm512_maskz_max_epi32( all, q, lo ), hi ) ) );
+        }
+#endif
+        for ( ; idx < n; ++idx )
+            out[idx] = static_cast<T>( std::clamp( static_cast<std::int32_t>( std::nearbyint( in[idx] * inverse ) ) + zero_point, lowest, highest ) );
+    }
+
+    ///
+    /// @brief The scale and the zero point mapping the range [lowest, highest], widened to hold zero, to the range of T.
+    ///
+    /// `std::uint8_t` is mapped asymmetrically, [lowest, highest] to [0, 255], and zero to a whole zero point.
+    /// `std::int8_t` is mapped symmetrically, [-max(|lowest|, |highest|), max(|lowest|, |highest|)] to [-127, 127], with a zero point of 0.
+    ///
+    template< typename T > requires std::same_as<T, std::int8_t> || std::same_as<T, std::uint8_t>
+    std::tuple<float, std::int32_t> quantization_parameters( float lowest, float highest ) noexcept
+    {
+        lowest = std::min( lowest, 0.0f );
+        highest = std::max( highest, 0.0f );
+        if constexpr( std::same_as<T, std::int8_t> )
+        {
+            float const scale = std::max( -lowest, highest ) / 127.0f;
+            return std::make_tuple( ( scale > 0.0f ) ? scale : 1.0f, std::int32_t{0} );
+        }
+        else
+        {
+            float const scale = ( highest - lowest ) / 255.0f;
+            if ( !( scale > 0.0f ) )
+                return std::make_tuple( 1.0f, std::int32_t{0} );
+            return std::make_tuple( scale, std::clamp( static_cast<std::int32_t>( std::nearbyint( -lowest / scale ) ), 0, 255 ) );
+        }
+    }
+
+}//namespace ceras
+
+#endif//INT8_GEMM_HPP_INCLUDED_KXQMWTRZLBNVPSAYDGHOEUFJCIKXQMWTRZLBNVPSAYDGHOEUFJCI
+
@@ -12,7 +12,12 @@
 #include "./optimizer.hpp"
 #include "./place_holder.hpp"
 #include "./session.hpp"
+#include "./execution_plan.hpp"
+#include "./elementwise_fusion.hpp"
+#include "./memory_plan.hpp"
 #include "./tensor.hpp"
+#include "./quantized_tensor.hpp"
+#include "./sparse_tensor.hpp"
 #include "./variable.hpp"
 #include "./constant.hpp"
 #include "./layer.hpp"
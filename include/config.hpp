@@ -45,6 +45,12 @@ namespace ceras
         inline constexpr unsigned long parallel_mode = 0;
     #endif
 
+    #if defined(OPENMP) && defined(_OPENMP)
+        inline constexpr unsigned long openmp_mode = 1;
+    #else
+        inline constexpr unsigned long openmp_mode = 0;
+    #endif
+
     #ifdef CUDA
         inline constexpr unsigned long cuda_mode = 1;
     #else
@@ -53,6 +59,9 @@ namespace ceras
 
     inline int visible_device = 0; // using GPU 0 by default
     inline unsigned long cuda_gemm_threshold = 0UL; // will be updated if in CUDA mode, always assume float multiplications as double is rearly used
+    inline unsigned long gemm_autotuning = 0UL; // 1 to tune the cpu gemm of a shape bucket at its first use, timing its candidate kernels once; 0 to use the plans of `tune_gemm` or of the tuning cache only, see 'backend/gemm_tuner.hpp'
+    inline unsigned long gemm_fast_algorithms = 0UL; // 1 to let the gemm autotuner pick the fast (Strassen) kernel for the large products, 0 for the classical kernels only, see 'backend/fast_gemm.hpp'
+                                                     // the fast kernel trades accuracy for speed: its error bound grows as n^log2(12) instead of n, see `fast_gemm_error_bound`
 
     inline constexpr double eps = 1.0e-8;
     inline constexpr double epsilon = eps; // alias of `eps`
@@ -51,6 +51,10 @@ namespace ceras
         }
     };
 
+    // a constant initialized with a view holds the tensor of the view, see `materialize` in './tensor_view.hpp'
+    template< Tensor_View View >
+    constant( View const& ) -> constant<typename View::tensor_type>;
+
     template< typename T >
     struct is_constant : std::false_type {};
 
@@ -0,0 +1,497 @@
+#ifndef ELEMENTWISE_FUSION_HPP_INCLUDED_KTWMZQHDRXNAJOYEBVLGPUSCFIKTWMZQHDRXNAJOYEBVLGPUSCFI
+#define ELEMENTWISE_FUSION_HPP_INCLUDED_KTWMZQHDRXNAJOYEBVLGPUSCFIKTWMZQHDRXNAJOYEBVLGPUSCFI
+
+#include "./includes.hpp"
+#include "./tensor.hpp"
+#include "./operation.hpp"
+#include "./execution_plan.hpp"
+#include "./backend/vectorized_math.hpp"
+#include "./utils/aligned_allocator.hpp"
+
+namespace ceras
+{
+
+    namespace elementwise_fusion_private
+    {
+
+        // the elements of a block, the blocks of the operators of a chain staying in the cache
+        inline constexpr size_t block_size = 1024;
+
+        // if `small` is repeated along `large` in the channel-last order, its leading dimensions of 1 aside
+        inline bool periodic( std::vector<size_t> small, std::vector<size_t> const& large )
+        {
+            small.erase( small.begin(), std::find_if( small.begin(), small.end(), []( size_t dim ) { return dim != 1; } ) );
+            return small.size() <= large.size() && std::equal( small.rbegin(), small.rend(), large.rbegin() );
+        }
+
+        inline size_t elements_of( std::vector<size_t> const& shape )
+        {
+            return std::accumulate( shape.begin(), shape.end(), 1UL, std::multiplies<size_t>() );
+        }
+
+        // an operand of an operator of a chain: the output of an operator of the chain, or of a node out of it
+        struct operand
+        {
+            bool external_;
+            size_t index_;  // in the operators of the chain, or in its external nodes
+        };
+
+        template< Tensor Tsor >
+        struct fused_chain
+        {
+            typedef typename Tsor::value_type value_type;
+            typedef elementwise_kernel<value_type> kernel_type;
+            typedef typename execution_plan<Tsor>::step_type step_type;
+            typedef std::vector<value_type, aligned_allocator<value_type>> buffer_type;
+
+            std::vector<size_t> nodes_;                             // in topological order, the root last
+            std::vector<std::shared_ptr<kernel_type>> kernels_;
+            std::vector<std::vector<operand>> operands_;
+            std::vector<size_t> externals_;                         // the nodes read from out of the chain
+            std::vector<step_type> forward_steps_;                  // the unfused steps of the nodes, run when the shapes of the externals do not fit
+            std::vector<step_type> backward_steps_;                 // in reverse topological order
+
+            bool fused_ = false;                                    // if the last forward pass was fused
+            size_t size_ = 0;                                       // the elements of the operators, or of the input of a reducing root
+            std::vector<size_t> shape_;
+            std::vector<size_t> periods_;                           // the elements of every external, less than `size_` if broadcast
+            Tsor output_;
+            std::vector<Tsor> gradients_;                           // of the externals
+
+            // the blocks of a task
+            struct scratch
+            {
+                buffer_type registers_;                             // the outputs of the operators
+                buffer_type gradients_;                             // and their gradients
+                buffer_type gathered_;                              // the broadcast externals, repeated to the block
+                buffer_type temporary_;
+                std::vector<value_type const*> externals_;
+                std::vector<char> assigned_;                        // the operators given a gradient in the block
+                std::vector<char> external_assigned_;               // and the externals
+                std::vector<buffer_type> partials_;                 // the gradients of the broadcast externals summed in the task
+            };
+            std::vector<scratch> scratches_;                        // of the tasks of the last passes, taken again by the tasks of the next ones
+
+            bool reduction() const noexcept
+            {
+                return kernels_.back()->reduction_;
+            }
+
+            // the shapes of the externals, the outputs of the operators of the chain all of the same shape, the externals of it or broadcast to it
+            bool fit( execution_plan<Tsor> const& plan )
+            {
+                std::vector<std::vector<size_t>> shapes( nodes_.size() );
+                for ( auto idx : range( nodes_.size() ) )
+                {
+                    std::vector<std::vector<size_t>> operand_shapes;
+                    for ( auto const& op : operands_[idx] )
+                        operand_shapes.push_back( op.external_ ? plan.outputs_[externals_[op.index_]].shape() : shapes[op.index_] );
+                    if ( operand_shapes.size() == 1 || operand_shapes[0] == operand_shapes[1] || periodic( operand_shapes[1], operand_shapes[0] ) )
+                        shapes[idx] = operand_shapes[0];
+                    else if ( periodic( operand_shapes[0], operand_shapes[1] ) )
+                        shapes[idx] = operand_shapes[1];
+                    else
+                        return false;
+                }
+
+                shape_ = shapes.back();
+                if ( !std::all_of( shapes.begin(), shapes.end(), [this]( auto const& shape ) { return shape == shape_; } ) )
+                    return false;
+                size_ = elements_of( shape_ );
+                periods_.clear();
+                for ( auto external : externals_ )
+                {
+                    auto const& shape = plan.outputs_[external].shape();
+                    if ( shape != shape_ && !periodic( shape, shape_ ) )
+                        return false;
+                    periods_.push_back( elements_of( shape ) );
+                }
+                return size_ > 0;
+            }
+
+            scratch make_scratch() const
+            {
+                size_t const operators = nodes_.size();
+                size_t const externals = externals_.size();
+                scratch ans{ buffer_type( block_size * operators ), buffer_type( block_size * operators ), buffer_type( block_size * externals ), buffer_type( block_size ),
+                             std::vector<value_type const*>( externals ), std::vector<char>( operators ), std::vector<char>( externals ), std::vector<buffer_type>( externals ) };
+                return ans;
+            }
+
+            // a scratch of the last passes if any left, the tasks of a pass taking and giving back theirs under `mutex`
+            scratch take_scratch( std::mutex& mutex )
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                if ( scratches_.empty() )
+                    return make_scratch();
+                scratch ans = std::move( scratches_.back() );
+                scratches_.pop_back();
+                return ans;
+            }
+
+            void give_back( std::mutex& mutex, scratch&& s )
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                scratches_.push_back( std::move( s ) );
+            }
+
+            value_type* register_of( scratch& s, size_t idx ) const noexcept
+            {
+                return s.registers_.data() + block_size * idx;
+            }
+
+            value_type const* pointer_of( scratch& s, operand const& op ) const noexcept
+            {
+                return op.external_ ? s.externals_[op.index_] : register_of( s, op.index_ );
+            }
+
+            // the output of the operator `idx` in the block at `first`, that of the root written to `output_`
+            value_type* output_of( scratch& s, size_t idx, size_t first ) noexcept
+            {
+                if ( idx + 1 == nodes_.size() && !reduction() )
+                    return output_.data() + first;
+                return register_of( s, idx );
+            }
+
+            typename kernel_type::inputs_type inputs_of( scratch& s, size_t idx ) const noexcept
+            {
+                typename kernel_type::inputs_type ans{ nullptr, nullptr };
+                for ( auto k : range( operands_[idx].size() ) )
+                    ans[k] = pointer_of( s, operands_[idx][k] );
+                return ans;
+            }
+
+            // computes the outputs of the operators in the `n` elements from `first`, but the root if not `with_root`
+            void run_block( execution_plan<Tsor> const& plan, scratch& s, size_t first, size_t n, bool with_root )
+            {
+                for ( auto idx : range( externals_.size() ) )
+                {
+                    value_type const* data = plan.outputs_[externals_[idx]].data();
+                    size_t const period = periods_[idx];
+                    if ( period == size_ )
+                    {
+                        s.externals_[idx] = data + first;
+                        continue;
+                    }
+                    value_type* gathered = s.gathered_.data() + block_size * idx;
+                    for ( size_t offset = first % period, done = 0; done < n; offset = 0 )
+                    {
+                        size_t const count = std::min( n - done, period - offset );
+                        std::copy_n( data + offset, count, gathered + done );
+                        done += count;
+                    }
+                    s.externals_[idx] = gathered;
+                }
+
+                size_t const operators = ( with_root && !reduction() ) ? nodes_.size() : nodes_.size() - 1;
+                for ( auto idx : range( operators ) )
+                    kernels_[idx]->forward_( inputs_of( s, idx ), output_of( s, idx, first ), n );
+            }
+
+            void forward( execution_plan<Tsor>& plan )
+            {
+                fused_ = fit( plan );
+                if ( !fused_ )
+                {
+                    for ( auto& step : forward_steps_ )
+                        step( plan );
+                    return;
+                }
+
+                output_.resize( reduction() ? std::vector<size_t>{ 1 } : shape_ );
+                std::mutex mutex;
+                std::vector<std::pair<size_t, value_type>> sums; // of the tasks, summed in order
+                vmath::vmath_private::for_each_range( size_, [&]( size_t first, size_t last )
+                {
+                    scratch s = take_scratch( mutex );
+                    value_type sum{ 0 };
+                    for ( size_t block = first; block < last; block += block_size )
+                    {
+                        size_t const n = std::min( block_size, last - block );
+                        run_block( plan, s, block, n, true );
+                        if ( reduction() )
+                        {
+                            value_type const* input = pointer_of( s, operands_.back()[0] );
+                            sum = std::accumulate( input, input + n, sum );
+                        }
+                    }
+                    if ( reduction() )
+                    {
+                        std::lock_guard<std::mutex> lock( mutex );
+                        sums.emplace_back( first, sum );
+                    }
+                    give_back( mutex, std::move( s ) );
+                } );
+
+                if ( reduction() )
+                {
+                    std::sort( sums.begin(), sums.end() );
+                    value_type sum{ 0 };
+                    for ( auto const& [first, partial] : sums )
+                        sum += partial;
+                    output_[0] = sum * kernels_.back()->forward_scale_( shape_ );
+                }
+                plan.outputs_[nodes_.back()] = output_;
+            }
+
+            // adds the gradient computed by `write( ans )` to the operand `op`, in the `n` elements from `first`
+            template< typename Write >
+            void deliver( scratch& s, operand const& op, size_t first, size_t n, Write const& write )
+            {
+                if ( !op.external_ )
+                {
+                    value_type* gradient = s.gradients_.data() + block_size * op.index_;
+                    if ( !s.assigned_[op.index_] )
+                    {
+                        write( gradient );
+                        s.assigned_[op.index_] = 1;
+                        return;
+                    }
+                    write( s.temporary_.data() );
+                    vectorized_map( gradient, s.temporary_.data(), gradient, n, []( auto x, auto y ) { return x + y; } );
+                    return;
+                }
+
+                size_t const period = periods_[op.index_];
+                if ( period == size_ )
+                {
+                    value_type* gradient = gradients_[op.index_].data() + first;
+                    if ( !s.external_assigned_[op.index_] )
+                    {
+                        write( gradient );
+                        s.external_assigned_[op.index_] = 1;
+                        return;
+                    }
+                    write( s.temporary_.data() );
+                    vectorized_map( gradient, s.temporary_.data(), gradient, n, []( auto x, auto y ) { return x + y; } );
+                    return;
+                }
+
+                // summed over the broadcast dimensions
+                write( s.temporary_.data() );
+                value_type* partial = s.partials_[op.index_].data();
+                for ( size_t idx = 0, offset = first % period; idx < n; ++idx, offset = ( offset + 1 == period ) ? 0 : offset + 1 )
+                    partial[offset] += s.temporary_[idx];
+            }
+
+            void backward( execution_plan<Tsor>& plan )
+            {
+                if ( !fused_ )
+                {
+                    for ( auto& step : backward_steps_ )
+                        step( plan );
+                    return;
+                }
+                size_t const root = nodes_.back();
+                if ( !plan.received_[root] )
+                    return;
+
+                gradients_.resize( externals_.size() );
+                for ( auto idx : range( externals_.size() ) )
+                {
+                    gradients_[idx].resize( plan.outputs_[externals_[idx]].shape() );
+                    if ( periods_[idx] != size_ )
+                        std::fill_n( gradients_[idx].data(), periods_[idx], value_type{0} );
+                }
+
+                Tsor const& grad = plan.gradients_[root];
+                value_type const seed = reduction() ? grad[0] * kernels_.back()->backward_scale_( shape_ ) : value_type{0};
+                std::mutex mutex;
+                std::vector<std::pair<size_t, scratch>> tasks; // their partials summed in order, their scratches given back then
+                vmath::vmath_private::for_each_range( size_, [&]( size_t first, size_t last )
+                {
+                    scratch s = take_scratch( mutex );
+                    for ( auto idx : range( externals_.size() ) )
+                        if ( periods_[idx] != size_ )
+                            s.partials_[idx].assign( periods_[idx], value_type{0} );
+
+                    for ( size_t block = first; block < last; block += block_size )
+                    {
+                        size_t const n = std::min( block_size, last - block );
+                        run_block( plan, s, block, n, false ); // the output of the root read from `output_`
+                        std::fill( s.assigned_.begin(), s.assigned_.end(), 0 );
+                        std::fill( s.external_assigned_.begin(), s.external_assigned_.end(), 0 );
+
+                        size_t idx = nodes_.size() - 1;
+                        if ( reduction() )
+                            deliver( s, operands_[idx][0], block, n, [&]( value_type* ans ) { std::fill_n( ans, n, seed ); } );
+                        else
+                            for ( auto k : range( operands_[idx].size() ) )
+                                deliver( s, operands_[idx][k], block, n, [&]( value_type* ans )
+                                {
+                                    kernels_[idx]->backward_( inputs_of( s, idx ), output_.data() + block, grad.data() + block, k, ans, n );
+                                } );
+
+                        // every operator but the root read once, by an operator after it
+                        while ( idx-- > 0 )
+                            for ( auto k : range( operands_[idx].size() ) )
+                                deliver( s, operands_[idx][k], block, n, [&]( value_type* ans )
+                                {
+                                    value_type const* gradient = s.gradients_.data() + block_size * idx;
+                                    kernels_[idx]->backward_( inputs_of( s, idx ), register_of( s, idx ), gradient, k, ans, n );
+                                } );
+                    }
+
+                    std::lock_guard<std::mutex> lock( mutex );
+                    tasks.emplace_back( first, std::move( s ) );
+                } );
+
+                std::sort( tasks.begin(), tasks.end(), []( auto const& a, auto const& b ) { return a.first < b.first; } );
+                for ( auto& [first, s] : tasks )
+                {
+                    for ( auto idx : range( externals_.size() ) )
+                        if ( periods_[idx] != size_ )
+                            vectorized_map( gradients_[idx].data(), s.partials_[idx].data(), gradients_[idx].data(), periods_[idx], []( auto x, auto y ) { return x + y; } );
+                    scratches_.push_back( std::move( s ) );
+                }
+
+                for ( auto idx : range( externals_.size() ) )
+                    plan.accumulate( externals_[idx], gradients_[idx] );
+            }
+        }; // struct fused_chain
+
+        // the chains of an `execution_plan`, see `fuse_elementwise`
+        template< Tensor Tsor >
+        void fuse( execution_plan<Tsor>& plan )
+        {
+            size_t const n = plan.size();
+            if ( plan.forward_steps_.size() != n ) // fused already
+                return;
+
+            // the distinct nodes reading every node, the inputs of a node numbered before it
+            std::vector<std::vector<size_t>> consumers( n );
+            for ( auto node : range( n ) )
+                for ( auto input : plan.inputs_[node] )
+                    if ( consumers[input].empty() || consumers[input].back() != node )
+                        consumers[input].push_back( node );
+
+            auto const& known = [&plan]( size_t node )
+            {
+                auto const& shape = plan.shapes_[node];
+                return std::find( shape.begin(), shape.end(), -1UL ) == shape.end();
+            };
+
+            // the operators inside a chain, not its roots
+            std::vector<char> inner( n, 0 );
+            for ( auto node : range( n ) )
+            {
+                auto const& kernel = plan.kernels_[node];
+                if ( !kernel || kernel->reduction_ || node + 1 == n || consumers[node].size() != 1 )
+                    continue;
+                size_t const consumer = consumers[node][0];
+                if ( !plan.kernels_[consumer] )
+                    continue;
+                if ( !plan.kernels_[consumer]->reduction_ && known( node ) && known( consumer ) && plan.shapes_[node] != plan.shapes_[consumer] )
+                    continue;
+                inner[node] = 1;
+            }
+
+            std::vector<std::shared_ptr<fused_chain<Tsor>>> chains( n ); // at their roots
+            for ( auto root : range( n ) )
+            {
+                if ( !plan.kernels_[root] || inner[root] )
+                    continue;
+
+                std::vector<size_t> nodes{ root };
+                for ( size_t idx = 0; idx < nodes.size(); ++idx )
+                    for ( auto input : plan.inputs_[nodes[idx]] )
+                        if ( inner[input] && std::find( nodes.begin(), nodes.end(), input ) == nodes.end() )
+                            nodes.push_back( input );
+                if ( nodes.size() < 2 )
+                    continue;
+                std::sort( nodes.begin(), nodes.end() );
+
+                auto chain = std::make_shared<fused_chain<Tsor>>();
+                chain->nodes_ = nodes;
+                for ( auto node : nodes )
+                {
+                    chain->kernels_.push_back( plan.kernels_[node] );
+                    std::vector<operand> operands;
+                    for ( auto input : plan.inputs_[node] )
+                    {
+                        if ( auto itor = std::find( nodes.begin(), nodes.end(), input ); itor != nodes.end() )
+                        {
+                            operands.push_back( { false, static_cast<size_t>( std::distance( nodes.begin(), itor ) ) } );
+                            continue;
+                        }
+                        auto itor = std::find( chain->externals_.begin(), chain->externals_.end(), input );
+                        if ( itor == chain->externals_.end() )
+                            itor = chain->externals_.insert( itor, input );
+                        operands.push_back( { true, static_cast<size_t>( std::distance( chain->externals_.begin(), itor ) ) } );
+                    }
+                    chain->operands_.push_back( operands );
+                    chain->forward_steps_.push_back( plan.forward_steps_[node] );
+                }
+                for ( auto itor = nodes.rbegin(); itor != nodes.rend(); ++itor )
+                    chain->backward_steps_.push_back( plan.backward_steps_[n - 1 - *itor] );
+                chains[root] = chain;
+                plan.fused_.push_back( nodes );
+            }
+
+            std::vector<char> skipped( n, 0 ); // the operators inside the fused chains
+            for ( auto const& nodes : plan.fused_ )
+                std::for_each( nodes.begin(), nodes.end() - 1, [&skipped]( size_t node ) { skipped[node] = 1; } );
+
+            std::vector<typename execution_plan<Tsor>::step_type> forward_steps;
+            std::vector<typename execution_plan<Tsor>::step_type> backward_steps;
+            for ( auto node : range( n ) )
+            {
+                if ( skipped[node] )
+                    continue;
+                if ( auto const& chain = chains[node]; chain )
+                    forward_steps.emplace_back( [chain]( execution_plan<Tsor>& plan ) { chain->forward( plan ); } );
+                else
+                    forward_steps.emplace_back( std::move( plan.forward_steps_[node] ) );
+            }
+            for ( size_t node = n; node-- > 0; )
+            {
+                if ( skipped[node] )
+                    continue;
+                if ( auto const& chain = chains[node]; chain )
+                    backward_steps.emplace_back( [chain]( execution_plan<Tsor>& plan ) { chain->backward( plan ); } );
+                else
+                    backward_steps.emplace_back( std::move( plan.backward_steps_[n - 1 - node] ) );
+            }
+            plan.forward_steps_.swap( forward_steps );
+            plan.backward_steps_.swap( backward_steps );
+        }
+
+    }//namespace elementwise_fusion_private
+
+    ///
+    /// @brief Fuses the chains of elementwise operators of an `execution_plan`, each running as a single loop over blocks of elements.
+    ///
+    /// A chain is a tree of operators with an elementwise kernel, see `with_elementwise_kernel`, every one of them but its root read
+    /// only by the operator after it in the chain, such as the `plus`, `square` and `mean_reduce` of `mse`. The root may also be a
+    /// reduction, as `sum_reduce` or `mean_reduce`. The nodes read from out of a chain, its externals, may be broadcast to it, as
+    /// the bias of `relu( x*w + b )`.
+    ///
+    /// A fused chain computes its outputs in blocks of 1024 elements, the inputs of every block read once from the externals and the
+    /// outputs of all but the root kept in the cache, and writes only the output of its root; its backward pass recomputes the blocks
+    /// and writes only the gradients of its externals. The operators inside a chain are not given outputs or gradients in the plan,
+    /// neither are their states written. The scratch buffers of the blocks are kept by the chain, allocated in its first passes only.
+    /// A chain runs its unfused steps in a pass when the shapes of its externals do not fit, such as two operands broadcast to each other.
+    ///
+    /// `session::plan` fuses the plans it compiles. The plan is to be fused once, as compiled.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto x = place_holder<tensor<float>>{};
+    /// auto w = variable{ random<float>( {784, 128} ) };
+    /// auto b = variable{ zeros<float>( {1, 128} ) };
+    /// auto plan = compile_plan( relu( x * w + b ) );
+    /// fuse_elementwise( plan ); // a chain of the plus and the relu, reading the product and b
+    /// @endcode
+    ///
+    template< Tensor Tsor >
+    void fuse_elementwise( execution_plan<Tsor>& plan )
+    {
+        typedef typename Tsor::value_type value_type;
+        if constexpr ( std::is_same_v<value_type, float> || std::is_same_v<value_type, double> ) // the only operators with elementwise kernels
+            elementwise_fusion_private::fuse( plan );
+    }
+
+}//namespace ceras
+
+#endif//ELEMENTWISE_FUSION_HPP_INCLUDED_KTWMZQHDRXNAJOYEBVLGPUSCFIKTWMZQHDRXNAJOYEBVLGPUSCFI
+
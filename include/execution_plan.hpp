@@ -0,0 +1,294 @@
+#ifndef EXECUTION_PLAN_HPP_INCLUDED_QDKWNRZBHTXLMAOYVGEPSCUFJIQDKWNRZBHTXLMAOYVGEPSCUFJI
+#define EXECUTION_PLAN_HPP_INCLUDED_QDKWNRZBHTXLMAOYVGEPSCUFJIQDKWNRZBHTXLMAOYVGEPSCUFJI
+
+#include "./includes.hpp"
+#include "./tensor.hpp"
+#include "./operation.hpp"
+#include "./utils/better_assert.hpp"
+
+namespace ceras
+{
+
+    ///
+    /// @brief A flat schedule of an expression, see `compile_plan`.
+    ///
+    /// The nodes of the expression -- its operators, variables, place holders and constants, each counted once however many times
+    /// it appears in the expression -- are numbered densely in a topological order, every node after the nodes it reads and the
+    /// expression itself last. A forward pass is a loop over `forward_steps_`, a step per node in this order; a backward pass is a
+    /// loop over `backward_steps_`, in the reverse order, the gradients a node gets from the nodes reading it summed before its
+    /// backward action runs. A chain of elementwise operators fused by `fuse_elementwise` takes a single step, that of its root.
+    ///
+    /// The steps write the inputs and the output of an operator to its state, where its `backward` finds them, as a `forward`
+    /// through the session would. They refer to the states of the operators without owning them, the expression compiled
+    /// outliving its plan; the plan of an operator run by a session is kept in the state of the operator.
+    ///
+    template< Tensor Tsor >
+    struct execution_plan
+    {
+        typedef Tsor tensor_type;
+        typedef typename tensor_type::value_type value_type;
+        typedef std::function<void( execution_plan& )> step_type;
+
+        std::vector<int> ids_;                      ///< the id of the expression of each node
+        std::vector<std::string> names_;            ///< the name of each node, such as "Variable" or "relu"
+        std::vector<std::vector<size_t>> inputs_;   ///< the nodes read by each node, empty for a leaf
+        std::vector<std::vector<size_t>> shapes_;   ///< the output shape of each node when compiled, `{-1UL}` if not known then
+        std::vector<std::shared_ptr<elementwise_kernel<value_type>>> kernels_; ///< the elementwise kernel of each node, null if none
+        std::vector<step_type> forward_steps_;      ///< a step per node, in topological order
+        std::vector<step_type> backward_steps_;     ///< a step per node, in reverse topological order
+        std::vector<std::vector<size_t>> fused_;    ///< the nodes of each chain fused by `fuse_elementwise`, its root last
+
+        std::vector<tensor_type> outputs_;          ///< the output of each node in the last forward pass
+        std::vector<tensor_type> gradients_;        ///< the gradient of each node in the last backward pass
+        std::vector<tensor_type> accumulations_;    ///< the buffers summing the gradients of a node read by several nodes
+        std::vector<char> received_;                ///< the nodes given a gradient in the current backward pass
+
+        ///
+        /// @brief The number of nodes.
+        ///
+        size_t size() const noexcept
+        {
+            return ids_.size();
+        }
+
+        ///
+        /// @brief The output of the expression, computed by running the forward steps.
+        ///
+        tensor_type forward()
+        {
+            for ( auto& step : forward_steps_ )
+                step( *this );
+            return outputs_.back();
+        }
+
+        ///
+        /// @brief Back-propagates `grad`, the gradient of the output of the expression, following a `forward`.
+        ///
+        void backward( tensor_type const& grad )
+        {
+            std::fill( received_.begin(), received_.end(), 0 );
+            accumulate( size()-1, grad );
+            for ( auto& step : backward_steps_ )
+                step( *this );
+        }
+
+        ///
+        /// @brief Adds `grad` to the gradient of `node`, sharing the buffer of the first gradient it gets.
+        ///
+        /// The second gradient is summed with the first into the buffer of the node in `accumulations_`, the later ones added to that buffer in place.
+        ///
+        void accumulate( size_t node, tensor_type const& grad )
+        {
+            if ( !received_[node] )
+            {
+                gradients_[node] = grad;
+                received_[node] = 1;
+                return;
+            }
+            tensor_type& sum = accumulations_[node];
+            if ( sum.empty() || gradients_[node].data() != sum.data() )
+            {
+                add( gradients_[node], grad, sum ); // the destination of `add` must not share the buffer of an input
+                gradients_[node] = sum;
+                return;
+            }
+            better_assert( grad.shape() == sum.shape(), "execution_plan::accumulate: gradient shape mismatch." );
+            for_each( grad.begin(), grad.end(), sum.begin(), []( auto g, auto& v ) noexcept { v += g; } );
+        }
+
+        // a node without steps yet, returning its index
+        size_t add_node( int id, std::string const& name, std::vector<size_t> const& inputs, std::vector<size_t> const& shape,
+                         std::shared_ptr<elementwise_kernel<value_type>> const& kernel = {} )
+        {
+            ids_.push_back( id );
+            names_.push_back( name );
+            inputs_.push_back( inputs );
+            shapes_.push_back( shape );
+            kernels_.push_back( kernel );
+            outputs_.emplace_back();
+            gradients_.emplace_back();
+            accumulations_.emplace_back();
+            received_.push_back( 0 );
+            return size() - 1;
+        }
+    }; // struct execution_plan
+
+    namespace execution_plan_private
+    {
+
+        template< Tensor Tsor >
+        struct compiler
+        {
+            execution_plan<Tsor>& plan_;
+            std::unordered_map<int, size_t> nodes_; // the node of every id met, used only while compiling
+
+            // the node of an expression, numbering it after its inputs the first time it is met
+            template< Expression Ex >
+            size_t visit( Ex const& ex )
+            {
+                if ( auto itor = nodes_.find( ex.id() ); itor != nodes_.end() )
+                    return (*itor).second;
+                size_t const node = add( ex );
+                nodes_.emplace( ex.id(), node );
+                return node;
+            }
+
+            template< Expression Ex > requires Unary_Operator<Ex>
+            size_t add( Ex const& ex )
+            {
+                size_t const input = visit( ex.op() );
+                std::vector<size_t> shape{ -1UL };
+                if ( known( input ) )
+                    shape = ex.output_shape_calculator()( plan_.shapes_[input] );
+                size_t const node = plan_.add_node( ex.id(), ex.name(), {input}, shape, ex.state_->elementwise_ );
+                plan_.forward_steps_.emplace_back( [state=ex.state_.get(), node, input]( execution_plan<Tsor>& plan )
+                {
+                    auto& s = *state;
+                    s.input_data_ = plan.outputs_[input];
+                    s.output_data_ = s.forward_action_( s.input_data_ );
+                    plan.outputs_[node] = s.output_data_;
+                } );
+                plan_.backward_steps_.emplace_back( [state=ex.state_.get(), node, input]( execution_plan<Tsor>& plan )
+                {
+                    if ( !plan.received_[node] )
+                        return;
+                    auto& s = *state;
+                    plan.accumulate( input, s.backward_action_( s.input_data_, s.output_data_, plan.gradients_[node] ) );
+                } );
+                return node;
+            }
+
+            template< Expression Ex > requires Binary_Operator<Ex>
+            size_t add( Ex const& ex )
+            {
+                typedef std::remove_cvref_t<decltype( ex.lhs_op() )> lhs_type;
+                typedef std::remove_cvref_t<decltype( ex.rhs_op() )> rhs_type;
+                static_assert( !(is_value_v<lhs_type> && is_value_v<rhs_type>), "Not valid for two values" );
+
+                // a value is not a node, but a tensor of the shape of the other operand made at every pass
+                size_t const lhs = visit_operand( ex.lhs_op() );
+                size_t const rhs = visit_operand( ex.rhs_op() );
+                std::vector<size_t> inputs;
+                for ( size_t input : { lhs, rhs } )
+                    if ( input != none )
+                        inputs.push_back( input );
+                // as `binary_operator::shape`, from the shapes of the operands instead of walking them again
+                std::vector<size_t> shape{ -1UL };
+                if constexpr ( is_value_v<lhs_type> )
+                    shape = plan_.shapes_[rhs];
+                else if constexpr ( is_value_v<rhs_type> )
+                    shape = plan_.shapes_[lhs];
+                else if ( known( lhs ) && known( rhs ) )
+                    shape = ex.output_shape_calculator()( plan_.shapes_[lhs], plan_.shapes_[rhs] );
+                size_t const node = plan_.add_node( ex.id(), ex.name(), inputs, shape, ex.state_->elementwise_ );
+
+                plan_.forward_steps_.emplace_back( [state=ex.state_.get(), node, lhs, rhs]( execution_plan<Tsor>& plan )
+                {
+                    auto& s = *state;
+                    if constexpr ( is_value_v<lhs_type> )
+                    {
+                        s.rhs_input_data_ = plan.outputs_[rhs];
+                        s.lhs_input_data_ = s.lhs_op_.forward( s.rhs_input_data_ );
+                    }
+                    else if constexpr ( is_value_v<rhs_type> )
+                    {
+                        s.lhs_input_data_ = plan.outputs_[lhs];
+                        s.rhs_input_data_ = s.rhs_op_.forward( s.lhs_input_data_ );
+                    }
+                    else
+                    {
+                        s.lhs_input_data_ = plan.outputs_[lhs];
+                        s.rhs_input_data_ = plan.outputs_[rhs];
+                    }
+                    s.output_data_ = s.forward_action_( s.lhs_input_data_, s.rhs_input_data_ );
+                    plan.outputs_[node] = s.output_data_;
+                } );
+                plan_.backward_steps_.emplace_back( [state=ex.state_.get(), node, lhs, rhs]( execution_plan<Tsor>& plan )
+                {
+                    if ( !plan.received_[node] )
+                        return;
+                    auto& s = *state;
+                    auto const& [lhs_gradient, rhs_gradient] = s.backward_action_( s.lhs_input_data_, s.rhs_input_data_, s.output_data_, plan.gradients_[node] );
+                    if constexpr ( !is_value_v<lhs_type> )
+                        plan.accumulate( lhs, lhs_gradient );
+                    if constexpr ( !is_value_v<rhs_type> )
+                        plan.accumulate( rhs, rhs_gradient );
+                } );
+                return node;
+            }
+
+            template< Expression Ex > requires Variable<Ex>
+            size_t add( Ex const& ex )
+            {
+                size_t const node = plan_.add_node( ex.id(), ex.name(), {}, ex.shape() );
+                plan_.forward_steps_.emplace_back( [v=ex, node]( execution_plan<Tsor>& plan ) mutable { plan.outputs_[node] = v.forward(); } );
+                plan_.backward_steps_.emplace_back( [v=ex, node]( execution_plan<Tsor>& plan ) mutable
+                {
+                    if ( plan.received_[node] )
+                        v.backward( plan.gradients_[node] );
+                } );
+                return node;
+            }
+
+            template< Expression Ex > requires Place_Holder<Ex> || Constant<Ex>
+            size_t add( Ex const& ex )
+            {
+                size_t const node = plan_.add_node( ex.id(), ex.name(), {}, ex.shape() );
+                plan_.forward_steps_.emplace_back( [leaf=ex, node]( execution_plan<Tsor>& plan ) { plan.outputs_[node] = leaf.forward(); } );
+                plan_.backward_steps_.emplace_back( []( execution_plan<Tsor>& ) {} );
+                return node;
+            }
+
+            static constexpr size_t none = -1UL; // the operand of a value
+
+            // if the shape of a node is known, the shape calculators of the operators asserting on an unknown dimension
+            bool known( size_t node ) const
+            {
+                auto const& shape = plan_.shapes_[node];
+                return std::find( shape.begin(), shape.end(), -1UL ) == shape.end();
+            }
+
+            template< typename Ex >
+            size_t visit_operand( Ex const& ex )
+            {
+                if constexpr ( is_value_v<Ex> )
+                    return none;
+                else
+                    return visit( ex );
+            }
+        }; // struct compiler
+
+    }//namespace execution_plan_private
+
+    ///
+    /// @brief Compiles an expression to an `execution_plan`, walking it once.
+    ///
+    /// The plan replays the expression with a loop over a vector of steps, in place of the recursive `forward` of the operators
+    /// looking their outputs up in the session to find the nodes met already. `session::run` compiles an operator the first time it
+    /// runs it and replays its plan from then on, and the `backward` of an operator runs the backward steps of its plan.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto x = place_holder<tensor<float>>{};
+    /// auto w = variable{ random<float>( {784, 10} ) };
+    /// auto y = sigmoid( x * w ) + x * w; // the product read by both sigmoid and the plus
+    /// auto plan = compile_plan( y ); // 5 nodes: x, w, the product, sigmoid and the plus
+    /// x.bind( images );
+    /// auto const& output = plan.forward();
+    /// plan.backward( ones_like( output ) ); // the product back-propagating the sum of its two gradients
+    /// @endcode
+    ///
+    template< Expression Ex >
+    auto compile_plan( Ex const& ex )
+    {
+        typedef std::remove_cv_t<decltype( std::declval<Ex&>().forward() )> tensor_type;
+        execution_plan<tensor_type> ans;
+        execution_plan_private::compiler<tensor_type>{ ans, {} }.visit( ex );
+        std::reverse( ans.backward_steps_.begin(), ans.backward_steps_.end() );
+        return ans;
+    }
+
+}//namespace ceras
+
+#endif//EXECUTION_PLAN_HPP_INCLUDED_QDKWNRZBHTXLMAOYVGEPSCUFJIQDKWNRZBHTXLMAOYVGEPSCUFJI
+
@@ -14,9 +14,30 @@ namespace ceras
 {
 
 
+    namespace layer_private
+    {
+        // the tensor type an expression evaluates to, `tensor<bfloat16>` in a model built on an `Input<bfloat16>`
+        template< Expression Ex >
+        using tensor_type_of = std::remove_cv_t<decltype(std::declval<Ex>().forward())>;
+    }
+
+    ///
+    /// @brief Input layer, a place holder for the tensors of type `tensor<T>` fed to the model.
+    ///
+    /// The layers on an input of `bfloat16` or `float16` create their weights and cache their activations in the same 16-bit
+    /// type, taking half the memory, while their kernels compute in float, see './utils/half_float.hpp'.
+    ///
+    /// Example code:
+    ///
+    /// \code{.cpp}
+    /// auto x = Input<bfloat16>( {224, 224, 3} );
+    /// auto y = Conv2D( 64, {3, 3}, "same" )( x ); // bfloat16 weights and activations
+    /// \endcode
+    ///
+    template< typename T = float >
     inline auto Input( std::vector<size_t> const& input_shape = {-1UL} )
     {
-        return place_holder<tensor<float>>{ input_shape };
+        return place_holder<tensor<T>>{ input_shape };
     }
 
     ///
@@ -67,8 +88,10 @@ namespace ceras
             size_t const dilation_row = dilations[0];
             size_t const dilation_col = dilations.size() == 2 ? dilations[1] : dilations[0];
             //size_t const stride_y = strides[1];
-            auto w = variable<tensor<float>>{ glorot_uniform<float>({output_channels, kernel_size_x, kernel_size_y, input_channels}), kernel_regularizer_l1, kernel_regularizer_l2 };
-            auto b = variable<tensor<float>>{ zeros<float>({1, 1, output_channels}), bias_regularizer_l1, bias_regularizer_l2, use_bias };
+            typedef layer_private::tensor_type_of<Ex> tensor_type;
+            typedef typename tensor_type::value_type value_type;
+            auto w = variable<tensor_type>{ glorot_uniform<float>({output_channels, kernel_size_x, kernel_size_y, input_channels}).as_type<value_type>(), kernel_regularizer_l1, kernel_regularizer_l2 };
+            auto b = variable<tensor_type>{ zeros<value_type>({1, 1, output_channels}), bias_regularizer_l1, bias_regularizer_l2, use_bias };
             return conv2d( input_x, input_y, stride_x, stride_y, dilation_row, dilation_col, padding )( ex, w ) + b;
         };
     }
@@ -115,8 +138,10 @@ namespace ceras
             size_t const stride_y = strides.size() == 2 ? strides[1] : strides[0];
             size_t const dilation_row = dilations[0];
             size_t const dilation_col = dilations.size() == 2 ? dilations[1] : dilations[0];
-            auto w = variable<tensor<float>>{ glorot_uniform<float>({output_channels, kernel_size_x, kernel_size_y, input_channels}), kernel_regularizer_l1, kernel_regularizer_l2 };
-            auto b = variable<tensor<float>>{ zeros<float>({1, 1, output_channels}), bias_regularizer_l1, bias_regularizer_l2, use_bias };
+            typedef layer_private::tensor_type_of<Ex> tensor_type;
+            typedef typename tensor_type::value_type value_type;
+            auto w = variable<tensor_type>{ glorot_uniform<float>({output_channels, kernel_size_x, kernel_size_y, input_channels}).as_type<value_type>(), kernel_regularizer_l1, kernel_regularizer_l2 };
+            auto b = variable<tensor_type>{ zeros<value_type>({1, 1, output_channels}), bias_regularizer_l1, bias_regularizer_l2, use_bias };
             return general_conv2d( stride_x, stride_y, dilation_row, dilation_col, padding )( ex, w ) + b;
         };
     }
@@ -176,8 +201,10 @@ namespace ceras
             size_t const stride_y = strides.size() == 2 ? strides[1] : strides[0];
             size_t const dilation_row = dilations[0];
             size_t const dilation_col = dilations.size() == 2 ? dilations[1] : dilations[0];
-            auto w = variable<tensor<float>>{ glorot_uniform<float>({output_channels, kernel_size_x, kernel_size_y, input_channels}), kernel_regularizer_l1, kernel_regularizer_l2 };
-            auto b = variable<tensor<float>>{ zeros<float>({1, 1, output_channels}), bias_regularizer_l1, bias_regularizer_l2, use_bias };
+            typedef layer_private::tensor_type_of<Ex> tensor_type;
+            typedef typename tensor_type::value_type value_type;
+            auto w = variable<tensor_type>{ glorot_uniform<float>({output_channels, kernel_size_x, kernel_size_y, input_channels}).as_type<value_type>(), kernel_regularizer_l1, kernel_regularizer_l2 };
+            auto b = variable<tensor_type>{ zeros<value_type>({1, 1, output_channels}), bias_regularizer_l1, bias_regularizer_l2, use_bias };
             return conv2d_transpose( kernel_size_x, kernel_size_y, stride_x, stride_y, dilation_row, dilation_col, padding )( ex, w ) + b;
         };
     }
@@ -208,8 +235,10 @@ namespace ceras
     {
         return [=]<Expression Ex>( Ex const& ex )
         {
-            auto w = variable<tensor<float>>{ glorot_uniform<float>({input_size, output_size}), kernel_regularizer_l1, kernel_regularizer_l2 };
-            auto b = variable<tensor<float>>{ zeros<float>({1, output_size}), bias_regularizer_l1, bias_regularizer_l2, use_bias }; // if use_baias, then b is trainable; otherwise, non-trainable.
+            typedef layer_private::tensor_type_of<Ex> tensor_type;
+            typedef typename tensor_type::value_type value_type;
+            auto w = variable<tensor_type>{ glorot_uniform<float>({input_size, output_size}).as_type<value_type>(), kernel_regularizer_l1, kernel_regularizer_l2 };
+            auto b = variable<tensor_type>{ zeros<value_type>({1, output_size}), bias_regularizer_l1, bias_regularizer_l2, use_bias }; // if use_baias, then b is trainable; otherwise, non-trainable.
             return ex * w + b;
         };
     }
@@ -223,24 +252,28 @@ namespace ceras
     /// @param kernel_regularizer_l2 L2 regularizer for the kernel. Defaults to `0.0f`.
     /// @param bias_regularizer_l1 L1 regularizer for the bias vector. Defaults to `0.0f`.
     /// @param bias_regularizer_l2 L2 regularizer for the bias vector. Defaults to `0.0f`.
+    /// @param activation Activation fused into the layer, one of `linear`, `relu`, `sigmoid` and `tanh`. Defaults to `linear`.
     ///
     /// Example code:
     ///
     /// \code{.cpp}
     /// auto x = Input{ {28*28,} };
     /// auto y = Dense( 10, )( x );
+    /// auto z = Dense( 10, true, 0.0f, 0.0f, 0.0f, 0.0f, "relu" )( x ); // same as `ReLU( Dense( 10 )( x ) )`, in a single pass
     /// auto m = model{ x, y };
     /// \endcode
     ///
-    inline auto Dense( size_t output_size, bool use_bias=true, float kernel_regularizer_l1=0.0f, float kernel_regularizer_l2=0.0f, float bias_regularizer_l1=0.0f, float bias_regularizer_l2=0.0f )
+    inline auto Dense( size_t output_size, bool use_bias=true, float kernel_regularizer_l1=0.0f, float kernel_regularizer_l2=0.0f, float bias_regularizer_l1=0.0f, float bias_regularizer_l2=0.0f, std::string const& activation="linear" )
     {
         return [=]<Expression Ex>( Ex const& ex )
         {
             better_assert( ex.shape().size() >= 1, fmt::format("Error: expecting shape 2D, but got {}D of {}.", ex.shape().size(), ex.shape()) );
             size_t const input_size = *(ex.shape().rbegin());
-            auto w = variable<tensor<float>>{ glorot_uniform<float>({input_size, output_size}), kernel_regularizer_l1, kernel_regularizer_l2 };
-            auto b = variable<tensor<float>>{ zeros<float>({1, output_size}), bias_regularizer_l1, bias_regularizer_l2, use_bias }; // if use_baias, then b is trainable; otherwise, non-trainable.
-            return ex * w + b;
+            typedef layer_private::tensor_type_of<Ex> tensor_type;
+            typedef typename tensor_type::value_type value_type;
+            auto w = variable<tensor_type>{ glorot_uniform<float>({input_size, output_size}).as_type<value_type>(), kernel_regularizer_l1, kernel_regularizer_l2 };
+            auto b = variable<tensor_type>{ zeros<value_type>({1, output_size}), bias_regularizer_l1, bias_regularizer_l2, use_bias }; // if use_baias, then b is trainable; otherwise, non-trainable.
+            return dense( activation )( ex, w, b );
         };
     }
 
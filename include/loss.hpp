@@ -61,11 +61,12 @@ namespace ceras
         struct cross_entropy_loss_context
         {
             template< std::floating_point T >
-            auto make_forward( T label_smoothing_factor ) const noexcept
+            auto make_forward( T label_smoothing_factor, std::shared_ptr<std::any> forward_cache ) const noexcept
             {
-                return [label_smoothing_factor]<Tensor Tsor>( Tsor const& ground_truth_input, Tsor const& prediction_input ) noexcept
+                return [label_smoothing_factor, forward_cache]<Tensor Tsor>( Tsor const& ground_truth_input, Tsor const& prediction_input ) noexcept
                 {
-                   Tsor sm = softmax( prediction_input );
+                   Tsor& sm = context_cast<Tsor>( forward_cache );
+                   softmax( prediction_input, sm );
                    typedef typename Tsor::value_type value_type;
                    typename Tsor::value_type ans{0};
                    size_t const n = *(ground_truth_input.shape().rbegin());
@@ -84,7 +85,7 @@ namespace ceras
             }
 
             template< std::floating_point T >
-            auto make_backward( T label_smoothing_factor) const noexcept
+            auto make_backward( T label_smoothing_factor, std::shared_ptr<std::any> backward_cache_lhs, std::shared_ptr<std::any> backward_cache_rhs ) const noexcept
             {
                 return [=]<Tensor Tsor>( Tsor const& ground_truth_input, Tsor const& prediction_input, [[maybe_unused]]Tsor const& output_data, [[maybe_unused]]Tsor const& grad ) noexcept
                 {
@@ -96,19 +97,22 @@ namespace ceras
                    value_type const _c0 = label_smoothing_factor / (n-1);
                    value_type const _c1 = value_type{1} - label_smoothing_factor;
 
-                   Tsor ground_truth_gradient = ground_truth_input;
+                   Tsor& ground_truth_gradient = context_cast<Tsor>( backward_cache_lhs );
+                   ground_truth_gradient.resize( ground_truth_input.shape() );
+                   for_each( ground_truth_input.begin(), ground_truth_input.end(), ground_truth_gradient.begin(), [factor]( auto x, auto& y ){ y = x * factor; } );
 
                    //Tsor sm = softmax( prediction_input ) - ground_truth_input;
                    //return std::make_tuple( ground_truth_gradient*factor, sm*factor );
 
-                   Tsor sm = softmax( prediction_input );
+                   Tsor& sm = context_cast<Tsor>( backward_cache_rhs );
+                   softmax( prediction_input, sm );
                    for ( auto idx : range( ground_truth_input.size() ) )
                    {
-                       value_type const v = ground_truth_gradient[idx] > eps ? _c1 : _c0;
+                       value_type const v = ground_truth_input[idx] > eps ? _c1 : _c0;
                        sm[idx] = factor * (sm[idx] - v );
                    }
 
-                   return std::make_tuple( ground_truth_gradient*factor, sm );
+                   return std::make_tuple( ground_truth_gradient, sm );
                 };
             }
 
@@ -129,7 +133,10 @@ namespace ceras
     template < Expression Lhs_Expression, Expression Rhs_Expression, std::floating_point F=float >
     auto constexpr cross_entropy_loss( Lhs_Expression const& lhs_ex, Rhs_Expression const& rhs_ex, F label_smoothing_factor=0.0 ) noexcept
     {
-        return make_binary_operator( cross_entropy_loss_context{}.make_forward( label_smoothing_factor ), cross_entropy_loss_context{}.make_backward( label_smoothing_factor ), "CrossEntropyLoss" )( lhs_ex, rhs_ex );
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
+        return make_binary_operator( cross_entropy_loss_context{}.make_forward( label_smoothing_factor, forward_cache ), cross_entropy_loss_context{}.make_backward( label_smoothing_factor, backward_cache_lhs, backward_cache_rhs ), "CrossEntropyLoss" )( lhs_ex, rhs_ex );
     }
 
     template < Expression Lhs_Expression, Expression Rhs_Expression >
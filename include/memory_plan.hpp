@@ -0,0 +1,248 @@
+#ifndef MEMORY_PLAN_HPP_INCLUDED_VJXQEWTKNOBRUHDMLZGAIYFPSCVJXQEWTKNOBRUHDMLZGAIYFPSC
+#define MEMORY_PLAN_HPP_INCLUDED_VJXQEWTKNOBRUHDMLZGAIYFPSCVJXQEWTKNOBRUHDMLZGAIYFPSC
+
+#include "./includes.hpp"
+#include "./config.hpp"
+#include "./tensor.hpp"
+#include "./execution_plan.hpp"
+
+namespace ceras
+{
+
+    ///
+    /// @brief The layout of the activations and the gradients of an `execution_plan` in a single arena, see `plan_memory` and `allocate_memory`.
+    ///
+    struct memory_plan
+    {
+        ///
+        /// @brief A buffer of the plan, live from the step it is written in to the last step reading it.
+        ///
+        /// The forward pass of a plan of `n` nodes takes the steps `0` to `n-1`, the node `i` computed in step `i`; the backward pass
+        /// takes the steps `n` to `2n-1`, the node `i` back-propagating in step `2n-1-i`.
+        ///
+        struct buffer
+        {
+            size_t node_;       ///< the node of the buffer
+            bool gradient_;     ///< the gradient of the node if true, its output otherwise
+            size_t size_;       ///< the bytes of the buffer, a multiple of `memory_alignment`
+            size_t first_;      ///< the step writing the buffer
+            size_t last_;       ///< the last step reading the buffer
+            size_t offset_;     ///< the offset of the buffer in the arena, in bytes
+            std::vector<std::pair<size_t, bool>> aliases_; ///< the other outputs and gradients sharing the buffer, as `node_` and `gradient_`
+        };
+
+        std::vector<buffer> buffers_;
+        size_t arena_size_ = 0;     ///< the planned peak, the bytes of the arena
+        size_t naive_size_ = 0;     ///< the naive peak, the bytes of all the buffers each allocated for itself
+        std::shared_ptr<std::byte[]> arena_; ///< the arena holding the buffers, allocated by `allocate_memory`, null for a plan only
+
+        ///
+        /// @brief If two buffers are live in a same step.
+        ///
+        static bool overlap( buffer const& a, buffer const& b ) noexcept
+        {
+            return a.first_ <= b.last_ && b.first_ <= a.last_;
+        }
+    }; // struct memory_plan
+
+    ///
+    /// @brief Plans the memory of the activations, and of the gradients if `training`, of an `execution_plan`.
+    ///
+    /// The output of an operator is live from its forward step to the last step reading it: the forward step of its last reader
+    /// in inference, its own backward step in training, its backward action reading both its input and its output. The gradient
+    /// of a node is live from the backward step of the first node back-propagating to it to its own backward step. The data of the
+    /// leaves, the weights and the inputs, are not planned, nor are the output of the expression, returned to the caller, and its
+    /// gradient, given by the caller.
+    ///
+    /// The operators inside the chains fused by `fuse_elementwise` have no buffers, the nodes they read being read by the roots of
+    /// their chains.
+    ///
+    /// Once the plan has run, the outputs and the gradients sharing a buffer -- those an operator returns as it gets them, as a
+    /// `reshape` does its input or a `plus` its gradient -- take a single buffer, live from the first to the last step of them all,
+    /// and a buffer shared with the data of a leaf or with the output of the expression, or a slice of a larger buffer, is not planned.
+    ///
+    /// The buffers are placed in decreasing size, each at the lowest offset not overlapping a buffer placed already and live in
+    /// a same step, as in the greedy-by-size planners of the inference engines.
+    ///
+    /// The sizes are those of the outputs and the gradients of the last pass of the plan, or of the shapes of the nodes when compiled if
+    /// it has not run yet, an unknown dimension counted as 1.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto x = Input( {224, 224, 3} );
+    /// auto y = ...; // vgg16
+    /// auto const& memory = plan_memory( compile_plan( y ), false );
+    /// std::cout << memory.arena_size_ << " bytes in place of " << memory.naive_size_ << std::endl;
+    /// @endcode
+    ///
+    template< Tensor Tsor >
+    memory_plan plan_memory( execution_plan<Tsor> const& plan, bool training=true )
+    {
+        typedef typename Tsor::value_type value_type;
+        size_t const n = plan.size();
+        auto const& backward_step = [n]( size_t node ) { return 2 * n - 1 - node; };
+
+        // the step of every node, that of the root of its chain for an operator inside a fused chain
+        std::vector<size_t> step( n );
+        std::iota( step.begin(), step.end(), 0UL );
+        for ( auto const& nodes : plan.fused_ )
+            for ( auto node : nodes )
+                step[node] = nodes.back();
+
+        // the last reader of every node, in topological order
+        std::vector<size_t> last_reader( n, -1UL );
+        for ( auto node : range( n ) )
+            for ( auto input : plan.inputs_[node] )
+                if ( last_reader[input] == -1UL || last_reader[input] < step[node] )
+                    last_reader[input] = step[node];
+
+        auto const& tensor_of = [&plan]( size_t node, bool gradient ) -> Tsor const& { return gradient ? plan.gradients_[node] : plan.outputs_[node]; };
+        auto const& bytes_of = [&plan, &tensor_of]( size_t node, bool gradient )
+        {
+            size_t elements = 1;
+            if ( !tensor_of( node, gradient ).empty() )
+                elements = tensor_of( node, gradient ).size();
+            else if ( !plan.outputs_[node].empty() )
+                elements = plan.outputs_[node].size();
+            else
+                for ( auto dim : plan.shapes_[node] )
+                    elements *= ( dim == -1UL ) ? 1UL : dim;
+            return ( elements * sizeof( value_type ) + memory_alignment - 1 ) / memory_alignment * memory_alignment;
+        };
+
+        // the buffers not to plan: those of the leaves, of the output of the expression and of its gradient, and those sliced
+        std::set<void const*> unplanned;
+        for ( auto node : range( n ) )
+        {
+            bool const is_root = ( node + 1 == n );
+            for ( bool gradient : { false, true } )
+            {
+                Tsor const& tsor = tensor_of( node, gradient );
+                if ( !tsor.empty() && ( ( !gradient && plan.inputs_[node].empty() ) || is_root || tsor.is_slice() ) )
+                    unplanned.insert( tsor.vector_.get() );
+            }
+        }
+
+        memory_plan ans;
+        std::map<void const*, size_t> shared; // the buffer planned for every buffer of the tensors run already
+        auto const& plan_buffer = [&]( size_t node, bool gradient, size_t first, size_t last )
+        {
+            Tsor const& tsor = tensor_of( node, gradient );
+            if ( tsor.empty() )
+            {
+                ans.buffers_.push_back( { node, gradient, bytes_of( node, gradient ), first, last, 0, {} } );
+                return;
+            }
+            if ( unplanned.contains( tsor.vector_.get() ) )
+                return;
+            if ( auto itor = shared.find( tsor.vector_.get() ); itor != shared.end() )
+            {
+                auto& current = ans.buffers_[(*itor).second];
+                current.first_ = std::min( current.first_, first );
+                current.last_ = std::max( current.last_, last );
+                current.aliases_.emplace_back( node, gradient );
+                return;
+            }
+            shared.emplace( tsor.vector_.get(), ans.buffers_.size() );
+            ans.buffers_.push_back( { node, gradient, bytes_of( node, gradient ), first, last, 0, {} } );
+        };
+
+        for ( auto node : range( n ) )
+        {
+            if ( step[node] != node ) // inside a fused chain
+                continue;
+            if ( node + 1 == n ) // the output of the expression and its gradient
+                continue;
+            if ( !plan.inputs_[node].empty() ) // the output of an operator
+                plan_buffer( node, false, node, training ? backward_step( node ) : last_reader[node] );
+            if ( training ) // the gradient of a node, written first by its last reader
+                plan_buffer( node, true, backward_step( last_reader[node] ), backward_step( node ) );
+        }
+
+        // greedy by size: the largest buffers first, each at the lowest offset fitting between the live buffers placed already
+        std::vector<size_t> order( ans.buffers_.size() );
+        std::iota( order.begin(), order.end(), 0UL );
+        std::stable_sort( order.begin(), order.end(), [&ans]( size_t a, size_t b ) { return ans.buffers_[a].size_ > ans.buffers_[b].size_; } );
+        std::vector<size_t> placed;
+        for ( auto idx : order )
+        {
+            auto& current = ans.buffers_[idx];
+            std::vector<std::pair<size_t, size_t>> taken; // the [offset, offset+size) ranges of the live buffers
+            for ( auto other : placed )
+                if ( memory_plan::overlap( current, ans.buffers_[other] ) )
+                    taken.emplace_back( ans.buffers_[other].offset_, ans.buffers_[other].offset_ + ans.buffers_[other].size_ );
+            std::sort( taken.begin(), taken.end() );
+
+            size_t offset = 0;
+            for ( auto [first, last] : taken )
+            {
+                if ( offset + current.size_ <= first )
+                    break;
+                offset = std::max( offset, last );
+            }
+            current.offset_ = offset;
+            placed.push_back( idx );
+
+            ans.arena_size_ = std::max( ans.arena_size_, offset + current.size_ );
+            ans.naive_size_ += current.size_;
+        }
+        return ans;
+    }
+
+    ///
+    /// @brief Allocates the arena planned by `plan_memory` for an `execution_plan` run already, and moves its buffers there.
+    ///
+    /// Every buffer planned takes the slot of the arena at its offset, in place of its own memory, freed: the tensors sharing it, the
+    /// cache of the operator writing it among them, keep writing to the same buffer at the next passes, now in the arena. A buffer
+    /// growing out of its slot, at a larger batch say, or replaced by an operator, goes back to the heap, the slot freed.
+    ///
+    /// The values of the buffers are not kept: this is to run between two passes, after a pass running as the next ones will, a
+    /// training step say. Planned for inference, with `training` false, the plan must not run backward any more, the outputs then
+    /// sharing their slots with the outputs read no more by the forward pass.
+    ///
+    /// The arena is freed with the last buffer in it.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto plan = compile_plan( loss );
+    /// plan.forward();
+    /// plan.backward( ones<float>( {1,} ) );
+    /// auto const& memory = allocate_memory( plan ); // the activations and the gradients in memory.arena_size_ bytes from now on
+    /// @endcode
+    ///
+    template< Tensor Tsor > requires std::same_as<typename Tsor::allocator, aligned_allocator<typename Tsor::value_type>>
+    memory_plan allocate_memory( execution_plan<Tsor>& plan, bool training=true )
+    {
+        typedef typename Tsor::value_type value_type;
+        better_assert( plan.size() && !plan.outputs_.back().empty(), "allocate_memory: expecting a plan run already." );
+
+        memory_plan ans = plan_memory( plan, training );
+
+        // the buffers freed before the arena is allocated, so that the two are not held together
+        std::vector<size_t> sizes;
+        for ( auto const& buffer : ans.buffers_ )
+        {
+            Tsor& tsor = buffer.gradient_ ? plan.gradients_[buffer.node_] : plan.outputs_[buffer.node_];
+            sizes.push_back( tsor.size() ); // 0 if not run yet
+            if ( tsor.vector_ )
+                *tsor.vector_ = typename Tsor::vector_type{};
+        }
+
+        ans.arena_ = std::shared_ptr<std::byte[]>{ static_cast<std::byte*>( ::operator new( std::max( ans.arena_size_, memory_alignment ), std::align_val_t{ memory_alignment } ) ),
+                                                   []( std::byte* p ) { ::operator delete( p, std::align_val_t{ memory_alignment } ); } };
+        for ( auto idx : range( ans.buffers_.size() ) )
+        {
+            auto const& buffer = ans.buffers_[idx];
+            if ( sizes[idx] == 0 )
+                continue;
+            Tsor& tsor = buffer.gradient_ ? plan.gradients_[buffer.node_] : plan.outputs_[buffer.node_];
+            auto slot = std::make_shared<arena_slot>( arena_slot{ ans.arena_, ans.arena_.get() + buffer.offset_, buffer.size_, false } );
+            *tsor.vector_ = typename Tsor::vector_type( sizes[idx], aligned_allocator<value_type>{ slot } );
+        }
+        return ans;
+    }
+
+}//namespace ceras
+
+#endif//MEMORY_PLAN_HPP_INCLUDED_VJXQEWTKNOBRUHDMLZGAIYFPSCVJXQEWTKNOBRUHDMLZGAIYFPSC
+
@@ -98,23 +98,11 @@ namespace ceras
             size_t const samples = *(inputs.shape().begin());
             size_t const loops = samples / batch_size;
 
-            // prepare tensor for inputs
-            std::vector<size_t> batch_input_shape = inputs.shape();
-            batch_input_shape[0] = batch_size;
-            Tsor input_samples{ batch_input_shape };
-            size_t const input_size_per_batch = input_samples.size();
-
-            // prepare tensor for outputs
-            std::vector<size_t> batch_output_shape = outputs.shape();
-            batch_output_shape[0] = batch_size;
-            Tsor output_samples{ batch_output_shape };
-            size_t const output_size_per_batch = output_samples.size();
-
-            // bind tensors to place holders
+            // bind the batches to place holders, slices sharing the buffers of the samples
             //session<Tsor> s;
             auto& s = get_default_session<Tsor>();
-            s.bind( input_place_holder_, input_samples );
-            s.bind( ground_truth_place_holder_, output_samples );
+            s.bind( input_place_holder_, slice( inputs, 0, batch_size ) );
+            s.bind( ground_truth_place_holder_, slice( outputs, 0, batch_size ) );
 
             typedef typename Tsor::value_type value_type;
             value_type validation_error = 0;
@@ -123,9 +111,9 @@ namespace ceras
 
             for ( auto l : tq::trange( loops ) )
             {
-                // feed data
-                std::copy_n( inputs.data() + l * input_size_per_batch, input_size_per_batch, input_samples.data() );
-                std::copy_n( outputs.data() + l * output_size_per_batch, output_size_per_batch, output_samples.data() );
+                // feed data, O(1)
+                s.rebind( input_place_holder_, slice( inputs, l * batch_size, (l+1) * batch_size ) );
+                s.rebind( ground_truth_place_holder_, slice( outputs, l * batch_size, (l+1) * batch_size ) );
                 // forward pass
                 auto error = s.run( loss_ ).as_scalar();
                 // in case of training split, do backpropagation
@@ -169,23 +157,11 @@ namespace ceras
             size_t const training_loops = ( 1.0 - validation_split ) * loops_per_epoch;
             size_t const validation_loops = loops_per_epoch - training_loops;
 
-            // prepare tensor for inputs
-            std::vector<size_t> batch_input_shape = inputs.shape();
-            batch_input_shape[0] = batch_size;
-            Tsor input_samples{ batch_input_shape };
-            size_t const input_size_per_batch = input_samples.size();
-
-            // prepare tensor for outputs
-            std::vector<size_t> batch_output_shape = outputs.shape();
-            batch_output_shape[0] = batch_size;
-            Tsor output_samples{ batch_output_shape };
-            size_t const output_size_per_batch = output_samples.size();
-
-            // bind tensors to place holders
+            // bind the batches to place holders, slices sharing the buffers of the samples
             //session<Tsor> s;
             auto& s = get_default_session<Tsor>();//.get();
-            s.bind( input_place_holder_, input_samples );
-            s.bind( ground_truth_place_holder_, output_samples );
+            s.bind( input_place_holder_, slice( inputs, 0, batch_size ) );
+            s.bind( ground_truth_place_holder_, slice( outputs, 0, batch_size ) );
 
             // collect training errors
             typedef typename Tsor::value_type value_type;
@@ -200,9 +176,9 @@ namespace ceras
                 value_type validation_error = 0;
                 for ( auto l : tq::trange( loops_per_epoch ) )
                 {
-                    // feed data
-                    std::copy_n( inputs.data() + l * input_size_per_batch, input_size_per_batch, input_samples.data() );
-                    std::copy_n( outputs.data() + l * output_size_per_batch, output_size_per_batch, output_samples.data() );
+                    // feed data, O(1)
+                    s.rebind( input_place_holder_, slice( inputs, l * batch_size, (l+1) * batch_size ) );
+                    s.rebind( ground_truth_place_holder_, slice( outputs, l * batch_size, (l+1) * batch_size ) );
                     // forward pass
                     auto error = s.run( loss_ ).as_scalar();
                     // in case of training split, do backpropagation
@@ -257,6 +233,25 @@ namespace ceras
             return error.as_scalar();
         }
 
+        /// `fit`, `evaluate` and `train_on_batch` on lazy element-wise expressions, such as `x/255.0f`, evaluated first.
+        template< Elementwise_Operand In, Elementwise_Operand Out, typename ... Args > requires ( Tensor_Expression<In> || Tensor_Expression<Out> )
+        auto fit( In const& inputs, Out const& outputs, Args ... args )
+        {
+            return fit( eval( inputs ), eval( outputs ), args... );
+        }
+
+        template< Elementwise_Operand In, Elementwise_Operand Out, typename ... Args > requires ( Tensor_Expression<In> || Tensor_Expression<Out> )
+        auto evaluate( In const& inputs, Out const& outputs, Args ... args )
+        {
+            return evaluate( eval( inputs ), eval( outputs ), args... );
+        }
+
+        template< Elementwise_Operand In, Elementwise_Operand Out > requires ( Tensor_Expression<In> || Tensor_Expression<Out> )
+        auto train_on_batch( In const& input, Out const& output )
+        {
+            return train_on_batch( eval( input ), eval( output ) );
+        }
+
         template< Tensor Tsor>
         auto predict( Tsor const& input_tensor )
         {
@@ -415,7 +410,7 @@ namespace ceras
         ///
         void save_weights( std::string const& file )
         {
-            auto& s = get_default_session<tensor<float>>();
+            auto& s = get_default_session<typename input_layer_type::tensor_type>();
             s.serialize( file );
         }
 
@@ -424,7 +419,7 @@ namespace ceras
         ///
         void load_weights( std::string const& file )
         {
-            auto& s = get_default_session<tensor<float>>();
+            auto& s = get_default_session<typename input_layer_type::tensor_type>();
             s.deserialize( file );
         }
 
@@ -7,6 +7,7 @@
 #include "./constant.hpp"
 #include "./value.hpp"
 #include "./session.hpp"
+#include "./quantized_tensor.hpp"
 #include "./utils/range.hpp"
 #include "./utils/debug.hpp"
 #include "./config.hpp"
@@ -43,6 +44,26 @@ namespace ceras
         }
     }; // struct identity_output_shape_calculator
 
+    ///
+    /// @brief The elementwise function of an operator, letting `fuse_elementwise` run a chain of such operators as a single loop, see './elementwise_fusion.hpp'.
+    ///
+    /// `forward_` writes `n` outputs from the `arity_` inputs of the operator, and `backward_` the gradients of its operand `operand`
+    /// from the inputs, the outputs and their gradients. A reduction outputs a single element, the sum of its inputs times
+    /// `forward_scale_`, each of its inputs getting its gradient times `backward_scale_`.
+    ///
+    template< typename T >
+    struct elementwise_kernel
+    {
+        typedef std::array<T const*, 2> inputs_type;
+
+        size_t arity_ = 1;
+        bool reduction_ = false;
+        std::function<void( inputs_type const& inputs, T* output, size_t n )> forward_;
+        std::function<void( inputs_type const& inputs, T const* output, T const* grad, size_t operand, T* ans, size_t n )> backward_;
+        std::function<T( std::vector<size_t> const& input_shape )> forward_scale_;
+        std::function<T( std::vector<size_t> const& input_shape )> backward_scale_;
+    }; // struct elementwise_kernel
+
 
 
     ///
@@ -55,6 +76,9 @@ namespace ceras
         enable_id<unary_operator<Operator, Forward_Action, Backward_Action, Output_Shape_Calculator, Serializer>, "Unary_Operator">,
         enable_unary_serializer<unary_operator<Operator, Forward_Action, Backward_Action, Output_Shape_Calculator, Serializer> >
     {
+        typedef decltype( std::declval<Forward_Action>()( std::declval<Operator>().forward() ) ) tensor_type;
+
+        // the input and the output of the last forward pass are shared by the copies of the operator, see `compile_plan` in './execution_plan.hpp'
         struct unary_operator_state
         {
             Operator op_;
@@ -62,35 +86,37 @@ namespace ceras
             Backward_Action backward_action_;
             Output_Shape_Calculator output_shape_calculator_;
             Serializer serializer_;
+            tensor_type input_data_;
+            tensor_type output_data_;
+            ceras_private::forward_cache_slot slot_; // the slot of the operator in the forward cache of the session
+            std::shared_ptr<execution_plan<tensor_type>> plan_; // the plan of the expression rooted at the operator, compiled when first run or back-propagated
+            std::shared_ptr<elementwise_kernel<typename tensor_type::value_type>> elementwise_; // set for the elementwise operators, see `with_elementwise_kernel`
         };
         std::shared_ptr<unary_operator_state> state_;
 
-        typedef decltype( std::declval<Forward_Action>()( std::declval<Operator>().forward() ) ) tensor_type;
-
-        tensor_type input_data_;
-        tensor_type output_data_;
-
         unary_operator( Operator const& op, Forward_Action const& forward_action, Backward_Action const& backward_action, Output_Shape_Calculator const& output_shape_calculator, Serializer const& serializer ) noexcept : state_{ std::make_shared<unary_operator_state>( op, forward_action, backward_action, output_shape_calculator, serializer ) } {}
 
         auto forward()
         {
             auto& sess = get_default_session<tensor_type>();
-            output_data_= sess.query_forward_cache( (*this).id() );
+            tensor_type& output_data_ = state_->output_data_;
 
-            if ( output_data_.empty() )
+            if ( !sess.query_forward_cache( state_->slot_ ) )
             {
-                input_data_ = op().forward();
-                output_data_ = forward_action()( input_data_ );
-                sess.update_forward_cache( (*this).id(), output_data_ );
+                state_->input_data_ = op().forward();
+                output_data_ = forward_action()( state_->input_data_ );
+                sess.update_forward_cache( state_->slot_ );
             }
 
             return output_data_;
         }
 
+        ///
+        /// @brief Back-propagates `grad` through the expression in reverse topological order, see `execution_plan::backward`.
+        ///
         void backward( tensor_type const& grad )
         {
-            auto const& current_gradient = backward_action()( input_data_, output_data_, grad );
-            op().backward( current_gradient );
+            get_default_session<tensor_type>().plan( *this ).backward( grad );
         }
 
         ///
@@ -106,8 +132,8 @@ namespace ceras
         Backward_Action const& backward_action() const { return state_->backward_action_; }
         Output_Shape_Calculator const& output_shape_calculator() const { return state_->output_shape_calculator_; }
         Serializer const& serializer() const { return state_->serializer_; }
-        tensor_type output_data() { return output_data_; }
-        tensor_type input_data() { return input_data_; }
+        tensor_type output_data() { return state_->output_data_; }
+        tensor_type input_data() { return state_->input_data_; }
 
         Operator& op() { return state_->op_; }
         Forward_Action& forward_action() { return state_->forward_action_; }
@@ -145,6 +171,9 @@ namespace ceras
         enable_id<binary_operator<Lhs_Operator, Rhs_Operator, Forward_Action, Backward_Action, Output_Shape_Calculator, Serializer>, "Binary Operator">,
         enable_binary_serializer<binary_operator<Lhs_Operator, Rhs_Operator, Forward_Action, Backward_Action, Output_Shape_Calculator, Serializer>>
     {
+        typedef typename tensor_deduction<Lhs_Operator, Rhs_Operator>::tensor_type tensor_type; // defined in value.hpp
+
+        // the inputs and the output of the last forward pass are shared by the copies of the operator, see `compile_plan` in './execution_plan.hpp'
         struct binary_operator_state
         {
             Lhs_Operator lhs_op_;
@@ -153,24 +182,24 @@ namespace ceras
             Backward_Action backward_action_;
             Output_Shape_Calculator output_shape_calculator_;
             Serializer serializer_;
+            tensor_type lhs_input_data_;
+            tensor_type rhs_input_data_;
+            tensor_type output_data_;
+            ceras_private::forward_cache_slot slot_; // the slot of the operator in the forward cache of the session
+            std::shared_ptr<execution_plan<tensor_type>> plan_; // the plan of the expression rooted at the operator, compiled when first run or back-propagated
+            std::shared_ptr<elementwise_kernel<typename tensor_type::value_type>> elementwise_; // set for the elementwise operators, see `with_elementwise_kernel`
         };
         std::shared_ptr<binary_operator_state> state_;
 
-        typedef typename tensor_deduction<Lhs_Operator, Rhs_Operator>::tensor_type tensor_type; // defined in value.hpp
-
-        tensor_type lhs_input_data_;
-        tensor_type rhs_input_data_;
-        tensor_type output_data_;
-
         binary_operator( Lhs_Operator const& lhs_op, Rhs_Operator const& rhs_op, Forward_Action const& forward_action, Backward_Action const& backward_action, Output_Shape_Calculator const& output_shape_calculator, Serializer const& serializer) noexcept :
             state_{ std::make_shared<binary_operator_state>(lhs_op, rhs_op, forward_action, backward_action, output_shape_calculator, serializer) } {}
 
         auto forward()
         {
             auto& sess = get_default_session<tensor_type>();
-            output_data_= sess.query_forward_cache( (*this).id() );
+            auto [lhs_input_data_, rhs_input_data_, output_data_] = std::tie( state_->lhs_input_data_, state_->rhs_input_data_, state_->output_data_ );
 
-            if ( !output_data_.empty() )
+            if ( sess.query_forward_cache( state_->slot_ ) )
                 return output_data_;
 
             static_assert( !(is_value_v<Lhs_Operator> && is_value_v<Rhs_Operator>), "Not valid for two values" );
@@ -192,18 +221,17 @@ namespace ceras
             }
 
             output_data_ = forward_action()( lhs_input_data_, rhs_input_data_ );
-            sess.update_forward_cache( (*this).id(), output_data_ );
+            sess.update_forward_cache( state_->slot_ );
             return output_data_;
         }
 
         ///
-        /// @brief Backward action, grad back-propagated.
+        /// @brief Back-propagates `grad` through the expression in reverse topological order, a node shared by several operators
+        ///        getting the sum of their gradients and running its backward action once, see `execution_plan::backward`.
         ///
         void backward( tensor_type const& grad )
         {
-            auto const& [current_gradient_lhs, current_gradient_rhs] = backward_action()( lhs_input_data_, rhs_input_data_, output_data_, grad );
-            lhs_op().backward( current_gradient_lhs );
-            rhs_op().backward( current_gradient_rhs );
+            get_default_session<tensor_type>().plan( *this ).backward( grad );
         }
 
         ///
@@ -234,9 +262,9 @@ namespace ceras
         Output_Shape_Calculator& output_shape_calculator() { return state_->output_shape_calculator_; }
         Serializer& serializer() { return state_->serializer_; }
 
-        tensor_type output_data() { return output_data_; }
-        tensor_type lhs_input_data() { return lhs_input_data_; }
-        tensor_type rhs_input_data() { return rhs_input_data_; }
+        tensor_type output_data() { return state_->output_data_; }
+        tensor_type lhs_input_data() { return state_->lhs_input_data_; }
+        tensor_type rhs_input_data() { return state_->rhs_input_data_; }
     }; // struct binary_operator
 
     template< typename Forward_Action, typename Backward_Action, typename Output_Shape_Calculator= identity_output_shape_calculator, typename Serializer = default_binary_expression_serializer >
@@ -309,6 +337,85 @@ namespace ceras
     template< typename T >
     concept Expression = Operator<T> || Variable<T> || Place_Holder<T> || Constant<T> || Value<T>;
 
+    ///
+    /// @brief Gives an unary operator of float or double tensors the elementwise kernel of `function( x )`, of gradient `derivative( x, y, grad )`.
+    ///
+    /// Both are called with the `vmath` packs of the input `x`, the output `y` and its gradient `grad`, as in `vectorized_map`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto y = with_elementwise_kernel( make_unary_operator( forward, backward, "square" )( x ),
+    ///                                   []( auto x ){ return x * x; },
+    ///                                   []( auto x, auto, auto g ){ return vmath::constant<decltype(x)>( 2.0f ) * x * g; } );
+    /// @endcode
+    ///
+    template< Unary_Operator Ex, typename Function, typename Derivative >
+    Ex with_elementwise_kernel( Ex const& ex, Function const& function, Derivative const& derivative )
+    {
+        typedef typename Ex::tensor_type::value_type value_type;
+        if constexpr ( std::is_same_v<value_type, float> || std::is_same_v<value_type, double> )
+        {
+            typedef elementwise_kernel<value_type> kernel_type;
+            auto kernel = std::make_shared<kernel_type>();
+            kernel->forward_ = [function]( typename kernel_type::inputs_type const& inputs, value_type* output, size_t n )
+            {
+                vectorized_map( inputs[0], output, n, function );
+            };
+            kernel->backward_ = [derivative]( typename kernel_type::inputs_type const& inputs, value_type const* output, value_type const* grad, size_t, value_type* ans, size_t n )
+            {
+                vectorized_map( inputs[0], output, grad, ans, n, derivative );
+            };
+            ex.state_->elementwise_ = kernel;
+        }
+        return ex;
+    }
+
+    ///
+    /// @brief Gives a binary operator of float or double tensors the elementwise kernel of `function( a, b )`, of gradients `lhs_derivative( a, b, grad )` and `rhs_derivative( a, b, grad )`.
+    ///
+    template< Binary_Operator Ex, typename Function, typename Lhs_Derivative, typename Rhs_Derivative >
+    Ex with_elementwise_kernel( Ex const& ex, Function const& function, Lhs_Derivative const& lhs_derivative, Rhs_Derivative const& rhs_derivative )
+    {
+        typedef typename Ex::tensor_type::value_type value_type;
+        if constexpr ( std::is_same_v<value_type, float> || std::is_same_v<value_type, double> )
+        {
+            typedef elementwise_kernel<value_type> kernel_type;
+            auto kernel = std::make_shared<kernel_type>();
+            kernel->arity_ = 2;
+            kernel->forward_ = [function]( typename kernel_type::inputs_type const& inputs, value_type* output, size_t n )
+            {
+                vectorized_map( inputs[0], inputs[1], output, n, function );
+            };
+            kernel->backward_ = [lhs_derivative, rhs_derivative]( typename kernel_type::inputs_type const& inputs, value_type const*, value_type const* grad, size_t operand, value_type* ans, size_t n )
+            {
+                if ( operand == 0 )
+                    vectorized_map( inputs[0], inputs[1], grad, ans, n, lhs_derivative );
+                else
+                    vectorized_map( inputs[0], inputs[1], grad, ans, n, rhs_derivative );
+            };
+            ex.state_->elementwise_ = kernel;
+        }
+        return ex;
+    }
+
+    ///
+    /// @brief Gives an unary operator reducing float or double tensors to a scalar the kernel of a reduction, its output being the sum of its inputs times `forward_scale( input_shape )`.
+    ///
+    template< Unary_Operator Ex, typename Forward_Scale, typename Backward_Scale >
+    Ex with_reduction_kernel( Ex const& ex, Forward_Scale const& forward_scale, Backward_Scale const& backward_scale )
+    {
+        typedef typename Ex::tensor_type::value_type value_type;
+        if constexpr ( std::is_same_v<value_type, float> || std::is_same_v<value_type, double> )
+        {
+            auto kernel = std::make_shared<elementwise_kernel<value_type>>();
+            kernel->reduction_ = true;
+            kernel->forward_scale_ = forward_scale;
+            kernel->backward_scale_ = backward_scale;
+            ex.state_->elementwise_ = kernel;
+        }
+        return ex;
+    }
+
     template< Expression Ex >
     std::tuple<std::string, std::vector<std::string>> const serialize( Ex const& ex )
     {
@@ -527,32 +634,37 @@ namespace ceras
         {
             auto make_forward() const noexcept
             {
-                return []<Tensor Tsor>( Tsor const& lhs_tensor, Tsor const& rhs_tensor ) noexcept
+                return []( std::shared_ptr<std::any> forward_cache ) noexcept
                 {
-                    better_assert( !has_nan( lhs_tensor ), "forward propagation for operator plus: lhs_tensor contains Nan!" );
-                    better_assert( !has_nan( rhs_tensor ), "forward propagation for operator plus: rhs_tensor contains Nan!" );
-                    return add( lhs_tensor, rhs_tensor );
+                    return [forward_cache]<Tensor Tsor>( Tsor const& lhs_tensor, Tsor const& rhs_tensor ) noexcept
+                    {
+                        better_assert( !has_nan( lhs_tensor ), "forward propagation for operator plus: lhs_tensor contains Nan!" );
+                        better_assert( !has_nan( rhs_tensor ), "forward propagation for operator plus: rhs_tensor contains Nan!" );
+                        Tsor& ans = context_cast<Tsor>( forward_cache );
+                        add( lhs_tensor, rhs_tensor, ans );
+                        return ans;
+                    };
                 };
             }
 
             auto const make_backward() const noexcept
             {
-                return []<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const& grad ) noexcept
+                return []( std::shared_ptr<std::any> backward_cache_lhs, std::shared_ptr<std::any> backward_cache_rhs ) noexcept
                 {
-                   better_assert( !has_nan( grad ), "backprop: upcoming gradient for operator + contains NaN!" );
-
-                   auto const& grad_fun = [&grad]( auto const& input )
-                   {
-                       Tsor ans = grad.deep_copy();
-                       while( input.ndim() < ans.ndim() )
-                           ans = sum( ans, 0 );
-                       auto const& shape = input.shape();
-                       for ( auto axis : range( input.ndim() ) )
-                           if ( shape[axis] == 1 )
-                              ans = sum( ans, axis, true );
-                       return ans;
-                   };
-                   return std::make_tuple( grad_fun( lhs_input), grad_fun( rhs_input ) );
+                    return [backward_cache_lhs, backward_cache_rhs]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const& grad ) noexcept
+                    {
+                        better_assert( !has_nan( grad ), "backprop: upcoming gradient for operator + contains NaN!" );
+                        // an operand of the shape of the output shares the incoming gradient, the backward actions not mutating their gradients
+                        auto const& gradient_of = [&grad]( Tsor const& input, std::shared_ptr<std::any> backward_cache )
+                        {
+                            if ( input.shape() == grad.shape() )
+                                return grad;
+                            Tsor& ans = context_cast<Tsor>( backward_cache );
+                            sum_to_shape( grad, input.shape(), ans ); // summed over the broadcasted dimensions
+                            return ans;
+                        };
+                        return std::make_tuple( gradient_of( lhs_input, backward_cache_lhs ), gradient_of( rhs_input, backward_cache_rhs ) );
+                    };
                 };
             }
         }; // plus_context
@@ -566,8 +678,17 @@ namespace ceras
             return broadcast_shape( l, r );
         };
 
-
-        return make_binary_operator( plus_context{}.make_forward(), plus_context{}.make_backward(), "plus", shape_calculator )( lhs_ex, rhs_ex );
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
+        auto ans = make_binary_operator( plus_context{}.make_forward()( forward_cache ), plus_context{}.make_backward()( backward_cache_lhs, backward_cache_rhs ), "plus", shape_calculator )( lhs_ex, rhs_ex );
+        if constexpr ( is_value_v<Lhs_Expression> || is_value_v<Rhs_Expression> )
+            return ans;
+        else
+            return with_elementwise_kernel( ans,
+                                            []( auto a, auto b ) noexcept { return a + b; },
+                                            []( auto, auto, auto g ) noexcept { return g; },
+                                            []( auto, auto, auto g ) noexcept { return g; } );
     }
 
     template< Expression Lhs_Expression, Expression Rhs_Expression >
@@ -595,8 +716,8 @@ namespace ceras
                         better_assert( lhs_tensor.size(), "multiplication::forward: empty lhs tensor." );
                         better_assert( rhs_tensor.size(), "multiplication::forward: empty rhs tensor." );
 
-                        better_assert( lhs_tensor.ndim() == 2, "multiplication::forward: lhs_tensor is not 2D." );
-                        better_assert( rhs_tensor.ndim() == 2, "multiplication::forward: rhs_tensor is not 2D." );
+                        better_assert( (lhs_tensor.ndim() == 2) || (lhs_tensor.ndim() == 3), "multiplication::forward: lhs_tensor is not 2D or 3D." );
+                        better_assert( (rhs_tensor.ndim() == 2) || (rhs_tensor.ndim() == 3), "multiplication::forward: rhs_tensor is not 2D or 3D." );
 
                         Tsor& ans = context_cast<Tsor>( forward_cache );
                         multiply( lhs_tensor, rhs_tensor, ans );
@@ -606,10 +727,44 @@ namespace ceras
             }
             auto make_backward() const noexcept
             {
-                return []( std::shared_ptr<std::any> backward_cache_lhs, std::shared_ptr<std::any> backward_cache_rhs ) noexcept
+                return []( std::shared_ptr<std::any> backward_cache_lhs, std::shared_ptr<std::any> backward_cache_rhs, std::shared_ptr<std::any> backward_cache_product ) noexcept
                 {
-                    return [backward_cache_lhs, backward_cache_rhs]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, [[maybe_unused]] Tsor const& output, Tsor const& grad ) noexcept
+                    return [backward_cache_lhs, backward_cache_rhs, backward_cache_product]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, [[maybe_unused]] Tsor const& output, Tsor const& grad ) noexcept
                     {
+                       if ( (lhs_input.ndim() == 3) || (rhs_input.ndim() == 3) ) // batched: [bs, m, n] * [bs, n, k], a 2D side is shared by the batch
+                       {
+                           auto const& g_shape = grad.shape();
+                           auto const[bs, m, k] = std::make_tuple( g_shape[0], g_shape[1], g_shape[2] );
+                           auto const n = *(lhs_input.shape().rbegin());
+                           bool const lhs_shared = lhs_input.ndim() == 2;
+                           bool const rhs_shared = rhs_input.ndim() == 2;
+
+                           // left branch <-- grad * rhs^T
+                           Tsor& lhs_grad = context_cast<Tsor>( backward_cache_lhs );
+                           lhs_grad.resize( lhs_input.shape() );
+                           if ( lhs_shared ) // summing over the batch
+                           {
+                               Tsor& partial = context_cast<Tsor>( backward_cache_product ); // the products of the samples
+                               partial.resize( {bs, m, n} );
+                               batched_gemm( grad.data(), m*k, false, rhs_input.data(), n*k, true, bs, m, k, n, partial.data(), m*n );
+                               lhs_grad.fill();
+                               for ( auto idx : range( bs ) )
+                                   for_each( lhs_grad.begin(), lhs_grad.end(), partial.begin()+idx*m*n, []( auto& x, auto y ){ x += y; } );
+                           }
+                           else
+                               batched_gemm( grad.data(), m*k, false, rhs_input.data(), rhs_shared ? 0UL : n*k, true, bs, m, k, n, lhs_grad.data(), m*n );
+
+                           // right branch <-- lhs^T * grad
+                           Tsor& rhs_grad = context_cast<Tsor>( backward_cache_rhs );
+                           rhs_grad.resize( rhs_input.shape() );
+                           if ( rhs_shared ) // summing over the batch: [bs*m, n]^T * [bs*m, k]
+                               gemm( lhs_input.data(), true, grad.data(), false, n, bs*m, k, rhs_grad.data() );
+                           else
+                               batched_gemm( lhs_input.data(), lhs_shared ? 0UL : m*n, true, grad.data(), m*k, false, bs, n, m, k, rhs_grad.data(), n*k );
+
+                           return std::make_tuple( lhs_grad, rhs_grad );
+                       }
+
                        // left branch <-- grad * rhs^T
                        auto const& g_shape = grad.shape();
                        auto const[m, n] = std::make_tuple( g_shape[0], g_shape[1] ); // 4, 1
@@ -644,15 +799,18 @@ namespace ceras
         {
             auto const& shape_calculator = []( std::vector<size_t> const& l, std::vector<size_t> const& r ) noexcept
             {
-                better_assert( l.size() == 2, fmt::format( "expecting l size of 2, but got {}", l.size() ) );
-                better_assert( r.size() == 2, fmt::format( "expecting r size of 2, but got {}", r.size() ) );
-                better_assert( l[1] == r[0], fmt::format( "expecting l[1] == r[0], but l[1]={}, r[0]={}", l[1], r[0] ) ); // TODO: what if unknown dimension???
+                better_assert( (l.size() == 2) || (l.size() == 3), fmt::format( "expecting l size of 2 or 3, but got {}", l.size() ) );
+                better_assert( (r.size() == 2) || (r.size() == 3), fmt::format( "expecting r size of 2 or 3, but got {}", r.size() ) );
+                better_assert( *(l.rbegin()) == *(r.rbegin()+1), fmt::format( "expecting lhs columns == rhs rows, but got {} and {}", *(l.rbegin()), *(r.rbegin()+1) ) ); // TODO: what if unknown dimension???
+                if ( (l.size() == 3) || (r.size() == 3) )
+                    return std::vector<size_t>{ {(l.size() == 3) ? l[0] : r[0], *(l.rbegin()+1), *(r.rbegin())} };
                 return std::vector<size_t>{ {l[0], r[1]} };
             };
             std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
             std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
             std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
-            return make_binary_operator( multiplication_context{}.make_forward()(forward_cache), multiplication_context{}.make_backward()(backward_cache_lhs, backward_cache_rhs), "multiply", shape_calculator )( lhs_ex, rhs_ex );
+            std::shared_ptr<std::any> backward_cache_product = std::make_shared<std::any>();
+            return make_binary_operator( multiplication_context{}.make_forward()(forward_cache), multiplication_context{}.make_backward()(backward_cache_lhs, backward_cache_rhs, backward_cache_product), "multiply", shape_calculator )( lhs_ex, rhs_ex );
         }
     }
 
@@ -662,6 +820,483 @@ namespace ceras
         return lhs_ex * rhs_ex;
     }
 
+    ///
+    /// @brief Batched matrix multiplication, `[bs, m, n] * [bs, n, k] -> [bs, m, k]`. A 2D side is shared by all the samples of the batch.
+    /// @code{.cpp}
+    /// auto q = variable{ random<float>( {8, 16, 32} ) };
+    /// auto k = variable{ random<float>( {8, 32, 16} ) };
+    /// auto qk = batch_matmul( q, k ); // [8, 16, 16]
+    /// @endcode
+    ///
+    template< Expression Lhs_Expression, Expression Rhs_Expression >
+    auto batch_matmul( Lhs_Expression const& lhs_ex, Rhs_Expression const& rhs_ex ) noexcept
+    {
+        return lhs_ex * rhs_ex;
+    }
+
+    namespace
+    {
+        // activations fused into the dense operator
+        enum class dense_activation { linear, relu, sigmoid, tanh };
+
+        inline dense_activation make_dense_activation( std::string const& activation )
+        {
+            if ( activation == "linear" ) return dense_activation::linear;
+            if ( activation == "relu" ) return dense_activation::relu;
+            if ( activation == "sigmoid" ) return dense_activation::sigmoid;
+            better_assert( activation == "tanh", "dense: unknown activation ", activation, ", expecting one of linear, relu, sigmoid and tanh." );
+            return dense_activation::tanh;
+        }
+
+        struct dense_context
+        {
+            // the gemm epilogue: c <= activation( c + bias ), on a tile of the output starting at column `col`
+            template< typename T >
+            static auto make_epilogue( T const* bias, dense_activation activation ) noexcept
+            {
+                return [bias, activation]( T* c, size_t ldc, size_t, size_t col, size_t rows, size_t cols ) noexcept
+                {
+                    auto const& apply = [=]( auto const& f ) noexcept
+                    {
+                        for ( size_t r = 0; r != rows; ++r )
+                        {
+                            T* __restrict__ c_row = c + r * ldc;
+                            T const* __restrict__ b_row = bias + col;
+                            for ( size_t j = 0; j != cols; ++j )
+                                c_row[j] = f( c_row[j] + b_row[j] );
+                        }
+                    };
+
+                    auto const& apply_vectorized = [=]( auto const& f ) noexcept
+                    {
+                        apply( []( T x ) noexcept { return x; } );
+                        for ( size_t r = 0; r != rows; ++r )
+                            vectorized_map( c + r * ldc, c + r * ldc, cols, f );
+                    };
+
+                    switch ( activation )
+                    {
+                        case dense_activation::linear: apply( []( T x ) noexcept { return x; } ); break;
+                        case dense_activation::relu: apply( []( T x ) noexcept { return std::max( x, T{0} ); } ); break;
+                        case dense_activation::sigmoid: apply_vectorized( []( auto x ) noexcept { return vmath::sigmoid( x ); } ); break;
+                        case dense_activation::tanh: apply_vectorized( []( auto x ) noexcept { return vmath::tanh( x ); } ); break;
+                    }
+                };
+            }
+
+            // delta <-- grad * activation'(output), and the bias gradient as its column sums, written to the `k` values at `bias_grad`, in one pass
+            template< Tensor Tsor >
+            static Tsor const& backward_delta( dense_activation activation, Tsor const& output, Tsor const& grad, size_t m, size_t k,
+                                               typename Tsor::value_type* bias_grad, std::shared_ptr<std::any> backward_cache_delta ) noexcept
+            {
+                typedef typename Tsor::value_type value_type;
+                std::fill_n( bias_grad, k, value_type{0} );
+                Tsor& delta = context_cast<Tsor>( backward_cache_delta );
+                if ( activation == dense_activation::linear )
+                    delta = grad;
+                else
+                    delta.resize( grad.shape() );
+
+                for ( size_t r = 0; r != m; ++r )
+                {
+                    value_type const* __restrict__ g = grad.data() + r * k;
+                    value_type const* __restrict__ y = output.data() + r * k;
+                    value_type* __restrict__ d = delta.data() + r * k;
+                    value_type* __restrict__ db = bias_grad;
+                    switch ( activation )
+                    {
+                        case dense_activation::linear: break;
+                        case dense_activation::relu: for ( size_t j = 0; j != k; ++j ) d[j] = ( y[j] > value_type{0} ) ? g[j] : value_type{0}; break;
+                        case dense_activation::sigmoid: for ( size_t j = 0; j != k; ++j ) d[j] = g[j] * y[j] * ( value_type{1} - y[j] ); break;
+                        case dense_activation::tanh: for ( size_t j = 0; j != k; ++j ) d[j] = g[j] * ( value_type{1} - y[j] * y[j] ); break;
+                    }
+                    for ( size_t j = 0; j != k; ++j )
+                        db[j] += d[j];
+                }
+                return delta;
+            }
+
+            // The parameters node of a dense operator reads the weights and the bias, and outputs the weights as they are, the dense
+            // operator reading the bias from the inputs the parameters node recorded in this pass, see `bias_of`. The gradient the
+            // dense operator returns for the parameters is packed, the weight gradient [n, k] followed by the bias gradient as an
+            // extra row, [n+1, k], or the gradient of the stored values of sparse weights followed by it, [nnz+k]: the gemm and the
+            // activation pass write the two parts in place, and the parameters node splits them into two slices of the same buffer.
+            auto make_parameters_forward() const noexcept
+            {
+                return []<Tensor Tsor>( Tsor const& weight, Tsor const& ) noexcept
+                {
+                    return weight;
+                };
+            }
+
+            auto make_parameters_backward() const noexcept
+            {
+                return []<Tensor Tsor>( Tsor const& weight, Tsor const& bias, Tsor const&, Tsor const& grad ) noexcept
+                {
+                    better_assert( grad.size() == weight.size() + bias.size(), fmt::format( "dense: expecting a packed gradient of {} values, but got shape {}", weight.size() + bias.size(), grad.shape() ) );
+                    size_t const rows = weight.shape()[0];
+                    Tsor bias_grad = slice( grad, rows, grad.shape()[0] );
+                    bias_grad.reshape( bias.shape() );
+                    return std::make_tuple( slice( grad, 0, rows ), bias_grad );
+                };
+            }
+
+            // the bias read by the parameters node of a dense operator in the current pass
+            template< typename Parameters_State >
+            static auto const& bias_of( std::shared_ptr<Parameters_State> const& parameters_state, size_t k ) noexcept
+            {
+                auto const& bias = (*parameters_state).rhs_input_data_;
+                better_assert( bias.size() == k, fmt::format( "dense: expecting a bias of {} values, but got shape {}", k, bias.shape() ) );
+                return bias;
+            }
+
+            template< typename Parameters_State >
+            auto make_forward( std::shared_ptr<Parameters_State> parameters_state, dense_activation activation, std::shared_ptr<std::any> forward_cache ) const noexcept
+            {
+                return [parameters_state, activation, forward_cache]<Tensor Tsor>( Tsor const& input, Tsor const& weight ) noexcept
+                {
+                    typedef typename Tsor::value_type value_type;
+                    auto const[n, k] = std::make_tuple( weight.shape()[0], weight.shape()[1] );
+                    better_assert( *(input.shape().rbegin()) == n, fmt::format( "dense::forward: expecting input of last dimension {}, but got shape {}", n, input.shape() ) );
+                    size_t const m = input.size() / n;
+
+                    std::vector<size_t> output_shape = input.shape();
+                    *(output_shape.rbegin()) = k;
+                    Tsor& ans = context_cast<Tsor>( forward_cache );
+                    ans.resize( output_shape );
+                    gemm( input.data(), false, weight.data(), false, m, n, k, ans.data(), make_epilogue<value_type>( bias_of( parameters_state, k ).data(), activation ) );
+                    return ans;
+                };
+            }
+
+            auto make_backward( dense_activation activation, std::shared_ptr<std::any> backward_cache_input, std::shared_ptr<std::any> backward_cache_parameters,
+                                std::shared_ptr<std::any> backward_cache_delta ) const noexcept
+            {
+                return [=]<Tensor Tsor>( Tsor const& input, Tsor const& weight, Tsor const& output, Tsor const& grad ) noexcept
+                {
+                    auto const[n, k] = std::make_tuple( weight.shape()[0], weight.shape()[1] );
+                    size_t const m = input.size() / n;
+
+                    Tsor& parameters_grad = context_cast<Tsor>( backward_cache_parameters );
+                    parameters_grad.resize( {n+1, k} );
+                    Tsor const& delta = backward_delta( activation, output, grad, m, k, parameters_grad.data() + n * k, backward_cache_delta );
+
+                    // input <-- delta * weight^T
+                    Tsor& input_grad = context_cast<Tsor>( backward_cache_input );
+                    input_grad.resize( input.shape() );
+                    gemm( delta.data(), false, weight.data(), true, m, k, n, input_grad.data() );
+
+                    // weight <-- input^T * delta, the bias gradient in the last row
+                    gemm( input.data(), true, delta.data(), false, n, m, k, parameters_grad.data() );
+
+                    return std::make_tuple( input_grad, parameters_grad );
+                };
+            }
+
+            // With sparse weights of shape [output, input] the product runs transposed, `output^T = weight * input^T`, for
+            // `spmm` to vectorize over the samples of the batch.
+            template< typename T, typename Parameters_State >
+            auto make_sparse_forward( std::shared_ptr<sparse_tensor<T>> weight, std::shared_ptr<Parameters_State> parameters_state, dense_activation activation,
+                                      std::shared_ptr<std::any> forward_cache, std::shared_ptr<std::any> input_transposed_cache, std::shared_ptr<std::any> output_transposed_cache ) const noexcept
+            {
+                return [=]<Tensor Tsor>( Tsor const& input, Tsor const& values ) noexcept
+                {
+                    typedef typename Tsor::value_type value_type;
+                    auto const[n, k] = std::make_tuple( (*weight).cols(), (*weight).rows() );
+                    better_assert( *(input.shape().rbegin()) == n, fmt::format( "dense::forward: expecting input of last dimension {}, but got shape {}", n, input.shape() ) );
+                    size_t const m = input.size() / n;
+                    (*weight).values_ = values;
+
+                    Tsor input_2d = input;
+                    Tsor& input_transposed = context_cast<Tsor>( input_transposed_cache );
+                    transpose( input_2d.reshape( {m, n} ), input_transposed );
+                    Tsor& output_transposed = context_cast<Tsor>( output_transposed_cache );
+                    output_transposed.resize( {k, m} );
+                    spmm( *weight, input_transposed.data(), m, output_transposed.data() );
+
+                    std::vector<size_t> output_shape = input.shape();
+                    *(output_shape.rbegin()) = k;
+                    Tsor& ans = context_cast<Tsor>( forward_cache );
+                    transpose( output_transposed, ans );
+                    ans.reshape( output_shape );
+                    make_epilogue<value_type>( bias_of( parameters_state, k ).data(), activation )( ans.data(), k, 0, 0, m, k );
+                    return ans;
+                };
+            }
+
+            // the gradient of the stored values only, sampled from `delta^T * input`, the input transposed by the forward pass
+            template< typename T >
+            auto make_sparse_backward( std::shared_ptr<sparse_tensor<T>> weight, dense_activation activation, std::shared_ptr<std::any> input_transposed_cache,
+                                       std::shared_ptr<std::any> backward_cache_input, std::shared_ptr<std::any> backward_cache_parameters,
+                                       std::shared_ptr<std::any> backward_cache_delta, std::shared_ptr<std::any> backward_cache_transposed,
+                                       std::shared_ptr<std::any> backward_cache_input_transposed ) const noexcept
+            {
+                return [=]<Tensor Tsor>( Tsor const& input, Tsor const& values, Tsor const& output, Tsor const& grad ) noexcept
+                {
+                    auto const[n, k] = std::make_tuple( (*weight).cols(), (*weight).rows() );
+                    size_t const nnz = values.size();
+                    size_t const m = input.size() / n;
+
+                    Tsor& parameters_grad = context_cast<Tsor>( backward_cache_parameters );
+                    parameters_grad.resize( {nnz+k,} );
+                    Tsor delta = backward_delta( activation, output, grad, m, k, parameters_grad.data() + nnz, backward_cache_delta );
+                    Tsor& delta_transposed = context_cast<Tsor>( backward_cache_transposed );
+                    transpose( delta.reshape( {m, k} ), delta_transposed );
+
+                    // input <-- ( weight^T * delta^T )^T
+                    Tsor& input_grad = context_cast<Tsor>( backward_cache_input );
+                    Tsor& input_grad_transposed = context_cast<Tsor>( backward_cache_input_transposed );
+                    input_grad_transposed.resize( {n, m} );
+                    spmm_transposed( *weight, delta_transposed.data(), m, input_grad_transposed.data() );
+                    transpose( input_grad_transposed, input_grad );
+                    input_grad.reshape( input.shape() );
+
+                    // values <-- delta^T * input, at the stored values, the bias gradient after them
+                    sampled_gemm( *weight, delta_transposed.data(), context_cast<Tsor>( input_transposed_cache ).data(), m, parameters_grad.data() );
+
+                    return std::make_tuple( input_grad, parameters_grad );
+                };
+            }
+        };//dense_context
+    }//anonymous namespace
+
+    ///
+    /// @brief Densely-connected operator, `activation( ex * w + b )` in a single pass over the output.
+    ///
+    /// The bias and the activation are applied in the epilogue of the gemm, tile by tile right after the product, instead of
+    /// in two more passes over the output. The backward pass derives the activation from the output, and accumulates the bias
+    /// gradient in the same pass. The weights and the bias are read by a `dense_parameters` node, the operand of the dense operator,
+    /// so that both are nodes of the graph, seen by `compile_plan`, `plan_memory` and the graph dumps; the gemm and its epilogue read
+    /// them in place, without copying them to an operand of their own.
+    ///
+    /// @param activation One of `linear`, `relu`, `sigmoid` and `tanh`. Defaults to `linear`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto x = place_holder<tensor<float>>{};
+    /// auto w = variable{ glorot_uniform<float>( {784, 256} ) };
+    /// auto b = variable{ zeros<float>( {1, 256} ) };
+    /// auto y = dense( "relu" )( x, w, b ); // relu( x * w + b )
+    /// @endcode
+    ///
+    /// The weights can be a `sparse_variable` of shape [output, input], the transpose of the dense weights: the product runs
+    /// through `spmm`, in the operations of the stored values only, and the backward pass trains the stored values only.
+    ///
+    /// @code{.cpp}
+    /// auto sw = sparse_variable{ to_sparse( transpose( w.data() ), 0.05f, 4, 1 ) }; // w pruned, in blocks of 4 outputs
+    /// auto z = dense( "relu" )( x, sw, b );
+    /// @endcode
+    ///
+    inline auto dense( std::string const& activation = "linear" ) noexcept
+    {
+        return overload( [activation]<Expression Ex, Variable Va>( Ex const& ex, Va const& w, Va const& b ) noexcept
+        {
+            dense_activation const act = make_dense_activation( activation );
+            auto const& shape_calculator = []( std::vector<size_t> const& l, std::vector<size_t> const& r ) noexcept
+            {
+                better_assert( r.size() == 2, fmt::format( "expecting r size of 2, but got {}", r.size() ) );
+                std::vector<size_t> ans = l;
+                *(ans.rbegin()) = r[1];
+                return ans;
+            };
+            // the rhs expression is the parameters node, reading the weights and the bias
+            auto const& serializer = [activation]<Expression Self_Expression, Expression Lhs_Expression, Expression Rhs_Expression>( Self_Expression const& self_expression, Lhs_Expression const& lhs_expression, Rhs_Expression const& rhs_expression ) noexcept
+            {
+                auto const& [lhs_name, lhs_code] = serialize( lhs_expression );
+                auto const& [rhs_name, rhs_code] = serialize( rhs_expression.lhs_op() );
+                auto const& [bias_name, bias_code] = serialize( rhs_expression.rhs_op() );
+                std::string const& self_expression_identity = fmt::format( "binary_expression_{}_{}", self_expression.name(), self_expression.id() );
+                std::vector<std::string> self_expression_code = lhs_code;
+                std::copy( rhs_code.begin(), rhs_code.end(), std::back_inserter( self_expression_code ) );
+                std::copy( bias_code.begin(), bias_code.end(), std::back_inserter( self_expression_code ) );
+                self_expression_code.emplace_back( fmt::format( "auto {} = dense( \"{}\" )( {}, {}, {} );", self_expression_identity, activation, lhs_name, rhs_name, bias_name ) );
+                return std::make_tuple( self_expression_identity, self_expression_code );
+            };
+            std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_input = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_parameters = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_delta = std::make_shared<std::any>();
+            auto const& parameters = make_binary_operator( dense_context{}.make_parameters_forward(), dense_context{}.make_parameters_backward(),
+                                                           "dense_parameters", []( std::vector<size_t> const& l, std::vector<size_t> const& ) noexcept { return l; } )( w, b );
+            return make_binary_operator( dense_context{}.make_forward( parameters.state_, act, forward_cache ),
+                                         dense_context{}.make_backward( act, backward_cache_input, backward_cache_parameters, backward_cache_delta ),
+                                         "dense", shape_calculator, serializer )( ex, parameters );
+        },
+        [activation]<Expression Ex, Sparse_Variable Sv, Variable Va>( Ex const& ex, Sv const& w, Va const& b ) noexcept
+        {
+            dense_activation const act = make_dense_activation( activation );
+            size_t const k = w.weight_->rows();
+            auto const& shape_calculator = [k]( std::vector<size_t> const& l, std::vector<size_t> const& ) noexcept
+            {
+                std::vector<size_t> ans = l;
+                *(ans.rbegin()) = k;
+                return ans;
+            };
+            std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> input_transposed_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> output_transposed_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_input = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_parameters = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_delta = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_transposed = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_input_transposed = std::make_shared<std::any>();
+            auto const& parameters = make_binary_operator( dense_context{}.make_parameters_forward(), dense_context{}.make_parameters_backward(),
+                                                           "dense_parameters", []( std::vector<size_t> const& l, std::vector<size_t> const& ) noexcept { return l; } )( w.values_, b );
+            return make_binary_operator( dense_context{}.make_sparse_forward( w.weight_, parameters.state_, act, forward_cache, input_transposed_cache, output_transposed_cache ),
+                                         dense_context{}.make_sparse_backward( w.weight_, act, input_transposed_cache, backward_cache_input, backward_cache_parameters,
+                                                                               backward_cache_delta, backward_cache_transposed, backward_cache_input_transposed ),
+                                         "sparse_dense", shape_calculator )( ex, parameters );
+        } );
+    }
+
+    namespace
+    {
+        struct quantized_context
+        {
+            typedef std::vector<std::uint8_t, aligned_allocator<std::uint8_t>> activation_type;
+
+            // the float input quantized to unsigned bytes over its own range, returning the scale and the zero point
+            static std::tuple<float, std::int32_t> quantize_input( float const* input, size_t n, std::uint8_t* output ) noexcept
+            {
+                float lowest = 0.0f;
+                float highest = 0.0f;
+                for ( size_t idx = 0; idx != n; ++idx )
+                {
+                    lowest = std::min( lowest, input[idx] );
+                    highest = std::max( highest, input[idx] );
+                }
+                auto const [scale, zero_point] = quantization_parameters<std::uint8_t>( lowest, highest );
+                vmath::vmath_private::for_each_range( n, [=]( size_t first, size_t last ) noexcept { quantize_range( input + first, last - first, scale, zero_point, output + first ); } );
+                return std::make_tuple( scale, zero_point );
+            }
+
+            // the patches of the `col_output` pixels of an output row of a sample, the channels of a pixel contiguous, the padding `zero`
+            static void gather_patches( std::uint8_t const* __restrict__ sample, size_t R, size_t C, size_t CH, std::int64_t row_origin,
+                                        size_t col_output, size_t col_stride, size_t col_padding, size_t row_kernel, size_t col_kernel,
+                                        size_t row_dilation, size_t col_dilation, std::uint8_t zero, std::uint8_t* __restrict__ patches ) noexcept
+            {
+                for ( size_t output_col = 0; output_col != col_output; ++output_col )
+                {
+                    std::int64_t const col_origin = static_cast<std::int64_t>( output_col * col_stride ) - static_cast<std::int64_t>( col_padding );
+                    for ( size_t r = 0; r != row_kernel; ++r )
+                    {
+                        std::int64_t const row = row_origin + static_cast<std::int64_t>( r * row_dilation );
+                        bool const row_inside = row >= 0 && row < static_cast<std::int64_t>( R );
+                        for ( size_t c = 0; c != col_kernel; ++c )
+                        {
+                            std::int64_t const col = col_origin + static_cast<std::int64_t>( c * col_dilation );
+                            bool const inside = row_inside && col >= 0 && col < static_cast<std::int64_t>( C );
+                            if ( CH == 1 ) // the first layer of a network of gray images, without a call per byte
+                                *patches = inside ? sample[row * C + col] : zero;
+                            else if ( inside )
+                                std::memcpy( patches, sample + ( row * C + col ) * CH, CH );
+                            else
+                                std::memset( patches, zero, CH );
+                            patches += CH;
+                        }
+                    }
+                }
+            }
+
+            // the scales of the `channels` output channels of the weights, one per channel even for weights quantized per tensor
+            static std::vector<float> weight_scales( quantized_tensor<std::int8_t> const& weight, size_t axis, size_t channels )
+            {
+                better_assert( !weight.per_channel() || weight.axis_ == axis, "quantized weights: expecting the channels along axis ", axis, ", but got ", weight.axis_ );
+                better_assert( std::all_of( weight.zero_points_.begin(), weight.zero_points_.end(), []( std::int32_t zp ){ return zp == 0; } ), "quantized weights: expecting a symmetric quantization." );
+                return weight.per_channel() ? weight.scales_ : std::vector<float>( channels, weight.scales_[0] );
+            }
+
+            // the requantization epilogue of `int8_gemm`: the 32-bit sums scaled back to float, then the bias and the activation of the dense operator
+            static auto make_epilogue( float* output, float const* multipliers, float const* bias, dense_activation activation ) noexcept
+            {
+                auto const dense_epilogue = dense_context::make_epilogue<float>( bias, activation );
+                return [=]( std::int32_t const* c, size_t ldc, size_t row, size_t col, size_t rows, size_t cols ) noexcept
+                {
+                    for ( size_t r = 0; r != rows; ++r )
+                    {
+                        std::int32_t const* __restrict__ c_row = c + r * ldc;
+                        float* __restrict__ o_row = output + ( row + r ) * ldc + col;
+                        for ( size_t j = 0; j != cols; ++j )
+                            o_row[j] = static_cast<float>( c_row[j] ) * multipliers[col + j];
+                    }
+                    dense_epilogue( output + row * ldc + col, ldc, row, col, rows, cols );
+                };
+            }
+        };//quantized_context
+    }//anonymous namespace
+
+    ///
+    /// @brief Densely-connected operator with int8 weights, `activation( ex * w + b )` computed in 8-bit integers, for inference.
+    ///
+    /// The input is quantized to unsigned bytes over its own range on every run, the product accumulates in 32-bit integers,
+    /// see `int8_gemm` in './backend/int8_gemm.hpp', and the epilogue scales every output channel back to float before adding
+    /// the bias and applying the activation. The operator has no gradient.
+    ///
+    /// @param weight The weights of shape [n, k], quantized symmetrically per tensor or per output channel along axis 1.
+    /// @param bias The bias of size k.
+    /// @param activation One of `linear`, `relu`, `sigmoid` and `tanh`. Defaults to `linear`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto w = variable{ glorot_uniform<float>( {784, 256} ) };
+    /// auto b = variable{ zeros<float>( {1, 256} ) };
+    /// // ... after training dense( "relu" )( x, w, b )
+    /// auto y = quantized_dense( quantize<std::int8_t>( w.data(), 1 ), b.data(), "relu" )( x );
+    /// @endcode
+    ///
+    inline auto quantized_dense( quantized_tensor<std::int8_t> const& weight, tensor<float> const& bias, std::string const& activation = "linear" )
+    {
+        better_assert( weight.shape().size() == 2, fmt::format( "quantized_dense: expecting 2D weights, but got shape {}", weight.shape() ) );
+        auto const[n, k] = std::make_tuple( weight.shape()[0], weight.shape()[1] );
+        better_assert( bias.size() == k, "quantized_dense: expecting bias of size ", k, ", but got ", bias.size() );
+        std::shared_ptr<int8_packed_matrix> packed = std::make_shared<int8_packed_matrix>( pack_int8( weight.data_.data(), false, n, k ) );
+        std::vector<float> const scales = quantized_context::weight_scales( weight, 1, k );
+
+        return [=]<Expression Ex>( Ex const& ex ) noexcept
+        {
+            std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> input_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> accumulator_cache = std::make_shared<std::any>();
+            return make_unary_operator
+            (
+                [=]<Tensor Tsor>( Tsor const& input ) noexcept
+                {
+                    static_assert( std::is_same_v<typename Tsor::value_type, float>, "quantized_dense: expecting a float input." );
+                    better_assert( *(input.shape().rbegin()) == n, fmt::format( "quantized_dense: expecting input of last dimension {}, but got shape {}", n, input.shape() ) );
+                    size_t const m = input.size() / n;
+
+                    auto& quantized_input = context_cast<quantized_context::activation_type>( input_cache );
+                    quantized_input.resize( input.size() );
+                    auto const [scale, zero_point] = quantized_context::quantize_input( input.data(), input.size(), quantized_input.data() );
+                    std::vector<float> multipliers( k );
+                    for ( size_t j = 0; j != k; ++j )
+                        multipliers[j] = scale * scales[j];
+
+                    std::vector<size_t> output_shape = input.shape();
+                    *(output_shape.rbegin()) = k;
+                    Tsor& ans = context_cast<Tsor>( forward_cache );
+                    ans.resize( output_shape );
+                    auto& accumulator = context_cast<std::vector<std::int32_t>>( accumulator_cache );
+                    accumulator.resize( m * k );
+                    int8_gemm( quantized_input.data(), m, *packed, zero_point, accumulator.data(), quantized_context::make_epilogue( ans.data(), multipliers.data(), bias.data(), make_dense_activation( activation ) ) );
+                    return ans;
+                },
+                []<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) noexcept
+                {
+                    better_assert( false, "quantized_dense: an inference operator, without gradient." );
+                    return grad;
+                },
+                "quantized_dense",
+                [k]( std::vector<size_t> const& shape ) noexcept
+                {
+                    std::vector<size_t> ans = shape;
+                    *(ans.rbegin()) = k;
+                    return ans;
+                }
+            )( ex );
+        };
+    }
+
     ///
     /// @brief Negative operator, elementwise.
     /// @code{.cpp}
@@ -672,18 +1307,28 @@ namespace ceras
     template <Expression Ex>
     auto constexpr negative( Ex const& ex ) noexcept
     {
-        return make_unary_operator( []<Tensor Tsor>( Tsor const& tensor ) noexcept
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return with_elementwise_kernel( make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& tensor ) noexcept
                                     {
                                         better_assert( !has_nan( tensor ), "forward propagation for operator log: tensor contains Nan!" );
-                                        return -tensor;
+                                        Tsor& ans = context_cast<Tsor>( forward_cache );
+                                        ans.resize( tensor.shape() );
+                                        for_each( tensor.begin(), tensor.end(), ans.begin(), []( auto x, auto& y ){ y = -x; } );
+                                        return ans;
                                     },
-                                    []<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         better_assert( !has_nan( grad ), "input gradient for operator negative contains NaN!" );
-                                        return -grad;
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( grad.shape() );
+                                        for_each( grad.begin(), grad.end(), ans.begin(), []( auto x, auto& y ){ y = -x; } );
+                                        return ans;
                                     },
                                     "negative"
-                )( ex );
+                )( ex ),
+                []( auto x ) noexcept { return -x; },
+                []( auto, auto, auto g ) noexcept { return -g; } );
     };
 
 
@@ -691,7 +1336,7 @@ namespace ceras
     auto constexpr operator + ( Ex const& ex, A const& rhs_val ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
-        return make_unary_operator( [rhs_val, forward_cache]<Tensor Tsor>( Tsor const& tensor ) noexcept
+        return with_elementwise_kernel( make_unary_operator( [rhs_val, forward_cache]<Tensor Tsor>( Tsor const& tensor ) noexcept
                                     {
                                         better_assert( tensor.size() > 0, "forward propagation for operator ex + a receives empty grad." );
 
@@ -717,7 +1362,9 @@ namespace ceras
                                         unary_expressioncode.emplace_back( fmt::format( "auto {} = {} + {};", unary_expression_identity, input_expression_name, rhs_val ) );
                                         return std::make_tuple( unary_expression_identity, unary_expressioncode );
                                     }
-                )( ex );
+                )( ex ),
+                [rhs_val]( auto x ) noexcept { return x + vmath::constant<decltype(x)>( static_cast<typename decltype(x)::value_type>( rhs_val ) ); },
+                []( auto, auto, auto g ) noexcept { return g; } );
     }
 
     template< Expression Ex, arithmetic A >
@@ -743,7 +1390,7 @@ namespace ceras
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
-        return make_unary_operator( [rhs_val, forward_cache]<Tensor Tsor>( Tsor const& tensor ) noexcept
+        return with_elementwise_kernel( make_unary_operator( [rhs_val, forward_cache]<Tensor Tsor>( Tsor const& tensor ) noexcept
                                     {
                                         better_assert( tensor.size() > 0, "forward propagation for operator ex * a receives empty grad." );
 
@@ -773,7 +1420,9 @@ namespace ceras
                                         unary_expressioncode.emplace_back( fmt::format( "auto {} = {} * {};", unary_expression_identity, input_expression_name, rhs_val ) );
                                         return std::make_tuple( unary_expression_identity, unary_expressioncode );
                                     }
-                )( ex );
+                )( ex ),
+                [rhs_val]( auto x ) noexcept { return x * vmath::constant<decltype(x)>( static_cast<typename decltype(x)::value_type>( rhs_val ) ); },
+                [rhs_val]( auto, auto, auto g ) noexcept { return g * vmath::constant<decltype(g)>( static_cast<typename decltype(g)::value_type>( rhs_val ) ); } );
     }
 
     template< Expression Ex, arithmetic A >
@@ -847,27 +1496,41 @@ namespace ceras
     template< Expression Lhs_Expression, Expression Rhs_Expression >
     auto constexpr elementwise_product( Lhs_Expression const& lhs_ex, Rhs_Expression const& rhs_ex ) noexcept
     {
-        return make_binary_operator( []<Tensor Tsor>( Tsor const& lhs_tensor, Tsor const& rhs_tensor ) noexcept
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache_product = std::make_shared<std::any>();
+        auto ans = make_binary_operator( [forward_cache]<Tensor Tsor>( Tsor const& lhs_tensor, Tsor const& rhs_tensor ) noexcept
                                      {
-                                        return elementwise_product( lhs_tensor, rhs_tensor );
+                                        Tsor& ans = context_cast<Tsor>( forward_cache );
+                                        elementwise_product( lhs_tensor, rhs_tensor, ans );
+                                        return ans;
                                      },
-                                     []<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const grad ) noexcept
+                                     [=]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const grad ) noexcept
                                      {
-                                        auto const& grad_fun = [&grad]( auto const& input, auto const& other_input )
+                                        auto const& grad_fun = [&grad, &backward_cache_product]( auto const& input, auto const& other_input, Tsor& ans )
                                         {
-                                            Tsor ans = elementwise_product( grad, other_input );
-                                            while( input.ndim() < ans.ndim() )
-                                                ans = sum( ans, 0 );
-                                            auto const& shape = input.shape();
-                                            for ( auto axis : range( input.ndim() ) )
-                                                if ( shape[axis] == 1 )
-                                                    ans = sum( ans, axis, true );
-                                            return ans;
+                                            if ( input.shape() == grad.shape() )
+                                                return elementwise_product( grad, other_input, ans );
+                                            Tsor& product = context_cast<Tsor>( backward_cache_product );
+                                            elementwise_product( grad, other_input, product );
+                                            sum_to_shape( product, input.shape(), ans ); // summed over the broadcasted dimensions
                                         };
-                                        return std::make_tuple( grad_fun( lhs_input, rhs_input ), grad_fun( rhs_input, lhs_input ) );
+                                        Tsor& lhs_ans = context_cast<Tsor>( backward_cache_lhs );
+                                        Tsor& rhs_ans = context_cast<Tsor>( backward_cache_rhs );
+                                        grad_fun( lhs_input, rhs_input, lhs_ans );
+                                        grad_fun( rhs_input, lhs_input, rhs_ans );
+                                        return std::make_tuple( lhs_ans, rhs_ans );
                                      },
                                      "elementwise_product"
                 )( lhs_ex, rhs_ex );
+        if constexpr ( is_value_v<Lhs_Expression> || is_value_v<Rhs_Expression> )
+            return ans;
+        else
+            return with_elementwise_kernel( ans,
+                                            []( auto a, auto b ) noexcept { return a * b; },
+                                            []( auto, auto b, auto g ) noexcept { return g * b; },
+                                            []( auto a, auto, auto g ) noexcept { return g * a; } );
     };
 
     template< Expression Lhs_Expression, Expression Rhs_Expression >
@@ -921,22 +1584,29 @@ namespace ceras
     template <Expression Ex>
     auto constexpr sum_reduce( Ex const& ex ) noexcept
     {
-        return make_unary_operator( []<Tensor Tsor>( Tsor const& tsor ) noexcept
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return with_reduction_kernel( make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& tsor ) noexcept
                                     {
                                         better_assert( !has_nan( tsor ), "forward propagation for operator sum_reduce: tensor contains Nan!" );
-                                        return reduce_sum( tsor );
+                                        Tsor& ans = context_cast<Tsor>( forward_cache );
+                                        reduce_sum( tsor, ans );
+                                        return ans;
                                     },
-                                    []<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         better_assert( !has_nan( grad ), "input gradient for operator sum_reduce contains NaN!" );
                                         better_assert( grad.size() == 1, "sum_reduce should only output one value" );
-                                        Tsor ans = ones_like( input );
-                                        ans *= grad[0];
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( input.shape() );
+                                        ans.fill( grad[0] );
                                         return ans;
                                     },
                                     "sum_reduce",
                                     []( std::vector<size_t> const& ) noexcept { return std::vector<size_t>{1}; }
-                )( ex );
+                )( ex ),
+                []( std::vector<size_t> const& ) noexcept { return 1.0; },
+                []( std::vector<size_t> const& ) noexcept { return 1.0; } );
     }
 
     template <Expression Ex>
@@ -960,24 +1630,30 @@ namespace ceras
     template <Expression Ex>
     auto constexpr mean_reduce( Ex const& ex ) noexcept
     {
-        return make_unary_operator( []<Tensor Tsor>( Tsor const& tsor ) noexcept
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return with_reduction_kernel( make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& tsor ) noexcept
                                     {
                                         better_assert( !has_nan( tsor ), "forward propagation for operator mean: tensor contains Nan!" );
-                                        return reduce_mean( tsor );
+                                        Tsor& ans = context_cast<Tsor>( forward_cache );
+                                        reduce_mean( tsor, ans );
+                                        return ans;
                                     },
-                                    []<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         better_assert( !has_nan( grad ), "input gradient for operator mean_reduce contains NaN!" );
                                         better_assert( grad.size() == 1, "mean_reduce should only output one value" );
-                                        Tsor ans = ones_like( input );
-                                        ans *= grad[0];
                                         size_t const batch_size = (input.shape().size() == 1) ? 1 : (*(input.shape().begin()));
-                                        ans /= static_cast<typename Tsor::value_type>(batch_size);
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( input.shape() );
+                                        ans.fill( grad[0] / static_cast<typename Tsor::value_type>(batch_size) );
                                         return ans;
                                     },
                                     "mean_reduce",
                                     []( std::vector<size_t> const& ) noexcept { return std::vector<size_t>{1}; }
-                )( ex );
+                )( ex ),
+                []( std::vector<size_t> const& shape ) noexcept { return 1.0 / static_cast<double>( std::accumulate( shape.begin(), shape.end(), 1UL, std::multiplies<size_t>() ) ); },
+                []( std::vector<size_t> const& shape ) noexcept { return 1.0 / static_cast<double>( (shape.size() == 1) ? 1UL : shape[0] ); } ); // as the backward action
     }
 
     ///
@@ -1036,23 +1712,28 @@ namespace ceras
     template <Expression Ex>
     auto constexpr square( Ex const& ex ) noexcept
     {
-        return make_unary_operator( []<Tensor Tsor>( Tsor const& tsor ) noexcept
+        std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+        std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+        return with_elementwise_kernel( make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& tsor ) noexcept
                                     {
                                         better_assert( !has_nan( tsor ), "forward propagation for operator square: tensor contains Nan!" );
-                                        Tsor ans = tsor.deep_copy();
-                                        std::for_each( ans.data(), ans.data() + ans.size(), []( auto & v ){ v *= v; } );
+                                        Tsor& ans = context_cast<Tsor>( forward_cache );
+                                        ans.resize( tsor.shape() );
+                                        for_each( tsor.begin(), tsor.end(), ans.begin(), []( auto x, auto& y ){ y = x * x; } );
                                         return ans;
                                     },
-                                    []<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                    [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         better_assert( !has_nan( grad ), "input gradient for operator square contains NaN!" );
-                                        Tsor ans = input.deep_copy();
-                                        ans *= grad;
-                                        ans *= typename Tsor::value_type{2};
+                                        Tsor& ans = context_cast<Tsor>( backward_cache );
+                                        ans.resize( input.shape() );
+                                        for_each( input.begin(), input.end(), grad.begin(), ans.begin(), []( auto x, auto g, auto& y ){ y = typename Tsor::value_type{2} * x * g; } );
                                         return ans;
                                     },
                                     "square"
-                )( ex );
+                )( ex ),
+                []( auto x ) noexcept { return x * x; },
+                []( auto x, auto, auto g ) noexcept { return vmath::constant<decltype(x)>( 2.0f ) * x * g; } );
     }
 
 
@@ -1081,22 +1762,27 @@ namespace ceras
     {
         return [lower, upper]<Expression Ex>( Ex const& ex ) noexcept
         {
-            return make_unary_operator( [lower, upper]<Tensor Tsor>( Tsor const& tsor ) noexcept
+            std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
+            return make_unary_operator( [lower, upper, forward_cache]<Tensor Tsor>( Tsor const& tsor ) noexcept
                                         {
                                             better_assert( !has_nan( tsor ), "forward propagation for operator clip: tensor contains Nan!" );
-                                            Tsor ans = tsor.deep_copy();
-                                            clip( ans, lower, upper );
+                                            typedef typename Tsor::value_type value_type;
+                                            Tsor& ans = context_cast<Tsor>( forward_cache );
+                                            ans.resize( tsor.shape() );
+                                            for_each( ans.begin(), ans.end(), tsor.begin(), [lower, upper]( value_type& a, value_type x ){ a = std::max( static_cast<value_type>(lower), std::min( static_cast<value_type>(upper), x ) ); } );
                                             return ans;
                                         },
-                                        [lower, upper]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
+                                        [lower, upper, backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                         {
                                             better_assert( !has_nan( grad ), "input gradient for operator clip contains NaN!" );
                                             const typename Tsor::value_type zero{0};
-                                            Tsor ans = grad;
+                                            Tsor& ans = context_cast<Tsor>( backward_cache );
+                                            ans.resize( grad.shape() );
                                             for ( auto idx : range( input.size() ) )
                                                 ans[idx] = (input[idx] < lower) ? zero :
                                                            (input[idx] > upper) ? zero :
-                                                           ans[idx];
+                                                           grad[idx];
                                             return ans;
                                         },
                                         "clip"
@@ -1476,41 +2162,14 @@ namespace ceras
         (
             [forward_cache]<Tensor Tsor>( Tsor const& tsor ) noexcept
             {
-                better_assert( tsor.ndim() == 2, "Expecting 2D tensor, but got dimensions ", tsor.ndim() );
-
-                typedef typename Tsor::value_type value_type;
-
-                std::vector<size_t> const shape = tsor.shape();
-                auto const[row, col] = std::make_tuple( shape[0], shape[1] );
-                view_2d<value_type> v_in{ tsor.data(), row, col };
-
                 Tsor& ans = context_cast<Tsor>( forward_cache );
-                ans.resize( {col, row} );
-                view_2d<value_type> v_out{ ans.data(), col, row };
-
-                for ( auto r : range( row ) )
-                    for ( auto c : range( col ) )
-                        v_out[c][r] = v_in[r][c];
-
+                transpose( tsor, ans );
                 return ans;
             },
             [backward_cache]<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) noexcept
             {
-                typedef typename Tsor::value_type value_type;
-
-                std::vector<size_t> const shape = grad.shape();
-                auto const[row, col] = std::make_tuple( shape[0], shape[1] );
-                view_2d<value_type> v_in{ grad.data(), row, col };
-
                 Tsor& back_ans = context_cast<Tsor>( backward_cache );
-                back_ans.resize( {col, row} );
-
-                view_2d<value_type> v_out{ back_ans.data(), col, row };
-
-                for ( auto r : range( row ) )
-                    for ( auto c : range( col ) )
-                        v_out[c][r] = v_in[r][c];
-
+                transpose( grad, back_ans );
                 return back_ans;
             },
             "transpose",
@@ -1598,12 +2257,15 @@ namespace ceras
                 }
             }
 
-            // fill-in
-            for ( auto idx : range( output_col_mat.size() ) )
+            // fill-in, row by row of the column matrix
+            parallel( [&]( size_t r )
             {
-                auto const index = index_record[idx];
-                output_col_mat[idx] = (index == 0xffffffff) ? value_type{0} : input_img[index];
-            }
+                for ( auto idx : range( r*output_column_matrix_col, (r+1)*output_column_matrix_col ) )
+                {
+                    auto const index = index_record[idx];
+                    output_col_mat[idx] = (index == 0xffffffff) ? value_type{0} : input_img[index];
+                }
+            }, size_t{0}, output_column_matrix_row );
         };
 
         auto img2col_backward = [s_index_record]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad, Tsor& ans ) noexcept
@@ -1759,6 +2421,118 @@ namespace ceras
         };
     }
 
+    ///
+    /// @brief Conv2D with int8 weights, computed in 8-bit integers, for inference.
+    ///
+    /// The input is quantized to unsigned bytes once, the patches are gathered from the bytes, a quarter of the memory of the
+    /// float column matrix, and multiplied by the packed weights to the [BS, .., .., NC] output directly, see `quantized_dense`
+    /// for the quantization of the input and the requantization epilogue. The operator has no gradient.
+    ///
+    /// @param weight The filters of shape [NC, r, c, CH], as for `general_conv2d`, quantized symmetrically per tensor or per output channel along axis 0.
+    /// @param bias The bias of size NC.
+    /// @param activation One of `linear`, `relu`, `sigmoid` and `tanh`, applied after the bias. Defaults to `linear`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto w = variable{ glorot_uniform<float>( {32, 3, 3, 1} ) };
+    /// auto b = variable{ zeros<float>( {1, 1, 32} ) };
+    /// // ... after training relu( general_conv2d( 1, 1, 1, 1, "same" )( x, w ) + b )
+    /// auto y = quantized_conv2d( quantize<std::int8_t>( w.data(), 0 ), b.data(), 1, 1, 1, 1, "same", "relu" )( x );
+    /// @endcode
+    ///
+    inline auto quantized_conv2d
+    (
+        quantized_tensor<std::int8_t> const& weight, tensor<float> const& bias,
+        size_t const row_stride=1, size_t const col_stride=1,
+        size_t const row_dilation=1, size_t const col_dilation=1,
+        std::string const& padding="valid", std::string const& activation="linear"
+    )
+    {
+        std::vector<size_t> const& shape = weight.shape();
+        better_assert( shape.size() == 4, fmt::format( "quantized_conv2d: expecting 4D filters, but got shape {}", shape ) );
+        auto const[new_channel, row_kernel, col_kernel, channel] = std::make_tuple( shape[0], shape[1], shape[2], shape[3] );
+        better_assert( bias.size() == new_channel, "quantized_conv2d: expecting bias of size ", new_channel, ", but got ", bias.size() );
+        size_t row_padding = 0;
+        size_t col_padding = 0;
+        if ( padding == "same" )
+        {
+            size_t const row_padding_total = (row_kernel + (row_kernel - 1) * (row_dilation - 1) - row_stride);
+            size_t const col_padding_total = (col_kernel + (col_kernel - 1) * (col_dilation - 1) - col_stride);
+            row_padding = ((row_kernel&1)+row_padding_total) >> 1;
+            col_padding = ((col_kernel&1)+col_padding_total) >> 1;
+        }
+        auto const& output_shape_of = [=]( std::vector<size_t> const& input_shape ) noexcept
+        {
+            better_assert( input_shape.size() == 4, fmt::format( "quantized_conv2d: expecting a 4D input, but got shape {}", input_shape ) );
+            size_t const row_output = ( input_shape[1] + 2 * row_padding - ( row_dilation * (row_kernel - 1) + 1 ) ) / row_stride + 1;
+            size_t const col_output = ( input_shape[2] + 2 * col_padding - ( col_dilation * (col_kernel - 1) + 1 ) ) / col_stride + 1;
+            return std::vector<size_t>{ {input_shape[0], row_output, col_output, new_channel} };
+        };
+
+        // the patches hold the channels of a pixel contiguous, as the input does, the flattened filters pair with the patches of
+        // `img2col`, channel by channel: their rows are reordered to match
+        size_t const patch_size = row_kernel * col_kernel * channel;
+        std::vector<std::int8_t> filters( new_channel * patch_size );
+        for ( auto nc : range( new_channel ) )
+            for ( auto c : range( patch_size ) )
+                filters[nc * patch_size + c] = weight.data_[nc * patch_size + ( c % channel ) * row_kernel * col_kernel + c / channel];
+        std::shared_ptr<int8_packed_matrix> packed = std::make_shared<int8_packed_matrix>( pack_int8( filters.data(), true, patch_size, new_channel ) );
+        std::vector<float> const scales = quantized_context::weight_scales( weight, 0, new_channel );
+
+        return [=]<Expression Ex>( Ex const& ex ) noexcept
+        {
+            std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> input_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> patch_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> accumulator_cache = std::make_shared<std::any>();
+            return make_unary_operator
+            (
+                [=]<Tensor Tsor>( Tsor const& input ) noexcept
+                {
+                    static_assert( std::is_same_v<typename Tsor::value_type, float>, "quantized_conv2d: expecting a float input." );
+                    std::vector<size_t> const& output_shape = output_shape_of( input.shape() );
+                    auto const [BS, R, C, CH] = std::make_tuple( input.shape()[0], input.shape()[1], input.shape()[2], input.shape()[3] );
+                    better_assert( CH == channel, "quantized_conv2d: expecting ", channel, " input channels, but got ", CH );
+                    auto const [row_output, col_output] = std::make_tuple( output_shape[1], output_shape[2] );
+
+                    auto& quantized_input = context_cast<quantized_context::activation_type>( input_cache );
+                    quantized_input.resize( input.size() );
+                    auto const [scale, zero_point] = quantized_context::quantize_input( input.data(), input.size(), quantized_input.data() );
+
+                    // the patches, one row per output pixel, the padding standing for zero
+                    size_t const pixels = BS * row_output * col_output;
+                    auto& patches = context_cast<quantized_context::activation_type>( patch_cache );
+                    patches.resize( pixels * patch_size );
+                    parallel( [&]( size_t output_row ) // of all the samples
+                    {
+                        quantized_context::gather_patches( quantized_input.data() + output_row / row_output * R * C * CH, R, C, CH,
+                                                           static_cast<std::int64_t>( output_row % row_output * row_stride ) - static_cast<std::int64_t>( row_padding ),
+                                                           col_output, col_stride, col_padding, row_kernel, col_kernel, row_dilation, col_dilation,
+                                                           static_cast<std::uint8_t>( zero_point ), patches.data() + output_row * col_output * patch_size );
+                    }, size_t{0}, BS * row_output );
+
+                    std::vector<float> multipliers( new_channel );
+                    for ( size_t j = 0; j != new_channel; ++j )
+                        multipliers[j] = scale * scales[j];
+
+                    Tsor& ans = context_cast<Tsor>( forward_cache );
+                    ans.resize( output_shape );
+                    auto& accumulator = context_cast<std::vector<std::int32_t>>( accumulator_cache );
+                    accumulator.resize( pixels * new_channel );
+                    int8_gemm( patches.data(), pixels, *packed, zero_point, accumulator.data(), quantized_context::make_epilogue( ans.data(), multipliers.data(), bias.data(), make_dense_activation( activation ) ) );
+                    return ans;
+                },
+                []<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) noexcept
+                {
+                    better_assert( false, "quantized_conv2d: an inference operator, without gradient." );
+                    return grad;
+                },
+                "quantized_conv2d",
+                output_shape_of
+            )( ex );
+        };
+    }
+
     ///
     /// @brief Conv2D Transpose intemediate layer
     ///
@@ -1799,7 +2573,7 @@ namespace ceras
                     std::vector<size_t> const& new_shape = shape_calculator( old_shape );
                     auto [bs, new_row, new_col, ch] = std::make_tuple( new_shape[0], new_shape[1], new_shape[2], new_shape[3] );
 
-                    auto ans = context_cast<Tsor>( forward_cache );
+                    Tsor& ans = context_cast<Tsor>( forward_cache );
                     ans.resize( new_shape );
                     std::fill( ans.begin(), ans.end(), value_type{0} ); // just in case not initialized
                     view_4d<value_type> output_4d{ ans.data(), bs, new_row, new_col, ch };
@@ -1821,13 +2595,13 @@ namespace ceras
                     typedef typename Tsor::value_type value_type;
                     std::vector<size_t> const& input_shape = input.shape();
                     auto [bs, i_row, i_col, ch] = std::make_tuple( input_shape[0], input_shape[1], input_shape[2], input_shape[3] );
-                    auto back_ans = context_cast<Tsor>( backward_cache );
+                    Tsor& back_ans = context_cast<Tsor>( backward_cache );
                     back_ans.resize( input_shape );
                     view_4d<value_type> b_4d{ back_ans.data(), bs, i_row, i_col, ch };
 
                     std::vector<size_t> const& output_shape = grad.shape();
                     auto [_bs, o_row, o_col, _ch] = std::make_tuple( output_shape[0], output_shape[1], output_shape[2], output_shape[3] );
-                    view_4d<value_type> g_4d{ grad.data(), bs, o_row, o_col, ch };
+                    view_4d<value_type const> g_4d{ grad.data(), bs, o_row, o_col, ch };
 
                     size_t row_offset = (padding == std::string{"valid"}) ? (row_kernel-1) : 0;
                     size_t col_offset = (padding == std::string{"valid"}) ? (col_kernel-1) : 0;
@@ -1915,10 +2689,9 @@ namespace ceras
                     Tsor& mask__ = std::any_cast<Tsor&>( mask_ );
 
                     Tsor& ans = context_cast<Tsor>( forward_cache );
-                    ans.deep_copy( input );
-
-                    for ( auto idx : range( input.size() ) )
-                        ans[idx] *= mask__[idx] / (value_type{1} - factor);
+                    ans.resize( input.shape() );
+                    value_type const scale = value_type{1} / (value_type{1} - factor);
+                    for_each( ans.begin(), ans.end(), input.begin(), mask__.begin(), [scale]( value_type& a, value_type x, value_type m ){ a = x * m * scale; } );
                     return ans;
                 },
                 [mask, backward_cache]<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) noexcept
@@ -1929,10 +2702,8 @@ namespace ceras
                     Tsor& mask__ = std::any_cast<Tsor&>( *mask );
 
                     Tsor& ans = context_cast<Tsor>( backward_cache );
-                    ans.deep_copy( grad );
-
-                    for ( auto idx : range( grad.size() ) )
-                        ans[idx] *= mask__[idx];
+                    ans.resize( grad.shape() );
+                    for_each( ans.begin(), ans.end(), grad.begin(), mask__.begin(), []( auto& a, auto g, auto m ){ a = g * m; } );
                     return ans;
                 },
                 "dropout",
@@ -1969,6 +2740,7 @@ namespace ceras
 
                         Tsor& mask__ = context_cast<Tsor>( mask );
                         mask__.resize( input.shape() );
+                        std::fill( mask__.begin(), mask__.end(), value_type{0} ); // the buffer is not initialized, and may hold the mask of the last batch
 
 
                         std::vector<size_t> shape = input.shape();
@@ -2021,6 +2793,7 @@ namespace ceras
 
                         Tsor& ans = context_cast<Tsor>( backward_cache );
                         ans.resize( input.shape() );
+                        std::fill( ans.begin(), ans.end(), value_type{0} );
 
                         view_4d<value_type> ta{ ans.data(), batch_size, row, col, channel };
 
@@ -2394,24 +3167,32 @@ namespace ceras
     {
         return [&]( size_t axe = -1 ) noexcept
         {
+            std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
+            std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
             return make_binary_operator
             (
-                [axe]<Tensor Tsor>( Tsor const& lhs_tensor, Tsor const& rhs_tensor ) noexcept
+                [axe, forward_cache]<Tensor Tsor>( Tsor const& lhs_tensor, Tsor const& rhs_tensor ) noexcept
                 {
-                    return concatenate( lhs_tensor, rhs_tensor, axe );
+                    Tsor& ans = context_cast<Tsor>( forward_cache );
+                    concatenate( lhs_tensor, rhs_tensor, axe, ans );
+                    return ans;
                 },
-                [axe]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const grad ) noexcept
+                [axe, backward_cache_lhs, backward_cache_rhs]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const& grad ) noexcept
                 {
                     typedef typename Tsor::value_type value_type;
 
-                    Tsor l_ans{ lhs_input.shape() };
-                    Tsor r_ans{ rhs_input.shape() };
+                    Tsor& l_ans = context_cast<Tsor>( backward_cache_lhs );
+                    l_ans.resize( lhs_input.shape() );
+                    Tsor& r_ans = context_cast<Tsor>( backward_cache_rhs );
+                    r_ans.resize( rhs_input.shape() );
                     better_assert(  l_ans.size() + r_ans.size() == grad.size(), "size mismatch: lhs size is ", l_ans.size(), " rhs size is ", r_ans.size(), " and grad size is ", grad.size(),
                                     " with lhs dim is ", l_ans.ndim(), "  and rhs dim is ", r_ans.ndim() );
 
                     // 2D view of grad
                     size_t const ax = (axe == (size_t)(-1)) ? grad.ndim()-1 : axe;
-                    size_t const g_col = std::accumulate( grad.shape().begin()+ax, grad.shape().end(), 1UL, []( size_t x, size_t y ){ return x*y; } );
+                    std::vector<size_t> const g_shape = grad.shape();
+                    size_t const g_col = std::accumulate( g_shape.begin()+ax, g_shape.end(), 1UL, []( size_t x, size_t y ){ return x*y; } );
                     size_t const g_row = grad.size() / g_col;
                     view_2d<value_type> v_g{ grad.data(), g_row, g_col };
 
@@ -2436,13 +3217,13 @@ namespace ceras
                     return std::make_tuple( l_ans, r_ans );
                 },
                 "concatenate",
-                [axe]( std::vector<size_t> const& l, std::vector<size_t> const& r ) mutable noexcept
+                [axe]( std::vector<size_t> const& l, std::vector<size_t> const& r ) noexcept
                 {
                     better_assert( l.size() == r.size(), fmt::format( "expecting of same size, but lhs.size is {} and rhs.size is {}.", l.size(), r.size() ) );
                     // more assertion ?
                     std::vector<size_t> ans = l;
-                    if ( axe > ans.size() ) axe = ans.size() - 1;
-                    ans[axe] += r[axe];
+                    size_t const ax = ( axe >= ans.size() ) ? ans.size() - 1 : axe;
+                    ans[ax] += r[ax];
                     return ans;
                 },
                 make_argumented_operator_serializer( axe )
@@ -2477,7 +3258,6 @@ namespace ceras
     auto constexpr maximum( Lhs_Expression const& lhs_ex, Rhs_Expression const& rhs_ex ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
-        std::shared_ptr<std::any> mask_cache = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
         return make_binary_operator
@@ -2488,23 +3268,19 @@ namespace ceras
 
                 Tsor& ans = context_cast<Tsor>( forward_cache );
                 ans.resize( lhs_tensor.shape() );
-                Tsor& mask = context_cast<Tsor>( mask_cache ); // 1 if lhs element is larger, 0 if rhs element is larger
-                mask.resize( lhs_tensor.shape() );
-
-                for_each( lhs_tensor.begin(), lhs_tensor.end(), rhs_tensor.begin(), ans.begin(), mask.begin(), []( auto const l, auto const r, auto& a, auto& m ) { m = l > r ? 1.0 : 0.0; a = l > r ? l : r; } );
+                broadcast_binary( lhs_tensor.data(), lhs_tensor.shape(), rhs_tensor.data(), rhs_tensor.shape(), ans.data(), ans.shape(), []( auto const l, auto const r ) { return l > r ? l : r; } );
 
                 return ans;
             },
             [=]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const& grad ) noexcept
             {
-                Tsor& mask = context_cast<Tsor>( mask_cache ); // 1 if lhs element is larger, 0 if rhs element is larger
-
                 Tsor& l_ans = context_cast<Tsor>( backward_cache_lhs );
                 l_ans.resize( lhs_input.shape() );
                 Tsor& r_ans = context_cast<Tsor>( backward_cache_rhs );
                 r_ans.resize( rhs_input.shape() );
 
-                for_each( grad.begin(), grad.end(), mask.begin(), l_ans.begin(), r_ans.begin(), []( auto const g, auto const m, auto& l, auto& r ) { if ( m > 0.5 ) { l = g; r = 0.0; } else { l = 0.0; r = g; } } );
+                // the gradient goes to the larger element
+                for_each( grad.begin(), grad.end(), lhs_input.begin(), rhs_input.begin(), l_ans.begin(), r_ans.begin(), []( auto const g, auto const x, auto const y, auto& l, auto& r ) { if ( x > y ) { l = g; r = 0.0; } else { l = 0.0; r = g; } } );
 
                 return std::make_tuple( l_ans, r_ans );
             },
@@ -2516,7 +3292,6 @@ namespace ceras
     auto constexpr minimum( Lhs_Expression const& lhs_ex, Rhs_Expression const& rhs_ex ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
-        std::shared_ptr<std::any> mask_cache = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache_lhs = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache_rhs = std::make_shared<std::any>();
         return make_binary_operator
@@ -2527,23 +3302,19 @@ namespace ceras
 
                 Tsor& ans = context_cast<Tsor>( forward_cache );
                 ans.resize( lhs_tensor.shape() );
-                Tsor& mask = context_cast<Tsor>( mask_cache ); // 1 if lhs element is larger, 0 if rhs element is larger
-                mask.resize( lhs_tensor.shape() );
-
-                for_each( lhs_tensor.begin(), lhs_tensor.end(), rhs_tensor.begin(), ans.begin(), mask.begin(), []( auto const l, auto const r, auto& a, auto& m ) { m = l > r ? 0.0: 1.0 ; a = l > r ? r: l; } );
+                broadcast_binary( lhs_tensor.data(), lhs_tensor.shape(), rhs_tensor.data(), rhs_tensor.shape(), ans.data(), ans.shape(), []( auto const l, auto const r ) { return l > r ? r : l; } );
 
                 return ans;
             },
             [=]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const& grad ) noexcept
             {
-                Tsor& mask = context_cast<Tsor>( mask_cache ); // 1 if lhs element is larger, 0 if rhs element is larger
-
                 Tsor& l_ans = context_cast<Tsor>( backward_cache_lhs );
                 l_ans.resize( lhs_input.shape() );
                 Tsor& r_ans = context_cast<Tsor>( backward_cache_rhs );
                 r_ans.resize( rhs_input.shape() );
 
-                for_each( grad.begin(), grad.end(), mask.begin(), l_ans.begin(), r_ans.begin(), []( auto const g, auto const m, auto& l, auto& r ) { if ( m < 0.5 ) { l = g; r = 0.0; } else { l = 0.0; r = g; } } );
+                // the gradient goes to the smaller element
+                for_each( grad.begin(), grad.end(), lhs_input.begin(), rhs_input.begin(), l_ans.begin(), r_ans.begin(), []( auto const g, auto const x, auto const y, auto& l, auto& r ) { if ( x > y ) { l = 0.0; r = g; } else { l = g; r = 0.0; } } );
 
                 return std::make_tuple( l_ans, r_ans );
             },
@@ -2567,7 +3338,7 @@ namespace ceras
                 better_assert( lhs_tensor.shape() == rhs_tensor.shape(), "tensor shape mismatch." );
                 Tsor& ans = context_cast<Tsor>( forward_cache );
                 ans.resize( lhs_tensor.shape() );
-                for_each( lhs_tensor.begin(), lhs_tensor.end(), rhs_tensor.begin(), ans.begin(), []( auto const l, auto const r, auto& a ) { a = std::atan2(l, r); } );
+                broadcast_binary( lhs_tensor.data(), lhs_tensor.shape(), rhs_tensor.data(), rhs_tensor.shape(), ans.data(), ans.shape(), []( auto const l, auto const r ) { return std::atan2(l, r); } );
                 return ans;
             },
             [=]<Tensor Tsor>( Tsor const& lhs_input, Tsor const& rhs_input, Tsor const&, Tsor const& grad ) noexcept
@@ -2672,7 +3443,7 @@ namespace ceras
     /// auto eq = equal(l, r);
     /// @endcode
     ///
-    template< Expression Lhs_Expression, Expression Rhs_Expression, std::floating_point FP >
+    template< Expression Lhs_Expression, Expression Rhs_Expression, std::floating_point FP=double >
     auto constexpr equal( Lhs_Expression const& lhs_ex, Rhs_Expression const& rhs_ex, FP threshold=0.5 ) noexcept
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
@@ -2693,6 +3464,7 @@ namespace ceras
             {
                 typedef typename Tsor::value_type value_type;
                 Tsor& ans = context_cast<Tsor>( backward_cache );
+                ans.resize( lhs_input.shape() );
                 std::fill( ans.begin(), ans.end(), value_type{0} );
                 return std::make_tuple( ans, ans );
             },
@@ -3001,7 +3773,7 @@ namespace ceras
                         auto const[batch_size, row, col, channel] = std::make_tuple(shape[0], shape[1], shape[2], shape[3]);
                         view_4d vi{tsor.data(), batch_size, row, col, channel};
 
-                        tensor<long> shifts = context_cast<tensor<long>>( shift_cache );
+                        tensor<long>& shifts = context_cast<tensor<long>>( shift_cache );
                         shifts.resize( {channel, 2} );
                         {   //generating random shifts
                             std::uniform_int_distribution<long> distribution( -pixels, pixels );
@@ -3041,7 +3813,7 @@ namespace ceras
                         std::vector<size_t> const& shape = grad.shape();
                         auto const[batch_size, row, col, channel] = std::make_tuple( shape[0], shape[1], shape[2], shape[3] );
                         view_4d vi{grad.data(), batch_size, row, col, channel};
-                        tensor<long> shifts = context_cast<tensor<long>>( shift_cache );
+                        tensor<long> const& shifts = context_cast<tensor<long>>( shift_cache );
                         view_2d _shifts{shifts.data(), channel, 2};
 
                         Tsor& ans = context_cast<Tsor>( backward_cache );
@@ -3141,7 +3913,7 @@ namespace ceras
 
                         Tsor& ans = context_cast<Tsor>( backward_cache );
                         ans.resize( input.shape() );
-                        ans.reset();
+                        ans.fill();
 
                         view_2d v2{ans.data(), iterations, stride };
                         view_3d v3{ grad.data(), iterations, repeats, stride };
@@ -3187,11 +3959,11 @@ namespace ceras
                 repeat_context{}.make_forward()( repeats, axis, forward_cache ),
                 repeat_context{}.make_backward()( repeats, axis, backward_cache ),
                 "repeat",
-                [=]( std::vector<size_t> const& shape ) mutable noexcept
+                [=]( std::vector<size_t> const& shape ) noexcept
                 {
                     std::vector<size_t> ans = shape;
-                    if ( axis >= ans.size() ) axis = ans.size()-1;
-                    ans[axis] *= repeats;
+                    size_t const ax = ( axis >= ans.size() ) ? ans.size()-1 : axis;
+                    ans[ax] *= repeats;
                     return ans;
                 },
                 make_argumented_operator_serializer( repeats, axis )
@@ -3273,7 +4045,7 @@ namespace ceras
 
                         Tsor& ans = context_cast<Tsor>( backward_cache );
                         ans.resize( shape ); // example: ans shape is ( 2, 3, 4, 5 )
-                        ans.reset();
+                        ans.fill();
 
                         view_2d v_index{ index.data(), iterations, stride }; // example: viewing as a matrix of ( 2, 20 )
                         view_3d v3{ ans.data(), iterations, scales, stride }; // example: view as a cube of ( 2, 3, 20 )
@@ -3320,11 +4092,11 @@ namespace ceras
                 reduce_min_context{}.make_forward()( axis, forward_cache, index_cache ),
                 reduce_min_context{}.make_backward()( axis, backward_cache, index_cache ),
                 "reduce_min",
-                [=]( std::vector<size_t> const& shape ) mutable noexcept
+                [=]( std::vector<size_t> const& shape ) noexcept
                 {
                     std::vector<size_t> ans = shape;
-                    if ( axis >= shape.size() ) axis = shape.size() - 1;
-                    std::copy( ans.begin()+axis+1, ans.end(), ans.begin()+axis );
+                    size_t const ax = ( axis >= shape.size() ) ? shape.size() - 1 : axis;
+                    std::copy( ans.begin()+ax+1, ans.end(), ans.begin()+ax );
                     ans.resize( ans.size() - 1 );
                     return ans;
                 },
@@ -3408,7 +4180,7 @@ namespace ceras
 
                         Tsor& ans = context_cast<Tsor>( backward_cache );
                         ans.resize( shape ); // example: ans shape is ( 2, 3, 4, 5 )
-                        ans.reset();
+                        ans.fill();
 
                         view_2d v_index{ index.data(), iterations, stride }; // example: viewing as a matrix of ( 2, 20 )
                         view_3d v3{ ans.data(), iterations, scales, stride }; // example: view as a cube of ( 2, 3, 20 )
@@ -3455,11 +4227,11 @@ namespace ceras
                 reduce_max_context{}.make_forward()( axis, forward_cache, index_cache ),
                 reduce_max_context{}.make_backward()( axis, backward_cache, index_cache ),
                 "reduce_max",
-                [=]( std::vector<size_t> const& shape ) mutable noexcept
+                [=]( std::vector<size_t> const& shape ) noexcept
                 {
                     std::vector<size_t> ans = shape;
-                    if ( axis >= shape.size() ) axis = shape.size() - 1;
-                    std::copy( ans.begin()+axis+1, ans.end(), ans.begin()+axis );
+                    size_t const ax = ( axis >= shape.size() ) ? shape.size() - 1 : axis;
+                    std::copy( ans.begin()+ax+1, ans.end(), ans.begin()+ax );
                     ans.resize( ans.size() - 1 );
                     return ans;
                 },
@@ -3529,7 +4301,7 @@ namespace ceras
 
                         Tsor& ans = context_cast<Tsor>( backward_cache );
                         ans.resize( shape ); // example: ans shape is ( 2, 3, 4, 5 )
-                        ans.reset();
+                        ans.fill();
 
                         view_3d v3{ ans.data(), iterations, scales, stride }; // example: view as a cube of ( 2, 3, 20 )
                         view_2d v2{ grad.data(), iterations, stride }; // example: viewing as a matrix of ( 2, 20 )
@@ -3571,11 +4343,11 @@ namespace ceras
                 reduce_sum_context{}.make_forward()( axis, forward_cache ),
                 reduce_sum_context{}.make_backward()( axis, backward_cache ),
                 "reduce_sum",
-                [=]( std::vector<size_t> const& shape ) mutable noexcept
+                [=]( std::vector<size_t> const& shape ) noexcept
                 {
                     std::vector<size_t> ans = shape;
-                    if ( axis >= shape.size() ) axis = shape.size() - 1;
-                    std::copy( ans.begin()+axis+1, ans.end(), ans.begin()+axis );
+                    size_t const ax = ( axis >= shape.size() ) ? shape.size() - 1 : axis;
+                    std::copy( ans.begin()+ax+1, ans.end(), ans.begin()+ax );
                     ans.resize( ans.size() - 1 );
                     return ans;
                 },
@@ -4010,14 +4782,14 @@ namespace ceras
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        for_each( input.begin(), input.end(), ans.begin(), []( auto x, auto& v ) noexcept { v = std::erf(x); } );
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ) noexcept { return vmath::erf( x ); } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
                                     {
                                         Tsor& ans = context_cast<Tsor>( backward_cache );
                                         ans.resize( input.shape() );
-                                        for_each( input.begin(), input.end(), grad.begin(), ans.begin(), []( auto x, auto g, auto& v ) noexcept { v = typename Tsor::value_type{1.12837916709551257389} * g * std::exp(-x*x); } );
+                                        vectorized_map( input.data(), grad.data(), ans.data(), input.size(), []( auto x, auto g ) noexcept { return vmath::constant<decltype(x)>( 1.12837916709551257389 ) * g * vmath::exp( -(x*x) ); } );
                                         return ans;
                                     },
                                     "erf"
@@ -4055,7 +4827,7 @@ namespace ceras
                                     {
                                         Tsor& ans = context_cast<Tsor>( backward_cache );
                                         ans.resize( input.shape() );
-                                        for_each( input.begin(), input.end(), grad.begin(), ans.begin(), []( auto x, auto g, auto& v ) noexcept { v = typename Tsor::value_type{-1.12837916709551257389} * g * std::exp(-x*x); } );
+                                        vectorized_map( input.data(), grad.data(), ans.data(), input.size(), []( auto x, auto g ) noexcept { return vmath::constant<decltype(x)>( -1.12837916709551257389 ) * g * vmath::exp( -(x*x) ); } );
                                         return ans;
                                     },
                                     "erfc"
@@ -4085,7 +4857,7 @@ namespace ceras
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        for_each( input.begin(), input.end(), ans.begin(), []( auto x, auto& v ) noexcept { v = std::exp(x); } );
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ) noexcept { return vmath::exp( x ); } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const& output, Tsor const& grad ) noexcept
@@ -4319,7 +5091,7 @@ namespace ceras
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        for_each( input.begin(), input.end(), ans.begin(), []( auto x, auto& v ) noexcept { v = std::log(x); } );
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ) noexcept { return vmath::log( x ); } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const&, Tsor const& grad ) noexcept
@@ -4774,11 +5546,11 @@ namespace ceras
     {
         std::shared_ptr<std::any> forward_cache = std::make_shared<std::any>();
         std::shared_ptr<std::any> backward_cache = std::make_shared<std::any>();
-        return make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
+        return with_elementwise_kernel( make_unary_operator( [forward_cache]<Tensor Tsor>( Tsor const& input ) noexcept
                                     {
                                         Tsor& ans = context_cast<Tsor>( forward_cache );
                                         ans.resize( input.shape() );
-                                        for_each( input.begin(), input.end(), ans.begin(), []( auto x, auto& v ) noexcept { v = std::tanh(x); } );
+                                        vectorized_map( input.data(), ans.data(), input.size(), []( auto x ) noexcept { return vmath::tanh( x ); } );
                                         return ans;
                                     },
                                     [backward_cache]<Tensor Tsor>( Tsor const& input, Tsor const& output, Tsor const& grad ) noexcept
@@ -4789,7 +5561,9 @@ namespace ceras
                                         return ans;
                                     },
                                     "tanh"
-                )( ex );
+                )( ex ),
+                []( auto x ) noexcept { return vmath::tanh( x ); },
+                []( auto, auto o, auto g ) noexcept { return g * ( vmath::constant<decltype(o)>( 1.0f ) - o * o ); } );
     };
 
 
@@ -4911,6 +5685,7 @@ namespace ceras
                                         return ans;
                                     },
                                     "pow",
+                                    identity_output_shape_calculator{},
                                     [exponent]<Expression Self_Expression, Expression Input_Expression>( Self_Expression const& self_expression, Input_Expression const& input_expression ) noexcept
                                     { // serializer
                                         auto const& [input_expression_name, input_expression_code] = serialize( input_expression );
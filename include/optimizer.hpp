@@ -15,6 +15,51 @@
 namespace ceras
 {
 
+    namespace optimizer_private
+    {
+        // the float copies a variable of 16-bit values is updated through
+        struct float_variable_state
+        {
+            tensor<float> data_;
+            tensor<float> gradient_;
+            std::vector<tensor<float>> contexts_;
+        };
+
+        typedef std::shared_ptr<std::unordered_map<int, float_variable_state>> float_states_type;
+
+        //
+        // Calls `update( data, gradient, contexts )` for a trainable variable, then clears its gradient. The updates write through
+        // `begin()`, in place, as the weights share their buffer with the inputs cached by the operators; the compound assignments of
+        // a tensor would give them a copy of their own, see the rules of `tensor`.
+        //
+        // A variable of `bfloat16` or `float16` values is updated through float copies of its weights and of the contexts of the
+        // optimizer, kept in `float_states` and rounded to 16 bits after every step: updated in place, a step smaller than half
+        // a unit in the last place of a weight, 1/512 of the weight for a `bfloat16`, would be lost.
+        //
+        template< typename Variable, typename Function >
+        void update_variable( int id, Variable& v, float_states_type const& float_states, Function const& update )
+        {
+            typedef typename Variable::value_type value_type;
+            if constexpr( Half_Float<value_type> )
+            {
+                auto [itor, created] = (*float_states).try_emplace( id );
+                auto& state = (*itor).second;
+                if ( created )
+                    state.data_ = v.data().template as_type<float>();
+                state.gradient_.resize( v.gradient().shape() );
+                convert( v.gradient().data(), state.gradient_.data(), v.gradient().size() );
+                update( state.data_, state.gradient_, state.contexts_ );
+                convert( state.data_.data(), v.data().data(), state.data_.size() );
+            }
+            else
+            {
+                update( v.data(), v.gradient(), v.contexts() );
+            }
+            v.gradient().reset(); // clear variable gradient
+        }
+
+    }//namespace optimizer_private
+
     // sgd:
     //     - loss:
     //     - batch_size:
@@ -26,7 +71,9 @@ namespace ceras
     template< typename Loss, typename T >
     struct sgd : enable_id<sgd<Loss, T>, "sgd optimizer">, enable_shared<sgd<Loss, T>>
     {
-        typedef tensor< T > tensor_type;
+        typedef std::remove_cv_t<decltype(std::declval<Loss&>().forward())> tensor_type; // `tensor<bfloat16>` for a model of 16-bit values
+        typedef typename tensor_type::value_type value_type;
+        optimizer_private::float_states_type float_states_ = std::make_shared<std::unordered_map<int, optimizer_private::float_variable_state>>();
 
         Loss&         loss_;
         T             learning_rate_;
@@ -44,24 +91,22 @@ namespace ceras
 
         void forward()
         {
-            loss_.backward( ones<T>( {1, } ) );
+            loss_.backward( ones<value_type>( {1, } ) );
             learning_rate_ /= ( 1.0 + decay_ * iterations_ );
             auto& ss = get_default_session<tensor_type>();
             for ( auto [id, v] : ss.variables_ )
             {
                 if (v.trainable_)
                 {
-                    auto& data = v.data();
-                    auto& gradient = v.gradient();
-                    auto& contexts = v.contexts();
-                    if ( contexts.empty() ) // create context
-                        contexts.push_back( zeros_like( data ) );
-                    auto& moments = contexts[0];
-                    for_each( moments.begin(), moments.end(), gradient.begin(), [this]( T& m, T g ) { m *= (*this).momentum_; m -= (*this).learning_rate_ * g;} );
-                    if (!nesterov_ ) for_each( moments.begin(), moments.end(), data.begin(), gradient.begin(), [this]( T m, T& v, T g ) { v += (*this).momentum_ * m - (*this).learning_rate_ * g; } );
-                    else data += moments;
-
-                    gradient.reset(); // clear variable gradient
+                    optimizer_private::update_variable( id, v, float_states_, [&]( auto& data, auto& gradient, auto& contexts )
+                    {
+                        if ( contexts.empty() ) // create context
+                            contexts.push_back( zeros_like( data ) );
+                        auto& moments = contexts[0];
+                        for_each( moments.begin(), moments.end(), gradient.begin(), [this]( auto& m, auto g ) { m *= (*this).momentum_; m -= (*this).learning_rate_ * g;} );
+                        if (!nesterov_ ) for_each( moments.begin(), moments.end(), data.begin(), gradient.begin(), [this]( auto m, auto& v, auto g ) { v += (*this).momentum_ * m - (*this).learning_rate_ * g; } );
+                        else for_each( data.begin(), data.end(), moments.begin(), []( auto& v, auto m ) { v += m; } );
+                    } );
                 }
             }
             ++iterations_;
@@ -71,7 +116,9 @@ namespace ceras
     template< typename Loss, typename T >
     struct adagrad : enable_id<adagrad<Loss, T >, "adagrad optimizer">, enable_shared<adagrad<Loss,T>>
     {
-        typedef tensor< T > tensor_type;
+        typedef std::remove_cv_t<decltype(std::declval<Loss&>().forward())> tensor_type; // `tensor<bfloat16>` for a model of 16-bit values
+        typedef typename tensor_type::value_type value_type;
+        optimizer_private::float_states_type float_states_ = std::make_shared<std::unordered_map<int, optimizer_private::float_variable_state>>();
 
         Loss&         loss_;
         T             learning_rate_;
@@ -87,7 +134,7 @@ namespace ceras
 
         void forward()
         {
-            loss_.backward( ones<T>( {1, } ) );
+            loss_.backward( ones<value_type>( {1, } ) );
 
             learning_rate_ /= ( 1.0 + decay_ * iterations_ );
 
@@ -96,19 +143,17 @@ namespace ceras
             {
                 if (v.trainable_)
                 {
-                    auto& data = v.data();
-                    auto& gradient = v.gradient();
-                    auto& contexts = v.contexts();
-                    if ( contexts.empty() ) // create context
-                        contexts.push_back( zeros_like( data ) );
-                        //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
-                    auto& moments = contexts[0];
-
-                    for_each( moments.begin(), moments.end(), gradient.begin(), []( T& m, T g ) { m  += g*g; } );
+                    optimizer_private::update_variable( id, v, float_states_, [&]( auto& data, auto& gradient, auto& contexts )
+                    {
+                        if ( contexts.empty() ) // create context
+                            contexts.push_back( zeros_like( data ) );
+                            //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
+                        auto& moments = contexts[0];
 
-                    for_each( data.begin(), data.end(), gradient.begin(), moments.begin(), [this]( T& d, T g, T m ) { d -= (*this).learning_rate_ * g / (eps + std::sqrt(m)); } );
+                        for_each( moments.begin(), moments.end(), gradient.begin(), []( auto& m, auto g ) { m  += g*g; } );
 
-                    gradient.reset(); // clear variable gradient
+                        for_each( data.begin(), data.end(), gradient.begin(), moments.begin(), [this]( auto& d, auto g, auto m ) { d -= (*this).learning_rate_ * g / (eps + std::sqrt(m)); } );
+                    } );
                 }
             }
             ++iterations_;
@@ -121,7 +166,9 @@ namespace ceras
     template< typename Loss, typename T >
     struct rmsprop : enable_id< rmsprop< Loss, T >, "rmsprop optimizer" >, enable_shared<rmsprop<Loss, T>>
     {
-        typedef tensor< T > tensor_type;
+        typedef std::remove_cv_t<decltype(std::declval<Loss&>().forward())> tensor_type; // `tensor<bfloat16>` for a model of 16-bit values
+        typedef typename tensor_type::value_type value_type;
+        optimizer_private::float_states_type float_states_ = std::make_shared<std::unordered_map<int, optimizer_private::float_variable_state>>();
 
         Loss&         loss_;
         T             learning_rate_;
@@ -138,7 +185,7 @@ namespace ceras
 
         void forward()
         {
-            loss_.backward( ones<T>( {1, } ) );
+            loss_.backward( ones<value_type>( {1, } ) );
 
             learning_rate_ /= ( 1.0 + decay_ * iterations_ );
 
@@ -147,22 +194,20 @@ namespace ceras
             {
                 if (v.trainable_)
                 {
-                    auto& data = v.data();
-                    auto& gradient = v.gradient();
-                    auto& contexts = v.contexts();
-                    if ( contexts.empty() ) // create context
-                        contexts.push_back( zeros_like( data ) );
-                        //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
-                    auto& moments = contexts[0];
-
-                    if ( iterations_ == 0 )
-                        for_each( moments.begin(), moments.end(), gradient.begin(), [this]( T& m, T g ) { m = g*g; } );
-                    else
-                        for_each( moments.begin(), moments.end(), gradient.begin(), [this]( T& m, T g ) { m *= (*this).rho_; m  += g*g*(1.0-(*this).rho_); } );
-
-                    for_each( data.begin(), data.end(), gradient.begin(), moments.begin(), [this]( T& d, T g, T m ) { d -= (*this).learning_rate_ * g / (eps + std::sqrt(m)); } );
-
-                    gradient.reset(); // clear variable gradient
+                    optimizer_private::update_variable( id, v, float_states_, [&]( auto& data, auto& gradient, auto& contexts )
+                    {
+                        if ( contexts.empty() ) // create context
+                            contexts.push_back( zeros_like( data ) );
+                            //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
+                        auto& moments = contexts[0];
+
+                        if ( iterations_ == 0 )
+                            for_each( moments.begin(), moments.end(), gradient.begin(), [this]( auto& m, auto g ) { m = g*g; } );
+                        else
+                            for_each( moments.begin(), moments.end(), gradient.begin(), [this]( auto& m, auto g ) { m *= (*this).rho_; m  += g*g*(1.0-(*this).rho_); } );
+
+                        for_each( data.begin(), data.end(), gradient.begin(), moments.begin(), [this]( auto& d, auto g, auto m ) { d -= (*this).learning_rate_ * g / (eps + std::sqrt(m)); } );
+                    } );
                 }
             }
             ++iterations_;
@@ -175,7 +220,9 @@ namespace ceras
     template< typename Loss, typename T >
     struct adadelta : enable_id< adadelta< Loss, T >, "adadelta optimizer" >, enable_shared<adadelta<Loss, T>>
     {
-        typedef tensor< T > tensor_type;
+        typedef std::remove_cv_t<decltype(std::declval<Loss&>().forward())> tensor_type; // `tensor<bfloat16>` for a model of 16-bit values
+        typedef typename tensor_type::value_type value_type;
+        optimizer_private::float_states_type float_states_ = std::make_shared<std::unordered_map<int, optimizer_private::float_variable_state>>();
 
         Loss&         loss_;
         T             rho_;
@@ -190,52 +237,50 @@ namespace ceras
 
         void forward()
         {
-            loss_.backward( ones<T>( {1, } ) );
+            loss_.backward( ones<value_type>( {1, } ) );
 
             auto& ss = get_default_session<tensor_type>();//.get();
             for ( auto [id, v] : ss.variables_ )
             {
                 if (v.trainable_)
                 {
-                    auto& data = v.data();
-                    auto& gradient = v.gradient();
-                    auto& contexts = v.contexts();
-                    if ( contexts.empty() ) // create context
-                    {
-                        //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
-                        //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
-                        contexts.push_back( zeros_like( data ) );
-                        contexts.push_back( zeros_like( data ) );
-                    }
-                    auto& moments = contexts[0];
-                    auto& delta = contexts[0];
-
-                    /*
-                    if (iterations_==0)
+                    optimizer_private::update_variable( id, v, float_states_, [&]( auto& data, auto& gradient, auto& contexts )
                     {
-                        for_each( moments.begin(), moments.end(), gradient.begin(), []( T& m, T g ) { m += g*g; } );
-                        for_each( delta.begin(), delta.end(), gradient.begin(), []( T& d, T g ) { d += g*g; } );
-                    }
-                    else
-                    {
-                        // m = rho * m + (1-rho) * g * g;
-                        for_each( moments.begin(), moments.end(), gradient.begin(), [this]( T& m, T g ) { m *= (*this).rho_; m  += g*g*(1.0-(*this).rho_); } );
-                    }
-                    */
-
-                    for_each( moments.begin(), moments.end(), gradient.begin(), [this]( T& m, T g ) { m *= (*this).rho_; m  += g*g*(1.0-(*this).rho_); } );
-
-                    // g_ = \sqrt{ (delta+eps) / (m+eps) }
-                    for_each( gradient.begin(), gradient.end(), delta.begin(), moments.begin(), [this]( T& g, T d, T m ){ g *= (*this).learning_rate_ * std::sqrt((d+eps)/(m+eps));} );
-                    // x = x - g_
-                    data -= gradient;
-                    // delta = rho * delta + (1-rho) * g_ * g_
-                    /*
-                    if (iterations_!=0)
-                    */
-                    for_each( delta.begin(), delta.end(), gradient.begin(), [this]( T& d, T g ) { d *= (*this).rho_; d += (1.0-(*this).rho_) * g * g; } );
-
-                    gradient.reset(); // clear variable gradient
+                        if ( contexts.empty() ) // create context
+                        {
+                            //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
+                            //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
+                            contexts.push_back( zeros_like( data ) );
+                            contexts.push_back( zeros_like( data ) );
+                        }
+                        auto& moments = contexts[0];
+                        auto& delta = contexts[0];
+
+                        /*
+                        if (iterations_==0)
+                        {
+                            for_each( moments.begin(), moments.end(), gradient.begin(), []( auto& m, auto g ) { m += g*g; } );
+                            for_each( delta.begin(), delta.end(), gradient.begin(), []( auto& d, auto g ) { d += g*g; } );
+                        }
+                        else
+                        {
+                            // m = rho * m + (1-rho) * g * g;
+                            for_each( moments.begin(), moments.end(), gradient.begin(), [this]( auto& m, auto g ) { m *= (*this).rho_; m  += g*g*(1.0-(*this).rho_); } );
+                        }
+                        */
+
+                        for_each( moments.begin(), moments.end(), gradient.begin(), [this]( auto& m, auto g ) { m *= (*this).rho_; m  += g*g*(1.0-(*this).rho_); } );
+
+                        // g_ = \sqrt{ (delta+eps) / (m+eps) }
+                        for_each( gradient.begin(), gradient.end(), delta.begin(), moments.begin(), [this]( auto& g, auto d, auto m ){ g *= (*this).learning_rate_ * std::sqrt((d+eps)/(m+eps));} );
+                        // x = x - g_
+                        for_each( data.begin(), data.end(), gradient.begin(), []( auto& x, auto g ) { x -= g; } );
+                        // delta = rho * delta + (1-rho) * g_ * g_
+                        /*
+                        if (iterations_!=0)
+                        */
+                        for_each( delta.begin(), delta.end(), gradient.begin(), [this]( auto& d, auto g ) { d *= (*this).rho_; d += (1.0-(*this).rho_) * g * g; } );
+                    } );
                 }
             }
             ++iterations_;
@@ -248,7 +293,9 @@ namespace ceras
     template< typename Loss, typename T >
     struct adam : enable_id< adam< Loss, T >, "adam optimizer" >, enable_shared<adam<Loss, T>>
     {
-        typedef tensor< T > tensor_type;
+        typedef std::remove_cv_t<decltype(std::declval<Loss&>().forward())> tensor_type; // `tensor<bfloat16>` for a model of 16-bit values
+        typedef typename tensor_type::value_type value_type;
+        optimizer_private::float_states_type float_states_ = std::make_shared<std::unordered_map<int, optimizer_private::float_variable_state>>();
 
         Loss&         loss_;
         T             learning_rate_;
@@ -266,41 +313,39 @@ namespace ceras
 
         void forward()
         {
-            loss_.backward( ones<T>( {1, } ) );
+            loss_.backward( ones<value_type>( {1, } ) );
             auto& ss = get_default_session<tensor_type>();//.get();
             for ( auto [id, v] : ss.variables_ )
             {
                 if (v.trainable_)
                 {
-                    auto& data = v.data();
-                    auto& gradient = v.gradient();
-                    auto& contexts = v.contexts();
-                    if ( contexts.empty() ) // create context
+                    optimizer_private::update_variable( id, v, float_states_, [&]( auto& data, auto& gradient, auto& contexts )
                     {
-                        //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
-                        //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
-                        contexts.push_back( zeros_like( data ) );
-                        contexts.push_back( zeros_like( data ) );
-                    }
-                    auto& m = contexts[0];
-                    auto& v = contexts[1];
-
-                    T const b_beta_1 = beta_1_;
-                    T const b_beta_2 = beta_2_;
-
-                    for_each( m.begin(), m.end(), gradient.begin(), [b_beta_1](T& m_, T g_){ m_ *= b_beta_1; m_ += g_*(1.0-b_beta_1); } );
-
-                    for_each( v.begin(), v.end(), gradient.begin(), [b_beta_2](T& v_, T g_){ v_ *= b_beta_2; v_ += g_* g_*(1.0-b_beta_2); } );
-
-                    T lr = learning_rate_ * std::sqrt( 1.0 - std::pow(beta_2_, iterations_+1) ) / ( 1.0 - std::pow(beta_1_, iterations_+1) );
-
-                    if ( iterations_ > 1 )
-                        for_each( data.begin(), data.end(), m.begin(), v.begin(), [lr]( T& d_, T m_, T v_ ){ d_ -= lr * m_ / (eps+std::sqrt(v_)); } );
-                    else
-                        for_each( data.begin(), data.end(), gradient.begin(), [this]( T& d_, T g_ ){ d_ -= (*this).learning_rate_ * g_; } );
-
-                    gradient.reset(); // clear variable gradient
-                    // TODO: enabling amsgrad
+                        if ( contexts.empty() ) // create context
+                        {
+                            //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
+                            //contexts.push_back( std::make_shared<tensor_type>( zeros_like( data ) ) );
+                            contexts.push_back( zeros_like( data ) );
+                            contexts.push_back( zeros_like( data ) );
+                        }
+                        auto& m = contexts[0];
+                        auto& v = contexts[1];
+
+                        T const b_beta_1 = beta_1_;
+                        T const b_beta_2 = beta_2_;
+
+                        for_each( m.begin(), m.end(), gradient.begin(), [b_beta_1](auto& m_, auto g_){ m_ *= b_beta_1; m_ += g_*(1.0-b_beta_1); } );
+
+                        for_each( v.begin(), v.end(), gradient.begin(), [b_beta_2](auto& v_, auto g_){ v_ *= b_beta_2; v_ += g_* g_*(1.0-b_beta_2); } );
+
+                        T lr = learning_rate_ * std::sqrt( 1.0 - std::pow(beta_2_, iterations_+1) ) / ( 1.0 - std::pow(beta_1_, iterations_+1) );
+
+                        if ( iterations_ > 1 )
+                            for_each( data.begin(), data.end(), m.begin(), v.begin(), [lr]( auto& d_, auto m_, auto v_ ){ d_ -= lr * m_ / (eps+std::sqrt(v_)); } );
+                        else
+                            for_each( data.begin(), data.end(), gradient.begin(), [this]( auto& d_, auto g_ ){ d_ -= (*this).learning_rate_ * g_; } );
+                        // TODO: enabling amsgrad
+                    } );
                 }
             }//loop of variables
             ++iterations_;
@@ -322,7 +367,9 @@ namespace ceras
     template< typename Loss, typename T >
     struct gradient_descent : enable_id< gradient_descent< Loss, T >, "gradient_descent optimizer" >, enable_shared<gradient_descent<Loss, T>>
     {
-        typedef tensor< T > tensor_type;
+        typedef std::remove_cv_t<decltype(std::declval<Loss&>().forward())> tensor_type; // `tensor<bfloat16>` for a model of 16-bit values
+        typedef typename tensor_type::value_type value_type;
+        optimizer_private::float_states_type float_states_ = std::make_shared<std::unordered_map<int, optimizer_private::float_variable_state>>();
         Loss& loss_;
         T learning_rate_;
         T momentum_;
@@ -335,7 +382,7 @@ namespace ceras
         void forward()
         {
             // update the gradient in the loss
-            loss_.backward( ones<T>( {1, } ) );
+            loss_.backward( ones<value_type>( {1, } ) );
             //update variables
             auto& ss = get_default_session<tensor_type>();//.get();
             for ( auto& [id, v] : ss.variables_ )
@@ -344,9 +391,11 @@ namespace ceras
                 {
                     //v.data() -= learning_rate_ * (v.gradient());
                     //
-                    auto& gradient = v.gradient();
-                    better_assert( !has_nan(gradient), "gradient_descent error, tensor with id ", id, " has a nan value." );
-                    v.data() -= learning_rate_ * gradient;
+                    optimizer_private::update_variable( id, v, float_states_, [&]( auto& data, auto& gradient, auto& )
+                    {
+                        better_assert( !has_nan(gradient), "gradient_descent error, tensor with id ", id, " has a nan value." );
+                        for_each( data.begin(), data.end(), gradient.begin(), [this]( auto& x, auto g ) { x -= (*this).learning_rate_ * g; } );
+                    } );
                     if (0)
                     {
                         std::ofstream ofs{ fmt::format("./debug/weight_{}.txt", id) };
@@ -354,8 +403,6 @@ namespace ceras
                         ofs.close();
                         better_assert( false, "stop here!" );
                     }
-
-                    gradient.reset(); // clear variable gradient
                 }
             }
         }
@@ -0,0 +1,132 @@
+#ifndef QUANTIZED_TENSOR_HPP_INCLUDED_MGZTQWXJBLKRPNVAYSHDOUEFCIMGZTQWXJBLKRPNVAYSHDOUEFCI
+#define QUANTIZED_TENSOR_HPP_INCLUDED_MGZTQWXJBLKRPNVAYSHDOUEFCIMGZTQWXJBLKRPNVAYSHDOUEFCI
+
+#include "./includes.hpp"
+#include "./tensor.hpp"
+#include "./backend/int8_gemm.hpp"
+#include "./utils/better_assert.hpp"
+
+namespace ceras
+{
+
+    ///
+    /// @brief A tensor of 8-bit integers standing for the floats `scale * ( data - zero_point )`.
+    ///
+    /// A tensor quantized per tensor has a single scale and zero point. A tensor quantized per channel has one of each for every
+    /// index of its axis `axis_`, as the weights of a layer have for every output channel. See `quantize` and `dequantize`.
+    ///
+    template< typename T > requires std::same_as<T, std::int8_t> || std::same_as<T, std::uint8_t>
+    struct quantized_tensor
+    {
+        typedef T value_type;
+
+        tensor<T> data_;
+        std::vector<float> scales_;
+        std::vector<std::int32_t> zero_points_;
+        size_t axis_ = 0; ///< the axis of the channels, meaningful only with more than one scale
+
+        std::vector<size_t> shape() const noexcept { return data_.shape(); }
+        size_t size() const noexcept { return data_.size(); }
+        bool per_channel() const noexcept { return scales_.size() > 1; }
+
+        ///
+        /// @brief The channel, along `axis_`, of the element at `index` of the flattened data.
+        ///
+        size_t channel( size_t index ) const noexcept
+        {
+            if ( !per_channel() )
+                return 0;
+            auto const& shape = data_.shape();
+            size_t const stride = std::accumulate( shape.begin() + axis_ + 1, shape.end(), 1UL, []( size_t x, size_t y ){ return x * y; } );
+            return ( index / stride ) % shape[axis_];
+        }
+    }; // struct quantized_tensor
+
+    namespace quantized_tensor_private
+    {
+        // the scales and zero points of the `channels` channels along an axis, the channel of every element given by `channel_of`
+        template< typename T, typename Function >
+        quantized_tensor<T> quantize( tensor<float> const& x, size_t axis, size_t channels, Function const& channel_of )
+        {
+            quantized_tensor<T> ans;
+            ans.axis_ = axis;
+            std::vector<float> lowest( channels, std::numeric_limits<float>::max() );
+            std::vector<float> highest( channels, std::numeric_limits<float>::lowest() );
+            for ( size_t idx = 0; idx != x.size(); ++idx )
+            {
+                size_t const c = channel_of( idx );
+                lowest[c] = std::min( lowest[c], x[idx] );
+                highest[c] = std::max( highest[c], x[idx] );
+            }
+            ans.scales_.resize( channels );
+            ans.zero_points_.resize( channels );
+            for ( size_t c = 0; c != channels; ++c )
+                std::tie( ans.scales_[c], ans.zero_points_[c] ) = quantization_parameters<T>( lowest[c], highest[c] );
+
+            ans.data_ = tensor<T>{ x.shape() };
+            if ( channels == 1 )
+                quantize_range( x.data(), x.size(), ans.scales_[0], ans.zero_points_[0], ans.data_.data() );
+            else
+                for ( size_t idx = 0; idx != x.size(); ++idx )
+                    quantize_range( x.data() + idx, 1, ans.scales_[channel_of( idx )], ans.zero_points_[channel_of( idx )], ans.data_.data() + idx );
+            return ans;
+        }
+    }//namespace quantized_tensor_private
+
+    ///
+    /// @brief Quantizes a float tensor with a single scale and zero point.
+    ///
+    /// `std::uint8_t` maps the range of the tensor to [0, 255], with the zero point standing for 0.0f; `std::int8_t` maps it
+    /// symmetrically to [-127, 127], with a zero point of 0. See `quantization_parameters` in './backend/int8_gemm.hpp'.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto x = random<float>( {16, 64}, -1.0f, 3.0f );
+    /// auto q = quantize<std::uint8_t>( x ); // q.scales_[0] == 4.0f/255.0f, q.zero_points_[0] == 64
+    /// auto y = dequantize( q ); // y[i] within half a scale of x[i]
+    /// @endcode
+    ///
+    template< typename T >
+    quantized_tensor<T> quantize( tensor<float> const& x )
+    {
+        return quantized_tensor_private::quantize<T>( x, 0, 1, []( size_t ){ return 0UL; } );
+    }
+
+    ///
+    /// @brief Quantizes a float tensor with a scale and a zero point for each of the channels along `axis`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto w = glorot_uniform<float>( {784, 256} );
+    /// auto q = quantize<std::int8_t>( w, 1 ); // a scale for each of the 256 output channels of a dense layer
+    /// @endcode
+    ///
+    template< typename T >
+    quantized_tensor<T> quantize( tensor<float> const& x, size_t axis )
+    {
+        auto const& shape = x.shape();
+        better_assert( axis < shape.size(), "quantize: expecting an axis less than ", shape.size(), ", but got ", axis );
+        size_t const channels = shape[axis];
+        size_t const stride = std::accumulate( shape.begin() + axis + 1, shape.end(), 1UL, []( size_t a, size_t b ){ return a * b; } );
+        return quantized_tensor_private::quantize<T>( x, axis, channels, [=]( size_t idx ){ return ( idx / stride ) % channels; } );
+    }
+
+    ///
+    /// @brief The floats a quantized tensor stands for, `scale * ( data - zero_point )`.
+    ///
+    template< typename T >
+    tensor<float> dequantize( quantized_tensor<T> const& q )
+    {
+        tensor<float> ans{ q.shape() };
+        for ( size_t idx = 0; idx != q.size(); ++idx )
+        {
+            size_t const c = q.channel( idx );
+            ans[idx] = q.scales_[c] * static_cast<float>( static_cast<std::int32_t>( q.data_[idx] ) - q.zero_points_[c] );
+        }
+        return ans;
+    }
+
+}//namespace ceras
+
+#endif//QUANTIZED_TENSOR_HPP_INCLUDED_MGZTQWXJBLKRPNVAYSHDOUEFCIMGZTQWXJBLKRPNVAYSHDOUEFCI
+
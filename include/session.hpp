@@ -13,9 +13,40 @@
 namespace ceras
 {
 
+    template< Tensor Tsor >
+    struct execution_plan; // defined in './execution_plan.hpp'
+
+    namespace ceras_private
+    {
+    template< Tensor Tsor >
+    struct session;
+    } //namespace ceras_private
+
+    template< Tensor Tsor >
+    ceras_private::session<Tsor>& get_default_session(); // defined below
+
     namespace ceras_private
     {
 
+    ///
+    /// @brief The slot of an operator in the forward cache of a session, see `session::query_forward_cache`.
+    ///
+    /// The slot indexes the cache of the session numbering it only, the id of which it keeps: an operator asked for by another
+    /// session, or by a session replacing the one numbering it, gets a new slot in place of aliasing the slot of another operator.
+    ///
+    struct forward_cache_slot
+    {
+        std::uint64_t session_ = 0; ///< the id of the session numbering the slot, 0 before any
+        std::size_t index_ = -1UL;  ///< the index of the slot in the forward cache of that session
+    };
+
+    // a new id for every session made, 0 for none
+    inline std::uint64_t new_session_id() noexcept
+    {
+        static std::atomic<std::uint64_t> last{ 0 };
+        return ++last;
+    }
+
     template< Tensor Tsor >
     struct session
     {
@@ -26,14 +57,35 @@ namespace ceras
 
         std::vector<place_holder_type> place_holders_;
         std::unordered_map<int, variable_type> variables_;
-        std::unordered_map<int, tensor_type> forward_cache_;
+        std::vector<std::uint64_t> forward_cache_; // the generation in which the operator of each slot was computed last
+        std::uint64_t forward_generation_ = 1; // the generation of the current run, the slots of the other generations stale
+        std::uint64_t id_ = new_session_id(); // the id kept by the slots of this session, see `forward_cache_slot`
 
         session() { }
 
         session( session const& ) = delete;
-        session( session&& ) = default;
         session& operator=( session const& ) = delete;
-        session& operator=( session&& ) = default;
+
+        // the slots of `other` move with its id, `other` left with no slots and a new id
+        session( session&& other ) : place_holders_{ std::move( other.place_holders_ ) }, variables_{ std::move( other.variables_ ) },
+            forward_cache_{ std::move( other.forward_cache_ ) }, forward_generation_{ other.forward_generation_ }, id_{ other.id_ }
+        {
+            other.forward_cache_.clear();
+            other.id_ = new_session_id();
+        }
+
+        // the slots numbered by this session before go stale, the slots of `other` moving with its id
+        session& operator=( session&& other )
+        {
+            place_holders_ = std::move( other.place_holders_ );
+            variables_ = std::move( other.variables_ );
+            forward_cache_ = std::move( other.forward_cache_ );
+            forward_generation_ = other.forward_generation_;
+            id_ = other.id_;
+            other.forward_cache_.clear();
+            other.id_ = new_session_id();
+            return *this;
+        }
 
         session& rebind( place_holder_type& p_holder, tensor_type const& value )
         {
@@ -55,11 +107,43 @@ namespace ceras
             return *this;
         }
 
+        ///
+        /// @brief Evaluates an expression, or runs an optimizer.
+        ///
+        /// An operator is compiled to an `execution_plan` the first time it runs, its plan replayed from then on, see './execution_plan.hpp'.
+        /// An expression of another tensor type runs in the session of its own type, which keeps its forward cache.
+        ///
         template< typename Operation >
         auto run( Operation& op )
         {
-            clear_forward_cache();
-            return op.forward();
+            if constexpr ( requires { typename Operation::tensor_type; } && !std::is_same_v<typename Operation::tensor_type, tensor_type> )
+                return get_default_session<typename Operation::tensor_type>().run( op );
+            else
+            {
+                clear_forward_cache();
+                if constexpr ( requires { op.state_->plan_; } )
+                    return plan( op ).forward();
+                else
+                    return op.forward();
+            }
+        }
+
+        ///
+        /// @brief The plan of the expression rooted at an operator, compiled the first time it is asked for and kept in the state of the operator.
+        ///
+        /// Its chains of elementwise operators are fused, see `fuse_elementwise` in './elementwise_fusion.hpp'.
+        ///
+        template< typename Operation >
+        execution_plan<typename Operation::tensor_type>& plan( Operation const& op )
+        {
+            static_assert( std::is_same_v<typename Operation::tensor_type, tensor_type>, "session::plan: expecting an expression of the tensor type of the session, see `get_default_session<typename Operation::tensor_type>()`." );
+            auto& ans = op.state_->plan_;
+            if ( !ans )
+            {
+                ans = std::make_shared<execution_plan<tensor_type>>( compile_plan( op ) );
+                fuse_elementwise( *ans );
+            }
+            return *ans;
         }
 
         // register variables associated to the op to this session
@@ -178,22 +262,38 @@ namespace ceras
             singleton<session<tensor_type>*>::instance() = nullptr;
         }
 
-        tensor_type query_forward_cache( int operation_id ) const
+        ///
+        /// @brief Checks if an operator has been computed in the current run, its output kept in its state.
+        ///
+        /// This is the cache of the `forward` of the operators called directly, computing every node shared by several operators once
+        /// per run; `run` replays the plan of an operator instead, see `plan`, computing every node once by construction.
+        ///
+        /// @param slot The slot of the operator, given by this session the first time the operator asks, and again if another session gave it.
+        ///
+        bool query_forward_cache( forward_cache_slot& slot )
         {
-            auto itor = forward_cache_.find( operation_id );
-            if ( itor == forward_cache_.end() )
-                return tensor_type{};
-            return (*itor).second;
+            if ( slot.session_ != id_ || slot.index_ >= forward_cache_.size() )
+            {
+                slot = forward_cache_slot{ id_, forward_cache_.size() };
+                forward_cache_.push_back( 0 );
+            }
+            return forward_cache_[slot.index_] == forward_generation_;
         }
 
-        void update_forward_cache( int operation_id, tensor_type tsor )
+        ///
+        /// @brief Marks the operator of `slot` computed in the current run.
+        ///
+        void update_forward_cache( forward_cache_slot const& slot )
         {
-            forward_cache_[operation_id] = tsor;
+            forward_cache_[slot.index_] = forward_generation_;
         }
 
+        ///
+        /// @brief Invalidates all the slots by starting a new generation, in constant time.
+        ///
         void clear_forward_cache()
         {
-            forward_cache_.clear();
+            ++forward_generation_;
         }
 
     }; // session
@@ -0,0 +1,364 @@
+#ifndef SPARSE_TENSOR_HPP_INCLUDED_HWBQZNKRVXOJMTLCAYSGEPDUFIHWBQZNKRVXOJMTLCAYSGEPDUFI
+#define SPARSE_TENSOR_HPP_INCLUDED_HWBQZNKRVXOJMTLCAYSGEPDUFIHWBQZNKRVXOJMTLCAYSGEPDUFI
+
+#include "./includes.hpp"
+#include "./tensor.hpp"
+#include "./utils/better_assert.hpp"
+#include "./utils/parallel.hpp"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace ceras
+{
+
+    ///
+    /// @brief A 2D tensor in blocked compressed sparse row format, keeping only the blocks holding a value.
+    ///
+    /// The matrix is cut in blocks of `block_rows_` x `block_cols_`, the blocks of the last block row and of the last block
+    /// column cut short by the edges of the matrix. Block row `r` keeps its blocks from `row_offsets_[r]` to `row_offsets_[r+1]`,
+    /// `column_indices_` holding their block columns and `values_` their values, one full block after another, row-major inside
+    /// a block, with zeros beyond the edges. With 1x1 blocks this is the plain CSR format. See `to_sparse` and `to_dense`.
+    ///
+    template< typename T > requires std::floating_point<T>
+    struct sparse_tensor
+    {
+        typedef T value_type;
+
+        std::vector<size_t> shape_;
+        size_t block_rows_ = 1;
+        size_t block_cols_ = 1;
+        std::vector<size_t> row_offsets_;
+        std::vector<size_t> column_indices_;
+        tensor<T> values_;
+
+        std::vector<size_t> shape() const noexcept { return shape_; }
+        size_t rows() const noexcept { return shape_[0]; }
+        size_t cols() const noexcept { return shape_[1]; }
+        size_t blocks() const noexcept { return column_indices_.size(); }
+        size_t block_size() const noexcept { return block_rows_ * block_cols_; }
+
+        ///
+        /// @brief The fraction of the matrix stored, the padding of the blocks on the edges included.
+        ///
+        double density() const noexcept
+        {
+            return ( rows() * cols() != 0 ) ? static_cast<double>( values_.size() ) / static_cast<double>( rows() * cols() ) : 0.0;
+        }
+    }; // struct sparse_tensor
+
+    ///
+    /// @brief Converts a 2D tensor to a sparse one, keeping the blocks holding a value of magnitude above `threshold`.
+    ///
+    /// Blocks of a few rows or columns cost some zeros but let the kernels reuse every loaded row of the dense side, see `spmm`.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto w = random<float>( {512, 784}, -1.0f, 1.0f );
+    /// auto csr = to_sparse( w, 0.9f );        // about 10% of the values kept
+    /// auto bsr = to_sparse( w, 0.99f, 4, 1 ); // blocks of 4 rows, kept if any of the 4 values is kept
+    /// @endcode
+    ///
+    template< typename T >
+    sparse_tensor<T> to_sparse( tensor<T> const& x, T threshold = T{0}, size_t block_rows = 1, size_t block_cols = 1 )
+    {
+        better_assert( x.ndim() == 2, "to_sparse: expecting a 2D tensor, but got dimensions ", x.ndim() );
+        better_assert( block_rows > 0 && block_cols > 0, "to_sparse: expecting positive block dimensions, but got ", block_rows, "x", block_cols );
+
+        sparse_tensor<T> ans;
+        ans.shape_ = x.shape();
+        ans.block_rows_ = block_rows;
+        ans.block_cols_ = block_cols;
+        auto const [rows, cols] = std::make_tuple( ans.rows(), ans.cols() );
+
+        std::vector<T> values;
+        ans.row_offsets_.push_back( 0 );
+        for ( size_t row = 0; row < rows; row += block_rows )
+        {
+            size_t const row_end = std::min( rows, row + block_rows );
+            for ( size_t col = 0; col < cols; col += block_cols )
+            {
+                size_t const col_end = std::min( cols, col + block_cols );
+                bool kept = false;
+                for ( size_t r = row; r != row_end && !kept; ++r )
+                    for ( size_t c = col; c != col_end && !kept; ++c )
+                        kept = std::abs( x[r*cols+c] ) > threshold;
+                if ( !kept )
+                    continue;
+
+                ans.column_indices_.push_back( col / block_cols );
+                for ( size_t r = row; r != row + block_rows; ++r )
+                    for ( size_t c = col; c != col + block_cols; ++c )
+                        values.push_back( ( r < row_end && c < col_end ) ? x[r*cols+c] : T{0} );
+            }
+            ans.row_offsets_.push_back( ans.column_indices_.size() );
+        }
+
+        ans.values_ = tensor<T>{ {values.size(),} };
+        std::copy( values.begin(), values.end(), ans.values_.begin() );
+        return ans;
+    }
+
+    ///
+    /// @brief The dense tensor of a sparse one.
+    ///
+    template< typename T >
+    tensor<T> to_dense( sparse_tensor<T> const& a )
+    {
+        tensor<T> ans{ a.shape() };
+        auto const [rows, cols] = std::make_tuple( a.rows(), a.cols() );
+        for ( size_t block_row = 0; block_row + 1 < a.row_offsets_.size(); ++block_row )
+            for ( size_t blk = a.row_offsets_[block_row]; blk != a.row_offsets_[block_row+1]; ++blk )
+            {
+                T const* block = a.values_.data() + blk * a.block_size();
+                size_t const row = block_row * a.block_rows_;
+                size_t const col = a.column_indices_[blk] * a.block_cols_;
+                for ( size_t r = row; r != std::min( rows, row + a.block_rows_ ); ++r )
+                    for ( size_t c = col; c != std::min( cols, col + a.block_cols_ ); ++c )
+                        ans[r*cols+c] = block[(r-row)*a.block_cols_ + (c-col)];
+            }
+        return ans;
+    }
+
+    namespace sparse_tensor_private
+    {
+        // the columns of the dense side a block row accumulates at once, in four 512-bit registers a row
+        template< typename T >
+        inline constexpr size_t lanes = 256 / sizeof( T );
+
+        // c[rows, width] = the blocks [first, last) of a block row of `Rows` rows and `Cols` columns, 0 for `block_cols`, times
+        // b[n, width], the products of a row of the dense side kept in registers; the zeros of the last block row computed but
+        // not stored
+        template< size_t Rows, size_t Cols, size_t Width, typename T >
+        void multiply_block_row( T const* __restrict__ values, size_t const* __restrict__ column_indices, size_t first, size_t last,
+                                 size_t block_cols, size_t n, T const* __restrict__ b, size_t ldb, size_t cols, T* __restrict__ c,
+                                 size_t ldc, size_t rows ) noexcept
+        {
+            if constexpr ( Cols != 0 )
+                block_cols = Cols;
+#if defined(__AVX512F__)
+            if constexpr ( std::is_same_v<T, float> && Width == lanes<float> )
+            {
+                __m512 accumulators[Rows][4];
+                for ( size_t r = 0; r != Rows; ++r )
+                    for ( size_t v = 0; v != 4; ++v )
+                        accumulators[r][v] = _mm512_setzero_ps();
+                for ( size_t blk = first; blk != last; ++blk )
+                {
+                    float const* __restrict__ block = values + blk * Rows * block_cols;
+                    size_t const p = column_indices[blk] * block_cols;
+                    size_t const depth = ( Cols == 1 ) ? 1 : std::min( block_cols, n - p );
+                    for ( size_t q = 0; q != depth; ++q )
+                    {
+                        float const* __restrict__ b_row = b + ( p + q ) * ldb;
+                        __m512 const b_row_0 = _mm512_loadu_ps( b_row );
+                        __m512 const b_row_1 = _mm512_loadu_ps( b_row + 16 );
+                        __m512 const b_row_2 = _mm512_loadu_ps( b_row + 32 );
+                        __m512 const b_row_3 = _mm512_loadu_ps( b_row + 48 );
+                        for ( size_t r = 0; r != Rows; ++r )
+                        {
+                            __m512 const a = _mm512_set1_ps( block[r * block_cols + q] );
+                            accumulators[r][0] = _mm512_fmadd_ps( a, b_row_0, accumulators[r][0] );
+                            accumulators[r][1] = _mm512_fmadd_ps( a, b_row_1, accumulators[r][1] );
+                            accumulators[r][2] = _mm512_fmadd_ps( a, b_row_2, accumulators[r][2] );
+                            accumulators[r][3] = _mm512_fmadd_ps( a, b_row_3, accumulators[r][3] );
+                        }
+                    }
+                }
+                for ( size_t r = 0; r != rows; ++r )
+                    for ( size_t v = 0; v != 4; ++v )
+                        _mm512_storeu_ps( c + r * ldc + 16 * v, accumulators[r][v] );
+                return;
+            }
+#endif
+            size_t const width = Width ? Width : cols;
+            T accumulators[Rows][lanes<T>] = {};
+            for ( size_t blk = first; blk != last; ++blk )
+            {
+                T const* __restrict__ block = values + blk * Rows * block_cols;
+                size_t const p = column_indices[blk] * block_cols;
+                size_t const depth = ( Cols == 1 ) ? 1 : std::min( block_cols, n - p );
+                for ( size_t q = 0; q != depth; ++q )
+                {
+                    T const* __restrict__ b_row = b + ( p + q ) * ldb;
+                    for ( size_t r = 0; r != Rows; ++r )
+                    {
+                        T const a = block[r * block_cols + q];
+                        for ( size_t j = 0; j != width; ++j )
+                            accumulators[r][j] += a * b_row[j];
+                    }
+                }
+            }
+            for ( size_t r = 0; r != rows; ++r )
+                std::copy_n( accumulators[r], width, c + r * ldc );
+        }
+
+        // the same for any number of rows in a block, accumulating in c
+        template< typename T >
+        void multiply_block_row( T const* __restrict__ values, size_t const* __restrict__ column_indices, size_t first, size_t last,
+                                 size_t block_rows, size_t block_cols, size_t n, T const* __restrict__ b, size_t ldb, size_t cols,
+                                 T* __restrict__ c, size_t ldc, size_t rows ) noexcept
+        {
+            for ( size_t r = 0; r != rows; ++r )
+                std::fill_n( c + r * ldc, cols, T{0} );
+            for ( size_t blk = first; blk != last; ++blk )
+            {
+                T const* __restrict__ block = values + blk * block_rows * block_cols;
+                size_t const p = column_indices[blk] * block_cols;
+                size_t const depth = std::min( block_cols, n - p );
+                for ( size_t r = 0; r != rows; ++r )
+                    for ( size_t q = 0; q != depth; ++q )
+                    {
+                        T const a = block[r * block_cols + q];
+                        T const* __restrict__ b_row = b + ( p + q ) * ldb;
+                        T* __restrict__ c_row = c + r * ldc;
+                        for ( size_t j = 0; j != cols; ++j )
+                            c_row[j] += a * b_row[j];
+                    }
+            }
+        }
+
+        // the columns [col, col+lanes) of the output rows of a block row
+        template< size_t Rows, typename T >
+        void multiply_block_row( sparse_tensor<T> const& a, size_t block_row, T const* b, size_t k, size_t col, T* c ) noexcept
+        {
+            size_t const row = block_row * a.block_rows_;
+            size_t const rows = std::min( a.block_rows_, a.rows() - row );
+            size_t const cols = std::min( lanes<T>, k - col );
+            auto const [first, last] = std::make_tuple( a.row_offsets_[block_row], a.row_offsets_[block_row+1] );
+            auto const& multiply = [&]<size_t Cols, size_t Width>() noexcept
+            {
+                multiply_block_row<Rows, Cols, Width>( a.values_.data(), a.column_indices_.data(), first, last, a.block_cols_, a.cols(), b + col, k, cols, c + row * k + col, k, rows );
+            };
+            if constexpr ( Rows == 0 )
+                multiply_block_row( a.values_.data(), a.column_indices_.data(), first, last, a.block_rows_, a.block_cols_, a.cols(), b + col, k, cols, c + row * k + col, k, rows );
+            else if ( cols != lanes<T> )
+                multiply.template operator()<0, 0>();
+            else if ( a.block_cols_ == 1 )
+                multiply.template operator()<1, lanes<T>>();
+            else
+                multiply.template operator()<0, lanes<T>>();
+        }
+
+        // c[n, cols] += the blocks of a block row, transposed, times b[rows, cols]
+        template< typename T >
+        void multiply_block_row_transposed( T const* __restrict__ values, size_t const* __restrict__ column_indices, size_t first, size_t last,
+                                            size_t block_rows, size_t block_cols, size_t n, T const* __restrict__ b, size_t ldb, size_t cols,
+                                            T* __restrict__ c, size_t ldc, size_t rows ) noexcept
+        {
+            for ( size_t blk = first; blk != last; ++blk )
+            {
+                T const* __restrict__ block = values + blk * block_rows * block_cols;
+                size_t const p = column_indices[blk] * block_cols;
+                size_t const depth = std::min( block_cols, n - p );
+                for ( size_t q = 0; q != depth; ++q )
+                {
+                    T* __restrict__ c_row = c + ( p + q ) * ldc;
+                    for ( size_t r = 0; r != rows; ++r )
+                    {
+                        T const a = block[r * block_cols + q];
+                        T const* __restrict__ b_row = b + r * ldb;
+                        for ( size_t j = 0; j != cols; ++j )
+                            c_row[j] += a * b_row[j];
+                    }
+                }
+            }
+        }
+
+        template< typename T >
+        T dot( T const* __restrict__ x, T const* __restrict__ y, size_t n ) noexcept
+        {
+            T ans{0};
+            for ( size_t idx = 0; idx != n; ++idx )
+                ans += x[idx] * y[idx];
+            return ans;
+        }
+    }//namespace sparse_tensor_private
+
+    ///
+    /// @brief Sparse-dense matrix multiplication, `c[m, k] = a[m, n] * b[n, k]`, with a sparse `a`.
+    ///
+    /// Every stored value of `a` multiplies a row of `b`, `k` contiguous values: the kernel is vectorized over this dense
+    /// dimension, a block row accumulating 256 bytes of columns of its output rows in registers, the block rows of `a` in
+    /// parallel. A block of `r` rows reuses every row of `b` it loads `r` times.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// auto w = to_sparse( random<float>( {512, 784}, -1.0f, 1.0f ), 0.9f );
+    /// auto x = random<float>( {784, 64} );
+    /// tensor<float> y{ {512, 64} };
+    /// spmm( w, x.data(), 64, y.data() ); // as gemm with to_dense( w ), in about a tenth of the operations
+    /// @endcode
+    ///
+    template< typename T >
+    void spmm( sparse_tensor<T> const& a, T const* b, size_t k, T* c ) noexcept
+    {
+        auto const& multiply = [&]<size_t Rows>( size_t block_row ) noexcept
+        {
+            for ( size_t col = 0; col < k; col += sparse_tensor_private::lanes<T> )
+                sparse_tensor_private::multiply_block_row<Rows>( a, block_row, b, k, col, c );
+        };
+        size_t const block_row_count = a.row_offsets_.size() - 1;
+        switch ( a.block_rows_ )
+        {
+            case 1: parallel( [&]( size_t block_row ){ multiply.template operator()<1>( block_row ); }, 0UL, block_row_count ); break;
+            case 2: parallel( [&]( size_t block_row ){ multiply.template operator()<2>( block_row ); }, 0UL, block_row_count ); break;
+            case 4: parallel( [&]( size_t block_row ){ multiply.template operator()<4>( block_row ); }, 0UL, block_row_count ); break;
+            default: parallel( [&]( size_t block_row ){ multiply.template operator()<0>( block_row ); }, 0UL, block_row_count ); break;
+        }
+    }
+
+    ///
+    /// @brief Transposed sparse-dense matrix multiplication, `c[n, k] = a[m, n]^T * b[m, k]`, with a sparse `a`.
+    ///
+    /// The stored values of a row of `a` scatter to different rows of `c`: the kernel runs in parallel over slices of the
+    /// columns of `b` and `c` instead, each vectorized over its slice.
+    ///
+    template< typename T >
+    void spmm_transposed( sparse_tensor<T> const& a, T const* b, size_t k, T* c ) noexcept
+    {
+        size_t constexpr slice = sparse_tensor_private::lanes<T> / 4;
+        size_t const block_row_count = a.row_offsets_.size() - 1;
+        std::fill_n( c, a.cols() * k, T{0} );
+        parallel( [&]( size_t s )
+        {
+            size_t const col = s * slice;
+            size_t const cols = std::min( slice, k - col );
+            for ( size_t block_row = 0; block_row != block_row_count; ++block_row )
+            {
+                size_t const row = block_row * a.block_rows_;
+                sparse_tensor_private::multiply_block_row_transposed( a.values_.data(), a.column_indices_.data(), a.row_offsets_[block_row], a.row_offsets_[block_row+1],
+                                                                      a.block_rows_, a.block_cols_, a.cols(), b + row * k + col, k, cols, c + col, k,
+                                                                      std::min( a.block_rows_, a.rows() - row ) );
+            }
+        }, 0UL, ( k + slice - 1 ) / slice );
+    }
+
+    ///
+    /// @brief The product `d[m, k] * x[n, k]^T` sampled at the stored values of `a[m, n]`, written in `values` in the layout of `a.values_`.
+    ///
+    /// This is the gradient of the stored values of `a` for `spmm( a, x^T )` with an output gradient `d`: the pruned values
+    /// keep no gradient. The padding of the blocks on the edges gets zeros.
+    ///
+    template< typename T >
+    void sampled_gemm( sparse_tensor<T> const& a, T const* d, T const* x, size_t k, T* values ) noexcept
+    {
+        parallel( [&]( size_t block_row )
+        {
+            size_t const row = block_row * a.block_rows_;
+            for ( size_t blk = a.row_offsets_[block_row]; blk != a.row_offsets_[block_row+1]; ++blk )
+            {
+                size_t const col = a.column_indices_[blk] * a.block_cols_;
+                T* block = values + blk * a.block_size();
+                for ( size_t r = 0; r != a.block_rows_; ++r )
+                    for ( size_t q = 0; q != a.block_cols_; ++q )
+                        block[r * a.block_cols_ + q] = ( row + r < a.rows() && col + q < a.cols() ) ? sparse_tensor_private::dot( d + ( row + r ) * k, x + ( col + q ) * k, k ) : T{0};
+            }
+        }, 0UL, a.row_offsets_.size() - 1 );
+    }
+
+}//namespace ceras
+
+#endif//SPARSE_TENSOR_HPP_INCLUDED_HWBQZNKRVXOJMTLCAYSGEPDUFIHWBQZNKRVXOJMTLCAYSGEPDUFI
+
@@ -1,16 +1,24 @@
 #ifndef HQKGLAXWWVFBFHQNHBVTQJKGUFTPCQPTPXDVNOSBDJIBHITCEKDISJYNAMCPLJDURURDAISFV
 #define HQKGLAXWWVFBFHQNHBVTQJKGUFTPCQPTPXDVNOSBDJIBHITCEKDISJYNAMCPLJDURURDAISFV
 
+#include "./backend/broadcast.hpp"
+#include "./backend/vectorized_math.hpp"
+#include "./backend/half_precision.hpp"
 #include "./backend/cblas.hpp"
 #include "./backend/cuda.hpp"
+#include "./backend/gemm.hpp"
+#include "./backend/fast_gemm_strassen.hpp"
+#include "./backend/gemm_tuner.hpp"
 #include "./config.hpp"
 #include "./includes.hpp"
+#include "./utils/aligned_allocator.hpp"
 #include "./utils/better_assert.hpp"
 #include "./utils/cached_allocator.hpp"
 #include "./utils/buffered_allocator.hpp"
 #include "./utils/debug.hpp"
 #include "./utils/fmt.hpp"
 #include "./utils/for_each.hpp"
+#include "./utils/half_float.hpp"
 #include "./utils/id.hpp"
 #include "./utils/range.hpp"
 #include "./utils/stride_iterator.hpp"
@@ -33,11 +41,28 @@ namespace ceras
     // static random number random_generator
     static std::mt19937 random_generator{random_seed};
 
+    ///
+    /// @brief The allocator of the tensor buffers, `memory_alignment` aligned, see './utils/aligned_allocator.hpp'.
+    ///
     template< typename T >
-    using default_allocator = std::allocator<T>;
-    //using default_allocator = std::allocator<T>;
+    using default_allocator = aligned_allocator<T>;
 
 
+    ///
+    /// @brief A dense tensor, its elements in a buffer shared by its copies and by its slices.
+    ///
+    /// A tensor is mutated by one of two rules, depending on the member writing it:
+    ///
+    /// - The value members are copy-on-write: the compound assignments, the assignment of an expression, `reset`, `map`,
+    ///   `deep_copy( other )` and `resize` to a different size give a tensor sharing its buffer a copy of its own first, leaving the
+    ///   other tensors untouched. After `auto b = a;`, `b += 1` leaves `a` as it is.
+    /// - The element accessors write in place: `data()`, `begin()`, `end()`, `operator[]` and `fill` reach the buffer shared with
+    ///   the other tensors. After `auto b = a;`, `b[0] = 1` changes `a[0]` too; `b.detach()[0] = 1` does not, see `detach`.
+    ///
+    /// The operators and the optimizers write through the element accessors on purpose: the plans keep the outputs and the
+    /// gradients of the last pass sharing the caches of the operators, and the weights share their buffers with the inputs cached
+    /// by the operators, which are to see the updated weights. A buffer owned by a single tensor is written in place by both rules.
+    ///
     template< typename T, typename Allocator = default_allocator<T> >
     struct tensor : enable_id<tensor<T, Allocator>, "Tensor">
     {
@@ -51,6 +76,8 @@ namespace ceras
         //std::vector<size_t> shape_;
         std::vector<size_t, buffered_allocator<size_t, 256>> shape_;
         shared_vector vector_;
+        size_t offset_ = 0; ///< the first element in `vector_`, non-zero for a slice sharing the buffer of another tensor, see `slice`
+        size_t window_ = 0; ///< the number of elements of a slice, 0 for a tensor spanning the whole of `vector_`
 
         ///
         /// @breif Construct an empty vector
@@ -105,22 +132,40 @@ namespace ceras
             std::fill( begin(), end(), init );
         }
 
+        ///
+        /// @brief The elements of a view, see `tensor_view::materialize` in './tensor_view.hpp'.
+        ///
+        template< typename View > requires requires( View const& view ) { { view.materialize() } -> std::same_as<tensor>; }
+        tensor( View const& view ) : tensor{ view.materialize() } { }
+
+        ///
+        /// @brief Evaluates a lazy element-wise expression, see './tensor_expression.hpp'.
+        ///
+        template< typename Expression > requires requires( Expression const& expression, T* dst ) { expression.evaluate_into( dst ); }
+        tensor( Expression const& expression ) : tensor{ expression.shape() }
+        {
+            expression.evaluate_into( data() );
+        }
+
         ///
         /// @brief Copy-ctor.
         ///
-        constexpr tensor( self_type const& other ) noexcept : shape_{ other.shape_ }
+        constexpr tensor( self_type const& other ) noexcept : shape_{ other.shape_ }, vector_{ other.vector_ }, offset_{ other.offset_ }, window_{ other.window_ }
         {
-            vector_ = other.vector_;
             (*this).id_ = other.id_;
         }
 
         ///
-        /// @brief Move-ctor.
+        /// @brief Move-ctor. The buffer is taken over without touching its reference count, leaving `other` empty.
+        ///
+        /// The shape is copied: `buffered_allocator` keeps a small shape in the tensor itself, where it cannot be moved from.
         ///
-        constexpr tensor( self_type && other ) noexcept : shape_{ other.shape_ }
+        constexpr tensor( self_type && other ) noexcept : shape_{ other.shape_ }, vector_{ std::move( other.vector_ ) }, offset_{ other.offset_ }, window_{ other.window_ }
         {
-            vector_ = other.vector_;
             (*this).id_ = other.id_;
+            other.shape_.clear();
+            other.offset_ = 0;
+            other.window_ = 0;
         }
 
         ///
@@ -130,18 +175,45 @@ namespace ceras
         {
             shape_ = other.shape_;
             vector_ = other.vector_;
+            offset_ = other.offset_;
+            window_ = other.window_;
             (*this).id_ = other.id_;
             return *this;
         }
 
         ///
-        /// @brief Move-assignment.
+        /// @brief Move-assignment. The buffer is taken over without touching its reference count, leaving `other` empty.
         ///
         constexpr self_type& operator = ( self_type && other ) noexcept
         {
-            shape_ = other.shape_;
-            vector_ = other.vector_;
+            if ( this == &other )
+                return *this;
+            shape_ = other.shape_; // see the move-ctor
+            vector_ = std::move( other.vector_ );
+            offset_ = other.offset_;
+            window_ = other.window_;
             (*this).id_ = other.id_;
+            other.shape_.clear();
+            other.offset_ = 0;
+            other.window_ = 0;
+            return *this;
+        }
+
+        ///
+        /// @brief Evaluates a lazy element-wise expression in a single pass, into the buffer of this tensor if no other tensor shares it.
+        ///
+        template< typename Expression > requires requires( Expression const& expression, T* dst ) { expression.evaluate_into( dst ); }
+        self_type& operator = ( Expression const& expression )
+        {
+            auto const& new_shape = expression.shape();
+            if ( is_slice() || !vector_ || vector_.use_count() > 1 ) // a buffer of its own, leaving the shared one untouched
+            {
+                vector_ = std::make_shared<vector_type>();
+                offset_ = 0;
+                window_ = 0;
+            }
+            resize( new_shape );
+            expression.evaluate_into( data() );
             return *this;
         }
 
@@ -249,16 +321,73 @@ namespace ceras
         constexpr size_t size() const noexcept
         {
             if ( !vector_ ) return 0;
-            return (*vector_ ).size();
+            return window_ ? window_ : (*vector_ ).size();
+        }
+
+        ///
+        /// @brief Check if the tensor is a slice of a larger buffer shared with another tensor, see `slice`.
+        ///
+        constexpr bool is_slice() const noexcept
+        {
+            return window_ != 0;
+        }
+
+
+        ///
+        /// @brief Check if another tensor shares the buffer of this tensor.
+        ///
+        /// Copies of a tensor share its buffer, and so do its slices, see `slice` in './tensor_view.hpp'. A shared tensor is copied on
+        /// writing by its value members and written in place by its element accessors, see the rules of `tensor`. Views, see
+        /// `tensor_view`, are read-only, so that no view writes a buffer shared by copies.
+        ///
+        constexpr bool is_shared() const noexcept
+        {
+            return vector_ && ( is_slice() || vector_.use_count() > 1 );
+        }
+
+        ///
+        /// @brief Gives the tensor a copy of its buffer if it shares it, see `is_shared`. Returns the tensor itself.
+        ///
+        /// \code{.cpp}
+        /// tensor<float> a = ones<float>( {2, 3} );
+        /// tensor<float> b = a; // sharing the buffer of a
+        /// b.detach()[0] = 2.0f; // a[0] is still 1.0f
+        /// \endcode
+        ///
+        constexpr self_type& detach()
+        {
+            if ( is_shared() )
+                own_buffer( true );
+            return *this;
+        }
+
+        // replaces the buffer by one of its own of the same size, with the current values if `keep_values`
+        constexpr void own_buffer( bool keep_values )
+        {
+            shared_vector owned = std::make_shared<vector_type>( size() );
+            if ( keep_values )
+                std::copy_n( data(), size(), (*owned).data() );
+            vector_ = owned;
+            offset_ = 0;
+            window_ = 0;
         }
 
+        ///
+        /// @brief Check if the first element is `memory_alignment` aligned.
+        ///
+        /// True for a tensor owning its buffer with a `default_allocator`. A slice is aligned if its offset is a multiple of `memory_alignment` bytes.
+        ///
+        constexpr bool is_aligned() const noexcept
+        {
+            return ceras::is_aligned( data() );
+        }
 
         ///
         /// @brief Check if the tensor has elements.
         ///
         [[nodiscard]] constexpr bool empty() const noexcept
         {
-            return cbegin() == cend();
+            return size() == 0; // also for a tensor moved from, without a buffer
         }
 
 
@@ -273,6 +402,20 @@ namespace ceras
         /// \endcode
         ///
         constexpr self_type& reset( T val = T{0} )
+        {
+            if ( is_shared() )
+                own_buffer( false );
+            std::fill_n( data(), size(), val );
+            return *this;
+        }
+
+        ///
+        /// @brief Sets all the elements to `val` in place, in the buffer shared with other tensors if any, see `is_shared`.
+        ///
+        /// This is `reset` for the caches of the operators, written at every pass while the outputs and the gradients of the last
+        /// pass still share them; `reset` would give a shared cache a new buffer at every pass.
+        ///
+        constexpr self_type& fill( T val = T{0} ) noexcept
         {
             std::fill_n( data(), size(), val );
             return *this;
@@ -300,6 +443,8 @@ namespace ceras
         ///
         constexpr self_type& deep_copy( self_type const& other )
         {
+            if ( is_shared() && ( vector_ != other.vector_ || offset_ != other.offset_ ) )
+                own_buffer( false );
             (*this).resize( other.shape() );
             std::copy_n( other.data(), size(), (*this).data() );
             return *this;
@@ -332,10 +477,22 @@ namespace ceras
         ///
         /// @brief Resize the tensor with a new shape.
         ///
+        /// A shared tensor resized to a different size gets a buffer of its own, leaving the buffer it shares untouched.
+        ///
         constexpr self_type& resize( std::vector< size_t > const& new_shape )
         {
             size_t const new_size = std::accumulate( new_shape.begin(), new_shape.end(), 1UL, [](auto x, auto y){ return x*y; } );
-            if( (*this).size() != new_size )
+            if ( is_shared() && ( (*this).size() != new_size ) )
+            {
+                shared_vector detached = std::make_shared<vector_type>( new_size, T{0} );
+                std::copy_n( data(), std::min( (*this).size(), new_size ), (*detached).data() );
+                vector_ = detached;
+                offset_ = 0;
+                window_ = 0;
+            }
+            else if ( !vector_ ) // moved from
+                vector_ = std::make_shared<vector_type>( new_size, T{0} );
+            else if( (*this).size() != new_size )
                 (*vector_).resize(new_size);
             (*this).shape_.resize( new_shape.size() );
             std::copy( new_shape.begin(), new_shape.end(), (*this).shape_.begin() );
@@ -375,7 +532,7 @@ namespace ceras
         ///
         constexpr value_type* data() noexcept
         {
-            return (*vector_).data();
+            return vector_ ? (*vector_).data() + offset_ : nullptr; // null for a tensor moved from
         }
 
         ///
@@ -386,7 +543,7 @@ namespace ceras
         ///
         constexpr const value_type* data() const noexcept
         {
-            return (*vector_).data();
+            return vector_ ? (*vector_).data() + offset_ : nullptr; // null for a tensor moved from
         }
 
         ///
@@ -400,20 +557,62 @@ namespace ceras
         template< typename Function >
         constexpr self_type& map( Function const& f )
         {
+            detach();
             for_each( (*this).data(), (*this).data()+(*this).size(), [&f]( auto& v ){ f(v); } );
             return *this;
         }
 
+        ///
+        /// @brief Fused compound assignments of lazy element-wise expressions, see './tensor_expression.hpp'.
+        ///
+        template< typename Expression > requires requires( Expression const& expression, T* dst ) { expression.evaluate_into( dst ); }
+        self_type& operator += ( Expression const& expression )
+        {
+            better_assert( shape() == expression.shape(), fmt::format("Error with tensor::operator += : Shape mismatch! This shape is {}, while expression shape is {}.", shape(), expression.shape() ) );
+            detach();
+            expression.evaluate_into( data(), []( T x, T y ){ return x + y; } );
+            return *this;
+        }
+
+        template< typename Expression > requires requires( Expression const& expression, T* dst ) { expression.evaluate_into( dst ); }
+        self_type& operator -= ( Expression const& expression )
+        {
+            better_assert( shape() == expression.shape(), "Error with tensor::operator -=: Shape not match!" );
+            detach();
+            expression.evaluate_into( data(), []( T x, T y ){ return x - y; } );
+            return *this;
+        }
+
+        template< typename Expression > requires requires( Expression const& expression, T* dst ) { expression.evaluate_into( dst ); }
+        self_type& operator *= ( Expression const& expression )
+        {
+            better_assert( shape() == expression.shape(), "Shape not match!" );
+            detach();
+            expression.evaluate_into( data(), []( T x, T y ){ return x * y; } );
+            return *this;
+        }
+
+        template< typename Expression > requires requires( Expression const& expression, T* dst ) { expression.evaluate_into( dst ); }
+        self_type& operator /= ( Expression const& expression )
+        {
+            better_assert( shape() == expression.shape(), "Shape not match!" );
+            detach();
+            expression.evaluate_into( data(), []( T x, T y ){ return x / y; } );
+            return *this;
+        }
+
         constexpr self_type& operator += ( self_type const& other )
         {
             //better_assert( shape() == other.shape(), "Error with tensor::operator += : Shape mismatch! -- current shape is ", shape(), " and other tensor shape is ", other.shape() );
             better_assert( shape() == other.shape(), fmt::format("Error with tensor::operator += : Shape mismatch! This shape is {}, while other shape is {}.", shape(), other.shape() ) );
+            detach();
             std::transform( data(), data()+size(), other.data(), data(), []( auto x, auto y ){ return x+y; } );
             return *this;
         }
 
         constexpr self_type& operator += ( value_type x )
         {
+            detach();
             for_each( data(), data()+size(), [x]( value_type& v ){ v += x; } );
             return *this;
         }
@@ -421,12 +620,14 @@ namespace ceras
         constexpr self_type& operator -= ( self_type const& other )
         {
             better_assert( shape() == other.shape(), "Error with tensor::operator -=: Shape not match!" );
+            detach();
             std::transform( data(), data()+size(), other.data(), data(), []( auto x, auto y ){ return x-y; } );
             return *this;
         }
 
         constexpr self_type& operator -= ( value_type x )
         {
+            detach();
             for_each( data(), data()+size(), [x]( auto& v ){ v -= x; } );
             return *this;
         }
@@ -434,12 +635,14 @@ namespace ceras
         constexpr self_type& operator *= ( self_type const& other )
         {
             better_assert( shape() == other.shape(), "Shape not match!" );
+            detach();
             std::transform( data(), data()+size(), other.data(), data(), []( auto x, auto y ){ return x*y; } );
             return *this;
         }
 
         constexpr self_type& operator *= ( value_type x )
         {
+            detach();
             for_each( data(), data()+size(), [x]( auto& v ){ v *= x; } );
             return *this;
         }
@@ -447,34 +650,50 @@ namespace ceras
         constexpr self_type& operator /= ( self_type const& other )
         {
             better_assert( shape() == other.shape(), "Shape not match!" );
+            detach();
             std::transform( data(), data()+size(), other.data(), data(), []( auto x, auto y ){ return x/y; } );
             return *this;
         }
 
         constexpr self_type& operator /= ( value_type x )
         {
+            detach();
             for_each( data(), data()+size(), [x]( auto& v ){ v /= x; } );
             return *this;
         }
 
-        constexpr self_type const operator - () const
+        constexpr self_type const operator - () const&
         {
-            self_type ans = (*this).deep_copy();
-            for_each( ans.data(), ans.data()+size(), []( auto& v ){ v = -v; } );
+            self_type ans{ shape_ };
+            std::transform( data(), data()+size(), ans.data(), []( auto v ){ return -v; } );
             return  ans;
         }
 
+        ///
+        /// @brief Negation of a temporary, in its buffer if not shared.
+        ///
+        constexpr self_type operator - () &&
+        {
+            if ( is_shared() )
+                return static_cast<self_type const&>( *this ).operator-();
+            for_each( data(), data()+size(), []( auto& v ){ v = -v; } );
+            return std::move( *this );
+        }
+
         constexpr value_type as_scalar() const noexcept
         {
             better_assert( size() == 1, "Expecting tensor has a single value, but got ", size() );
             return *begin();
         }
 
+        ///
+        /// @brief A copy with the elements converted to type U, for example `as_type<bfloat16>()` for a tensor of half the memory, see `convert`.
+        ///
         template< typename U >
         constexpr auto as_type() const noexcept
         {
             tensor<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>> ans{ (*this).shape() };
-            std::copy( (*this).begin(), (*this).end(), ans.begin() );
+            convert( (*this).data(), ans.data(), (*this).size() );
             return ans;
         }
     }; // struct tensor
@@ -504,6 +723,10 @@ namespace ceras
 
 // All numerical operations defined in tensor.tcc
 #include "./tensor.tcc"
+// Lazy element-wise arithmetic
+#include "./tensor_expression.hpp"
+// Strided views and slices sharing the buffer of a tensor
+#include "./tensor_view.hpp"
 
 #endif//HQKGLAXWWVFBFHQNHBVTQJKGUFTPCQPTPXDVNOSBDJIBHITCEKDISJYNAMCPLJDURURDAISFV
 
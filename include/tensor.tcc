@@ -299,6 +299,56 @@ namespace ceras
     }
 
 
+    ///
+    /// @brief Writes `tsor` broadcast to `new_shape` into `ans`, whose buffer is reused if large enough. `ans` should not share the buffer of `tsor`.
+    ///
+    template <Tensor Tsor>
+    void broadcast_tensor( Tsor const& tsor, std::vector<size_t> const& new_shape, Tsor& ans ) noexcept
+    {
+        better_assert( tsor.ndim() <= new_shape.size(), "broadcast_tensor: cannot broadcast ", tsor.ndim(), " dimensions to ", new_shape.size() );
+        // the strides of tsor padded with leading 1s to the new shape, 0 along the expanded dimensions
+        size_t const ndim = new_shape.size();
+        std::vector<size_t> const& old_shape = tsor.shape();
+        std::vector<size_t> shape( ndim - old_shape.size(), 1UL );
+        shape.insert( shape.end(), old_shape.begin(), old_shape.end() );
+        std::vector<size_t> strides( ndim, 0UL );
+        for ( size_t axis = ndim, stride = 1; axis-- > 0; stride *= shape[axis] )
+        {
+            better_assert( shape[axis] == new_shape[axis] || shape[axis] == 1, fmt::format("expecting the expanding dimension to be 1, but got {}", shape[axis]) );
+            strides[axis] = ( shape[axis] == new_shape[axis] ) ? stride : 0UL;
+        }
+
+        ans.resize( new_shape );
+        if ( ans.empty() ) return;
+        if ( ndim == 0 )
+        {
+            ans[0] = tsor[0];
+            return;
+        }
+
+        // row by row of the last dimension, carrying over the outer indices
+        size_t const inner = new_shape.back();
+        size_t const inner_stride = strides.back();
+        std::vector<size_t> indices( ndim, 0UL );
+        auto const* src = tsor.data();
+        auto* dst = ans.data();
+        for ( size_t row = 0, rows = ans.size() / inner; row != rows; ++row, dst += inner )
+        {
+            if ( inner_stride == 0 )
+                std::fill_n( dst, inner, *src );
+            else
+                std::copy_n( src, inner, dst );
+            for ( size_t axis = ndim-1; axis-- > 0; )
+            {
+                src += strides[axis];
+                if ( ++indices[axis] != new_shape[axis] )
+                    break;
+                src -= new_shape[axis] * strides[axis];
+                indices[axis] = 0;
+            }
+        }
+    }
+
     template <Tensor Tsor>
     Tsor broadcast_tensor( Tsor const& tsor, std::vector<size_t> const& new_shape ) noexcept
     {
@@ -306,50 +356,18 @@ namespace ceras
         if ( tsor.shape() == new_shape )
             return tsor;
 
-        auto _ans = tsor;
-        std::vector<size_t> updated_shape = _ans.shape();
-        if (updated_shape.size() < new_shape.size())
-        {
-            for ([[maybe_unused]]auto _ : range(new_shape.size()-updated_shape.size()))
-                updated_shape.insert( updated_shape.begin(), 1 );
-            _ans.reshape( updated_shape );
-        }
-
         // case of same shapes after 1-padding
-        if ( updated_shape == new_shape )
-            return _ans;
-
-
-        // finding the expanding dimension
-        std::make_signed_t<size_t> dim_to_expand = updated_shape.size()-1;
-        while( dim_to_expand >= 0 )
+        std::vector<size_t> const& old_shape = tsor.shape();
+        if ( old_shape.size() < new_shape.size() && std::equal( old_shape.rbegin(), old_shape.rend(), new_shape.rbegin() ) &&
+             std::all_of( new_shape.begin(), new_shape.end() - old_shape.size(), []( size_t dim ) noexcept { return dim == 1; } ) )
         {
-            if ( new_shape[dim_to_expand] != updated_shape[dim_to_expand] )
-                break;
-            --dim_to_expand;
+            Tsor ans = tsor;
+            return ans.reshape( new_shape );
         }
 
-        better_assert( updated_shape[dim_to_expand] == 1, fmt::format("expecting the expanding dimension to be 1, but got {}", updated_shape[dim_to_expand]) );
-
-        // [headings..][1][tailings...] <- updated_shape
-        // [headings..][x][tailings...] <- new_shape
-        size_t const headings = std::accumulate( updated_shape.begin(), updated_shape.begin()+dim_to_expand, 1UL, []( auto x, auto y ) noexcept { return x*y; } );
-        size_t const repeats = new_shape[dim_to_expand];
-        size_t const tailings = std::accumulate( updated_shape.begin()+dim_to_expand, updated_shape.end(), 1UL, []( auto x, auto y ) noexcept { return x*y; } );
-
-        std::vector<size_t> expanded_shape = updated_shape;
-        expanded_shape[dim_to_expand] = new_shape[dim_to_expand];
-        Tsor ans{ expanded_shape };
-        view_3d v3{ ans.data(), headings, repeats, tailings }; // 3D view of ans
-        view_2d v2{ _ans.data(), headings, tailings }; // 2D view of _ans
-
-        for ( auto r : range( headings ) )
-            for ( auto c : range( repeats ) )
-                for ( auto ch : range( tailings ) )
-                    v3[r][c][ch] = v2[r][ch];
-
-        ans.reshape( expanded_shape );
-        return broadcast_tensor( ans, new_shape ); // not necessarily done in a single loop
+        Tsor ans;
+        broadcast_tensor( tsor, new_shape, ans );
+        return ans;
     }
 
     ///
@@ -425,35 +443,23 @@ namespace ceras
 
     // C <= A * B
     // where A or A' is [m x n], B or B' is [n x k] and C is [m x k]
-    template< typename T > requires std::floating_point<T>
-    void gemm_cpu( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C )
-    {
-        auto a_view = view_2d{ A, m, n, a_transposed };
-        auto b_view = view_2d{ B, n, k, b_transposed };
-        auto c_view = view_2d{ C, m, k };
-
-        std::fill_n( C, m*k, T{0} );
-
-        if ( a_transposed == false && b_transposed == false )
-            for ( auto r = 0UL; r != m; ++r )
-                for ( auto idx = 0UL; idx != n; ++idx )
-                    for ( auto c = 0UL; c != k; ++c )
-                        c_view[r][c] += a_view[r][idx] * b_view[idx][c];
-        else if ( a_transposed == false && b_transposed == true )
-            for ( auto r = 0UL; r != m; ++r )
-                for ( auto idx = 0UL; idx != n; ++idx )
-                    for ( auto c = 0UL; c != k; ++c )
-                        c_view[r][c] += a_view[r][idx] * b_view[c][idx];
-        else if ( a_transposed == true && b_transposed == false )
-            for ( auto r = 0UL; r != m; ++r )
-                for ( auto idx = 0UL; idx != n; ++idx )
-                    for ( auto c = 0UL; c != k; ++c )
-                        c_view[r][c] += a_view[idx][r] * b_view[idx][c];
-        else
-            for ( auto r = 0UL; r != m; ++r )
-                for ( auto idx = 0UL; idx != n; ++idx )
-                    for ( auto c = 0UL; c != k; ++c )
-                        c_view[r][c] += a_view[idx][r] * b_view[c][idx];
+    //
+    // Tiny products are dominated by the packing overhead of the blocked engine, they go through the plain loop.
+    // Larger ones are split over the available cores by parallel_gemm.
+    // The epilogue is applied to C tile by tile, see `gemm_no_epilogue` in './backend/gemm.hpp'.
+    template< typename T, typename Epilogue = gemm_no_epilogue > requires std::floating_point<T>
+    void gemm_cpu( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C, Epilogue const& epilogue = Epilogue{} )
+    {
+        if ( m * n * k < 4096 )
+        {
+            naive_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
+            epilogue( C, k, 0, 0, m, k );
+            return;
+        }
+
+        size_t const lda = a_transposed ? m : n;
+        size_t const ldb = b_transposed ? n : k;
+        parallel_gemm( A, lda, a_transposed, B, ldb, b_transposed, m, n, k, C, k, ceras_private::default_gemm_blocking<T>(), thread_pool::instance().size(), epilogue );
     }
 
     // this function is used to update the threshod 'cuda_gemm_threshold' defined in '../config.hpp', only considering float case
@@ -522,8 +528,33 @@ namespace ceras
 
     // C <= A * B
     // where A or A' is [m x n], B or B' is [n x k] and C is [m x k]
-    template< typename T > requires std::floating_point<T>
-    void gemm( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C )
+    //
+    // Dispatches to the cpu kernel tuned for the shape bucket of (m, n, k, a_transposed, b_transposed), see './backend/gemm_tuner.hpp'.
+    // Without a plan, cblas is used if enabled, and gemm_cpu otherwise.
+    template< typename T, typename Epilogue = gemm_no_epilogue > requires std::floating_point<T>
+    void host_gemm( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C, Epilogue const& epilogue = Epilogue{} )
+    {
+        if ( auto const plan = find_gemm_plan<T>( m, n, k, a_transposed, b_transposed ); plan )
+        {
+            run_gemm_plan( *plan, A, a_transposed, B, b_transposed, m, n, k, C, epilogue );
+            return;
+        }
+
+        if constexpr( cblas_mode )
+        {
+            cblas_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
+            epilogue( C, k, 0, 0, m, k );
+        }
+        else
+            gemm_cpu( A, a_transposed, B, b_transposed, m, n, k, C, epilogue );
+    }
+
+    // C <= A * B
+    // where A or A' is [m x n], B or B' is [n x k] and C is [m x k]
+    //
+    // The epilogue is fused into the cpu kernel; after a cuda or cblas product it runs over the whole of C.
+    template< typename T, typename Epilogue = gemm_no_epilogue > requires std::floating_point<T>
+    void gemm( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C, Epilogue const& epilogue = Epilogue{} )
     {
         if ( cuda_gemm_threshold == 0 ) // global variable defined in config.h
             update_cuda_gemm_threshold();
@@ -533,25 +564,37 @@ namespace ceras
             size_t const operations = m * n * k;
 
             if ( operations >= cuda_gemm_threshold )
-                cuda_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
-            else
             {
-                if constexpr( cblas_mode )
-                    cblas_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
-                else
-                    gemm_cpu( A, a_transposed, B, b_transposed, m, n, k, C );
+                cuda_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
+                epilogue( C, k, 0, 0, m, k );
             }
-        }
-        else
-        {
-            if constexpr( cblas_mode )
-                cblas_gemm( A, a_transposed, B, b_transposed, m, n, k, C );
             else
-                gemm_cpu( A, a_transposed, B, b_transposed, m, n, k, C );
+                host_gemm( A, a_transposed, B, b_transposed, m, n, k, C, epilogue );
         }
+        else
+            host_gemm( A, a_transposed, B, b_transposed, m, n, k, C, epilogue );
     }
 
-    template< typename T >  requires std::floating_point<T> // this one only for non-transposed 2d View
+    // C <= A * B
+    // where A or A' is [m x n], B or B' is [n x k] and C is [m x k], of a 16-bit type, see './utils/half_float.hpp'
+    //
+    // The operands are converted to float in scratch buffers of the calling thread and multiplied by the float gemm above,
+    // accumulating in float; the product is rounded to 16 bits before the epilogue.
+    template< Half_Float T, typename Epilogue = gemm_no_epilogue >
+    void gemm( T const* A, bool a_transposed, T const* B, bool b_transposed, size_t m, size_t n, size_t k, T* __restrict__ C, Epilogue const& epilogue = Epilogue{} )
+    {
+        thread_local std::vector<float, aligned_allocator<float>> a, b, c;
+        a.resize( m * n );
+        b.resize( n * k );
+        c.resize( m * k );
+        convert( A, a.data(), m * n );
+        convert( B, b.data(), n * k );
+        gemm( a.data(), a_transposed, b.data(), b_transposed, m, n, k, c.data() );
+        convert( c.data(), C, m * k );
+        epilogue( C, k, 0, 0, m, k );
+    }
+
+    template< typename T >  requires Floating_Point<T> // this one only for non-transposed 2d View
     void gemm( view_2d<T> const& x, view_2d<T> const& y, view_2d<T>& ans ) //note: direct copy of x and y
     {
         auto const [x_row, x_col] = x.shape();
@@ -565,6 +608,32 @@ namespace ceras
         gemm( x.data(), x.transposed_, y.data(), y.transposed_, x_row, x_col, y_col, ans.data() );
     }
 
+    // C[i] <= A[i] * B[i], for i in [0, batch)
+    // where A[i] = A + i * stride_a, B[i] = B + i * stride_b and C[i] = C + i * stride_c, A[i] or A[i]' is [m x n], B[i] or B[i]' is [n x k] and C[i] is [m x k]
+    //
+    // A stride of 0 shares the same matrix with all the products. A right side shared by a contiguous, non-transposed left side
+    // folds the whole batch into a single [batch*m x n] * [n x k] product; the others are spread over the cores one product per task.
+    template< typename T > requires Floating_Point<T>
+    void batched_gemm( T const* A, size_t stride_a, bool a_transposed, T const* B, size_t stride_b, bool b_transposed,
+                       size_t batch, size_t m, size_t n, size_t k, T* __restrict__ C, size_t stride_c )
+    {
+        if ( (batch == 1) || ((stride_b == 0) && (!a_transposed) && (stride_a == m*n) && (stride_c == m*k)) )
+        {
+            gemm( A, a_transposed, B, b_transposed, batch*m, n, k, C );
+            return;
+        }
+
+        if constexpr( cuda_mode || cblas_mode || Half_Float<T> ) // these libraries manage their own threads, and the 16-bit products convert through float
+        {
+            for ( auto idx : range( batch ) )
+                gemm( A+idx*stride_a, a_transposed, B+idx*stride_b, b_transposed, m, n, k, C+idx*stride_c );
+        }
+        else
+        {
+            parallel( [=]( size_t idx ){ gemm_cpu( A+idx*stride_a, a_transposed, B+idx*stride_b, b_transposed, m, n, k, C+idx*stride_c ); }, size_t{0}, batch, 1 );
+        }
+    }
+
     // always prefer channel-last data format
     // Example:
     //
@@ -574,93 +643,88 @@ namespace ceras
     // [ 3, 4 ] + [  -1, 1 ] = [ 2, 5 ]
     // [ 5, 6 ]                [ 4, 7 ]
     //
-    template< Tensor Tsor >
-    Tsor add( Tsor const& lhs, Tsor const& rhs ) noexcept
-    {
-        auto const& broadcasted_shape = broadcast_shape( lhs.shape(), rhs.shape() );
-        auto llhs = broadcast_tensor( lhs, broadcasted_shape );
-        auto const& rrhs = broadcast_tensor( rhs, broadcasted_shape );
-
-        for_each( llhs.begin(), llhs.end(), rrhs.begin(), []( auto& x, auto const& y ) noexcept { x += y; } );
-        return llhs;
-    }
+    //
+    // Most of the kernels below come in two forms, as `multiply` and `flip` do: one returning a new tensor, and one writing to a
+    // destination `ans` passed as the last argument. The destination is resized to the shape of the result, keeping its buffer if
+    // that is large enough, so that an operator calling it with a cached tensor allocates nothing once warmed up.
+    // The destination must not share the buffer of an input, unless stated otherwise.
+    //
 
-    template< Tensor Tsor >
-    Tsor operator + ( Tsor const& lhs, Tsor const& rhs ) noexcept
+    ///
+    /// @brief Applies `func` element-wise to two tensors broadcasted together, see `broadcast_binary` in './backend/broadcast.hpp'.
+    ///
+    /// The broadcasted operand is read in place, never expanded to the shape of the result.
+    ///
+    template< Tensor Tsor, typename Function >
+    void broadcast_apply( Tsor const& lhs, Tsor const& rhs, Function const& func, Tsor& ans )
     {
-        return add( lhs, rhs );
+        ans.resize( broadcast_shape( lhs.shape(), rhs.shape() ) );
+        broadcast_binary( lhs.data(), lhs.shape(), rhs.data(), rhs.shape(), ans.data(), ans.shape(), func );
     }
 
-    template< Tensor Tsor >
-    Tsor operator + ( typename Tsor::value_type const& lhs, Tsor const& rhs ) noexcept
+    template< Tensor Tsor, typename Function >
+    Tsor broadcast_apply( Tsor const& lhs, Tsor const& rhs, Function const& func )
     {
-        auto ans = rhs.deep_copy();
-        ans.map( [lhs]( auto& v ){ v += lhs; } );
+        Tsor ans;
+        broadcast_apply( lhs, rhs, func, ans );
         return ans;
     }
 
+    ///
+    /// @brief Sums a tensor over its broadcasted dimensions down to `shape`, the reverse of broadcasting it to its shape.
+    ///
+    /// This is the gradient of a broadcasted operand, see `broadcast_sum` in './backend/broadcast.hpp'.
+    ///
     template< Tensor Tsor >
-    Tsor operator + ( Tsor const& lhs, typename Tsor::value_type const& rhs ) noexcept
-    {
-        return rhs + lhs;
-    }
-
-    template< Tensor Tsor >
-    Tsor minus( Tsor const& lhs, Tsor const& rhs ) noexcept
-    {
-        auto const& broadcasted_shape = broadcast_shape( lhs.shape(), rhs.shape() );
-        auto llhs = broadcast_tensor( lhs, broadcasted_shape );
-        auto const& rrhs = broadcast_tensor( rhs, broadcasted_shape );
-
-        for_each( llhs.begin(), llhs.end(), rrhs.begin(), []( auto& x, auto const& y ) noexcept { x -= y; } );
-        return llhs;
-        //return add( lhs, -rhs );
-    }
-
-    template< Tensor Tsor >
-    Tsor operator - ( Tsor const& lhs, Tsor const& rhs ) noexcept
+    void sum_to_shape( Tsor const& tsor, std::vector<size_t> const& shape, Tsor& ans )
     {
-        return minus( lhs, rhs );
+        ans.resize( shape );
+        if ( shape == tsor.shape() )
+        {
+            std::copy_n( tsor.data(), tsor.size(), ans.data() );
+            return;
+        }
+        broadcast_sum( tsor.data(), tsor.shape(), ans.data(), shape );
     }
 
     template< Tensor Tsor >
-    Tsor operator - ( typename Tsor::value_type const& lhs, Tsor const& rhs ) noexcept
+    Tsor sum_to_shape( Tsor const& tsor, std::vector<size_t> const& shape )
     {
-        auto ans = rhs.deep_copy();
-        ans.map( [lhs]( auto& v ){ v = lhs - v; } );
+        Tsor ans;
+        sum_to_shape( tsor, shape, ans );
         return ans;
     }
 
     template< Tensor Tsor >
-    Tsor operator - ( Tsor const& lhs, typename Tsor::value_type const& rhs ) noexcept
+    void add( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
     {
-        auto ans = lhs.deep_copy();
-        ans.map( [rhs]( auto& v ){ v -= rhs; } );
-        return ans;
+        broadcast_apply( lhs, rhs, []( auto x, auto y ) noexcept { return x + y; }, ans );
     }
 
     template< Tensor Tsor >
-    Tsor operator * ( typename Tsor::value_type const& lhs, Tsor const& rhs ) noexcept
+    Tsor add( Tsor const& lhs, Tsor const& rhs ) noexcept
     {
-        auto ans = rhs.deep_copy();
-        ans.map( [lhs]( auto& v ){ v *= lhs; } );
+        Tsor ans;
+        add( lhs, rhs, ans );
         return ans;
     }
 
     template< Tensor Tsor >
-    Tsor operator * ( Tsor const& lhs, typename Tsor::value_type const& rhs ) noexcept
+    void minus( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
     {
-        return rhs * lhs;
+        broadcast_apply( lhs, rhs, []( auto x, auto y ) noexcept { return x - y; }, ans );
     }
 
     template< Tensor Tsor >
-    Tsor operator / ( Tsor const& lhs, typename Tsor::value_type const& rhs ) noexcept
+    Tsor minus( Tsor const& lhs, Tsor const& rhs ) noexcept
     {
-        auto ans = lhs.deep_copy();
-        ans.map( [rhs]( auto& v ){ v /= rhs; } );
+        Tsor ans;
+        minus( lhs, rhs, ans );
         return ans;
     }
 
+    // the element-wise operators `+`, `-`, `*` and `/` of tensors and scalars are lazy, see './tensor_expression.hpp'
+
     template< Tensor Tsor >
     Tsor reshape( Tsor const& ts, std::vector<size_t> const& new_shape )
     {
@@ -677,6 +741,22 @@ namespace ceras
         if ( 1 == rhs.ndim() )
             return multiply( lhs, reshape( rhs, {lhs.size(), 1UL} ), ans );
 
+        if ( (3 == lhs.ndim()) || (3 == rhs.ndim()) ) // [bs, m, n] * [bs, n, k], or one side shared by the batch
+        {
+            better_assert( (lhs.ndim() <= 3) && (rhs.ndim() <= 3), "expecting tensors of at most 3 dimensions, but got ", lhs.ndim(), " and ", rhs.ndim() );
+            auto const& lhs_shape = lhs.shape();
+            auto const& rhs_shape = rhs.shape();
+            size_t const batch = ( 3 == lhs.ndim() ) ? lhs_shape[0] : rhs_shape[0];
+            auto const [m, n] = std::make_pair( *(lhs_shape.rbegin()+1), *(lhs_shape.rbegin()) );
+            auto const [n_, k] = std::make_pair( *(rhs_shape.rbegin()+1), *(rhs_shape.rbegin()) );
+            better_assert( n == n_, "expecting lhs columns equal to rhs rows, but got ", n, " and ", n_ );
+            better_assert( (2 == lhs.ndim()) || (2 == rhs.ndim()) || (lhs_shape[0] == rhs_shape[0]), "batch size mismatch: ", lhs_shape[0], " and ", rhs_shape[0] );
+
+            ans.resize( {batch, m, k} );
+            batched_gemm( lhs.data(), ( 3 == lhs.ndim() ) ? m*n : 0UL, false, rhs.data(), ( 3 == rhs.ndim() ) ? n*k : 0UL, false, batch, m, n, k, ans.data(), m*k );
+            return;
+        }
+
         better_assert( 2 == rhs.ndim(), "expecting rhs tensor has 2 dimensions, but got ", rhs.ndim() );
 
         if ( 2 == lhs.ndim() )
@@ -710,24 +790,35 @@ namespace ceras
         return multiply( lhs, rhs );
     }
 
-    // caution: only valid for channel last case
+    ///
+    /// @brief Element-wise product, with broadcasting.
+    ///
+    /// Operands of different but not broadcastable shapes are still accepted if the size of one divides the size of the other,
+    /// the smaller being repeated over the larger in the channel-last order.
+    ///
     template< Tensor Tsor >
-    Tsor elementwise_product( Tsor const& lhs, Tsor const& rhs ) noexcept
+    void elementwise_product( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
     {
+        auto const& multiplies = []( auto x, auto y ) noexcept { return x * y; };
+        if ( broadcastable( lhs.shape(), rhs.shape() ) )
+            return broadcast_apply( lhs, rhs, multiplies, ans );
+
         size_t const l_size = lhs.size();
         size_t const r_size = rhs.size();
-        if ( l_size < r_size ) return elementwise_product(rhs, lhs);
+        if ( l_size < r_size ) return elementwise_product( rhs, lhs, ans );
 
         size_t const repeats = l_size / r_size;
         better_assert( (r_size * repeats) == l_size, "Dimension is not match!" );
 
-        Tsor ans = lhs.deep_copy();
-        for ( auto idx : range( repeats ) )
-            for ( auto jdx : range( r_size ) )
-            {
-                ans[idx*r_size+jdx] *= rhs[jdx];
-            }
+        ans.resize( lhs.shape() );
+        broadcast_binary( lhs.data(), {repeats, r_size}, rhs.data(), {r_size,}, ans.data(), {repeats, r_size}, multiplies );
+    }
 
+    template< Tensor Tsor >
+    Tsor elementwise_product( Tsor const& lhs, Tsor const& rhs ) noexcept
+    {
+        Tsor ans;
+        elementwise_product( lhs, rhs, ans );
         return ans;
     }
 
@@ -737,45 +828,157 @@ namespace ceras
         return elementwise_product( lhs, rhs );
     }
 
+    ///
+    /// @brief Element-wise division, with broadcasting.
+    ///
+    template< Tensor Tsor >
+    void elementwise_divide( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
+    {
+        broadcast_apply( lhs, rhs, []( auto x, auto y ) noexcept { return x / y; }, ans );
+    }
+
     template< Tensor Tsor >
     Tsor elementwise_divide( Tsor const& lhs, Tsor const& rhs ) noexcept
     {
-        better_assert( lhs.shape() == rhs.shape(), "Shape not match!" );
-        Tsor ans{ lhs.shape() };
-        for_each( lhs.begin(), lhs.end(), rhs.begin(), ans.begin(), []( auto x, auto y, auto& z ){ z = x/y; } );
+        Tsor ans;
+        elementwise_divide( lhs, rhs, ans );
         return ans;
     }
 
+    ///
+    /// @brief Element-wise maximum, with broadcasting.
+    ///
     template< Tensor Tsor >
-    Tsor repeat( Tsor const& tsor, size_t n )
+    void maximum( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
     {
-        Tsor ans{ {n, tsor.size()} };
-        {
-            auto itor = ans.data();
-            for  ( auto idx : range(n) )
-                std::copy( tsor.begin(), tsor.end(), itor + idx * tsor.size() );
+        broadcast_apply( lhs, rhs, []( auto x, auto y ) noexcept { return x > y ? x : y; }, ans );
+    }
 
-            std::vector<size_t>  new_shape;
-            new_shape.push_back( n );
-            std::copy( tsor.shape().begin(), tsor.shape().end(), std::back_inserter( new_shape ) );
-            ans.reshape( new_shape );
-        }
+    template< Tensor Tsor >
+    Tsor maximum( Tsor const& lhs, Tsor const& rhs ) noexcept
+    {
+        Tsor ans;
+        maximum( lhs, rhs, ans );
+        return ans;
+    }
+
+    ///
+    /// @brief Element-wise minimum, with broadcasting.
+    ///
+    template< Tensor Tsor >
+    void minimum( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
+    {
+        broadcast_apply( lhs, rhs, []( auto x, auto y ) noexcept { return x > y ? y : x; }, ans );
+    }
+
+    template< Tensor Tsor >
+    Tsor minimum( Tsor const& lhs, Tsor const& rhs ) noexcept
+    {
+        Tsor ans;
+        minimum( lhs, rhs, ans );
+        return ans;
+    }
+
+    ///
+    /// @brief Element-wise arc tangent of `lhs/rhs`, in the quadrant given by their signs, with broadcasting.
+    ///
+    template< Tensor Tsor >
+    void atan2( Tsor const& lhs, Tsor const& rhs, Tsor& ans ) noexcept
+    {
+        broadcast_apply( lhs, rhs, []( auto y, auto x ) noexcept { return std::atan2( y, x ); }, ans );
+    }
 
+    template< Tensor Tsor >
+    Tsor atan2( Tsor const& lhs, Tsor const& rhs ) noexcept
+    {
+        Tsor ans;
+        atan2( lhs, rhs, ans );
         return ans;
     }
 
+    ///
+    /// @brief The transpose of a 2D tensor.
+    ///
+    template< Tensor Tsor >
+    void transpose( Tsor const& tsor, Tsor& ans ) noexcept
+    {
+        better_assert( tsor.ndim() == 2, "Expecting 2D tensor, but got dimensions ", tsor.ndim() );
+        typedef typename Tsor::value_type value_type;
+
+        auto const& shape = tsor.shape();
+        auto const [row, col] = std::make_pair( shape[0], shape[1] );
+        ans.resize( {col, row} );
+        view_2d<value_type> const v_in{ tsor.data(), row, col };
+        view_2d<value_type> v_out{ ans.data(), col, row };
+
+        // a tile of the input and a tile of the output in L1, written row by row; with rows of a power of two bytes apart,
+        // larger tiles put more lines than the ways of a set of the cache
+        size_t constexpr tile = 16;
+        for ( size_t c0 = 0; c0 < col; c0 += tile )
+            for ( size_t r0 = 0; r0 < row; r0 += tile )
+                for ( size_t c = c0; c < std::min( col, c0+tile ); ++c )
+                    for ( size_t r = r0; r < std::min( row, r0+tile ); ++r )
+                        v_out[c][r] = v_in[r][c];
+    }
+
+    template< Tensor Tsor >
+    Tsor transpose( Tsor const& tsor ) noexcept
+    {
+        Tsor ans;
+        transpose( tsor, ans );
+        return ans;
+    }
+
+    template< Tensor Tsor >
+    void repeat( Tsor const& tsor, size_t n, Tsor& ans )
+    {
+        std::vector<size_t> new_shape;
+        new_shape.push_back( n );
+        auto const& shape = tsor.shape();
+        std::copy( shape.begin(), shape.end(), std::back_inserter( new_shape ) );
+        ans.resize( new_shape );
+
+        auto itor = ans.data();
+        for  ( auto idx : range(n) )
+            std::copy( tsor.begin(), tsor.end(), itor + idx * tsor.size() );
+    }
+
+    template< Tensor Tsor >
+    Tsor repeat( Tsor const& tsor, size_t n )
+    {
+        Tsor ans;
+        repeat( tsor, n, ans );
+        return ans;
+    }
+
+    template< Tensor Tsor >
+    void reduce_sum( Tsor const& tsor, Tsor& ans )
+    {
+        auto result = std::reduce( tsor.data(), tsor.data()+tsor.size(), compute_type_t<typename Tsor::value_type>{0} ); // in float for the 16-bit types
+        ans.resize( {1,} );
+        ans[0] = result;
+    }
+
     template< Tensor Tsor >
     Tsor reduce_sum( Tsor const& tsor )
     {
-        auto result = std::reduce( tsor.data(), tsor.data()+tsor.size(), typename Tsor::value_type{0} );
-        return Tsor{ std::vector<size_t>{1}, {result,} };
+        Tsor ans;
+        reduce_sum( tsor, ans );
+        return ans;
+    }
+
+    template< Tensor Tsor >
+    void reduce_mean( Tsor const& tsor, Tsor& ans )
+    {
+        reduce_sum( tsor, ans );
+        for_each( ans.begin(), ans.end(), [n=tsor.size()]( auto& v ){ v /= n; } ); // in the buffer of `ans`, as `reduce_sum` writes it
     }
 
     template< Tensor Tsor >
     Tsor reduce_mean( Tsor const& tsor )
     {
-        auto ans = reduce_sum( tsor );
-        ans /= tsor.size();
+        Tsor ans;
+        reduce_mean( tsor, ans );
         return ans;
     }
 
@@ -912,20 +1115,22 @@ namespace ceras
     }
 
     template< Tensor Tsor >
-    Tsor concatenate( Tsor const& lhs, Tsor const& rhs, size_t axis=0 ) noexcept
+    void concatenate( Tsor const& lhs, Tsor const& rhs, size_t axis, Tsor& ans ) noexcept
     {
         if ( lhs.ndim() < rhs.ndim() )
-            return concatenate( rhs, lhs, axis );
+            return concatenate( rhs, lhs, axis, ans );
 
         // axis alignment
         if ( lhs.ndim() > rhs.ndim() )
         {
-            size_t const dims_to_repeat = std::accumulate( lhs.shape().begin(), lhs.shape().begin()+lhs.ndim()-rhs.ndim(), 1UL, [](auto x, auto y ){ return x*y; } );
+            std::vector<size_t> const lhs_shape = lhs.shape();
+            std::vector<size_t> const rhs_shape = rhs.shape();
+            size_t const dims_to_repeat = std::accumulate( lhs_shape.begin(), lhs_shape.begin()+lhs.ndim()-rhs.ndim(), 1UL, [](auto x, auto y ){ return x*y; } );
             auto new_rhs = repeat( rhs, dims_to_repeat );
-            std::vector<size_t> new_shape{ lhs.shape().begin(), lhs.shape().begin()+lhs.ndim()-rhs.ndim() };
-            std::copy( rhs.shape().begin(), rhs.shape().end(), std::back_inserter( new_shape ) );
+            std::vector<size_t> new_shape{ lhs_shape.begin(), lhs_shape.begin()+lhs.ndim()-rhs.ndim() };
+            std::copy( rhs_shape.begin(), rhs_shape.end(), std::back_inserter( new_shape ) );
             new_rhs.reshape( new_shape );
-            return concatenate( lhs, new_rhs, axis );
+            return concatenate( lhs, new_rhs, axis, ans );
         }
 
         auto l_shape = lhs.shape();
@@ -942,7 +1147,7 @@ namespace ceras
 
         std::vector<size_t> result_shape = l_shape;
         result_shape[axis] += r_shape[axis];
-        Tsor ans{ result_shape };
+        ans.resize( result_shape );
         auto target_memory_position = ans.data();
 
         for ( auto idx = 0UL; idx != memory_copy_times; ++idx )
@@ -952,24 +1157,36 @@ namespace ceras
             std::copy_n( rhs.data() + r_memory_stride*idx, r_memory_stride, target_memory_position );
             target_memory_position += r_memory_stride;
         }
+    }
 
+    template< Tensor Tsor >
+    Tsor concatenate( Tsor const& lhs, Tsor const& rhs, size_t axis=0 ) noexcept
+    {
+        Tsor ans;
+        concatenate( lhs, rhs, axis, ans );
         return ans;
     }
 
     template< Tensor Tsor >
-    Tsor repmat( Tsor const& tsor, size_t row_rep, size_t col_rep )
+    void repmat( Tsor const& tsor, size_t row_rep, size_t col_rep, Tsor& ans )
     {
         better_assert( tsor.shape().size() == 2, "Only 2D array has repmat method, the input array has ", tsor.shape().size(), " dimensions!" );
         auto const& old_shape = tsor.shape();
         auto const [old_row, old_col] = std::make_pair( old_shape[0], old_shape[1] );
 
-        Tsor ans{ {old_row*row_rep, old_col*col_rep} };
+        ans.resize( {old_row*row_rep, old_col*col_rep} );
         // fill cols
         for ( auto rdx = 0UL; rdx != row_rep; ++rdx )
             for ( auto cdx = 0UL; cdx != col_rep; ++cdx )
                 for ( auto odx = 0UL; odx != old_row; ++odx )
                     std::copy_n( tsor.data() + odx * old_col, old_col, ans.data() + old_row * old_col * rdx * col_rep + odx * old_col * col_rep + old_col * cdx );
+    }
 
+    template< Tensor Tsor >
+    Tsor repmat( Tsor const& tsor, size_t row_rep, size_t col_rep )
+    {
+        Tsor ans;
+        repmat( tsor, row_rep, col_rep, ans );
         return ans;
     }
 
@@ -1059,30 +1276,48 @@ namespace ceras
         return std::sqrt( std::accumulate( tsor.data(), tsor.data()+tsor.size(), value_type{0}, []( value_type x, value_type y ){ return x + y*y; }  ) ) / static_cast<value_type>( tsor.size() );
     }
 
+    template< Tensor Tsor >
+    void abs( Tsor const& tsor, Tsor& ans )
+    {
+        ans.resize( tsor.shape() );
+        for_each( tsor.begin(), tsor.end(), ans.begin(), []( auto x, auto& y ){ y = std::abs( x ); } );
+    }
+
     template< Tensor Tsor >
     Tsor abs( Tsor const& tsor )
     {
-        auto ans = tsor.deep_copy();
-        ans.map( []( auto& x ){ x = std::abs( x ); } );
+        Tsor ans;
+        abs( tsor, ans );
         return ans;
     }
 
+    ///
+    /// @brief Softmax along the last axis. `ans` may be `tsor` itself.
+    ///
     template< Tensor Tsor >
-    Tsor softmax( Tsor const& tsor )
+    void softmax( Tsor const& tsor, Tsor& ans )
     {
         typedef typename Tsor::value_type value_type;
         better_assert( !tsor.empty(), "softmax argument is an empty tensor. " );
-        Tsor ans = tsor.deep_copy();
+        ans.resize( tsor.shape() ); // a no-op if `ans` is `tsor`
         size_t const last_dim = *(tsor.shape().rbegin());
         size_t const rem_dim = tsor.size() / last_dim;
+        view_2d<value_type> const src{ tsor.data(), rem_dim, last_dim };
         view_2d<value_type> mat{ ans.data(), rem_dim, last_dim };
         for ( auto idx : range( rem_dim ) )
         {
-            value_type const mx = *std::max_element( mat[idx], mat[idx+1] );
-            for_each( mat[idx], mat[idx+1], [mx]( auto& v ){ v -= mx; } );
-            value_type const ac = std::accumulate( mat[idx], mat[idx+1], value_type{0}, []( value_type init, value_type val ){ return init + std::exp(val); } );
-            for_each( mat[idx], mat[idx+1], [ac]( auto& v ){ v = std::exp(v) / (ac+eps); } );
+            value_type const mx = *std::max_element( src[idx], src[idx+1] );
+            for_each( src[idx], src[idx+1], mat[idx], [mx]( auto x, auto& v ){ v = std::exp( x - mx ); } ); // read from `tsor`, no copy of it
+            value_type const ac = std::accumulate( mat[idx], mat[idx+1], value_type{0} );
+            for_each( mat[idx], mat[idx+1], [ac]( auto& v ){ v /= (ac+eps); } );
         }
+    }
+
+    template< Tensor Tsor >
+    Tsor softmax( Tsor const& tsor )
+    {
+        Tsor ans;
+        softmax( tsor, ans );
         return ans;
     }
 
@@ -1105,9 +1340,13 @@ namespace ceras
     }
 
     template< Tensor Tsor, typename Function >
-    Tsor reduce( Tsor const& ts, size_t axis, typename Tsor::value_type const& init, Function const& func, bool keepdims=false ) noexcept
+    void reduce( Tsor const& ts, size_t axis, typename Tsor::value_type const& init, Function const& func, bool keepdims, Tsor& ans ) noexcept
     {
-        if ( ts.empty() ) return ts;
+        if ( ts.empty() )
+        {
+            ans.resize( ts.shape() );
+            return;
+        }
 
         axis = (axis == static_cast<size_t>( -1 )) ? ts.ndim()-1 : axis;
         better_assert( axis < ts.ndim(), "Error with tensor::reduce, input axis ", axis, " is too large for a tensor with ", ts.ndim(), " dimensions." );
@@ -1117,79 +1356,143 @@ namespace ceras
         size_t const post = std::reduce( _shape.begin()+axis+1, _shape.end(), 1Ul, []( size_t x, size_t y ){ return x*y; } );
 
         size_t const n = _shape[axis];
-        _shape[axis] = 1UL;
+        if ( keepdims )
+            _shape[axis] = 1UL;
+        else
+            _shape.erase( _shape.begin() + axis );
 
-        Tsor ans{ _shape };
+        ans.resize( _shape );
         auto itor = ans.begin();
         for ( auto idx : range( pres ) )
             for ( auto jdx : range( post ) )
             {
                 auto start = ts.begin() + idx * post * n + jdx;
                 stride_iterator si{ start, static_cast<std::int64_t>(post) };
-                *itor++ = std::reduce( si, si+n, init, func );
+                *itor++ = std::reduce( si, si+n, static_cast<compute_type_t<typename Tsor::value_type>>( init ), func );
             }
+    }
 
-        if ( !keepdims )
-        {
-            std::copy( _shape.begin()+axis+1, _shape.end(), _shape.begin()+axis );
-            _shape.resize( _shape.size() - 1 );
-            ans.reshape( _shape );
-        }
-
+    template< Tensor Tsor, typename Function >
+    Tsor reduce( Tsor const& ts, size_t axis, typename Tsor::value_type const& init, Function const& func, bool keepdims=false ) noexcept
+    {
+        if ( ts.empty() ) return ts;
+        Tsor ans;
+        reduce( ts, axis, init, func, keepdims, ans );
         return ans;
     }
 
+    template <Tensor Tsor>
+    void sum( Tsor const& ts, size_t axis, bool keepdims, Tsor& ans ) noexcept
+    {
+        reduce( ts, axis, typename Tsor::value_type{0}, []( auto const& a, auto const& b ){ return a+b; }, keepdims, ans );
+    }
+
     template <Tensor Tsor>
     Tsor sum( Tsor const& ts, size_t axis, bool keepdims=false ) noexcept
     {
         return reduce( ts, axis, typename Tsor::value_type{0}, []( auto const& a, auto const& b ){ return a+b; }, keepdims );
     }
 
-    template <Tensor Tsor> requires std::floating_point<typename Tsor::value_type>
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
+    void mean( Tsor const& ts, size_t axis, bool keepdims, Tsor& ans ) noexcept
+    {
+        typedef typename Tsor::value_type value_type;
+        axis = ( axis == static_cast<size_t>( -1 ) ) ? ts.ndim()-1 : axis;
+        sum( ts, axis, keepdims, ans );
+        for_each( ans.begin(), ans.end(), [n=static_cast<value_type>( ts.shape()[axis] )]( auto& v ){ v /= n; } );
+    }
+
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
     Tsor mean( Tsor const& ts, size_t axis, bool keepdims=false ) noexcept
+    {
+        Tsor ans;
+        mean( ts, axis, keepdims, ans );
+        return ans;
+    }
+
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
+    void variance( Tsor const& ts, size_t axis, bool keepdims, Tsor& ans ) noexcept
     {
         typedef typename Tsor::value_type value_type;
+        mean( ts, axis, keepdims, ans );
+        if ( ts.empty() ) return;
         axis = ( axis == static_cast<size_t>( -1 ) ) ? ts.ndim()-1 : axis;
-        auto const& _shape = ts.shape();
-        return reduce( ts, axis, value_type{0}, []( auto const& a, auto const& b ){ return a+b; }, keepdims ) / static_cast<value_type>( _shape[axis] );
+        std::vector<size_t> const& shape = ts.shape();
+        size_t const pres = std::reduce( shape.begin(), shape.begin()+axis, 1UL, []( size_t x, size_t y ){ return x*y; } );
+        size_t const post = std::reduce( shape.begin()+axis+1, shape.end(), 1UL, []( size_t x, size_t y ){ return x*y; } );
+        size_t const n = shape[axis];
+        // the mean in ans is replaced by the mean of the squared deviations from it, without a tensor of the deviations
+        value_type const* x = ts.data();
+        value_type* v = ans.data();
+        for ( auto idx : range( pres ) )
+            for ( auto jdx : range( post ) )
+            {
+                value_type const mu = v[idx*post+jdx];
+                value_type const* row = x + idx * post * n + jdx;
+                compute_type_t<value_type> acc{0};
+                for ( auto kdx : range( n ) )
+                {
+                    value_type const d = row[kdx*post] - mu;
+                    acc += d * d;
+                }
+                v[idx*post+jdx] = static_cast<value_type>( acc / static_cast<compute_type_t<value_type>>( n ) );
+            }
     }
 
-    template <Tensor Tsor> requires std::floating_point<typename Tsor::value_type>
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
     Tsor variance( Tsor const& ts, size_t axis, bool keepdims=false ) noexcept
     {
-        Tsor x = mean( ts, axis, true );
-        x = x - ts;
-        for_each( x.begin(), x.end(), [](auto& v){ v *= v; } );
-        return mean( x, axis, keepdims );
+        Tsor ans;
+        variance( ts, axis, keepdims, ans );
+        return ans;
     }
 
-    template <Tensor Tsor> requires std::floating_point<typename Tsor::value_type>
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
+    void standard_deviation( Tsor const& ts, size_t axis, bool keepdims, Tsor& ans ) noexcept
+    {
+        variance( ts, axis, keepdims, ans );
+        for_each( ans.begin(), ans.end(), [](auto& v){ v = std::sqrt(v); } );
+    }
+
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
     Tsor standard_deviation( Tsor const& ts, size_t axis, bool keepdims=false ) noexcept
     {
-        Tsor x = variance( ts, axis, keepdims );
-        for_each( x.begin(), x.end(), [](auto& v){ v = std::sqrt(v); } );
-        return x;
+        Tsor ans;
+        standard_deviation( ts, axis, keepdims, ans );
+        return ans;
     }
 
-    template <Tensor Tsor> requires std::floating_point<typename Tsor::value_type>
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
     typename Tsor::value_type var( Tsor const& ts ) noexcept
     {
         auto x = ts - mean(ts);
         return std::inner_product( x.begin(), x.end(), x.begin(), typename Tsor::value_type{0} );
     }
 
-    template <Tensor Tsor> requires std::floating_point<typename Tsor::value_type>
+    template <Tensor Tsor> requires Floating_Point<typename Tsor::value_type>
     typename Tsor::value_type std( Tsor const& ts ) noexcept
     {
         return std::sqrt( var(ts) );
     }
 
+    template <Tensor Tsor>
+    void max( Tsor const& ts, size_t axis, bool keepdims, Tsor& ans ) noexcept
+    {
+        reduce( ts, axis, std::numeric_limits<typename Tsor::value_type>::min(), []( auto const& a, auto const& b ){ return a > b ? a : b; }, keepdims, ans );
+    }
+
     template <Tensor Tsor>
     Tsor max( Tsor const& ts, size_t axis, bool keepdims=false ) noexcept
     {
         return reduce( ts, axis, std::numeric_limits<typename Tsor::value_type>::min(), []( auto const& a, auto const& b ){ return a > b ? a : b; }, keepdims );
     }
 
+    template <Tensor Tsor>
+    void min( Tsor const& ts, size_t axis, bool keepdims, Tsor& ans ) noexcept
+    {
+        reduce( ts, axis, std::numeric_limits<typename Tsor::value_type>::max(), []( auto const& a, auto const& b ){ return a < b ? a : b; }, keepdims, ans );
+    }
+
     template <Tensor Tsor>
     Tsor min( Tsor const& ts, size_t axis, bool keepdims=false ) noexcept
     {
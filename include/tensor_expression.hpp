@@ -0,0 +1,602 @@
+#ifndef SFHYVTYNWXHIHAZMJACWFNJPEKUKWBIPVWLFZBXKQZFYIHPKTZIJIONNSUELMXYESKHOSU
+#define SFHYVTYNWXHIHAZMJACWFNJPEKUKWBIPVWLFZBXKQZFYIHPKTZIJIONNSUELMXYESKHOSU
+
+#include "./tensor.hpp"
+
+//
+// Lazy element-wise arithmetic of tensors.
+//
+// `a + b * 2.0f - c` builds a small tree of `tensor_expression` nodes, holding the tensors (sharing their buffers) and the scalars,
+// and computes nothing. The tree is evaluated element by element, in a single pass and without temporaries, when it is assigned
+// to a tensor, used to construct one, or applied with `+=`, `-=`, `*=` or `/=`:
+//
+//      tensor<float> x = a + b * 2.0f - c;     // one loop, one buffer allocated
+//      x -= learning_rate * gradient;          // one loop, no buffer allocated
+//
+// The loop reads the raw view of the tree, see `tensor_expression::reader`: the functions, the scalars and the pointers of the tensor
+// leaves, copied to every chunk of the thread pool without allocating, the tree itself and its shapes never copied.
+//
+// Broadcasting follows `broadcast_shape` and is resolved when a node is built: a tensor leaf of a smaller shape is read in place
+// through its strides, 0 along the broadcasted dimensions, as in `broadcast_binary`, and never expanded to the shape of the node.
+//
+namespace ceras
+{
+
+    namespace ceras_private
+    {
+        // the raw pointers of a tensor leaf read by the evaluation loop, into the buffer and the broadcast layout of the leaf, see `tensor_operand`
+        template< typename T >
+        struct tensor_operand_reader
+        {
+            T const* data_;
+            size_t const* dims_ = nullptr;
+            std::ptrdiff_t const* strides_ = nullptr;
+            size_t ndims_ = 0; // 0 for a leaf of the shape of the node
+
+            T element( size_t idx ) const noexcept
+            {
+                if ( ndims_ == 0 ) [[likely]]
+                    return data_[idx];
+                std::ptrdiff_t offset = 0;
+                for ( size_t dim = ndims_; dim-- > 0; idx /= dims_[dim] )
+                    offset += static_cast<std::ptrdiff_t>( idx % dims_[dim] ) * strides_[dim];
+                return data_[offset];
+            }
+        };
+
+        // a tensor leaf, read through its raw pointer in the evaluation loop
+        //
+        // A broadcasted leaf keeps its elements and the broadcast layout of its shape over the shape of the node, the dimensions of
+        // size 1 dropped and the contiguous ones merged, see `make_broadcast_layout` in './backend/broadcast.hpp'. The element at
+        // the index `idx` of the node is then at the sum of `( idx / inner ) % dim * stride` over the dimensions, `inner` being the
+        // size of the dimensions after a dimension; the leading dimensions of stride 0, along which the leaf repeats, are dropped
+        // too, leaving a single modulo for a bias of shape [R, C, CH] added to activations of shape [BS, R, C, CH].
+        template< Tensor Tsor >
+        struct tensor_operand
+        {
+            typedef Tsor tensor_type;
+            typedef typename Tsor::value_type value_type;
+
+            Tsor tsor_;
+            value_type const* data_;
+            std::vector<size_t> shape_;
+            std::vector<size_t> dims_; // the broadcast layout, empty for a leaf of the shape of the node
+            std::vector<std::ptrdiff_t> strides_;
+
+            tensor_operand( Tsor const& tsor ) : tsor_{ tsor }, data_{ tsor_.data() }, shape_{ tsor_.shape() } {}
+
+            std::vector<size_t> shape() const noexcept { return shape_; }
+
+            bool is_broadcasted() const noexcept { return !dims_.empty(); }
+
+            tensor_operand_reader<value_type> reader() const noexcept
+            {
+                return tensor_operand_reader<value_type>{ data_, dims_.data(), strides_.data(), dims_.size() };
+            }
+
+            value_type element( size_t idx ) const noexcept
+            {
+                return reader().element( idx );
+            }
+
+            tensor_operand broadcast( std::vector<size_t> const& new_shape ) const
+            {
+                auto const& shape = tsor_.shape(); // also for a leaf broadcasted already
+                auto const& layout = broadcast_private::make_broadcast_layout( shape, shape, new_shape );
+                tensor_operand ans = *this;
+                ans.shape_ = new_shape;
+                size_t first = 0;
+                while ( ( first+1 < layout.shape_.size() ) && ( layout.lhs_strides_[first] == 0 ) )
+                    ++first;
+                if ( ( layout.shape_.size() == 1 ) && ( layout.lhs_strides_[0] == 1 ) ) // only dimensions of size 1 added
+                    return ans;
+                ans.dims_.assign( layout.shape_.begin()+first, layout.shape_.end() );
+                ans.strides_.assign( layout.lhs_strides_.begin()+first, layout.lhs_strides_.end() );
+                return ans;
+            }
+        };
+
+        // a scalar leaf, the same value at every index
+        template< typename T >
+        struct scalar_operand
+        {
+            typedef void tensor_type;
+            typedef T value_type;
+
+            T value_;
+
+            value_type element( size_t ) const noexcept { return value_; }
+
+            scalar_operand reader() const noexcept { return *this; }
+
+            scalar_operand broadcast( std::vector<size_t> const& ) const noexcept { return *this; }
+        };
+
+        template< typename T >
+        struct is_scalar_operand : std::false_type {};
+
+        template< typename T >
+        struct is_scalar_operand< scalar_operand<T> > : std::true_type {};
+
+        // the tensor type of the first tensor leaf
+        template< typename Operand, typename ... Operands >
+        struct first_tensor_type
+        {
+            typedef std::conditional_t< std::is_void_v<typename Operand::tensor_type>, typename first_tensor_type<Operands...>::type, typename Operand::tensor_type > type;
+        };
+
+        template< typename Operand >
+        struct first_tensor_type< Operand >
+        {
+            typedef typename Operand::tensor_type type;
+        };
+
+        // the shape of the non-scalar operands broadcasted together
+        template< typename ... Operands >
+        std::vector<size_t> broadcast_operand_shape( Operands const& ... operands )
+        {
+            std::optional<std::vector<size_t>> ans;
+            ( [&]( auto const& operand )
+              {
+                  if constexpr( !is_scalar_operand<std::remove_cvref_t<decltype(operand)>>::value )
+                      ans = ans ? broadcast_shape( *ans, operand.shape() ) : operand.shape();
+              }( operands ), ... );
+            return *ans;
+        }
+
+        // ranges shorter than this are evaluated on the calling thread, as in `for_each`
+        inline constexpr size_t expression_parallel_threshold = for_each_parallel_threshold;
+
+        // dst[idx] = func( dst[idx], reader.element( idx ) ) for idx in [0, n), in contiguous chunks over the thread pool
+        //
+        // `reader` is the raw view of an expression, see `tensor_expression::reader`, its pointers copied to every chunk without allocating.
+        template< typename T, typename Reader, typename Function >
+        void evaluate_elementwise( T* __restrict__ dst, size_t n, Reader const& reader, Function const& func )
+        {
+            auto const& chunk_job = [dst, &reader, &func]( size_t first, size_t last )
+            {
+                Reader const local = reader; // the leaf pointers in registers
+                for ( size_t idx = first; idx != last; ++idx )
+                    dst[idx] = func( dst[idx], local.element( idx ) );
+            };
+
+            if ( (parallel_mode == 0) || (n < expression_parallel_threshold) || (thread_pool::instance().size() <= 1) )
+            {
+                chunk_job( 0, n );
+                return;
+            }
+
+            size_t const chunks = std::min( 4 * thread_pool::instance().size(), n / (expression_parallel_threshold / 4) );
+            size_t const chunk_size = ( n + chunks - 1 ) / chunks;
+            parallel( [&]( size_t chunk ){ chunk_job( chunk * chunk_size, std::min( n, (chunk+1) * chunk_size ) ); }, size_t{0}, chunks, 1 );
+        }
+
+        struct assign_evaluated
+        {
+            template< typename T >
+            T operator()( T, T y ) const noexcept { return y; }
+        };
+
+    }//namespace ceras_private
+
+    ///
+    /// @brief A lazy element-wise expression of tensors and scalars, `func( operands[idx]... )` at every index.
+    ///
+    /// Built by the arithmetic operators, evaluated into a tensor in a single pass by the construction of or the assignment to a tensor,
+    /// and by the compound assignments of tensors.
+    ///
+    /// An expression keeps the buffers of its tensors alive, and reads them when it is evaluated, not when it is built.
+    /// Where a tensor is expected instead, as in `auto x = a + b; x -= amax( x );`, the expression is evaluated once by `eval`,
+    /// and stands for the resulting tensor from then on.
+    ///
+    template< typename Function, typename ... Operands >
+    struct tensor_expression
+    {
+        typedef typename ceras_private::first_tensor_type<Operands...>::type tensor_type;
+        typedef typename tensor_type::value_type value_type;
+
+        Function func_;
+        std::vector<size_t> shape_;
+        std::tuple<Operands...> operands_;
+        mutable std::optional<tensor_type> value_; // set by `eval`
+        mutable std::optional<ceras_private::tensor_operand<tensor_type>> broadcasted_value_; // `value_` broadcasted with the expression, read in place
+
+        tensor_expression( Function const& func, Operands const& ... operands ) :
+            func_{ func }, shape_{ ceras_private::broadcast_operand_shape( operands... ) }, operands_{ broadcast_operand( operands )... } {}
+
+        std::vector<size_t> shape() const noexcept
+        {
+            return shape_;
+        }
+
+        size_t ndim() const noexcept
+        {
+            return shape_.size();
+        }
+
+        size_t size() const noexcept
+        {
+            return std::accumulate( shape_.begin(), shape_.end(), 1UL, []( size_t x, size_t y ){ return x*y; } );
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        ///
+        /// @brief The element at `idx`, the inner loop of the evaluation.
+        ///
+        value_type element( size_t idx ) const noexcept
+        {
+            if ( broadcasted_value_ )
+                return (*broadcasted_value_).element( idx );
+            if ( value_ )
+                return (*value_)[idx];
+            return std::apply( [this, idx]( auto const& ... operands ){ return static_cast<value_type>( func_( operands.element( idx )... ) ); }, operands_ );
+        }
+
+        value_type operator[]( size_t idx ) const noexcept
+        {
+            return element( idx );
+        }
+
+        ///
+        /// @brief The raw view of the expression read by the evaluation loop, the function and the pointers of its leaves, owning nothing.
+        ///
+        struct reader_type
+        {
+            Function func_;
+            std::tuple<decltype( std::declval<Operands const&>().reader() )...> operands_;
+            ceras_private::tensor_operand_reader<value_type> value_; // the evaluated expression, if any
+            bool evaluated_;
+
+            value_type element( size_t idx ) const noexcept
+            {
+                if ( evaluated_ )
+                    return value_.element( idx );
+                return std::apply( [this, idx]( auto const& ... operands ){ return static_cast<value_type>( func_( operands.element( idx )... ) ); }, operands_ );
+            }
+        };
+
+        reader_type reader() const noexcept
+        {
+            auto const& leaves = std::apply( []( auto const& ... operands ){ return std::make_tuple( operands.reader()... ); }, operands_ );
+            if ( broadcasted_value_ )
+                return reader_type{ func_, leaves, (*broadcasted_value_).reader(), true };
+            if ( value_ )
+                return reader_type{ func_, leaves, ceras_private::tensor_operand_reader<value_type>{ (*value_).data() }, true };
+            return reader_type{ func_, leaves, ceras_private::tensor_operand_reader<value_type>{ nullptr }, false };
+        }
+
+        ///
+        /// @brief The expression with its tensor leaves broadcasted to a larger shape.
+        ///
+        tensor_expression broadcast( std::vector<size_t> const& new_shape ) const
+        {
+            if ( new_shape == shape_ )
+                return *this;
+            tensor_expression ans = *this;
+            if ( broadcasted_value_ )
+                ans.broadcasted_value_ = (*broadcasted_value_).broadcast( new_shape );
+            else if ( value_ )
+            {
+                ans.broadcasted_value_ = ceras_private::tensor_operand<tensor_type>{ *value_ }.broadcast( new_shape );
+                ans.value_.reset();
+            }
+            else
+                ans.operands_ = std::apply( [&new_shape]( auto const& ... operands ){ return std::make_tuple( operands.broadcast( new_shape )... ); }, operands_ );
+            ans.shape_ = new_shape;
+            return ans;
+        }
+
+        ///
+        /// @brief Writes the elements to `dst`, which holds at least `size()` elements, in a single pass.
+        ///
+        /// @param func Combines the element in `dst` with the evaluated one, `func( dst[idx], (*this)[idx] )`, the plain assignment by default.
+        ///
+        template< typename Function_ = ceras_private::assign_evaluated >
+        void evaluate_into( value_type* dst, Function_ const& func = Function_{} ) const
+        {
+            ceras_private::evaluate_elementwise( dst, size(), reader(), func );
+        }
+
+        ///
+        /// @brief Evaluates the expression into a tensor, once. Later calls, and the element access, return this tensor.
+        ///
+        /// An evaluated expression broadcasted by a larger expression is expanded to its shape only here, when a tensor is asked for.
+        ///
+        tensor_type& eval() const
+        {
+            if ( !value_ )
+            {
+                tensor_type ans{ shape_ };
+                evaluate_into( ans.data() );
+                value_ = ans;
+                broadcasted_value_.reset();
+            }
+            return *value_;
+        }
+
+        value_type as_scalar() const noexcept
+        {
+            better_assert( size() == 1, "Expecting expression has a single value, but got ", size() );
+            return (*this)[0];
+        }
+
+        // the tensor interface, on the evaluated tensor
+
+        value_type* data() const { return eval().data(); }
+        value_type* begin() const { return eval().begin(); }
+        value_type* end() const { return eval().end(); }
+        tensor_type deep_copy() const { return eval().deep_copy(); }
+        tensor_type copy() const { return eval().copy(); }
+        tensor_type reshape( std::vector<size_t> const& new_shape ) const { tensor_type ans = eval(); return ans.reshape( new_shape ); }
+
+        template< typename U >
+        auto as_type() const { return eval().template as_type<U>(); }
+
+        template< typename Function_ >
+        tensor_expression& map( Function_ const& func ) { eval().map( func ); return *this; }
+
+        template< typename Other >
+        tensor_expression& operator += ( Other const& other ) { eval() += other; return *this; }
+
+        template< typename Other >
+        tensor_expression& operator -= ( Other const& other ) { eval() -= other; return *this; }
+
+        template< typename Other >
+        tensor_expression& operator *= ( Other const& other ) { eval() *= other; return *this; }
+
+        template< typename Other >
+        tensor_expression& operator /= ( Other const& other ) { eval() /= other; return *this; }
+
+    private:
+        template< typename Operand >
+        Operand broadcast_operand( Operand const& operand ) const
+        {
+            if constexpr( ceras_private::is_scalar_operand<Operand>::value )
+                return operand;
+            else
+                return ( operand.shape() == shape_ ) ? operand : operand.broadcast( shape_ );
+        }
+    }; // struct tensor_expression
+
+    template< typename T >
+    struct is_tensor_expression : std::false_type {};
+
+    template< typename Function, typename ... Operands >
+    struct is_tensor_expression< tensor_expression<Function, Operands...> > : std::true_type {};
+
+    template< class T >
+    inline constexpr bool is_tensor_expression_v = is_tensor_expression<T>::value;
+
+    template< typename T >
+    concept Tensor_Expression = is_tensor_expression_v<T>;
+
+    ///
+    /// @brief Tensors and their lazy expressions, the operands of the element-wise operators.
+    ///
+    template< typename T >
+    concept Elementwise_Operand = Tensor<T> || Tensor_Expression<T>;
+
+    namespace ceras_private
+    {
+        template< Elementwise_Operand Operand >
+        auto as_expression_operand( Operand const& operand )
+        {
+            if constexpr( Tensor<Operand> )
+                return tensor_operand<Operand>{ operand };
+            else
+                return operand;
+        }
+
+        template< typename T >
+        scalar_operand<T> as_expression_operand( T const& value ) noexcept requires std::is_arithmetic_v<T>
+        {
+            return scalar_operand<T>{ value };
+        }
+
+        template< typename Function, typename ... Operands >
+        auto make_tensor_expression( Function const& func, Operands const& ... operands )
+        {
+            return tensor_expression<Function, decltype( as_expression_operand( operands ) )...>{ func, as_expression_operand( operands )... };
+        }
+
+        struct negate_element
+        {
+            template< typename T >
+            T operator()( T x ) const noexcept { return -x; }
+        };
+
+        struct plus_element
+        {
+            template< typename T >
+            T operator()( T x, T y ) const noexcept { return x + y; }
+        };
+
+        struct minus_element
+        {
+            template< typename T >
+            T operator()( T x, T y ) const noexcept { return x - y; }
+        };
+
+        struct multiplies_element
+        {
+            template< typename T >
+            T operator()( T x, T y ) const noexcept { return x * y; }
+        };
+
+        struct divides_element
+        {
+            template< typename T >
+            T operator()( T x, T y ) const noexcept { return x / y; }
+        };
+    }//namespace ceras_private
+
+    ///
+    /// @brief Evaluates an expression into a new tensor. A tensor is returned as it is.
+    ///
+    template< Tensor_Expression Expression >
+    auto eval( Expression const& expression )
+    {
+        return expression.eval();
+    }
+
+    template< Tensor Tsor >
+    Tsor eval( Tsor const& tsor ) noexcept
+    {
+        return tsor;
+    }
+
+    //
+    // The functions of tensors, on the evaluated expressions.
+    //
+    template< Tensor_Expression Expression > auto begin( Expression const& expression ) { return expression.begin(); }
+    template< Tensor_Expression Expression > auto end( Expression const& expression ) { return expression.end(); }
+    template< Tensor_Expression Expression > auto data( Expression const& expression ) { return expression.data(); }
+    template< Tensor_Expression Expression > auto size( Expression const& expression ) { return expression.size(); }
+    template< Tensor_Expression Expression > auto ndim( Expression const& expression ) { return expression.ndim(); }
+    template< Tensor_Expression Expression > auto shape( Expression const& expression ) { return expression.shape(); }
+
+    template< Tensor_Expression Expression, typename ... Args > auto deep_copy( Expression const& expression, Args&& ... args ) { return deep_copy( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto copy( Expression const& expression, Args&& ... args ) { return copy( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto reshape( Expression const& expression, Args&& ... args ) { return reshape( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto repeat( Expression const& expression, Args&& ... args ) { return repeat( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto repmat( Expression const& expression, Args&& ... args ) { return repmat( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto squeeze( Expression const& expression, Args&& ... args ) { return squeeze( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto flip( Expression const& expression, Args&& ... args ) { return flip( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto poisson( Expression const& expression, Args&& ... args ) { return poisson( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto reduce_sum( Expression const& expression, Args&& ... args ) { return reduce_sum( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto reduce_mean( Expression const& expression, Args&& ... args ) { return reduce_mean( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto max( Expression const& expression, Args&& ... args ) { return max( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto amax( Expression const& expression, Args&& ... args ) { return amax( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto min( Expression const& expression, Args&& ... args ) { return min( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto amin( Expression const& expression, Args&& ... args ) { return amin( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto sum( Expression const& expression, Args&& ... args ) { return sum( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto mean( Expression const& expression, Args&& ... args ) { return mean( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto norm( Expression const& expression, Args&& ... args ) { return norm( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto abs( Expression const& expression, Args&& ... args ) { return abs( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto softmax( Expression const& expression, Args&& ... args ) { return softmax( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto has_nan( Expression const& expression, Args&& ... args ) { return has_nan( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto has_inf( Expression const& expression, Args&& ... args ) { return has_inf( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto is_valid( Expression const& expression, Args&& ... args ) { return is_valid( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto variance( Expression const& expression, Args&& ... args ) { return variance( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto standard_deviation( Expression const& expression, Args&& ... args ) { return standard_deviation( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto var( Expression const& expression, Args&& ... args ) { return var( eval( expression ), std::forward<Args>(args)... ); }
+    template< Tensor_Expression Expression, typename ... Args > auto std( Expression const& expression, Args&& ... args ) { return std( eval( expression ), std::forward<Args>(args)... ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs, typename ... Args > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto concatenate( Lhs const& lhs, Rhs const& rhs, Args&& ... args ) { return concatenate( eval( lhs ), eval( rhs ), std::forward<Args>(args)... ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto multiply( Lhs const& lhs, Rhs const& rhs ) { return multiply( eval( lhs ), eval( rhs ) ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto elementwise_product( Lhs const& lhs, Rhs const& rhs ) { return elementwise_product( eval( lhs ), eval( rhs ) ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto hadamard_product( Lhs const& lhs, Rhs const& rhs ) { return hadamard_product( eval( lhs ), eval( rhs ) ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto elementwise_divide( Lhs const& lhs, Rhs const& rhs ) { return elementwise_divide( eval( lhs ), eval( rhs ) ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto maximum( Lhs const& lhs, Rhs const& rhs ) { return maximum( eval( lhs ), eval( rhs ) ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto minimum( Lhs const& lhs, Rhs const& rhs ) { return minimum( eval( lhs ), eval( rhs ) ); }
+
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto atan2( Lhs const& lhs, Rhs const& rhs ) { return atan2( eval( lhs ), eval( rhs ) ); }
+
+    ///
+    /// @brief Lazy element-wise sum, with broadcasting.
+    ///
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs >
+    auto operator + ( Lhs const& lhs, Rhs const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::plus_element{}, lhs, rhs );
+    }
+
+    template< Elementwise_Operand Operand >
+    auto operator + ( Operand const& lhs, typename Operand::value_type const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::plus_element{}, lhs, rhs );
+    }
+
+    template< Elementwise_Operand Operand >
+    auto operator + ( typename Operand::value_type const& lhs, Operand const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::plus_element{}, lhs, rhs );
+    }
+
+    ///
+    /// @brief Lazy element-wise difference, with broadcasting.
+    ///
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs >
+    auto operator - ( Lhs const& lhs, Rhs const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::minus_element{}, lhs, rhs );
+    }
+
+    template< Elementwise_Operand Operand >
+    auto operator - ( Operand const& lhs, typename Operand::value_type const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::minus_element{}, lhs, rhs );
+    }
+
+    template< Elementwise_Operand Operand >
+    auto operator - ( typename Operand::value_type const& lhs, Operand const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::minus_element{}, lhs, rhs );
+    }
+
+    template< Tensor_Expression Expression >
+    auto operator - ( Expression const& expression )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::negate_element{}, expression );
+    }
+
+    ///
+    /// @brief Lazy scaling. The product of two tensors is the matrix product, see `multiply`.
+    ///
+    template< Elementwise_Operand Operand >
+    auto operator * ( Operand const& lhs, typename Operand::value_type const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::multiplies_element{}, lhs, rhs );
+    }
+
+    template< Elementwise_Operand Operand >
+    auto operator * ( typename Operand::value_type const& lhs, Operand const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::multiplies_element{}, lhs, rhs );
+    }
+
+    ///
+    /// @brief Matrix product with an expression operand, evaluated first.
+    ///
+    template< Elementwise_Operand Lhs, Elementwise_Operand Rhs > requires ( Tensor_Expression<Lhs> || Tensor_Expression<Rhs> )
+    auto operator * ( Lhs const& lhs, Rhs const& rhs )
+    {
+        return multiply( lhs, rhs );
+    }
+
+    ///
+    /// @brief Lazy division by a scalar.
+    ///
+    template< Elementwise_Operand Operand >
+    auto operator / ( Operand const& lhs, typename Operand::value_type const& rhs )
+    {
+        return ceras_private::make_tensor_expression( ceras_private::divides_element{}, lhs, rhs );
+    }
+
+    template< typename CharT, typename Traits, Tensor_Expression Expression >
+    std::basic_ostream<CharT, Traits>& operator << ( std::basic_ostream<CharT, Traits>& os_, Expression const& expression )
+    {
+        return os_ << expression.eval();
+    }
+
+}//namespace ceras
+
+#endif//SFHYVTYNWXHIHAZMJACWFNJPEKUKWBIPVWLFZBXKQZFYIHPKTZIJIONNSUELMXYESKHOSU
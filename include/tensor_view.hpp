@@ -0,0 +1,597 @@
+#ifndef BYNBSQSIERPTHXMKEWWXSEJQRNDOGTIOXNRVCZPEJOCGUZGENCNZTDAFACATOKYVHTWEYK
+#define BYNBSQSIERPTHXMKEWWXSEJQRNDOGTIOXNRVCZPEJOCGUZGENCNZTDAFACATOKYVHTWEYK
+
+#include "./tensor.hpp"
+
+namespace ceras
+{
+
+    ///
+    /// @brief A strided view of a tensor: an offset, a shape and a stride per dimension over the buffer of the tensor, which is shared and never copied.
+    ///
+    /// Slicing, permuting, transposing and flipping a view are O(1), and so is turning a contiguous view back into a tensor with `materialize`.
+    /// A view is read-only: its elements are `value_type const`, as the buffer it reads may be shared by copies of the tensor, see `tensor::is_shared`.
+    /// To write the elements, write the tensor, or a slice of its first axis, see `slice`.
+    ///
+    /// The free functions of tensors -- `sum`, `mean`, `softmax`, `concatenate` and the others -- take views too, through `materialize`, as do
+    /// `variable` and `constant`; `transpose` and `flip` of a view are views themselves.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// tensor<float> images = random<float>( {60000, 28, 28, 3} );
+    /// tensor<float> batch = slice( images, 128, 256 );              // a tensor of [128, 28, 28, 3] sharing the buffer of images, O(1)
+    /// auto red = slice( images, 3, 0, 1 );                          // the first channel, a strided view of [60000, 28, 28, 1], O(1)
+    /// auto mirrored = as_view( images ).flip( 2 );                  // O(1)
+    /// tensor<float> x = random<float>( {128, 784} );
+    /// tensor<float> w = random<float>( {256, 784} );
+    /// tensor<float> y = x * as_view( w ).transpose();               // a gemm reading w transposed, without copying it
+    /// @endcode
+    ///
+    template< typename T, typename Allocator = default_allocator<T> >
+    struct tensor_view
+    {
+        typedef T value_type;
+        typedef tensor<T, Allocator> tensor_type;
+        typedef typename tensor_type::shared_vector shared_vector;
+        typedef tensor_view self_type;
+
+        shared_vector vector_;
+        size_t offset_; ///< the position of the element (0, 0, ..., 0) in `vector_`
+        std::vector<size_t> shape_;
+        std::vector<std::ptrdiff_t> strides_; ///< in elements, negative for a flipped dimension
+
+        ///
+        /// @brief A view of the whole of a tensor.
+        ///
+        tensor_view( tensor_type const& tsor ) : vector_{ tsor.vector_ }, offset_{ tsor.offset_ }, shape_{ tsor.shape() }, strides_( shape_.size() )
+        {
+            std::ptrdiff_t stride = 1;
+            for ( size_t axis = shape_.size(); axis-- > 0; )
+            {
+                strides_[axis] = stride;
+                stride *= static_cast<std::ptrdiff_t>( shape_[axis] );
+            }
+        }
+
+        tensor_view( shared_vector vector, size_t offset, std::vector<size_t> shape, std::vector<std::ptrdiff_t> strides ) noexcept :
+            vector_{ vector }, offset_{ offset }, shape_{ std::move( shape ) }, strides_{ std::move( strides ) } {}
+
+        std::vector<size_t> const& shape() const noexcept
+        {
+            return shape_;
+        }
+
+        std::vector<std::ptrdiff_t> const& strides() const noexcept
+        {
+            return strides_;
+        }
+
+        size_t ndim() const noexcept
+        {
+            return shape_.size();
+        }
+
+        size_t size() const noexcept
+        {
+            return std::accumulate( shape_.begin(), shape_.end(), 1UL, []( size_t x, size_t y ){ return x*y; } );
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        ///
+        /// @brief Pointer to the element (0, 0, ..., 0), the element (i, j, ...) is at `data()[i*strides()[0] + j*strides()[1] + ...]`.
+        ///
+        value_type const* data() const noexcept
+        {
+            return (*vector_).data() + offset_;
+        }
+
+        value_type const& at( std::vector<size_t> const& indices ) const noexcept
+        {
+            better_assert( indices.size() == ndim(), "tensor_view::at: expecting ", ndim(), " indices, but got ", indices.size() );
+            std::ptrdiff_t position = 0;
+            for ( auto axis : range( ndim() ) )
+                position += static_cast<std::ptrdiff_t>( indices[axis] ) * strides_[axis];
+            return data()[position];
+        }
+
+        template< typename ... Indices > requires ( std::convertible_to<Indices, size_t> && ... )
+        value_type const& operator()( Indices ... indices ) const noexcept
+        {
+            return at( std::vector<size_t>{ static_cast<size_t>( indices )... } );
+        }
+
+        ///
+        /// @brief Check if the elements are laid out in the row-major order without gaps, as in a tensor.
+        ///
+        bool is_contiguous() const noexcept
+        {
+            std::ptrdiff_t stride = 1;
+            for ( size_t axis = ndim(); axis-- > 0; )
+            {
+                if ( shape_[axis] != 1 && strides_[axis] != stride )
+                    return false;
+                stride *= static_cast<std::ptrdiff_t>( shape_[axis] );
+            }
+            return true;
+        }
+
+        ///
+        /// @brief The elements [first, last) of an axis, every `step`-th of them.
+        ///
+        self_type slice( size_t axis, size_t first, size_t last, size_t step = 1 ) const noexcept
+        {
+            better_assert( axis < ndim(), "tensor_view::slice: axis ", axis, " out of ", ndim(), " dimensions" );
+            better_assert( first <= last && last <= shape_[axis], "tensor_view::slice: range [", first, ", ", last, ") out of the dimension ", shape_[axis] );
+            better_assert( step > 0, "tensor_view::slice: expecting a positive step" );
+            self_type ans = *this;
+            ans.offset_ = static_cast<size_t>( static_cast<std::ptrdiff_t>( offset_ ) + static_cast<std::ptrdiff_t>( first ) * strides_[axis] );
+            ans.shape_[axis] = ( last - first + step - 1 ) / step;
+            ans.strides_[axis] *= static_cast<std::ptrdiff_t>( step );
+            return ans;
+        }
+
+        ///
+        /// @brief The sub-view at `index` of the first axis, with one dimension less.
+        ///
+        self_type operator[]( size_t index ) const noexcept
+        {
+            better_assert( ndim() > 0 && index < shape_[0], "tensor_view::operator[]: index ", index, " out of range" );
+            self_type ans = slice( 0, index, index+1 );
+            ans.shape_.erase( ans.shape_.begin() );
+            ans.strides_.erase( ans.strides_.begin() );
+            return ans;
+        }
+
+        ///
+        /// @brief The view with its axes reordered, the new axis `i` is the old axis `axes[i]`.
+        ///
+        self_type permute( std::vector<size_t> const& axes ) const noexcept
+        {
+            better_assert( axes.size() == ndim(), "tensor_view::permute: expecting ", ndim(), " axes, but got ", axes.size() );
+            self_type ans = *this;
+            for ( auto [idx, axis] : enumerate( axes ) )
+            {
+                better_assert( axis < ndim(), "tensor_view::permute: axis ", axis, " out of ", ndim(), " dimensions" );
+                ans.shape_[idx] = shape_[axis];
+                ans.strides_[idx] = strides_[axis];
+            }
+            return ans;
+        }
+
+        ///
+        /// @brief The view with its axes in the reverse order, the matrix transpose for a 2D view.
+        ///
+        self_type transpose() const noexcept
+        {
+            self_type ans = *this;
+            std::reverse( ans.shape_.begin(), ans.shape_.end() );
+            std::reverse( ans.strides_.begin(), ans.strides_.end() );
+            return ans;
+        }
+
+        ///
+        /// @brief The view with the elements of an axis in the reverse order.
+        ///
+        self_type flip( size_t axis ) const noexcept
+        {
+            better_assert( axis < ndim(), "tensor_view::flip: axis ", axis, " out of ", ndim(), " dimensions" );
+            self_type ans = *this;
+            if ( shape_[axis] > 0 )
+                ans.offset_ = static_cast<size_t>( static_cast<std::ptrdiff_t>( offset_ ) + static_cast<std::ptrdiff_t>( shape_[axis] - 1 ) * strides_[axis] );
+            ans.strides_[axis] = -strides_[axis];
+            return ans;
+        }
+
+        ///
+        /// @brief Calls `func( value_type const& )` on every element in the row-major order of the view.
+        ///
+        template< typename Function >
+        void for_each( Function const& func ) const
+        {
+            if ( empty() ) return;
+            if ( ndim() == 0 )
+            {
+                func( *data() );
+                return;
+            }
+            size_t const inner = shape_.back();
+            std::ptrdiff_t const inner_stride = strides_.back();
+            size_t const outer = size() / inner;
+            std::vector<size_t> indices( ndim(), 0 ); // of the outer dimensions
+            value_type const* row = data();
+            for ( size_t idx = 0; idx != outer; ++idx )
+            {
+                for ( size_t col = 0; col != inner; ++col )
+                    func( row[static_cast<std::ptrdiff_t>( col ) * inner_stride] );
+                // next row, carrying over the outer indices
+                for ( size_t axis = ndim()-1; axis-- > 0; )
+                {
+                    row += strides_[axis];
+                    if ( ++indices[axis] != shape_[axis] )
+                        break;
+                    row -= static_cast<std::ptrdiff_t>( shape_[axis] ) * strides_[axis];
+                    indices[axis] = 0;
+                }
+            }
+        }
+
+        ///
+        /// @brief A new tensor holding a copy of the elements.
+        ///
+        tensor_type copy() const
+        {
+            tensor_type ans{ shape_ };
+            value_type* dst = ans.data();
+            for_each( [&dst]( value_type const& v ){ *dst++ = v; } );
+            return ans;
+        }
+
+        ///
+        /// @brief A tensor of the elements: sharing the buffer in O(1) for a contiguous view, a copy otherwise.
+        ///
+        tensor_type materialize() const
+        {
+            if ( !is_contiguous() || empty() )
+                return copy();
+            tensor_type ans;
+            ans.vector_ = vector_;
+            ans.shape_.assign( shape_.begin(), shape_.end() );
+            ans.offset_ = offset_;
+            ans.window_ = ( offset_ == 0 && size() == (*vector_).size() ) ? 0 : size();
+            return ans;
+        }
+    }; // struct tensor_view
+
+    template< typename T >
+    struct is_tensor_view : std::false_type {};
+
+    template< typename T, typename A >
+    struct is_tensor_view< tensor_view<T, A> > : std::true_type {};
+
+    template< class T >
+    inline constexpr bool is_tensor_view_v = is_tensor_view<T>::value;
+
+    template< typename T >
+    concept Tensor_View = is_tensor_view_v<T>;
+
+    ///
+    /// @brief A strided view of the whole of a tensor, sharing its buffer.
+    ///
+    template< typename T, typename A >
+    tensor_view<T, A> as_view( tensor<T, A> const& tsor )
+    {
+        return tensor_view<T, A>{ tsor };
+    }
+
+    template< Tensor_View View >
+    View as_view( View const& view )
+    {
+        return view;
+    }
+
+    ///
+    /// @brief The tensor of a view, in O(1) if the view is contiguous, see `tensor_view::materialize`. A tensor is returned as it is.
+    ///
+    template< Tensor_View View >
+    auto materialize( View const& view )
+    {
+        return view.materialize();
+    }
+
+    template< Tensor Tsor >
+    Tsor materialize( Tsor const& tsor )
+    {
+        return tsor;
+    }
+
+    ///
+    /// @brief The samples [first, last) of the first axis, a tensor sharing the buffer of `tsor`, in O(1).
+    ///
+    /// The slice is a tensor sharing the buffer of `tsor`, and follows the copy-on-write rule of every such tensor, see `tensor::is_shared`:
+    /// its mutating members -- the compound assignments, `reset`, `map`, `deep_copy( other )` and `resize` to a different size -- give
+    /// it a buffer of its own first, leaving `tsor` untouched, while writing its elements through `data()`, `begin()` or `operator[]`
+    /// writes the elements of `tsor`.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// tensor<float> inputs{ {60000, 28, 28} };
+    /// tensor<float> batch = slice( inputs, 1024, 1024+128 ); // [128, 28, 28], no copy
+    /// @endcode
+    ///
+    template< Tensor Tsor >
+    Tsor slice( Tsor const& tsor, size_t first, size_t last )
+    {
+        better_assert( tsor.ndim() > 0, "slice: expecting a tensor of at least one dimension" );
+        auto shape = tsor.shape();
+        better_assert( first <= last && last <= shape[0], "slice: range [", first, ", ", last, ") out of the first dimension ", shape[0] );
+        if ( first == last )
+        {
+            shape[0] = 0;
+            return Tsor{ shape };
+        }
+        size_t const stride = tsor.size() / shape[0];
+        Tsor ans = tsor;
+        shape[0] = last - first;
+        ans.shape_.assign( shape.begin(), shape.end() );
+        ans.offset_ = tsor.offset_ + first * stride;
+        ans.window_ = ( last - first ) * stride;
+        if ( ans.offset_ == 0 && ans.window_ == (*(ans.vector_)).size() )
+            ans.window_ = 0;
+        return ans;
+    }
+
+    ///
+    /// @brief The elements [first, last) of an axis, every `step`-th of them, a strided view sharing the buffer of `tsor`, in O(1).
+    ///
+    template< Tensor Tsor >
+    auto slice( Tsor const& tsor, size_t axis, size_t first, size_t last, size_t step = 1 )
+    {
+        return as_view( tsor ).slice( axis, first, last, step );
+    }
+
+    ///
+    /// @brief Matrix product of two 2D views, or of a view and a tensor.
+    ///
+    /// A view with unit stride along one of its axes -- a slice of rows or of columns, or a transposed tensor -- goes to the gemm as it is,
+    /// using the transpose flag and the leading dimension of its layout; any other view is copied first.
+    ///
+    template< typename T, typename A >
+    tensor<T, A> multiply( tensor_view<T, A> const& lhs, tensor_view<T, A> const& rhs )
+    {
+        better_assert( lhs.ndim() == 2 && rhs.ndim() == 2, "multiply: expecting 2D views, but got ", lhs.ndim(), " and ", rhs.ndim(), " dimensions" );
+        better_assert( lhs.shape()[1] == rhs.shape()[0], "multiply: expecting lhs columns equal to rhs rows, but got ", lhs.shape()[1], " and ", rhs.shape()[0] );
+
+        // (pointer, transposed, leading dimension) of a gemm operand
+        auto const& layout_of = []( tensor_view<T, A> const& view ) -> std::tuple<T const*, bool, size_t, tensor<T, A>>
+        {
+            auto const [rows, cols] = std::make_pair( view.shape()[0], view.shape()[1] );
+            auto const [row_stride, col_stride] = std::make_pair( view.strides()[0], view.strides()[1] );
+            if ( ( col_stride == 1 || cols == 1 ) && row_stride >= static_cast<std::ptrdiff_t>( cols ) )
+                return { view.data(), false, std::max( static_cast<size_t>( row_stride ), cols ), tensor<T, A>{} };
+            if ( ( row_stride == 1 || rows == 1 ) && col_stride >= static_cast<std::ptrdiff_t>( rows ) )
+                return { view.data(), true, std::max( static_cast<size_t>( col_stride ), rows ), tensor<T, A>{} };
+            tensor<T, A> copied = view.copy();
+            return { copied.data(), false, cols, copied };
+        };
+        auto const [a, a_transposed, lda, a_copy] = layout_of( lhs );
+        auto const [b, b_transposed, ldb, b_copy] = layout_of( rhs );
+
+        size_t const m = lhs.shape()[0];
+        size_t const n = lhs.shape()[1];
+        size_t const k = rhs.shape()[1];
+        tensor<T, A> ans{ {m, k} };
+        if ( lda == ( a_transposed ? m : n ) && ldb == ( b_transposed ? n : k ) ) // dense operands, through the tuned dispatch
+            gemm( a, a_transposed, b, b_transposed, m, n, k, ans.data() );
+        else
+            parallel_gemm( a, lda, a_transposed, b, ldb, b_transposed, m, n, k, ans.data(), k );
+        return ans;
+    }
+
+    template< typename T, typename A >
+    tensor<T, A> multiply( tensor_view<T, A> const& lhs, tensor<T, A> const& rhs )
+    {
+        return multiply( lhs, as_view( rhs ) );
+    }
+
+    template< typename T, typename A >
+    tensor<T, A> multiply( tensor<T, A> const& lhs, tensor_view<T, A> const& rhs )
+    {
+        return multiply( as_view( lhs ), rhs );
+    }
+
+    // the operators of tensors, for views mixed with views or tensors, through `materialize`
+    template< typename Lhs, typename Rhs >
+    concept View_Operands = ( Tensor_View<Lhs> || Tensor_View<Rhs> ) && ( Tensor_View<Lhs> || Tensor<Lhs> ) && ( Tensor_View<Rhs> || Tensor<Rhs> );
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto operator + ( Lhs const& lhs, Rhs const& rhs )
+    {
+        return materialize( lhs ) + materialize( rhs );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto operator - ( Lhs const& lhs, Rhs const& rhs )
+    {
+        return materialize( lhs ) - materialize( rhs );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto operator * ( Lhs const& lhs, Rhs const& rhs )
+    {
+        return multiply( lhs, rhs );
+    }
+
+    template< Tensor_View View >
+    auto operator + ( View const& view, typename View::value_type x )
+    {
+        return materialize( view ) + x;
+    }
+
+    template< Tensor_View View >
+    auto operator - ( View const& view, typename View::value_type x )
+    {
+        return materialize( view ) - x;
+    }
+
+    template< Tensor_View View >
+    auto operator * ( View const& view, typename View::value_type x )
+    {
+        return materialize( view ) * x;
+    }
+
+    template< Tensor_View View >
+    auto operator / ( View const& view, typename View::value_type x )
+    {
+        return materialize( view ) / x;
+    }
+
+    template< Tensor_View View >
+    auto operator * ( typename View::value_type x, View const& view )
+    {
+        return x * materialize( view );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto elementwise_product( Lhs const& lhs, Rhs const& rhs )
+    {
+        return elementwise_product( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto hadamard_product( Lhs const& lhs, Rhs const& rhs )
+    {
+        return elementwise_product( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto elementwise_divide( Lhs const& lhs, Rhs const& rhs )
+    {
+        return elementwise_divide( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto add( Lhs const& lhs, Rhs const& rhs )
+    {
+        return add( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto minus( Lhs const& lhs, Rhs const& rhs )
+    {
+        return minus( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto maximum( Lhs const& lhs, Rhs const& rhs )
+    {
+        return maximum( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto minimum( Lhs const& lhs, Rhs const& rhs )
+    {
+        return minimum( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto atan2( Lhs const& lhs, Rhs const& rhs )
+    {
+        return atan2( materialize( lhs ), materialize( rhs ) );
+    }
+
+    template< typename Lhs, typename Rhs > requires View_Operands<Lhs, Rhs>
+    auto concatenate( Lhs const& lhs, Rhs const& rhs, size_t axis=0 )
+    {
+        return concatenate( materialize( lhs ), materialize( rhs ), axis );
+    }
+
+    ///
+    /// @brief The transpose of a view, a view sharing its buffer, in O(1), see `tensor_view::transpose`.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// tensor<float> w = random<float>( {256, 784} );
+    /// auto wt = transpose( as_view( w ) ); // no copy, unlike `transpose( w )`
+    /// @endcode
+    ///
+    template< Tensor_View View >
+    View transpose( View const& view ) noexcept
+    {
+        return view.transpose();
+    }
+
+    ///
+    /// @brief A view with the elements of an axis in the reverse order, sharing the buffer, in O(1), see `tensor_view::flip`.
+    ///
+    template< Tensor_View View >
+    View flip( View const& view, int axis = -1 ) noexcept
+    {
+        return view.flip( axis < 0 ? static_cast<size_t>( static_cast<int>( view.ndim() ) + axis ) : static_cast<size_t>( axis ) );
+    }
+
+    // the other free functions of tensors, for views, through `materialize`: a contiguous view is read in place, a strided one copied once
+    template< Tensor_View View, typename ... Args >
+    auto sum( View const& view, Args&& ... args ) { return sum( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View, typename ... Args >
+    auto mean( View const& view, Args&& ... args ) { return mean( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View, typename ... Args >
+    auto max( View const& view, Args&& ... args ) { return max( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View, typename ... Args >
+    auto min( View const& view, Args&& ... args ) { return min( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View >
+    auto amax( View const& view ) { return amax( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto amin( View const& view ) { return amin( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto norm( View const& view ) { return norm( materialize( view ) ); }
+
+    template< Tensor_View View, typename ... Args >
+    auto variance( View const& view, Args&& ... args ) { return variance( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View, typename ... Args >
+    auto standard_deviation( View const& view, Args&& ... args ) { return standard_deviation( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View >
+    auto var( View const& view ) { return var( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto std( View const& view ) { return std( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto reduce_sum( View const& view ) { return reduce_sum( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto reduce_mean( View const& view ) { return reduce_mean( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto abs( View const& view ) { return abs( materialize( view ) ); }
+
+    template< Tensor_View View >
+    auto softmax( View const& view ) { return softmax( materialize( view ) ); }
+
+    template< Tensor_View View >
+    bool has_nan( View const& view ) { return has_nan( materialize( view ) ); }
+
+    template< Tensor_View View >
+    bool has_inf( View const& view ) { return has_inf( materialize( view ) ); }
+
+    template< Tensor_View View >
+    bool is_valid( View const& view ) { return is_valid( materialize( view ) ); }
+
+    template< Tensor_View View, typename ... Args >
+    auto squeeze( View const& view, Args&& ... args ) { return squeeze( materialize( view ), std::forward<Args>( args )... ); }
+
+    template< Tensor_View View >
+    auto reshape( View const& view, std::vector<size_t> const& new_shape ) { return reshape( view.materialize(), new_shape ); }
+
+    template< Tensor_View View >
+    auto repeat( View const& view, size_t n ) { return repeat( materialize( view ), n ); }
+
+    template< Tensor_View View >
+    auto repmat( View const& view, size_t row_rep, size_t col_rep ) { return repmat( materialize( view ), row_rep, col_rep ); }
+
+    template< Tensor_View View >
+    auto deep_copy( View const& view ) { return view.copy(); }
+
+    template< typename CharT, typename Traits, Tensor_View View >
+    std::basic_ostream<CharT, Traits>& operator << ( std::basic_ostream<CharT, Traits>& os_, View const& view )
+    {
+        return os_ << view.copy();
+    }
+
+}//namespace ceras
+
+#endif//BYNBSQSIERPTHXMKEWWXSEJQRNDOGTIOXNRVCZPEJOCGUZGENCNZTDAFACATOKYVHTWEYK
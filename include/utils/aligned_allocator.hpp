@@ -0,0 +1,129 @@
+#ifndef ALIGNED_ALLOCATOR_HPP_INCLUDED_KQWMZTRXVNPLSADHGYEBUCIFOJKWQMZTRXVNPLSADHGYEBUCIF
+#define ALIGNED_ALLOCATOR_HPP_INCLUDED_KQWMZTRXVNPLSADHGYEBUCIFOJKWQMZTRXVNPLSADHGYEBUCIF
+
+#include "../includes.hpp"
+#include "../config.hpp"
+
+namespace ceras
+{
+
+    ///
+    /// @brief Test if `ptr` is a multiple of `Alignment` bytes, `memory_alignment` by default.
+    ///
+    template< unsigned long Alignment = memory_alignment, typename T >
+    constexpr bool is_aligned( T const* ptr ) noexcept
+    {
+        static_assert( std::has_single_bit( Alignment ), "Alignment must be a power of 2." );
+        return ( reinterpret_cast<std::uintptr_t>( ptr ) & ( Alignment - 1 ) ) == 0;
+    }
+
+    ///
+    /// @brief The number of elements of type T, no less than `n`, that fills up a whole number of `Alignment` bytes.
+    ///
+    /// A row of `aligned_leading_dimension<T>(n)` elements keeps every row of a row-major matrix starting on an aligned address.
+    ///
+    template< typename T, unsigned long Alignment = memory_alignment >
+    constexpr std::size_t aligned_leading_dimension( std::size_t n ) noexcept
+    {
+        if constexpr( Alignment % sizeof(T) != 0 )
+            return n;
+        else
+        {
+            constexpr std::size_t elements = Alignment / sizeof(T);
+            return ( ( n + elements - 1 ) / elements ) * elements;
+        }
+    }
+
+    ///
+    /// @brief A block of an arena, handed out by the `aligned_allocator` holding it, see `allocate_memory` in '../memory_plan.hpp'.
+    ///
+    struct arena_slot
+    {
+        std::shared_ptr<std::byte[]> arena_;    ///< the arena, kept alive as long as an allocator holds one of its slots
+        std::byte* data_ = nullptr;             ///< the first byte of the slot
+        std::size_t size_ = 0;                  ///< the bytes of the slot
+        bool taken_ = false;                    ///< if an allocation holds the slot
+    }; // struct arena_slot
+
+    ///
+    /// @brief An allocator returning `Alignment` aligned memory, `memory_alignment` (a cache line) by default.
+    ///
+    /// The size of an allocation is rounded up to a whole number of `Alignment` bytes, so that no allocation shares a cache line with another one.
+    /// This is the default allocator of the tensors, see `default_allocator` in './tensor.hpp', and the vectorized kernels may test their buffers with `is_aligned`.
+    ///
+    /// An allocator made from an `arena_slot` returns the slot to the first allocation fitting in it while no other allocation holds it, and
+    /// the heap otherwise; it moves with the vector it allocates for, a copy of the vector allocating from the heap.
+    ///
+    template< typename T, unsigned long Alignment = memory_alignment > requires (not std::same_as<T, void>)
+    struct aligned_allocator
+    {
+        static_assert( std::has_single_bit( Alignment ), "Alignment must be a power of 2." );
+        static_assert( Alignment >= alignof(T), "Alignment must be no less than the alignment of T." );
+
+        typedef T value_type;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template< typename U >
+        struct rebind
+        {
+            typedef aligned_allocator<U, Alignment> other;
+        };
+
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+        typedef std::false_type is_always_equal;
+
+        std::shared_ptr<arena_slot> slot_; ///< the slot of an arena to allocate from, the heap only if null
+
+        constexpr aligned_allocator() noexcept = default;
+        aligned_allocator( aligned_allocator const& ) noexcept = default;
+
+        explicit aligned_allocator( std::shared_ptr<arena_slot> slot ) noexcept : slot_{ std::move( slot ) } {}
+
+        template< typename U >
+        constexpr aligned_allocator( aligned_allocator<U, Alignment> const& ) noexcept {} // a slot holds the buffer of a single type
+
+        aligned_allocator select_on_container_copy_construction() const noexcept
+        {
+            return aligned_allocator{};
+        }
+
+        [[nodiscard]] T* allocate( std::size_t const n )
+        {
+            if ( n > std::numeric_limits<std::size_t>::max() / sizeof(T) - Alignment )
+                throw std::bad_array_new_length{};
+            if ( slot_ && !(*slot_).taken_ && bytes( n ) <= (*slot_).size_ && is_aligned<Alignment>( (*slot_).data_ ) )
+            {
+                (*slot_).taken_ = true;
+                return reinterpret_cast<T*>( (*slot_).data_ );
+            }
+            return static_cast<T*>( ::operator new( bytes( n ), std::align_val_t{ Alignment } ) );
+        }
+
+        void deallocate( T* p, std::size_t const n ) noexcept
+        {
+            if ( slot_ && reinterpret_cast<std::byte*>( p ) == (*slot_).data_ )
+            {
+                (*slot_).taken_ = false;
+                return;
+            }
+            ::operator delete( p, bytes( n ), std::align_val_t{ Alignment } );
+        }
+
+        static constexpr std::size_t bytes( std::size_t const n ) noexcept
+        {
+            return ( ( n * sizeof(T) + Alignment - 1 ) / Alignment ) * Alignment;
+        }
+
+        template< typename U >
+        friend bool operator == ( aligned_allocator const& lhs, aligned_allocator<U, Alignment> const& rhs ) noexcept
+        {
+            return lhs.slot_ == rhs.slot_;
+        }
+    }; // struct aligned_allocator
+
+}//namespace ceras
+
+#endif//ALIGNED_ALLOCATOR_HPP_INCLUDED_KQWMZTRXVNPLSADHGYEBUCIFOJKWQMZTRXVNPLSADHGYEBUCIF
+
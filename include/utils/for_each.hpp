@@ -8,14 +8,23 @@
 namespace ceras
 {
 
+    ///
+    /// @brief Ranges shorter than this are processed by `for_each` on the calling thread.
+    ///
+    inline constexpr std::size_t for_each_parallel_threshold = 1UL << 15;
+
     namespace// anonymous namespace
     {
-		template <typename Range, typename Function>
-        void omp_for(const Range& vec, const Function& func){
-			#pragma omp parallel for
-			for(const auto& idx : vec) func(idx);
-		}
-		
+        template < typename Function >
+        void omp_for( std::int64_t n, Function const& func )
+        {
+            #ifdef _OPENMP
+            #pragma omp parallel for
+            #endif
+            for ( std::int64_t idx = 0; idx < n; ++idx )
+                func( idx );
+        }
+
         template < std::size_t Index, typename Type, typename... Types >
         struct extract_type_forward
         {
@@ -50,21 +59,31 @@ namespace ceras
         template < typename Function, typename InputIterator1, typename... InputIteratorn >
         constexpr Function _for_each_n( Function f, std::size_t n, InputIterator1 begin1, InputIteratorn... beginn )
         {
-            //for ( auto idx : range( n ) ) f( *(begin1+idx), *(beginn+idx)... );
-            auto const& func = [&]( std::uint_least64_t idx )
+            if ( std::is_constant_evaluated() || (parallel_mode == 0) || (n < for_each_parallel_threshold) )
             {
-                f( *(begin1+idx), *(beginn+idx)... );
+                for ( std::size_t idx = 0; idx != n; ++idx )
+                    f( *(begin1+idx), *(beginn+idx)... );
+                return f;
+            }
+
+            if constexpr( openmp_mode )
+            {
+                omp_for( static_cast<std::int64_t>(n), [&]( std::int64_t idx ){ f( *(begin1+idx), *(beginn+idx)... ); } );
+                return f;
+            }
+
+            // contiguous chunks of at least a quarter of the threshold, about four per thread
+            std::size_t const chunks = std::min( 4 * thread_pool::instance().size(), n / (for_each_parallel_threshold / 4) );
+            std::size_t const chunk_size = ( n + chunks - 1 ) / chunks;
+            auto const& chunk_job = [&]( std::size_t chunk )
+            {
+                std::size_t const first = chunk * chunk_size;
+                std::size_t const last = std::min( n, first + chunk_size );
+                for ( std::size_t idx = first; idx != last; ++idx )
+                    f( *(begin1+idx), *(beginn+idx)... );
             };
-            //parallel( func, 0UL, n );
-			
-			const auto& vec = range(n);
-			
-			if(std::is_constant_evaluated()){
-				for(const auto& idx : vec) func(idx);
-			}else{
-				omp_for(vec, func);
-			}
-			
+            parallel( chunk_job, std::size_t{0}, chunks, 1 );
+
             return f;
         }
 
@@ -0,0 +1,206 @@
+#ifndef HALF_FLOAT_HPP_INCLUDED_PWNQZLXKMVTRJASYGDEBHUCFOIPWNQZLXKMVTRJASYGDEBHUCFOI
+#define HALF_FLOAT_HPP_INCLUDED_PWNQZLXKMVTRJASYGDEBHUCFOIPWNQZLXKMVTRJASYGDEBHUCFOI
+
+#include "../includes.hpp"
+
+//
+// 16-bit floating point storage types, for the tensors whose values do not need the precision of a float.
+//
+// `bfloat16` keeps the 8 exponent bits of a float and 7 mantissa bits, it covers the range of a float with 2-3 significant
+// digits. `float16` is the IEEE 754 half precision, with 5 exponent bits and 10 mantissa bits, from 6.0e-8 to 65504.
+//
+// Both are storage types only: a value converts implicitly to a float, all the arithmetic is done in float, and the result
+// is rounded to the nearest 16-bit value, ties to even, when it is stored back. A `tensor<bfloat16>` thus takes half the
+// memory of a `tensor<float>` while every kernel still computes, and accumulates, in float.
+//
+
+namespace ceras
+{
+
+    namespace half_float_private
+    {
+        constexpr std::uint16_t float_to_bfloat16_bits( float x ) noexcept
+        {
+            std::uint32_t const u = std::bit_cast<std::uint32_t>( x );
+            if ( ( u & 0x7fffffffU ) > 0x7f800000U ) // NaN, kept quiet
+                return static_cast<std::uint16_t>( ( u >> 16 ) | 0x0040U );
+            return static_cast<std::uint16_t>( ( u + 0x7fffU + ( ( u >> 16 ) & 1U ) ) >> 16 );
+        }
+
+        constexpr float bfloat16_bits_to_float( std::uint16_t h ) noexcept
+        {
+            return std::bit_cast<float>( static_cast<std::uint32_t>( h ) << 16 );
+        }
+
+        constexpr std::uint16_t float_to_float16_bits( float x ) noexcept
+        {
+            std::uint32_t u = std::bit_cast<std::uint32_t>( x );
+            std::uint32_t const sign = ( u >> 16 ) & 0x8000U;
+            u &= 0x7fffffffU;
+            if ( u >= 0x7f800000U ) // inf and NaN
+                return static_cast<std::uint16_t>( sign | 0x7c00U | ( ( u > 0x7f800000U ) ? 0x0200U : 0U ) );
+            if ( u >= 0x47800000U ) // 65536 and above
+                return static_cast<std::uint16_t>( sign | 0x7c00U );
+            if ( u < 0x38800000U ) // below 2^-14, a subnormal or a zero: rounded by the addition, the ulp of 0.5 being the ulp of the subnormals
+                return static_cast<std::uint16_t>( sign | ( std::bit_cast<std::uint32_t>( std::bit_cast<float>( u ) + 0.5f ) - 0x3f000000U ) );
+            u += ( static_cast<std::uint32_t>( 15 - 127 ) << 23 ) + 0x0fffU + ( ( u >> 13 ) & 1U );
+            return static_cast<std::uint16_t>( sign | ( u >> 13 ) );
+        }
+
+        constexpr float float16_bits_to_float( std::uint16_t h ) noexcept
+        {
+            std::uint32_t const sign = static_cast<std::uint32_t>( h & 0x8000U ) << 16;
+            std::uint32_t const em = h & 0x7fffU;
+            if ( em >= 0x7c00U ) // inf and NaN
+                return std::bit_cast<float>( sign | 0x7f800000U | ( ( em & 0x03ffU ) << 13 ) );
+            if ( em < 0x0400U ) // a subnormal or a zero, em 2^-24, exactly
+                return std::bit_cast<float>( sign | std::bit_cast<std::uint32_t>( std::bit_cast<float>( 0x3f000000U | em ) - 0.5f ) );
+            return std::bit_cast<float>( sign | ( ( em << 13 ) + ( static_cast<std::uint32_t>( 127 - 15 ) << 23 ) ) );
+        }
+
+    }//namespace half_float_private
+
+    ///
+    /// @brief A 16-bit floating point storing the bits given by `Encode`, see `bfloat16` and `float16`.
+    ///
+    template< std::uint16_t (*Encode)( float ), float (*Decode)( std::uint16_t ) >
+    struct half_float
+    {
+        std::uint16_t bits_ = 0;
+
+        constexpr half_float() noexcept = default;
+
+        template< typename U > requires std::is_arithmetic_v<U>
+        constexpr half_float( U value ) noexcept : bits_{ Encode( static_cast<float>( value ) ) } {}
+
+        constexpr operator float() const noexcept { return Decode( bits_ ); }
+
+        ///
+        /// @brief The value of the given bits.
+        ///
+        static constexpr half_float from_bits( std::uint16_t bits ) noexcept
+        {
+            half_float ans;
+            ans.bits_ = bits;
+            return ans;
+        }
+
+        constexpr std::uint16_t bits() const noexcept { return bits_; }
+
+        constexpr half_float& operator += ( float other ) noexcept { return *this = half_float{ static_cast<float>( *this ) + other }; }
+        constexpr half_float& operator -= ( float other ) noexcept { return *this = half_float{ static_cast<float>( *this ) - other }; }
+        constexpr half_float& operator *= ( float other ) noexcept { return *this = half_float{ static_cast<float>( *this ) * other }; }
+        constexpr half_float& operator /= ( float other ) noexcept { return *this = half_float{ static_cast<float>( *this ) / other }; }
+
+        friend std::ostream& operator << ( std::ostream& os, half_float const& x )
+        {
+            return os << static_cast<float>( x );
+        }
+
+        friend std::istream& operator >> ( std::istream& is, half_float& x )
+        {
+            float value;
+            if ( is >> value )
+                x = half_float{ value };
+            return is;
+        }
+    }; // struct half_float
+
+    ///
+    /// @brief The brain floating point, a float with its mantissa rounded to 7 bits.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// bfloat16 x = 3.14159f; // 3.140625
+    /// float y = x * 2.0f;    // in float
+    /// tensor<bfloat16> t = random<float>( {128, 256} ).as_type<bfloat16>(); // half the memory
+    /// @endcode
+    ///
+    typedef half_float<half_float_private::float_to_bfloat16_bits, half_float_private::bfloat16_bits_to_float> bfloat16;
+
+    ///
+    /// @brief The IEEE 754 half precision floating point.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// float16 x = 3.14159f; // 3.140625
+    /// float16 y = 1.0e5f;   // inf, above the largest float16 of 65504
+    /// @endcode
+    ///
+    typedef half_float<half_float_private::float_to_float16_bits, half_float_private::float16_bits_to_float> float16;
+
+    template< typename T >
+    struct is_half_float : std::false_type {};
+
+    template<>
+    struct is_half_float<bfloat16> : std::true_type {};
+
+    template<>
+    struct is_half_float<float16> : std::true_type {};
+
+    template< typename T >
+    inline constexpr bool is_half_float_v = is_half_float<T>::value;
+
+    ///
+    /// @brief `bfloat16` or `float16`.
+    ///
+    template< typename T >
+    concept Half_Float = is_half_float_v<T>;
+
+    ///
+    /// @brief A floating point type a tensor of the library can hold: float, double, `bfloat16` or `float16`.
+    ///
+    template< typename T >
+    concept Floating_Point = std::floating_point<T> || Half_Float<T>;
+
+    ///
+    /// @brief The type a kernel computes and accumulates a value type in: float for the 16-bit types, the type itself otherwise.
+    ///
+    template< typename T >
+    using compute_type_t = std::conditional_t<Half_Float<T>, float, T>;
+
+}//namespace ceras
+
+namespace std
+{
+    template<>
+    struct numeric_limits<ceras::bfloat16> : numeric_limits<float>
+    {
+        static constexpr int digits = 8;
+        static constexpr int digits10 = 2;
+        static constexpr int max_digits10 = 4;
+        static constexpr ceras::bfloat16 min() noexcept { return ceras::bfloat16::from_bits( 0x0080 ); }
+        static constexpr ceras::bfloat16 max() noexcept { return ceras::bfloat16::from_bits( 0x7f7f ); }
+        static constexpr ceras::bfloat16 lowest() noexcept { return ceras::bfloat16::from_bits( 0xff7f ); }
+        static constexpr ceras::bfloat16 epsilon() noexcept { return ceras::bfloat16::from_bits( 0x3c00 ); }
+        static constexpr ceras::bfloat16 round_error() noexcept { return ceras::bfloat16::from_bits( 0x3f00 ); }
+        static constexpr ceras::bfloat16 infinity() noexcept { return ceras::bfloat16::from_bits( 0x7f80 ); }
+        static constexpr ceras::bfloat16 quiet_NaN() noexcept { return ceras::bfloat16::from_bits( 0x7fc0 ); }
+        static constexpr ceras::bfloat16 signaling_NaN() noexcept { return ceras::bfloat16::from_bits( 0x7fa0 ); }
+        static constexpr ceras::bfloat16 denorm_min() noexcept { return ceras::bfloat16::from_bits( 0x0001 ); }
+    };
+
+    template<>
+    struct numeric_limits<ceras::float16> : numeric_limits<float>
+    {
+        static constexpr int digits = 11;
+        static constexpr int digits10 = 3;
+        static constexpr int max_digits10 = 5;
+        static constexpr int min_exponent = -13;
+        static constexpr int min_exponent10 = -4;
+        static constexpr int max_exponent = 16;
+        static constexpr int max_exponent10 = 4;
+        static constexpr ceras::float16 min() noexcept { return ceras::float16::from_bits( 0x0400 ); }
+        static constexpr ceras::float16 max() noexcept { return ceras::float16::from_bits( 0x7bff ); }
+        static constexpr ceras::float16 lowest() noexcept { return ceras::float16::from_bits( 0xfbff ); }
+        static constexpr ceras::float16 epsilon() noexcept { return ceras::float16::from_bits( 0x1400 ); }
+        static constexpr ceras::float16 round_error() noexcept { return ceras::float16::from_bits( 0x3800 ); }
+        static constexpr ceras::float16 infinity() noexcept { return ceras::float16::from_bits( 0x7c00 ); }
+        static constexpr ceras::float16 quiet_NaN() noexcept { return ceras::float16::from_bits( 0x7e00 ); }
+        static constexpr ceras::float16 signaling_NaN() noexcept { return ceras::float16::from_bits( 0x7d00 ); }
+        static constexpr ceras::float16 denorm_min() noexcept { return ceras::float16::from_bits( 0x0001 ); }
+    };
+}//namespace std
+
+#endif//HALF_FLOAT_HPP_INCLUDED_PWNQZLXKMVTRJASYGDEBHUCFOIPWNQZLXKMVTRJASYGDEBHUCFOI
+
@@ -4,14 +4,24 @@
 #include "../includes.hpp"
 #include "../config.hpp"
 #include "./range.hpp"
+#include "./thread_pool.hpp"
 
 namespace ceras
 {
 
 #if 1
 
+    ///
+    /// @brief Calls `func(idx)` for every `idx` in `[dim_first, dim_last)` on the process-wide thread pool.
+    ///
+    /// Calls nested in `func` run on the same workers, see `thread_pool::parallel_for`.
+    ///
+    /// @param threshold Ranges not longer than this run on the calling thread.
+    /// @param grain The largest number of consecutive indices run as one task. `0` splits the range into
+    ///              about four tasks per thread, which leaves room to balance uneven jobs.
+    ///
     template< typename Function, std::unsigned_integral Integer_Type >
-    void parallel( Function const& func, Integer_Type dim_first, Integer_Type dim_last, size_t threshold = 8 ) // 1d parallel
+    void parallel( Function const& func, Integer_Type dim_first, Integer_Type dim_last, size_t threshold = 8, size_t grain = 0 ) // 1d parallel
     {
         if constexpr( parallel_mode == 0 )
         {
@@ -21,51 +31,19 @@ namespace ceras
         }
         else // <- this is constexpr-if, `else` is a must
         {
-            unsigned int const total_cores = std::thread::hardware_concurrency();
+            thread_pool& pool = thread_pool::instance();
 
             // case of non-parallel or small jobs
-            if ( (total_cores <= 1) || ((dim_last - dim_first) <= threshold) )
+            if ( (dim_last <= dim_first) || (pool.size() <= 1) || ((dim_last - dim_first) <= threshold) )
             {
                 for ( auto a : range( dim_first, dim_last ) )
                     func( a );
                 return;
             }
 
-            // case of small job numbers
-            std::vector<std::thread> threads;
-            if ( dim_last - dim_first <= total_cores )
-            {
-                for ( auto index = dim_first; index != dim_last; ++index )
-                    threads.emplace_back( std::thread{[&func, index](){ func( index ); }} );
-                for ( auto& th : threads )
-                    th.join();
-                return;
-            }
-
-            // case of more jobs than CPU cores
-            auto const& job_slice = [&func]( Integer_Type a, Integer_Type b )
-            {
-                if ( a >= b ) return;
-                while ( a != b )
-                    func(a++);
-            };
-
-            threads.reserve( total_cores-1 );
-            std::uint_least64_t tasks_per_thread = ( dim_last - dim_first + total_cores - 1 ) / total_cores;
-
-            for ( auto index : range( total_cores-1 ) )
-            {
-                Integer_Type first = tasks_per_thread * index + dim_first;
-                first = std::min( first, dim_last );
-                Integer_Type last =  first + tasks_per_thread;
-                last = std::min( last, dim_last );
-                threads.emplace_back( std::thread{ job_slice, first, last } );
-            }
-
-            job_slice( tasks_per_thread*(total_cores-1), dim_last );
-
-            for ( auto& th : threads )
-                th.join();
+            std::uint_least64_t const jobs = dim_last - dim_first;
+            std::uint_least64_t const chunk = grain ? grain : std::max( std::uint_least64_t{1}, jobs / (4 * pool.size()) );
+            pool.parallel_for( dim_first, dim_last, chunk, [&func]( std::size_t index ){ func( static_cast<Integer_Type>( index ) ); } );
         }
     }//parallel
 
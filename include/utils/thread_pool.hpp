@@ -0,0 +1,288 @@
+#ifndef THREAD_POOL_HPP_INCLUDED_SDLKJFOIWEURNMVXCBZKJHQWPOEIRUTYALSKDJFHGMNBVCXZQPWOEIRU
+#define THREAD_POOL_HPP_INCLUDED_SDLKJFOIWEURNMVXCBZKJHQWPOEIRUTYALSKDJFHGMNBVCXZQPWOEIRU
+
+#include "../includes.hpp"
+#include "../config.hpp"
+#include "./range.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace ceras
+{
+
+    struct thread_pool;
+
+    ///
+    /// @brief A set of tasks spawned on a thread pool, waited for together.
+    ///
+    /// `wait()` does not block the calling thread: until the last task of the group is done, it runs queued tasks
+    /// itself. Parallel regions nested inside tasks therefore share the workers of the pool instead of starting
+    /// new threads, and cannot deadlock waiting for a worker.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// ceras::task_group group;
+    /// group.run( [](){ load_next_batch(); } );
+    /// train_on_current_batch();
+    /// group.wait();
+    /// @endcode
+    ///
+    struct task_group
+    {
+        explicit task_group( thread_pool& pool );
+        task_group();
+        ~task_group();
+
+        task_group( task_group const& ) = delete;
+        task_group& operator=( task_group const& ) = delete;
+
+        ///
+        /// @brief Queues `func()` on the pool. A task spawned from a worker goes to the deque of that worker.
+        ///
+        template< typename Function >
+        void run( Function&& func );
+
+        ///
+        /// @brief Returns when all the tasks of this group are done, running queued tasks meanwhile.
+        ///
+        void wait();
+
+    private:
+        thread_pool& pool_;
+        std::atomic<std::size_t> pending_{ 0 };
+    };//struct task_group
+
+    ///
+    /// @brief A fixed set of worker threads with work-stealing, started once and reused by every parallel region.
+    ///
+    /// Every worker owns a deque of tasks. A worker pushes and pops the tasks it spawns at the back of its own deque,
+    /// and when that runs dry it steals from the front of the other deques, where the oldest -- and, for a recursively
+    /// split range, the largest -- tasks are. Tasks spawned from a thread outside of the pool go to a shared deque
+    /// that all the workers steal from.
+    ///
+    /// Example code:
+    ///
+    /// @code{.cpp}
+    /// std::vector<float> v( 1024 );
+    /// ceras::thread_pool::instance().parallel_for( 0, 1024, 128, [&]( std::size_t idx ){ v[idx] = 1.0f; } );
+    /// @endcode
+    ///
+    struct thread_pool
+    {
+        ///
+        /// @brief Starts `workers` threads. The thread waiting for a parallel region also runs its tasks, so a pool of `n-1` workers keeps `n` cores busy.
+        ///
+        explicit thread_pool( std::size_t workers ) : queues_( workers + 1 )
+        {
+            threads_.reserve( workers );
+            for ( auto index : range( workers ) )
+                threads_.emplace_back( [this, index](){ worker_loop( index ); } );
+        }
+
+        ~thread_pool()
+        {
+            {
+                std::scoped_lock lock{ mutex_ };
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for ( auto& th : threads_ )
+                th.join();
+        }
+
+        thread_pool( thread_pool const& ) = delete;
+        thread_pool& operator=( thread_pool const& ) = delete;
+
+        ///
+        /// @brief The number of threads running the tasks of a region, the waiting thread included.
+        ///
+        std::size_t size() const noexcept
+        {
+            return threads_.size() + 1;
+        }
+
+        ///
+        /// @brief Calls `func(idx)` for every `idx` in `[first, last)`.
+        ///
+        /// The range is halved recursively until the pieces hold no more than `grain` indices, and the upper halves
+        /// are spawned as tasks; idle workers steal the largest pieces left, which evens out ranges of uneven work.
+        ///
+        template< typename Function >
+        void parallel_for( std::size_t first, std::size_t last, std::size_t grain, Function const& func )
+        {
+            grain = std::max( grain, std::size_t{1} );
+            if ( (last <= first + grain) || threads_.empty() )
+            {
+                for ( auto idx : range( first, last ) )
+                    func( idx );
+                return;
+            }
+
+            task_group group{ *this };
+            auto const& split = [&group, &func, grain]( auto const& self, std::size_t a, std::size_t b ) -> void
+            {
+                while ( b - a > grain )
+                {
+                    std::size_t const mid = a + ( b - a ) / 2;
+                    group.run( [&self, mid, b](){ self( self, mid, b ); } );
+                    b = mid;
+                }
+                for ( auto idx : range( a, b ) )
+                    func( idx );
+            };
+            split( split, first, last );
+            group.wait();
+        }
+
+        ///
+        /// @brief Runs `func(0)`, `func(1)`, ..., `func(tasks-1)` in parallel and returns when all of them are done.
+        ///
+        template< typename Function >
+        void fork_join( std::size_t tasks, Function const& func )
+        {
+            parallel_for( 0, tasks, 1, func );
+        }
+
+        ///
+        /// @brief The process-wide pool, with one worker less than the hardware threads.
+        ///
+        static thread_pool& instance()
+        {
+            static thread_pool pool{ std::max( 1U, std::thread::hardware_concurrency() ) - 1 };
+            return pool;
+        }
+
+    private:
+        friend struct task_group;
+
+        typedef std::function<void()> task_type;
+
+        struct alignas(64) task_queue
+        {
+            std::mutex mutex;
+            std::deque<task_type> tasks;
+        };
+
+        // the deque of the calling thread, the shared one for threads outside of this pool
+        task_queue& local_queue() noexcept
+        {
+            return queues_[ ( current_pool_ == this ) ? current_worker_ : threads_.size() ];
+        }
+
+        void spawn( task_type&& task )
+        {
+            queued_.fetch_add( 1 ); // counted before it is visible, so that a thief never takes the count below zero
+            {
+                task_queue& queue = local_queue();
+                std::scoped_lock lock{ queue.mutex };
+                queue.tasks.push_back( std::move( task ) );
+            }
+            if ( sleeping_.load() > 0 )
+            {
+                { std::scoped_lock lock{ mutex_ }; }
+                wake_.notify_one();
+            }
+        }
+
+        // pops the newest task of the own deque, or steals the oldest task of another one
+        bool try_run_one()
+        {
+            task_type task;
+            {
+                task_queue& queue = local_queue();
+                std::scoped_lock lock{ queue.mutex };
+                if ( !queue.tasks.empty() )
+                {
+                    task = std::move( queue.tasks.back() );
+                    queue.tasks.pop_back();
+                }
+            }
+
+            if ( !task )
+            {
+                std::size_t const start = ( current_pool_ == this ) ? current_worker_ + 1 : 0;
+                for ( auto offset : range( queues_.size() ) )
+                {
+                    task_queue& victim = queues_[ ( start + offset ) % queues_.size() ];
+                    std::scoped_lock lock{ victim.mutex };
+                    if ( !victim.tasks.empty() )
+                    {
+                        task = std::move( victim.tasks.front() );
+                        victim.tasks.pop_front();
+                        break;
+                    }
+                }
+            }
+
+            if ( !task )
+                return false;
+
+            queued_.fetch_sub( 1 );
+            task();
+            return true;
+        }
+
+        void worker_loop( std::size_t index )
+        {
+            current_pool_ = this;
+            current_worker_ = index;
+
+            while ( true )
+            {
+                if ( try_run_one() )
+                    continue;
+
+                std::unique_lock lock{ mutex_ };
+                sleeping_.fetch_add( 1 );
+                wake_.wait( lock, [this](){ return stop_ || (queued_.load() > 0); } );
+                sleeping_.fetch_sub( 1 );
+                if ( stop_ ) return;
+            }
+        }
+
+        std::vector<task_queue> queues_; // one per worker, and a shared one at the end
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable wake_; // idle workers wait here for new tasks
+        bool stop_ = false;
+        std::atomic<std::size_t> queued_{ 0 };
+        std::atomic<std::size_t> sleeping_{ 0 };
+
+        inline static thread_local thread_pool* current_pool_ = nullptr;
+        inline static thread_local std::size_t current_worker_ = 0;
+    };//struct thread_pool
+
+    inline task_group::task_group( thread_pool& pool ) : pool_{ pool } {}
+
+    inline task_group::task_group() : pool_{ thread_pool::instance() } {}
+
+    inline task_group::~task_group()
+    {
+        wait();
+    }
+
+    template< typename Function >
+    void task_group::run( Function&& func )
+    {
+        pending_.fetch_add( 1, std::memory_order_relaxed );
+        pool_.spawn( [this, f = std::forward<Function>( func )]() mutable
+        {
+            f();
+            pending_.fetch_sub( 1, std::memory_order_release );
+        } );
+    }
+
+    inline void task_group::wait()
+    {
+        while ( pending_.load( std::memory_order_acquire ) > 0 )
+            if ( !pool_.try_run_one() )
+                std::this_thread::yield();
+    }
+
+}//namespace ceras
+
+#endif//THREAD_POOL_HPP_INCLUDED_SDLKJFOIWEURNMVXCBZKJHQWPOEIRUTYALSKDJFHGMNBVCXZQPWOEIRU
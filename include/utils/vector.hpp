@@ -22,19 +22,25 @@ namespace ceras
 
         size_t size_;
         pointer data_;
+        allocator_type alloc_; // the allocator of `data_`, moving with it
 
         constexpr vector( vector && other ) noexcept
         {
             size_ = other.size_;
             data_ = other.data_;
+            alloc_ = std::move( other.alloc_ );
             other.size_ = 0;
             other.data_ = nullptr;
         }
 
         constexpr vector& operator = ( vector && other ) noexcept
         {
+            if ( this == &other )
+                return *this;
+            clear();
             size_ = other.size_;
             data_ = other.data_;
+            alloc_ = std::move( other.alloc_ );
             other.size_ = 0;
             other.data_ = nullptr;
             return *this;
@@ -48,6 +54,14 @@ namespace ceras
                 std::fill_n( data_, size_, init );
         }
 
+        ///
+        /// @brief A vector of `size` elements allocated by `alloc`, such as an allocator holding a slot of an arena, see `allocate_memory` in '../memory_plan.hpp'.
+        ///
+        constexpr vector( size_t size, allocator_type const& alloc ) : size_{ 0 }, data_{ nullptr }, alloc_{ alloc }
+        {
+            resize( size );
+        }
+
         constexpr vector( vector const& other ) : size_{ 0 }, data_{ nullptr }
         {
             resize( other.size() );
@@ -78,10 +92,7 @@ namespace ceras
         constexpr void clear()
         {
             if ( !empty() )
-            {
-                allocator_type alloc;
-                alloc.deallocate( data_, size_ );
-            }
+                alloc_.deallocate( data_, size_ );
             data_ = nullptr;
             size_ = 0;
         }
@@ -95,9 +106,8 @@ namespace ceras
 
             if ( size != 0 )
             {
+                data_ = alloc_.allocate( size );
                 size_ = size;
-                allocator_type alloc;
-                data_ = alloc.allocate( size_ );
             }
         }
 
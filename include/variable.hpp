@@ -3,6 +3,7 @@
 
 #include "./includes.hpp"
 #include "./tensor.hpp"
+#include "./sparse_tensor.hpp"
 #include "./utils/id.hpp"
 #include "./utils/debug.hpp"
 #include "./config.hpp"
@@ -29,17 +30,17 @@ namespace ceras
         Tsor data_;
         Tsor gradient_;
         std::vector<Tsor> contexts_;
+        bool regularized_ = false; ///< the regularizers added to `gradient_` in this backward pass, shared by the copies of the variable
     };
 
-    template< typename Float > requires std::floating_point<Float>
+    template< typename Float > requires Floating_Point<Float>
     struct regularizer
     {
         typedef Float value_type;
         value_type l1_;
         value_type l2_;
-        bool synchronized_;
 
-        constexpr regularizer( value_type l1=0.0, value_type l2=0.0, bool synchronized=false ) noexcept : l1_{l1}, l2_{l2}, synchronized_{synchronized} {}
+        constexpr regularizer( value_type l1=0.0, value_type l2=0.0 ) noexcept : l1_{l1}, l2_{l2} {}
     };
 
     template< Tensor Tsor >
@@ -52,7 +53,7 @@ namespace ceras
         regularizer<value_type> regularizer_;
         bool trainable_;
 
-        variable( tensor_type const& data, value_type l1=value_type{0}, value_type l2=value_type{0}, bool trainable=true ) : enable_id<variable<tensor_type>, "Variable">{}, regularizer_{l1, l2, true}, trainable_{trainable}
+        variable( tensor_type const& data, value_type l1=value_type{0}, value_type l2=value_type{0}, bool trainable=true ) : enable_id<variable<tensor_type>, "Variable">{}, regularizer_{l1, l2}, trainable_{trainable}
         {
             (*this).state_ = std::make_shared<variable_state<tensor_type>>();
             (*((*this).state_)).data_ = data;
@@ -77,7 +78,7 @@ namespace ceras
             {
                 typedef typename tensor_type::value_type value_type;
                 state.gradient_.reset( value_type{0} );
-                regularizer_.synchronized_ = false; // mark changes
+                state.regularized_ = false; // mark changes
             }
             return state.data_;
         }
@@ -94,20 +95,20 @@ namespace ceras
             state.gradient_ += grad; // collecting all the gradients from its children nodes, will be called mulitple times in a single backward pass
 
             // apply regularizers
-            if (!(regularizer_.synchronized_)) // in case of multiple invoke of this method in a same backward pass
+            if (!(state.regularized_)) // in case of multiple invoke of this method in a same backward pass
             {
                 if ( regularizer_.l1_ >= eps ) // l1 regularizer
                 {
-                    value_type const factor = regularizer_.l1_;
+                    compute_type_t<value_type> const factor = regularizer_.l1_;
                     for_each( state.data_.begin(), state.data_.end(), state.gradient_.begin(), [factor]( value_type d, value_type& g ){ g += (d >= value_type{0}) ? factor : -factor; } );
                 }
                 if ( regularizer_.l2_ >= eps ) // l2 regularizer
                 {
-                    value_type const factor = regularizer_.l2_;
+                    compute_type_t<value_type> const factor = regularizer_.l2_;
                     for_each( state.data_.begin(), state.data_.end(), state.gradient_.begin(), [factor]( value_type d, value_type& g ){ g += value_type{2} * d * factor; } );
                 }
 
-                regularizer_.synchronized_ = true;
+                state.regularized_ = true;
             }
         }
 
@@ -186,6 +187,14 @@ namespace ceras
 
     };//struct variable
 
+    // a variable initialized with a lazy expression holds the evaluated tensor
+    template< Tensor_Expression Expression, typename ... Args >
+    variable( Expression const&, Args ... ) -> variable<typename Expression::tensor_type>;
+
+    // and a variable initialized with a view the tensor of the view, see `materialize` in './tensor_view.hpp'
+    template< Tensor_View View, typename ... Args >
+    variable( View const&, Args ... ) -> variable<typename View::tensor_type>;
+
     template< typename T >
     struct is_variable : std::false_type {};
 
@@ -198,6 +207,60 @@ namespace ceras
     template< typename T >
     concept Variable = is_variable_v<T>;
 
+    ///
+    /// @brief The sparse weights of a layer, see `dense`: the pattern of a `sparse_tensor`, and a variable of its stored values.
+    ///
+    /// Only the stored values are trained: a pruned layer is fine-tuned with its pattern fixed, the pruned weights staying zero.
+    ///
+    /// Example code:
+    /// @code{.cpp}
+    /// // ... after training dense( "relu" )( x, w, b ), pruning w of shape [input, output]
+    /// auto sw = sparse_variable{ to_sparse( transpose( w.data() ), 0.05f ) };
+    /// auto y = dense( "relu" )( x, sw, b );
+    /// @endcode
+    ///
+    template< Tensor Tsor >
+    struct sparse_variable
+    {
+        typedef Tsor tensor_type;
+        typedef typename tensor_type::value_type value_type;
+
+        std::shared_ptr<sparse_tensor<value_type>> weight_; ///< the weights of shape [output, input], its values shared with `values_`
+        variable<tensor_type> values_;
+
+        sparse_variable( sparse_tensor<value_type> const& weight, bool trainable=true ) :
+            weight_{ std::make_shared<sparse_tensor<value_type>>( weight ) }, values_{ weight.values_, value_type{0}, value_type{0}, trainable } {}
+
+        sparse_variable() noexcept {}
+
+        std::vector<std::size_t> shape() const noexcept { return weight_->shape(); }
+
+        sparse_tensor<value_type> data() const
+        {
+            sparse_tensor<value_type> ans = *weight_;
+            ans.values_ = values_.data();
+            return ans;
+        }
+
+        bool trainable() const noexcept { return values_.trainable(); }
+        void trainable( bool t ) { values_.trainable( t ); }
+    };//struct sparse_variable
+
+    template< typename T, typename ... Args >
+    sparse_variable( sparse_tensor<T> const&, Args ... ) -> sparse_variable<tensor<T>>;
+
+    template< typename T >
+    struct is_sparse_variable : std::false_type {};
+
+    template< Tensor Tsor >
+    struct is_sparse_variable< sparse_variable<Tsor> > : std::true_type {};
+
+    template< class T >
+    inline constexpr bool is_sparse_variable_v = is_sparse_variable<T>::value;
+
+    template< typename T >
+    concept Sparse_Variable = is_sparse_variable_v<T>;
+
     template< Variable Var >
     bool operator == ( Var const& lhs, Var const& rhs ) noexcept
     {
@@ -212,7 +275,7 @@ namespace ceras
 
         std::string var_name = fmt::format( "variable_{}", var.id() );
         std::vector<std::string> var_code = data_code;
-        //variable( tensor_type const& data, value_type l1=value_type{0}, value_type l2=value_type{0}, bool trainable=true ) : enable_id<variable<tensor_type>, "Variable">{}, regularizer_{l1, l2, true}, trainable_{trainable}
+        //variable( tensor_type const& data, value_type l1=value_type{0}, value_type l2=value_type{0}, bool trainable=true ) : enable_id<variable<tensor_type>, "Variable">{}, regularizer_{l1, l2}, trainable_{trainable}
         var_code.emplace_back( fmt::format( "ceras::variable<ceras::tensor<{}>> {}( {}/*tensor*/, {}/*l1 regularizer*/, {}/*l2 regularizer*/, {}/*trainable*/ );", type2string<typename Var::value_type>(), var_name, data_name, var.l1_regularizer(), var.l2_regularizer(), var.trainable()  ) );
 
         return std::forward_as_tuple( var_name, var_code );
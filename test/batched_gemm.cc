@@ -0,0 +1,46 @@
+#include "../include/tensor.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// One batched_gemm call against a loop of gemm calls, for many small products and for a shared right side.
+int main()
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // batch, m, n, k, rhs shared
+    std::vector<std::tuple<size_t, size_t, size_t, size_t, bool>> const shapes
+    {
+        { 4096,  8,  8,  8, false },
+        { 4096, 16, 16, 16, false },
+        { 1024, 32, 64, 32, false },
+        {  256, 64, 64, 64, false },
+        {  256, 32, 256, 256, true },
+    };
+
+    for ( auto const& [bs, m, n, k, shared] : shapes )
+    {
+        auto A = random<float>( {bs*m*n,}, -1.0f, 1.0f );
+        auto B = random<float>( {(shared ? 1 : bs)*n*k,}, -1.0f, 1.0f );
+        tensor<float> C{ {bs*m*k,} };
+        size_t const stride_b = shared ? 0 : n*k;
+
+        auto const& time_it = [&]( auto const& call )
+        {
+            call();
+            size_t const repeats = std::max( 1UL, (1UL << 30) / (bs*m*n*k) );
+            auto const start = std::chrono::steady_clock::now();
+            for ( [[maybe_unused]] auto _ : range( repeats ) )
+                call();
+            return std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / repeats;
+        };
+
+        double const looped = time_it( [&](){ for ( auto idx : range( bs ) ) gemm( A.data()+idx*m*n, false, B.data()+idx*stride_b, false, m, n, k, C.data()+idx*m*k ); } );
+        double const batched = time_it( [&](){ batched_gemm( A.data(), m*n, false, B.data(), stride_b, false, bs, m, n, k, C.data(), m*k ); } );
+        std::cout << fmt::format( "{} x [{}x{}x{}] {}\tgemm loop: {} us\tbatched_gemm: {} us\tspeedup: {}\n", bs, m, n, k, std::string{ shared ? "shared rhs" : "own rhs" }, looped, batched, looped / batched );
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "../include/tensor.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// Throughput of the element-wise kernels on L1, L2 and memory sized tensors, on the tensor buffers and on the same buffers
+// shifted by one element, which splits every other vector load across two cache lines.
+//
+// Usage: test_bench_elementwise [seconds per measurement]
+int main( int argc, char** argv )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    double const min_seconds = ( argc > 1 ) ? std::stod( argv[1] ) : 0.2;
+
+    typedef std::function<void( float const*, float const*, float*, size_t )> kernel_type;
+    std::vector<std::tuple<std::string, kernel_type, size_t>> const kernels // name, kernel, bytes moved per element
+    {
+        { "copy",  []( float const* x, float const*, float* y, size_t n ){ vectorized_map( x, y, n, []( auto v ){ return v; } ); }, 8 },
+        { "add",   []( float const* x, float const* z, float* y, size_t n ){ vectorized_map( x, z, y, n, []( auto u, auto v ){ return u + v; } ); }, 12 },
+        { "fma",   []( float const* x, float const* z, float* y, size_t n ){ vectorized_map( x, z, y, n, []( auto u, auto v ){ return fma( u, v, u ); } ); }, 12 },
+        { "exp",   []( float const* x, float const*, float* y, size_t n ){ vectorized_map( x, y, n, []( auto v ){ return vmath::exp( v ); } ); }, 8 },
+        { "tanh",  []( float const* x, float const*, float* y, size_t n ){ vectorized_map( x, y, n, []( auto v ){ return vmath::tanh( v ); } ); }, 8 },
+        { "gelu",  []( float const* x, float const*, float* y, size_t n ){ vectorized_map( x, y, n, []( auto v ){ return vmath::gelu( v ); } ); }, 8 },
+    };
+
+    std::cout << fmt::format( "{} threads\n", thread_pool::instance().size() );
+    for ( size_t n : { 2048UL, 49152UL, 16777216UL } ) // 24 KiB, 576 KiB and 192 MiB in the three buffers
+    {
+        auto const x = random<float>( {n+1,}, -2.0f, 2.0f );
+        auto const z = random<float>( {n+1,}, -2.0f, 2.0f );
+        tensor<float> y{ {n+1,} };
+
+        for ( size_t shift : { 0UL, 1UL } )
+            for ( auto const& [name, kernel, bytes] : kernels )
+            {
+                auto const& run = [&](){ kernel( x.data() + shift, z.data() + shift, y.data() + shift, n ); };
+                run(); // warm-up
+
+                // median of the runs, at least 3 and at least `min_seconds` in total
+                std::vector<double> seconds;
+                double total = 0.0;
+                while ( seconds.size() < 3 || total < min_seconds )
+                {
+                    auto const start = std::chrono::steady_clock::now();
+                    for ( size_t repeat = 0; repeat < std::max( 1UL, 1048576UL / n ); ++repeat )
+                        run();
+                    seconds.push_back( std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() / std::max( 1UL, 1048576UL / n ) );
+                    total += seconds.back() * std::max( 1UL, 1048576UL / n );
+                }
+                std::sort( seconds.begin(), seconds.end() );
+                double const median = seconds[seconds.size() / 2];
+
+                std::cout << fmt::format( "{}\t{}\t{}\t{} ns/element\t{} GB/s\n", n, shift ? "shifted" : "aligned", name, 1.0e9 * median / n, 1.0e-9 * bytes * n / median );
+            }
+    }
+
+    return 0;
+}
+
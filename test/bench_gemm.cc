@@ -0,0 +1,162 @@
+#include "../include/tensor.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+// Throughput of the gemm kernels on square, tall-skinny and layer-derived shapes, in all the four transpose modes.
+//
+// Usage: test_bench_gemm [output.json] [seconds per measurement] [baseline.json]
+//
+// The results go to stdout as a table and to a JSON file, one record per line and per (shape, transpose mode, kernel).
+// Given the JSON file of an earlier run -- before a change, or of the last release -- the records more than 10% slower
+// than their baseline are listed at the end, and the program returns 1.
+int main( int argc, char** argv )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    std::string const json_path = ( argc > 1 ) ? std::string{ argv[1] } : std::string{ "./bench_gemm.json" };
+    double const min_seconds = ( argc > 2 ) ? std::stod( argv[2] ) : 0.2;
+
+    // (shape, transpose mode, kernel) -> GFLOP/s of the baseline run
+    std::map<std::tuple<std::string, std::string, std::string>, double> baseline;
+    if ( argc > 3 )
+    {
+        std::ifstream ifs{ argv[3] };
+        std::regex const record{ "\"shape\": \"([^\"]*)\".*\"transpose\": \"([^\"]*)\", \"kernel\": \"([^\"]*)\".*\"gflops\": ([-0-9.e+]*)" };
+        std::string line;
+        std::smatch match;
+        while ( std::getline( ifs, line ) )
+            if ( std::regex_search( line, match, record ) )
+                baseline[ { match[1], match[2], match[3] } ] = std::stod( match[4] );
+        std::cout << fmt::format( "{} baseline records read from {}\n", baseline.size(), std::string{ argv[3] } );
+    }
+    std::vector<std::string> regressions;
+
+    // [m x n] * [n x k]
+    std::vector<std::tuple<std::string, size_t, size_t, size_t>> const shapes
+    {
+        { "square 64",                  64,    64,    64 },
+        { "square 128",                128,   128,   128 },
+        { "square 256",                256,   256,   256 },
+        { "square 512",                512,   512,   512 },
+        { "square 1024",              1024,  1024,  1024 },
+        { "square 2048",              2048,  2048,  2048 },
+        { "tall-skinny 16384x64x64", 16384,    64,    64 },
+        { "tall-skinny 64x16384x64",    64, 16384,    64 },
+        { "tall-skinny 64x64x16384",    64,    64, 16384 },
+        { "vector 1x1024x1024",          1,  1024,  1024 },
+        { "mnist dense 784x256",        10,   784,   256 },
+        { "mnist dense 256x128",        10,   256,   128 },
+        { "dense 784x512 batch 128",   128,   784,   512 },
+        { "vgg16 fc6 batch 32",         32, 25088,  4096 },
+        { "vgg16 fc7 batch 32",         32,  4096,  4096 },
+        { "resnet conv3x3x64 56x56",  3136,   576,    64 },
+        { "resnet conv3x3x128 28x28",  784,  1152,   128 },
+        { "vgg16 conv3x3x256 56x56",  3136,  2304,   256 },
+        { "unet conv3x3x64 128x128", 16384,   576,    64 },
+    };
+
+    typedef std::function<void( float const*, bool, float const*, bool, size_t, size_t, size_t, float* )> kernel_type;
+    std::vector<std::tuple<std::string, kernel_type, size_t>> kernels // name, kernel, largest number of multiply-adds to try
+    {
+        { "naive",    []( auto... args ){ naive_gemm( args... ); }, 1UL << 27 },
+        { "blocked",  []( float const* A, bool a_t, float const* B, bool b_t, size_t m, size_t n, size_t k, float* C )
+                      {
+                          blocked_gemm( A, a_t ? m : n, a_t, B, b_t ? n : k, b_t, m, n, k, C, k );
+                      }, std::numeric_limits<size_t>::max() },
+        { "gemm_cpu", []( auto... args ){ gemm_cpu( args... ); }, std::numeric_limits<size_t>::max() },
+        { "gemm",     []( auto... args ){ gemm( args... ); }, std::numeric_limits<size_t>::max() }, // the dispatcher, with the autotuned plans
+        { "strassen", []( float const* A, bool a_t, float const* B, bool b_t, size_t m, size_t n, size_t k, float* C )
+                      {
+                          fast_gemm<strassen_fast_gemm>( A, a_t ? m : n, a_t, B, b_t ? n : k, b_t, m, n, k, C, k, 512 );
+                      }, std::numeric_limits<size_t>::max() }, // the classical kernel below 1024 in every dimension
+    };
+    if constexpr( cblas_mode )
+        kernels.emplace_back( "cblas_gemm", []( auto... args ){ cblas_gemm( args... ); }, std::numeric_limits<size_t>::max() );
+
+#if defined(__AVX512F__)
+    std::string const isa = "avx512";
+#elif defined(__AVX2__) && defined(__FMA__)
+    std::string const isa = "avx2";
+#else
+    std::string const isa = "generic";
+#endif
+
+    std::ofstream json{ json_path };
+    json << "{\n";
+    json << "  \"version\": " << version << ",\n";
+    json << "  \"isa\": \"" << isa << "\",\n";
+    json << "  \"threads\": " << thread_pool::instance().size() << ",\n";
+    json << "  \"cblas\": " << ( cblas_mode ? "true" : "false" ) << ",\n";
+    json << "  \"results\": [\n";
+    bool first_record = true;
+
+    std::cout << fmt::format( "{} threads, {}, results written to {}\n", thread_pool::instance().size(), isa, json_path );
+    for ( auto const& [name, m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+            {
+                auto A = random<float>( {m, n}, -1.0f, 1.0f );
+                auto B = random<float>( {n, k}, -1.0f, 1.0f );
+                tensor<float> C{ {m, k} };
+                tensor<float> reference{ {m, k} };
+                double const gflop = 2.0e-9 * m * n * k;
+
+                gemm_cpu( A.data(), a_transposed, B.data(), b_transposed, m, n, k, reference.data() );
+
+                std::string const mode = std::string{ a_transposed ? "T" : "N" } + std::string{ b_transposed ? "T" : "N" };
+                std::cout << fmt::format( "{} [{}x{}x{}] {}\n", name, m, n, k, mode );
+
+                for ( auto const& [kernel_name, kernel, max_work] : kernels )
+                {
+                    if ( m * n * k > max_work ) continue;
+
+                    auto const& run = [&](){ kernel( A.data(), a_transposed, B.data(), b_transposed, m, n, k, C.data() ); };
+                    run(); // warm-up, also tunes the bucket of the dispatcher
+
+                    float max_error = 0.0f;
+                    for ( auto idx : range( m * k ) )
+                        max_error = std::max( max_error, std::abs( C[idx] - reference[idx] ) );
+
+                    // median of the runs, at least 3 and at least `min_seconds` in total
+                    std::vector<double> seconds;
+                    double total = 0.0;
+                    while ( seconds.size() < 3 || total < min_seconds )
+                    {
+                        auto const start = std::chrono::steady_clock::now();
+                        run();
+                        seconds.push_back( std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() );
+                        total += seconds.back();
+                    }
+                    std::sort( seconds.begin(), seconds.end() );
+                    double const median = seconds[seconds.size() / 2];
+                    double const best = seconds.front();
+
+                    std::cout << fmt::format( "\t{}\t{} GFLOP/s\t(best {} GFLOP/s, max error {})\n", kernel_name, gflop / median, gflop / best, max_error );
+
+                    if ( auto const itor = baseline.find( { name, mode, kernel_name } ); itor != baseline.end() && gflop / median < 0.9 * itor->second )
+                        regressions.push_back( fmt::format( "{} [{}x{}x{}] {} {}: {} GFLOP/s, baseline {} GFLOP/s", name, m, n, k, mode, kernel_name, gflop / median, itor->second ) );
+
+                    json << ( first_record ? "" : ",\n" );
+                    first_record = false;
+                    json << "    {\"shape\": \"" << name << "\", \"m\": " << m << ", \"n\": " << n << ", \"k\": " << k
+                         << ", \"transpose\": \"" << mode << "\", \"kernel\": \"" << kernel_name
+                         << "\", \"median_seconds\": " << median << ", \"best_seconds\": " << best << ", \"gflops\": " << gflop / median
+                         << ", \"max_error\": " << max_error << ", \"runs\": " << seconds.size() << "}";
+                }
+            }
+
+    json << "\n  ]\n}\n";
+
+    if ( regressions.empty() )
+        return 0;
+
+    std::cout << fmt::format( "{} regressions against the baseline:\n", regressions.size() );
+    for ( auto const& regression : regressions )
+        std::cout << "\t" << regression << "\n";
+    return 1;
+}
+
@@ -0,0 +1,86 @@
+#include "../include/ceras.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// Inference throughput of the int8 operators against their float counterparts, on dense and conv layers of a few sizes and
+// on the conv network of the MNIST tests.
+//
+// Usage: test_bench_quantization [seconds per measurement]
+int main( int argc, char** argv )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    double const min_seconds = ( argc > 1 ) ? std::stod( argv[1] ) : 0.2;
+
+    // median of the runs, at least 3 and at least `min_seconds` in total, every run computing the expression again
+    auto const& measure = [min_seconds]( auto& expression )
+    {
+        auto const& run = [&](){ get_default_session<tensor<float>>().clear_forward_cache(); expression.forward(); };
+        run(); // warm-up
+        std::vector<double> seconds;
+        double total = 0.0;
+        while ( seconds.size() < 3 || total < min_seconds )
+        {
+            auto const start = std::chrono::steady_clock::now();
+            run();
+            seconds.push_back( std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() );
+            total += seconds.back();
+        }
+        std::sort( seconds.begin(), seconds.end() );
+        return seconds[seconds.size() / 2];
+    };
+
+    std::cout << fmt::format( "{} threads\n", thread_pool::instance().size() );
+    for ( auto [m, n, k] : std::vector<std::tuple<size_t, size_t, size_t>>{ {64, 784, 512}, {256, 512, 512}, {256, 1024, 1024} } )
+    {
+        auto x = variable{ random<float>( {m, n}, -1.0f, 1.0f ) };
+        auto w = variable{ glorot_uniform<float>( {n, k} ) };
+        auto b = variable{ random<float>( {1, k}, -0.1f, 0.1f ) };
+        auto y = dense( "relu" )( x, w, b );
+        auto q = quantized_dense( quantize<std::int8_t>( w.data(), 1 ), b.data(), "relu" )( x );
+        double const float_seconds = measure( y );
+        double const int8_seconds = measure( q );
+        std::cout << fmt::format( "dense\t{}x{}x{}\tfloat {} GOP/s\tint8 {} GOP/s\tspeedup {}\n", m, n, k,
+                                  2.0e-9 * m * n * k / float_seconds, 2.0e-9 * m * n * k / int8_seconds, float_seconds / int8_seconds );
+    }
+
+    for ( auto [bs, size, channels, filters] : std::vector<std::tuple<size_t, size_t, size_t, size_t>>{ {16, 28, 1, 32}, {16, 28, 32, 64}, {16, 14, 64, 128}, {8, 56, 64, 64} } )
+    {
+        auto x = variable{ random<float>( {bs, size, size, channels}, -1.0f, 1.0f ) };
+        auto w = variable{ glorot_uniform<float>( {filters, 3, 3, channels} ) };
+        auto b = variable{ random<float>( {1, 1, filters}, -0.1f, 0.1f ) };
+        auto y = relu( general_conv2d( 1, 1, 1, 1, "same" )( x, w ) + b );
+        auto q = quantized_conv2d( quantize<std::int8_t>( w.data(), 0 ), b.data(), 1, 1, 1, 1, "same", "relu" )( x );
+        double const operations = 2.0 * bs * size * size * 9 * channels * filters;
+        double const float_seconds = measure( y );
+        double const int8_seconds = measure( q );
+        std::cout << fmt::format( "conv2d\t{}x{}x{}x{}->{}\tfloat {} GOP/s\tint8 {} GOP/s\tspeedup {}\n", bs, size, size, channels, filters,
+                                  1.0e-9 * operations / float_seconds, 1.0e-9 * operations / int8_seconds, float_seconds / int8_seconds );
+    }
+
+    // the conv network of the MNIST tests, end to end
+    {
+        size_t const bs = 64;
+        auto x = variable{ random<float>( {bs, 28, 28, 1}, 0.0f, 1.0f ) };
+        auto w1 = variable{ glorot_uniform<float>( {32, 3, 3, 1} ) };
+        auto b1 = variable{ random<float>( {1, 1, 32}, -0.1f, 0.1f ) };
+        auto w2 = variable{ glorot_uniform<float>( {64, 3, 3, 32} ) };
+        auto b2 = variable{ random<float>( {1, 1, 64}, -0.1f, 0.1f ) };
+        auto w3 = variable{ glorot_uniform<float>( {3136, 128} ) };
+        auto b3 = variable{ random<float>( {1, 128}, -0.1f, 0.1f ) };
+        auto w4 = variable{ glorot_uniform<float>( {128, 10} ) };
+        auto b4 = variable{ random<float>( {1, 10}, -0.1f, 0.1f ) };
+        auto const& conv = [&]( auto const& input, auto const& w, auto const& b ){ return MaxPooling2D( 2 )( relu( general_conv2d( 1, 1, 1, 1, "same" )( input, w ) + b ) ); };
+        auto const& quantized_conv = [&]( auto const& input, auto const& w, auto const& b ){ return MaxPooling2D( 2 )( quantized_conv2d( quantize<std::int8_t>( w.data(), 0 ), b.data(), 1, 1, 1, 1, "same", "relu" )( input ) ); };
+        auto y = dense()( dense( "relu" )( Flatten()( conv( conv( x, w1, b1 ), w2, b2 ) ), w3, b3 ), w4, b4 );
+        auto q = quantized_dense( quantize<std::int8_t>( w4.data(), 1 ), b4.data() )( quantized_dense( quantize<std::int8_t>( w3.data(), 1 ), b3.data(), "relu" )( Flatten()( quantized_conv( quantized_conv( x, w1, b1 ), w2, b2 ) ) ) );
+        double const float_seconds = measure( y );
+        double const int8_seconds = measure( q );
+        std::cout << fmt::format( "mnist conv\t{} images\tfloat {} images/s\tint8 {} images/s\tspeedup {}\n", bs, bs / float_seconds, bs / int8_seconds, float_seconds / int8_seconds );
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "../include/ceras.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// Inference time of dense layers with pruned weights, as sparse variables in CSR and in blocks of 4 outputs, against the
+// dense weights, at several sparsities.
+//
+// Usage: test_bench_sparse [seconds per measurement]
+int main( int argc, char** argv )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    double const min_seconds = ( argc > 1 ) ? std::stod( argv[1] ) : 0.2;
+
+    // median of the runs, at least 3 and at least `min_seconds` in total, every run computing the expression again
+    auto const& measure = [min_seconds]( auto& expression )
+    {
+        auto const& run = [&](){ get_default_session<tensor<float>>().clear_forward_cache(); expression.forward(); };
+        run(); // warm-up
+        std::vector<double> seconds;
+        double total = 0.0;
+        while ( seconds.size() < 3 || total < min_seconds )
+        {
+            auto const start = std::chrono::steady_clock::now();
+            run();
+            seconds.push_back( std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() );
+            total += seconds.back();
+        }
+        std::sort( seconds.begin(), seconds.end() );
+        return seconds[seconds.size() / 2];
+    };
+
+    std::cout << fmt::format( "{} threads\n", thread_pool::instance().size() );
+    for ( auto [m, n, k] : std::vector<std::tuple<size_t, size_t, size_t>>{ {64, 784, 512}, {256, 1024, 1024}, {256, 4096, 1024} } )
+    {
+        auto x = variable{ random<float>( {m, n}, -1.0f, 1.0f ) };
+        auto b = variable{ random<float>( {1, k}, -0.1f, 0.1f ) };
+        auto const weight = random<float>( {k, n}, -1.0f, 1.0f ); // uniform magnitudes, a threshold t keeps a fraction 1-t
+        auto w = variable{ transpose( weight ) };
+        auto y = dense( "relu" )( x, w, b );
+        double const dense_seconds = measure( y );
+        for ( float sparsity : { 0.5f, 0.9f, 0.95f, 0.99f } )
+        {
+            auto csr = sparse_variable{ to_sparse( weight, sparsity ) };
+            auto y_csr = dense( "relu" )( x, csr, b );
+            auto bsr = sparse_variable{ to_sparse( weight, 1.0f - ( 1.0f - sparsity ) / 4.0f, 4, 1 ) }; // about the same density in blocks of 4
+            auto y_bsr = dense( "relu" )( x, bsr, b );
+            double const csr_seconds = measure( y_csr );
+            double const bsr_seconds = measure( y_bsr );
+            std::cout << fmt::format( "dense\t{}x{}x{}\tsparsity {}\tdense {} ms\tcsr (density {}) {} ms, speedup {}\tbsr 4x1 (density {}) {} ms, speedup {}\n",
+                                      m, n, k, sparsity, 1.0e3 * dense_seconds, csr.weight_->density(), 1.0e3 * csr_seconds, dense_seconds / csr_seconds,
+                                      bsr.weight_->density(), 1.0e3 * bsr_seconds, dense_seconds / bsr_seconds );
+        }
+    }
+
+    return 0;
+}
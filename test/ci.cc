@@ -4,4 +4,27 @@
 
 #include "./ci/utils_enumerate.hpp"
 #include "./ci/utils_buffered_allocator.hpp"
+#include "./ci/utils_aligned_allocator.hpp"
+#include "./ci/utils_heap_allocations.hpp"
+#include "./ci/utils_parallel.hpp"
+#include "./ci/utils_for_each.hpp"
+#include "./ci/backend_gemm.hpp"
+#include "./ci/backend_gemm_tuner.hpp"
+#include "./ci/backend_fast_gemm.hpp"
+#include "./ci/backend_broadcast.hpp"
+#include "./ci/backend_vectorized_math.hpp"
+#include "./ci/tensor_view.hpp"
+#include "./ci/tensor_expression.hpp"
+#include "./ci/tensor_destination.hpp"
+#include "./ci/tensor_copy_on_write.hpp"
+#include "./ci/execution_plan.hpp"
+#include "./ci/session_forward_cache.hpp"
+#include "./ci/session_run_operators.hpp"
+#include "./ci/memory_plan.hpp"
+#include "./ci/elementwise_fusion.hpp"
+#include "./ci/tensor_half_float.hpp"
+#include "./ci/tensor_sparse.hpp"
+#include "./ci/operation_batch_matmul.hpp"
+#include "./ci/operation_dense.hpp"
+#include "./ci/operation_quantization.hpp"
 
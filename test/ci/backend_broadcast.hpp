@@ -0,0 +1,107 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "broadcast_binary", "[backend_broadcast_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // the element of a tensor broadcasted to `out_shape`, at the flat index `idx` of the output
+    auto const& broadcasted_at = []( auto const& tsor, std::vector<size_t> const& out_shape, size_t idx )
+    {
+        auto const& shape = tsor.shape();
+        size_t offset = 0;
+        size_t stride = 1;
+        for ( size_t dim = 0; dim != shape.size(); ++dim )
+        {
+            size_t const out_dim = out_shape[out_shape.size()-1-dim];
+            size_t const index = idx % out_dim;
+            idx /= out_dim;
+            if ( shape[shape.size()-1-dim] != 1 )
+                offset += index * stride;
+            stride *= shape[shape.size()-1-dim];
+        }
+        return tsor[offset];
+    };
+
+    // small shapes run on the calling thread, the large ones over the thread pool, either along the rows or within a single row
+    std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>> const shapes
+    {
+        { {3, 4}, {3, 4} }, { {2, 3, 4}, {4,} }, { {4,}, {2, 3, 4} }, { {3, 1}, {1, 4} }, { {5, 1, 3}, {1, 6, 1} },
+        { {2, 3}, {1,} }, { {1,}, {1,} }, { {8, 5, 7, 3}, {5, 7, 3} }, { {8, 1, 7, 3}, {8, 5, 1, 3} },
+        { {64, 32, 32, 3}, {32, 32, 3} }, { {64, 32, 32, 3}, {3,} }, { {64, 1, 32, 16}, {64, 32, 1, 16} }, { {1, 100000}, {100000,} },
+    };
+
+    for ( auto const& [lhs_shape, rhs_shape] : shapes )
+    {
+        auto const lhs = ceras::random<float>( lhs_shape, -1.0f, 1.0f );
+        auto const rhs = ceras::random<float>( rhs_shape, 0.5f, 1.0f );
+        auto const& out_shape = ceras::broadcast_shape( lhs_shape, rhs_shape );
+
+        auto const& check = [&]( auto const& ans, auto const& func )
+        {
+            REQUIRE( ans.shape() == out_shape );
+            bool ok = true;
+            for ( auto idx : ceras::range( ans.size() ) )
+                ok = ok && ( std::abs( ans[idx] - func( broadcasted_at( lhs, out_shape, idx ), broadcasted_at( rhs, out_shape, idx ) ) ) < 1.0e-6f );
+            REQUIRE( ok );
+        };
+
+        check( ceras::add( lhs, rhs ), []( float x, float y ){ return x + y; } );
+        check( ceras::minus( lhs, rhs ), []( float x, float y ){ return x - y; } );
+        check( ceras::elementwise_product( lhs, rhs ), []( float x, float y ){ return x * y; } );
+        check( ceras::elementwise_divide( lhs, rhs ), []( float x, float y ){ return x / y; } );
+        check( ceras::maximum( lhs, rhs ), []( float x, float y ){ return std::max( x, y ); } );
+        check( ceras::minimum( lhs, rhs ), []( float x, float y ){ return std::min( x, y ); } );
+        check( ceras::atan2( lhs, rhs ), []( float x, float y ){ return std::atan2( x, y ); } );
+    }
+
+    // the operands are left untouched, the result does not share their buffers
+    auto a = ceras::random<float>( {3, 4}, -1.0f, 1.0f );
+    auto b = ceras::random<float>( {3, 4}, -1.0f, 1.0f );
+    auto const a_copy = a.deep_copy();
+    auto c = ceras::add( a, b );
+    REQUIRE( c.data() != a.data() );
+    for ( auto idx : ceras::range( a.size() ) )
+        REQUIRE( a[idx] == a_copy[idx] );
+
+    // the product of not broadcastable shapes of dividing sizes repeats the smaller operand
+    auto x = ceras::random<float>( {6,}, -1.0f, 1.0f );
+    auto y = ceras::random<float>( {2, 3}, -1.0f, 1.0f );
+    auto z = ceras::random<float>( {4, 6}, -1.0f, 1.0f );
+    auto xy = ceras::elementwise_product( x, y );
+    auto yz = ceras::elementwise_product( y, z );
+    REQUIRE( xy.shape() == std::vector<size_t>{ {6,} } );
+    REQUIRE( yz.shape() == std::vector<size_t>{ {4, 6} } );
+    for ( auto idx : ceras::range( 6 ) )
+        REQUIRE( xy[idx] == x[idx] * y[idx] );
+    for ( auto idx : ceras::range( 24 ) )
+        REQUIRE( yz[idx] == z[idx] * y[idx%6] );
+}
+
+TEST_CASE( "broadcast_binary_operators", "[backend_broadcast_2]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // the gradients of `maximum` and `minimum` go to the selected operand
+    auto const& check = []( auto const& maker, bool to_larger )
+    {
+        auto x = ceras::variable{ ceras::random<float>( {7, 9}, -1.0f, 1.0f ) };
+        auto y = ceras::variable{ ceras::random<float>( {7, 9}, -1.0f, 1.0f ) };
+        auto grad = ceras::random<float>( {7, 9}, -1.0f, 1.0f );
+
+        auto ex = maker( x, y );
+        auto const output = ex.forward().deep_copy();
+        ex.backward( grad );
+        auto const xs = x.data();
+        auto const ys = y.data();
+        for ( auto idx : ceras::range( grad.size() ) )
+        {
+            bool const x_selected = ( xs[idx] > ys[idx] ) == to_larger;
+            REQUIRE( output[idx] == ( x_selected ? xs[idx] : ys[idx] ) );
+            REQUIRE( x.gradient()[idx] == ( x_selected ? grad[idx] : 0.0f ) );
+            REQUIRE( y.gradient()[idx] == ( x_selected ? 0.0f : grad[idx] ) );
+        }
+    };
+
+    check( []( auto const& x, auto const& y ){ return ceras::maximum( x, y ); }, true );
+    check( []( auto const& x, auto const& y ){ return ceras::minimum( x, y ); }, false );
+}
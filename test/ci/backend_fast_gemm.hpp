@@ -0,0 +1,74 @@
+#include "../../include/tensor.hpp"
+
+TEST_CASE( "fast_gemm", "[backend_fast_gemm_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // Strassen's coefficients are an exact decomposition of the 2x2x2 product
+    auto const strassen = ceras::strassen_decomposition();
+    REQUIRE( strassen.n0 == 2 );
+    REQUIRE( strassen.rank == 7 );
+    REQUIRE( ceras::brent_residual( strassen ) == 0.0 );
+    REQUIRE( ceras::fast_gemm_error_growth( strassen ) == 12.0 );
+
+    // a decomposition survives a round trip through its file
+    std::string const path = ( std::filesystem::temp_directory_path() / "ceras_test_strassen.txt" ).string();
+    ceras::save_bilinear_decomposition( strassen, path );
+    auto const loaded = ceras::load_bilinear_decomposition( path );
+    std::filesystem::remove( path );
+    REQUIRE( loaded.n0 == strassen.n0 );
+    REQUIRE( loaded.rank == strassen.rank );
+    REQUIRE( loaded.a == strassen.a );
+    REQUIRE( loaded.b == strassen.b );
+    REQUIRE( loaded.c == strassen.c );
+
+    // a perturbed decomposition is rounded back to the exact one
+    auto perturbed = strassen;
+    for ( auto& x : perturbed.a ) x += 1.0e-3;
+    REQUIRE( ceras::brent_residual( perturbed ) > 0.0 );
+    REQUIRE( ceras::brent_residual( ceras::round_bilinear_decomposition( perturbed ) ) == 0.0 );
+
+    // the shipped kernel is the one generated from the decomposition, at the absolute path given by the Makefile, see the `ci` target
+    {
+#ifdef CERAS_FAST_GEMM_STRASSEN_KERNEL
+        std::filesystem::path const kernel{ CERAS_FAST_GEMM_STRASSEN_KERNEL };
+#else // built without the Makefile, relative to the directory the compiler ran in
+        std::filesystem::path const kernel = std::filesystem::path{ __FILE__ }.parent_path() / ".." / ".." / "include" / "backend" / "fast_gemm_strassen.hpp";
+#endif
+        REQUIRE( std::filesystem::exists( kernel ) );
+        std::ifstream ifs{ kernel };
+        std::string const shipped{ std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+        REQUIRE( shipped == ceras::generate_fast_gemm_kernel( strassen, "strassen_fast_gemm" ) );
+    }
+
+    // products within the a priori error bound, with a small cutoff for several levels and odd sizes for the peeling
+    std::vector<std::tuple<size_t, size_t, size_t>> const shapes{ {64, 64, 64}, {67, 45, 39}, {33, 130, 71} };
+    for ( auto [m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+            {
+                auto A = ceras::random<double>( {m, n}, -1.0, 1.0 );
+                auto B = ceras::random<double>( {n, k}, -1.0, 1.0 );
+                ceras::tensor<double> expected{ {m, k} };
+                ceras::tensor<double> ans{ {m, k} };
+                ceras::naive_gemm( A.data(), a_transposed, B.data(), b_transposed, m, n, k, expected.data() );
+                ceras::fast_gemm<ceras::strassen_fast_gemm>( A.data(), a_transposed ? m : n, a_transposed, B.data(), b_transposed ? n : k, b_transposed, m, n, k, ans.data(), k, 8 );
+                REQUIRE( ceras::fast_gemm_levels<ceras::strassen_fast_gemm>( m, n, k, 8 ) >= 1 );
+                double const bound = ceras::fast_gemm_error_bound<ceras::strassen_fast_gemm, double>( m, n, k, 8, 1.0, 1.0 );
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( ans[idx] - expected[idx] ) <= bound );
+
+                // and through a plan of the tuner, with the fast algorithms allowed
+                unsigned long const fast_algorithms = ceras::gemm_fast_algorithms;
+                ceras::gemm_fast_algorithms = 1;
+                ceras::tensor<float> af{ {m, n} }, bf{ {n, k} }, expected_f{ {m, k} }, ans_f{ {m, k} };
+                std::copy_n( A.data(), m*n, af.data() );
+                std::copy_n( B.data(), n*k, bf.data() );
+                ceras::naive_gemm( af.data(), a_transposed, bf.data(), b_transposed, m, n, k, expected_f.data() );
+                ceras::run_gemm_plan( ceras::gemm_plan{ ceras::gemm_kernel::strassen, ceras::gemm_blocking{ 16, 8, 64 }, 16 }, af.data(), a_transposed, bf.data(), b_transposed, m, n, k, ans_f.data() );
+                ceras::gemm_fast_algorithms = fast_algorithms;
+                double const bound_f = ceras::fast_gemm_error_bound<ceras::strassen_fast_gemm, float>( m, n, k, 16, 1.0, 1.0 ) + 1.0e-5 * n;
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( ans_f[idx] - expected_f[idx] ) <= bound_f );
+            }
+}
@@ -0,0 +1,67 @@
+#include "../../include/tensor.hpp"
+
+TEST_CASE( "blocked_gemm", "[backend_gemm_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // odd sizes to exercise the partial register tiles; a small blocking to exercise every blocking loop
+    std::vector<std::tuple<size_t, size_t, size_t>> const shapes{ {1, 1, 1}, {3, 5, 7}, {17, 33, 65}, {67, 129, 43}, {128, 31, 257} };
+    ceras::gemm_blocking const small_blocking{ 16, 8, 64 };
+
+    for ( auto [m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+            {
+                auto A = ceras::random<float>( {m, n}, -1.0f, 1.0f );
+                auto B = ceras::random<float>( {n, k}, -1.0f, 1.0f );
+                ceras::tensor<float> expected{ {m, k} };
+                ceras::tensor<float> ans{ {m, k} };
+                ceras::naive_gemm( A.data(), a_transposed, B.data(), b_transposed, m, n, k, expected.data() );
+
+                size_t const lda = a_transposed ? m : n;
+                size_t const ldb = b_transposed ? n : k;
+                ceras::blocked_gemm( A.data(), lda, a_transposed, B.data(), ldb, b_transposed, m, n, k, ans.data(), k );
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-4f * n );
+
+                ans.reset( 123.0f );
+                ceras::blocked_gemm( A.data(), lda, a_transposed, B.data(), ldb, b_transposed, m, n, k, ans.data(), k, small_blocking );
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-4f * n );
+
+                auto dA = A.as_type<double>();
+                auto dB = B.as_type<double>();
+                ceras::tensor<double> d_ans{ {m, k} };
+                ceras::gemm_cpu( dA.data(), a_transposed, dB.data(), b_transposed, m, n, k, d_ans.data() );
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( d_ans[idx] - static_cast<double>(expected[idx]) ) < 1.0e-4 * n );
+            }
+}
+
+
+TEST_CASE( "parallel_gemm", "[backend_gemm_2]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // large enough to be split, with ragged tiles on both sides
+    std::vector<std::tuple<size_t, size_t, size_t>> const shapes{ {97, 130, 211}, {13, 257, 517}, {301, 64, 45} };
+
+    for ( auto [m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+                for ( size_t threads : {2UL, 3UL, 4UL, 7UL} )
+                {
+                    auto A = ceras::random<float>( {m, n}, -1.0f, 1.0f );
+                    auto B = ceras::random<float>( {n, k}, -1.0f, 1.0f );
+                    ceras::tensor<float> expected{ {m, k} };
+                    ceras::tensor<float> ans{ {m, k} };
+                    ceras::naive_gemm( A.data(), a_transposed, B.data(), b_transposed, m, n, k, expected.data() );
+
+                    size_t const lda = a_transposed ? m : n;
+                    size_t const ldb = b_transposed ? n : k;
+                    ceras::parallel_gemm( A.data(), lda, a_transposed, B.data(), ldb, b_transposed, m, n, k, ans.data(), k,
+                                          ceras::ceras_private::default_gemm_blocking<float>(), threads );
+                    for ( auto idx : ceras::range( m*k ) )
+                        REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-4f * n );
+                }
+}
@@ -0,0 +1,116 @@
+#include "../../include/tensor.hpp"
+
+TEST_CASE( "gemm_tuner", "[backend_gemm_tuner_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // no cache file by default, the plans of the test are kept in a temporary directory
+    REQUIRE( ceras::gemm_autotuning == 0 );
+    std::filesystem::path const directory = std::filesystem::temp_directory_path() / fmt::format( "ceras_test_gemm_tuning_{}", std::random_device{}() );
+    std::string const cache = ( directory / "gemm_tuning.txt" ).string();
+    std::string const original_cache = ceras::gemm_tuning_cache();
+    ceras::gemm_tuning_cache() = cache;
+    ceras::reset_gemm_tuning();
+
+    std::vector<std::tuple<size_t, size_t, size_t>> const shapes{ {3, 5, 7}, {37, 65, 129}, {130, 97, 61} };
+    for ( auto [m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+            {
+                auto const plan = ceras::tune_gemm<float>( m, n, k, a_transposed, b_transposed );
+                REQUIRE( plan.kernel >= ceras::gemm_kernel::naive );
+                REQUIRE( plan.kernel <= ceras::gemm_kernel::strassen );
+
+                // the later products of the bucket use the tuned plan, without timing
+                auto const found = ceras::find_gemm_plan<float>( m, n, k, a_transposed, b_transposed );
+                REQUIRE( found );
+                REQUIRE( found->kernel == plan.kernel );
+                REQUIRE( found->blocking.mc == plan.blocking.mc );
+                REQUIRE( found->blocking.kc == plan.blocking.kc );
+                REQUIRE( found->blocking.nc == plan.blocking.nc );
+
+                auto A = ceras::random<float>( {m, n}, -1.0f, 1.0f );
+                auto B = ceras::random<float>( {n, k}, -1.0f, 1.0f );
+                ceras::tensor<float> expected{ {m, k} };
+                ceras::tensor<float> ans{ {m, k} };
+                ceras::naive_gemm( A.data(), a_transposed, B.data(), b_transposed, m, n, k, expected.data() );
+                ceras::gemm( A.data(), a_transposed, B.data(), b_transposed, m, n, k, ans.data() );
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-4f * n );
+            }
+
+    // every kernel gives the same product
+    for ( auto kernel : { ceras::gemm_kernel::naive, ceras::gemm_kernel::blocked, ceras::gemm_kernel::threaded } )
+    {
+        size_t const m = 67, n = 129, k = 43;
+        auto A = ceras::random<double>( {m, n}, -1.0, 1.0 );
+        auto B = ceras::random<double>( {n, k}, -1.0, 1.0 );
+        ceras::tensor<double> expected{ {m, k} };
+        ceras::tensor<double> ans{ {m, k} };
+        ceras::naive_gemm( A.data(), false, B.data(), true, m, n, k, expected.data() );
+        ceras::run_gemm_plan( ceras::gemm_plan{ kernel, ceras::gemm_blocking{ 16, 8, 64 } }, A.data(), false, B.data(), true, m, n, k, ans.data() );
+        for ( auto idx : ceras::range( m*k ) )
+            REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-10 * n );
+    }
+
+    // a first product larger than the tuned dimensions keeps its plan in its own bucket, not in the bucket of the capped shape
+    REQUIRE( !ceras::find_gemm_plan<float>( 4100, 3, 5, false, false ) ); // not tuned unless autotuning
+    ceras::gemm_autotuning = 1;
+    REQUIRE( ceras::find_gemm_plan<float>( 4100, 3, 5, false, false ) );
+    ceras::gemm_autotuning = 0;
+    REQUIRE( ceras::find_gemm_plan<float>( 4100, 3, 5, false, false ) );
+
+    // the plans survive in the cache file
+    REQUIRE( std::filesystem::exists( cache ) );
+    ceras::reset_gemm_tuning();
+    REQUIRE( !ceras::find_gemm_plan<float>( 3, 5, 7, false, false ) );
+    REQUIRE( ceras::load_gemm_tuning( cache ) );
+    for ( auto [m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+                REQUIRE( ceras::find_gemm_plan<float>( m, n, k, a_transposed, b_transposed ) );
+
+    // a plan round-trips through its code at the limits of its fields, and a plan out of them is rejected rather than truncated
+    {
+        using ceras::ceras_private::encode_gemm_plan;
+        using ceras::ceras_private::decode_gemm_plan;
+        ceras::gemm_plan const largest{ ceras::gemm_kernel::strassen, ceras::gemm_blocking{ 4095, 4095, (1UL << 20) - 1 }, 65535 };
+        ceras::gemm_plan const smallest{ ceras::gemm_kernel::naive, ceras::gemm_blocking{ 1, 1, 1 }, 0 };
+        for ( auto const& plan : { largest, smallest } )
+        {
+            auto const decoded = decode_gemm_plan( encode_gemm_plan( plan ) );
+            REQUIRE( decoded.kernel == plan.kernel );
+            REQUIRE( decoded.blocking.mc == plan.blocking.mc );
+            REQUIRE( decoded.blocking.kc == plan.blocking.kc );
+            REQUIRE( decoded.blocking.nc == plan.blocking.nc );
+            REQUIRE( decoded.cutoff == plan.cutoff );
+        }
+        REQUIRE( encode_gemm_plan( ceras::gemm_plan{ ceras::gemm_kernel::blocked, ceras::gemm_blocking{ 4096, 256, 4096 } } ) == 0 );
+        REQUIRE( encode_gemm_plan( ceras::gemm_plan{ ceras::gemm_kernel::blocked, ceras::gemm_blocking{ 192, 4096, 4096 } } ) == 0 );
+        REQUIRE( encode_gemm_plan( ceras::gemm_plan{ ceras::gemm_kernel::blocked, ceras::gemm_blocking{ 192, 256, 1UL << 20 } } ) == 0 );
+        REQUIRE( encode_gemm_plan( ceras::gemm_plan{ ceras::gemm_kernel::strassen, ceras::gemm_blocking{ 192, 256, 4096 }, 1UL << 16 } ) == 0 );
+        REQUIRE( encode_gemm_plan( ceras::gemm_plan{ ceras::gemm_kernel::blocked, ceras::gemm_blocking{ 0, 256, 4096 } } ) == 0 );
+
+        // a cache line out of range is skipped, the lines in range loaded
+        ceras::reset_gemm_tuning();
+        {
+            std::ofstream ofs{ cache };
+            ofs << "float 0 0 0 0 0 blocked 192 4096 4096 0\n";
+            ofs << "float 0 0 0 0 1 blocked 192 256 1048576 0\n";
+            ofs << "float 0 0 0 1 0 blocked 4095 4095 1048575 0\n";
+        }
+        REQUIRE( ceras::load_gemm_tuning( cache ) );
+        REQUIRE( !ceras::find_gemm_plan<float>( 3, 5, 7, false, false ) );
+        REQUIRE( !ceras::find_gemm_plan<float>( 3, 5, 7, false, true ) );
+        auto const loaded = ceras::find_gemm_plan<float>( 3, 5, 7, true, false );
+        REQUIRE( loaded );
+        REQUIRE( loaded->blocking.kc == 4095 );
+        REQUIRE( loaded->blocking.nc == 1048575 );
+    }
+
+    std::filesystem::remove_all( directory );
+    ceras::gemm_tuning_cache() = original_cache;
+    ceras::reset_gemm_tuning();
+    ceras::load_gemm_tuning();
+}
+
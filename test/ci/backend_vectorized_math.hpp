@@ -0,0 +1,111 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "vectorized_math", "[backend_vectorized_math_1]" )
+{
+    // the error in ulps of `got` against a long double reference
+    auto const& ulp_error = []( float got, long double ref )
+    {
+        int exponent;
+        std::frexp( static_cast<double>( ref ), &exponent );
+        return static_cast<double>( std::abs( static_cast<long double>( got ) - ref ) / std::ldexp( 1.0L, exponent - 24 ) );
+    };
+
+    // the documented error bounds for -Ofast, over a sweep of the range, for the vectorized body and for the scalar tail
+    auto const& check = [&ulp_error]( float lo, float hi, double max_ulp, auto const& func, auto const& reference )
+    {
+        size_t const n = 1000003; // not a multiple of the pack width
+        std::vector<float> x( n ), y( n );
+        for ( auto idx : ceras::range( n ) )
+            x[idx] = lo + ( hi - lo ) * static_cast<float>( idx ) / static_cast<float>( n );
+        ceras::vectorized_map( x.data(), y.data(), n, func );
+
+        double worst = 0.0;
+        for ( auto idx : ceras::range( n ) )
+        {
+            long double const ref = reference( static_cast<long double>( x[idx] ) );
+            worst = std::max( worst, ulp_error( y[idx], ref ) );
+            worst = std::max( worst, ulp_error( func( ceras::vmath::pack<float>{ x[idx] } ).v_, ref ) );
+        }
+        REQUIRE( worst <= max_ulp );
+    };
+
+    auto const& sigmoid = []( long double x ) { return 1.0L / ( 1.0L + std::exp( -x ) ); };
+    auto const& gelu = [&sigmoid]( long double x ) { return x * sigmoid( 2.0L * 0.79788456080286535588L * ( x + 0.044715L * x * x * x ) ); };
+
+    check( -87.0f, 88.0f, 1.01, []( auto x ){ return ceras::vmath::exp( x ); }, []( long double x ){ return std::exp( x ); } );
+    check( 1.0e-30f, 1.0e30f, 0.83, []( auto x ){ return ceras::vmath::log( x ); }, []( long double x ){ return std::log( x ); } );
+    check( 0.5f, 2.0f, 0.83, []( auto x ){ return ceras::vmath::log( x ); }, []( long double x ){ return std::log( x ); } );
+    check( -12.0f, 12.0f, 1.70, []( auto x ){ return ceras::vmath::tanh( x ); }, []( long double x ){ return std::tanh( x ); } );
+    check( -5.0f, 5.0f, 1.18, []( auto x ){ return ceras::vmath::erf( x ); }, []( long double x ){ return std::erf( x ); } );
+    check( -80.0f, 30.0f, 3.42, []( auto x ){ return ceras::vmath::sigmoid( x ); }, sigmoid );
+    check( 0.0f, 100.0f, 3.24, []( auto x ){ return ceras::vmath::gelu( x ); }, gelu );
+    check( -1.0f, 0.0f, 4.24, []( auto x ){ return ceras::vmath::gelu( x ); }, gelu );
+
+    // saturation and the ends of the ranges
+    std::vector<float> const x{ -200.0f, -104.5f, 0.0f, 1.0f, 50.0f, 200.0f };
+    std::vector<float> y( x.size() );
+    ceras::vectorized_map( x.data(), y.data(), x.size(), []( auto v ){ return ceras::vmath::exp( v ); } );
+    REQUIRE( y[0] == 0.0f );
+    REQUIRE( y[1] == 0.0f );
+    REQUIRE( y[2] == 1.0f );
+    REQUIRE( y[5] > std::numeric_limits<float>::max() );
+    ceras::vectorized_map( x.data(), y.data(), x.size(), []( auto v ){ return ceras::vmath::tanh( v ); } );
+    REQUIRE( y[0] == -1.0f );
+    REQUIRE( y[4] == 1.0f );
+    ceras::vectorized_map( x.data(), y.data(), x.size(), []( auto v ){ return ceras::vmath::erf( v ); } );
+    REQUIRE( y[0] == -1.0f );
+    REQUIRE( y[4] == 1.0f );
+    ceras::vectorized_map( x.data(), y.data(), x.size(), []( auto v ){ return ceras::vmath::sigmoid( v ); } );
+    REQUIRE( y[0] == 0.0f );
+    REQUIRE( y[2] == 0.5f );
+    REQUIRE( y[5] == 1.0f );
+    ceras::vectorized_map( x.data() + 3, y.data(), 3, []( auto v ){ return ceras::vmath::log( v ); } );
+    REQUIRE( y[0] == 0.0f );
+}
+
+TEST_CASE( "vectorized_activations", "[backend_vectorized_math_2]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // forward and backward passes against the closed forms, in float and in double
+    auto const& check = []<typename T>( T, auto const& maker, auto const& forward, auto const& derivative, T tolerance )
+    {
+        auto x = ceras::variable{ ceras::random<T>( {17, 33}, T{-6}, T{6} ) };
+        auto grad = ceras::random<T>( {17, 33}, T{-1}, T{1} );
+        ceras::get_default_session<ceras::tensor<T>>().clear_forward_cache();
+        auto ex = maker( x );
+        auto const output = ex.forward();
+        ex.backward( grad );
+        auto const xs = x.data();
+        for ( auto idx : ceras::range( xs.size() ) )
+        {
+            long double const v = xs[idx];
+            REQUIRE( std::abs( output[idx] - forward( v ) ) <= tolerance * ( 1.0L + std::abs( forward( v ) ) ) );
+            REQUIRE( std::abs( x.gradient()[idx] - grad[idx] * derivative( v ) ) <= tolerance * ( 1.0L + std::abs( derivative( v ) ) ) );
+        }
+    };
+
+    auto const& sigmoid = []( long double x ) { return 1.0L / ( 1.0L + std::exp( -x ) ); };
+    auto const& gelu = [&sigmoid]( long double x ) { return x * sigmoid( 2.0L * 0.79788456080286535588L * ( x + 0.044715L * x * x * x ) ); };
+    auto const& gelu_derivative = []( long double x )
+    {
+        long double const t = std::tanh( 0.79788456080286535588L * ( x + 0.044715L * x * x * x ) );
+        return 0.5L * ( 1.0L + t ) + 0.5L * x * ( 1.0L - t * t ) * 0.79788456080286535588L * ( 1.0L + 3.0L * 0.044715L * x * x );
+    };
+    auto const& softplus = []( long double x ) { return std::log1p( std::exp( x ) ); };
+    auto const& elu = []( long double x ) { return x > 0.0L ? x : 0.5L * ( std::exp( x ) - 1.0L ); };
+    auto const& elu_derivative = []( long double x ) { return x >= 0.0L ? 1.0L : 0.5L * std::exp( x ); };
+
+    auto const& run = [&]<typename T>( T tolerance )
+    {
+        check( T{}, []( auto const& x ){ return ceras::gelu( x ); }, gelu, gelu_derivative, tolerance );
+        check( T{}, []( auto const& x ){ return ceras::sigmoid( x ); }, sigmoid, [&]( long double x ){ return sigmoid( x ) * ( 1.0L - sigmoid( x ) ); }, tolerance );
+        check( T{}, []( auto const& x ){ return ceras::softplus( x ); }, softplus, sigmoid, tolerance );
+        check( T{}, []( auto const& x ){ return ceras::elu( T{0.5} )( x ); }, elu, elu_derivative, tolerance );
+        check( T{}, []( auto const& x ){ return ceras::tanh( x ); }, []( long double x ){ return std::tanh( x ); }, []( long double x ){ return 1.0L - std::tanh( x ) * std::tanh( x ); }, tolerance );
+        check( T{}, []( auto const& x ){ return ceras::erf( x ); }, []( long double x ){ return std::erf( x ); }, []( long double x ){ return 1.12837916709551257389L * std::exp( -x * x ); }, tolerance );
+        check( T{}, []( auto const& x ){ return ceras::exp( x ); }, []( long double x ){ return std::exp( x ); }, []( long double x ){ return std::exp( x ); }, tolerance );
+    };
+    run.template operator()<float>( 1.0e-6f );
+    run.template operator()<double>( 1.0e-14 );
+}
@@ -0,0 +1,97 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "elementwise_fusion", "[elementwise_fusion_1]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    auto const& same = []( auto const& x, auto const& y )
+    {
+        REQUIRE( x.shape() == y.shape() );
+        bool ok = true;
+        for ( auto idx : range( x.size() ) )
+            ok = ok && ( std::abs( x[idx] - y[idx] ) <= 1.0e-4f * ( 1.0f + std::abs( y[idx] ) ) );
+        REQUIRE( ok );
+    };
+
+    // the fused plan of an expression computes the output and the gradients of the unfused one, the nodes inside its chains aside,
+    // and gives these nodes no output unless the shapes do not fit
+    auto const& check = [&same]( auto const& ex, std::vector<std::vector<size_t>> const& chains, bool fit = true )
+    {
+        auto unfused = compile_plan( ex );
+        auto const expected = unfused.forward().deep_copy();
+        auto const grad = random<float>( expected.shape(), -1.0f, 1.0f );
+        unfused.backward( grad );
+        std::vector<tensor<float>> gradients;
+        for ( auto const& gradient : unfused.gradients_ )
+            gradients.push_back( gradient.deep_copy() );
+
+        auto fused = compile_plan( ex );
+        fuse_elementwise( fused );
+        REQUIRE( fused.fused_ == chains );
+        same( fused.forward(), expected );
+        fused.backward( grad );
+        std::vector<char> inside( fused.size(), 0 );
+        for ( auto const& nodes : chains )
+            std::for_each( nodes.begin(), nodes.end() - 1, [&inside]( size_t node ) { inside[node] = 1; } );
+        for ( auto node : range( fused.size() ) )
+            if ( !inside[node] )
+                same( fused.gradients_[node], gradients[node] );
+            else
+                REQUIRE( fused.outputs_[node].empty() == fit );
+        return fused;
+    };
+
+    // relu( x*w + b ): the plus and the relu, reading the product and the bias broadcast to it
+    {
+        auto x = place_holder<tensor<float>>{};
+        auto w = variable{ random<float>( {32, 64}, -0.5f, 0.5f ) };
+        auto b = variable{ random<float>( {1, 64}, -0.5f, 0.5f ) };
+        x.bind( random<float>( {40, 32}, -1.0f, 1.0f ) );
+        auto plan = check( relu( x * w + b ), { {4, 5} } ); // x, w, the product, b, the plus and the relu
+        // the plus writes no buffer of its own, and the output of the relu is returned, not planned
+        REQUIRE( plan_memory( plan, false ).buffers_.size() == 1 );
+    }
+
+    // sigmoid( a ) * tanh( c ), in blocks with a tail, and in tasks on the thread pool
+    for ( auto const& shape : { std::vector<size_t>{ 7, 300 }, std::vector<size_t>{ 300, 200 } } )
+    {
+        auto a = variable{ random<float>( shape, -3.0f, 3.0f ) };
+        auto c = variable{ random<float>( shape, -3.0f, 3.0f ) };
+        check( elementwise_product( sigmoid( a ), tanh( c ) ), { {1, 3, 4} } );
+    }
+
+    // mse: the product by 2, the negative, the plus, the square and the mean_reduce
+    for ( auto const& shape : { std::vector<size_t>{ 33, 10 }, std::vector<size_t>{ 500, 100 } } )
+    {
+        auto y = place_holder<tensor<float>>{};
+        auto p = variable{ random<float>( shape, -1.0f, 1.0f ) };
+        y.bind( random<float>( shape, -1.0f, 1.0f ) );
+        check( mse( y, p * 2.0f ), { {2, 3, 4, 5, 6} } ); // y, p, and the arithmetic multiply in the chain
+    }
+
+    // an operand used twice and a scalar, as in ( a + 1 ) * ( a + 1 ) reduced to a sum
+    {
+        auto a = variable{ random<float>( {9, 130}, -1.0f, 1.0f ) };
+        auto d = a + 1.0f;
+        check( sum_reduce( elementwise_product( d, d ) ), { {1, 2, 3} } );
+    }
+
+    // operands broadcast to each other: the unfused steps
+    {
+        auto a = variable{ random<float>( {3, 1}, -1.0f, 1.0f ) };
+        auto c = variable{ random<float>( {1, 4}, -1.0f, 1.0f ) };
+        check( relu( a + c ), { {2, 3} }, false );
+    }
+
+    // the plans of a session are fused
+    {
+        auto a = variable{ random<float>( {4, 5}, -1.0f, 1.0f ) };
+        auto y = sigmoid( relu( a ) );
+        auto& s = get_default_session<tensor<float>>();
+        auto const output = s.run( y );
+        REQUIRE( s.plan( y ).fused_.size() == 1 );
+        same( output, compile_plan( y ).forward() );
+    }
+}
+
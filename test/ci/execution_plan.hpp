@@ -0,0 +1,146 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "execution_plan", "[execution_plan_1]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    auto const& same = []( auto const& x, auto const& y )
+    {
+        REQUIRE( x.shape() == y.shape() );
+        bool ok = true;
+        for ( auto idx : range( x.size() ) )
+            ok = ok && ( std::abs( x[idx] - y[idx] ) < 1.0e-4f );
+        REQUIRE( ok );
+    };
+
+    // the product is read by both the sigmoid and the plus, the value is not a node
+    auto x = place_holder<tensor<float>>{};
+    auto w = variable{ random<float>( {5, 4}, -1.0f, 1.0f ) };
+    auto b = variable{ random<float>( {1, 4}, -1.0f, 1.0f ) };
+    auto p = x * w;
+    auto y = sigmoid( p ) + ( p + b ) * value<float>{ 2.0f };
+
+    auto plan = compile_plan( y );
+    REQUIRE( plan.size() == 8 );
+    REQUIRE( plan.ids_.back() == y.id() );
+    REQUIRE( std::count( plan.ids_.begin(), plan.ids_.end(), p.id() ) == 1 );
+    for ( auto node : range( plan.size() ) )
+        for ( auto input : plan.inputs_[node] )
+            REQUIRE( input < node );
+
+    auto& s = get_default_session<tensor<float>>();
+    auto const input = random<float>( {3, 5}, -1.0f, 1.0f );
+    auto const grad = random<float>( {3, 4}, -1.0f, 1.0f );
+    s.bind( x, input );
+
+    // the output and the gradients worked out by hand, the product getting the gradients of both the sigmoid and the plus
+    tensor<float> expected{ {3, 4} }, w_gradient{ {5, 4} }, b_gradient{ {1, 4} };
+    for ( auto r : range( 3UL ) )
+        for ( auto c : range( 4UL ) )
+        {
+            float product = 0.0f;
+            for ( auto k : range( 5UL ) )
+                product += input[r*5+k] * w.data()[k*4+c];
+            float const sig = 1.0f / ( 1.0f + std::exp( -product ) );
+            float const g = grad[r*4+c];
+            expected[r*4+c] = sig + 2.0f * ( product + b.data()[c] );
+            for ( auto k : range( 5UL ) )
+                w_gradient[k*4+c] += input[r*5+k] * ( g * sig * ( 1.0f - sig ) + 2.0f * g );
+            b_gradient[c] += 2.0f * g;
+        }
+
+    same( plan.forward(), expected );
+    plan.backward( grad );
+    same( w.gradient(), w_gradient );
+    same( b.gradient(), b_gradient );
+
+    // the session compiles an expression once, a copy of it sharing its plan
+    same( s.run( y ), expected );
+    auto const* const compiled = &s.plan( y );
+    auto z = y;
+    same( s.run( z ), expected );
+    REQUIRE( &s.plan( z ) == compiled );
+    REQUIRE( s.plan( y ).size() == 8 );
+
+    // the backward of an operator runs the backward steps of its plan
+    y.backward( grad );
+    same( w.gradient(), w_gradient );
+    same( b.gradient(), b_gradient );
+}
+
+TEST_CASE( "execution_plan_training", "[execution_plan_2]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // a linear regression trained through the session
+    auto const truth = random<float>( {6, 2}, -1.0f, 1.0f );
+    auto x = place_holder<tensor<float>>{};
+    auto t = place_holder<tensor<float>>{};
+    auto w = variable{ zeros<float>( {6, 2} ) };
+    auto loss = mean_squared_error( x * w, t );
+    auto optimizer = Adam( 1UL, 5.0e-2f )( loss );
+
+    auto& s = get_default_session<tensor<float>>();
+    float first = 0.0f, last = 0.0f;
+    for ( auto step : range( 200 ) )
+    {
+        auto const input = random<float>( {32, 6}, -1.0f, 1.0f );
+        s.bind( x, input );
+        s.bind( t, input * truth );
+        last = s.run( loss )[0];
+        if ( step == 0 )
+            first = last;
+        s.run( optimizer );
+    }
+    REQUIRE( last < first * 0.05f );
+}
+
+TEST_CASE( "execution_plan_backward", "[execution_plan_3]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // an identity counting its backward passes
+    int count = 0;
+    auto x = variable{ random<float>( {3, 4}, -1.0f, 1.0f ) };
+    auto c = make_unary_operator( []<Tensor Tsor>( Tsor const& input ) { return input; },
+                                  [&count]<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) { ++count; return grad; }, "counted" )( x );
+
+    // doubling 24 times, the sum of two copies of the same node: 2^24 paths from the output to `c`
+    auto const& twice = []( auto const& ex ) { return ex + ex; };
+    auto y = twice( twice( twice( twice( twice( twice( twice( twice( twice( twice( twice( twice(
+             twice( twice( twice( twice( twice( twice( twice( twice( twice( twice( twice( twice( c ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) ) );
+
+    auto& s = get_default_session<tensor<float>>();
+    s.run( y );
+    REQUIRE( s.plan( y ).size() == 26 );
+    auto const grad = random<float>( {3, 4}, -1.0f, 1.0f );
+    y.backward( grad );
+
+    // the backward action of `c` runs once, given the sum of the gradients of all the paths
+    REQUIRE( count == 1 );
+    bool ok = true;
+    for ( auto idx : range( grad.size() ) )
+        ok = ok && ( std::abs( x.gradient()[idx] - 16777216.0f * grad[idx] ) <= 1.0e-5f * std::abs( 16777216.0f * grad[idx] ) );
+    REQUIRE( ok );
+
+    // a node read four times, unfused: its second gradient summed into its accumulation buffer, the third and the fourth added there in place
+    auto v = variable{ random<float>( {3, 4}, -1.0f, 1.0f ) };
+    auto u = square( v );
+    auto z = u + u + u + u;
+    auto plan = compile_plan( z );
+    REQUIRE( plan.names_[1] == "square" );
+    for ( [[maybe_unused]] auto pass : range( 2 ) )
+    {
+        plan.forward();
+        plan.backward( grad );
+        REQUIRE( plan.gradients_[1].data() == plan.accumulations_[1].data() );
+        bool sum_ok = true;
+        for ( auto idx : range( grad.size() ) )
+            sum_ok = sum_ok && ( std::abs( plan.gradients_[1][idx] - 4.0f * grad[idx] ) <= 1.0e-6f );
+        REQUIRE( sum_ok );
+    }
+}
+
@@ -0,0 +1,121 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "memory_plan", "[memory_plan_1]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // no two buffers live in a same step share a byte
+    auto const& valid = []( memory_plan const& memory )
+    {
+        bool ok = true;
+        for ( auto const& a : memory.buffers_ )
+        {
+            ok = ok && ( a.offset_ % memory_alignment == 0 ) && ( a.offset_ + a.size_ <= memory.arena_size_ );
+            for ( auto const& b : memory.buffers_ )
+                if ( ( &a != &b ) && memory_plan::overlap( a, b ) )
+                    ok = ok && ( a.offset_ + a.size_ <= b.offset_ || b.offset_ + b.size_ <= a.offset_ );
+        }
+        REQUIRE( ok );
+        REQUIRE( memory.arena_size_ <= memory.naive_size_ );
+    };
+
+    // a chain: two buffers at a time in inference
+    {
+        auto x = variable{ random<float>( {10, 100} ) };
+        auto y = relu( relu( relu( relu( relu( relu( relu( relu( x ) ) ) ) ) ) ) );
+        auto const plan = compile_plan( y );
+        auto const& inference = plan_memory( plan, false );
+        valid( inference );
+        REQUIRE( inference.buffers_.size() == 7 ); // the output of the expression returned, not planned
+        REQUIRE( inference.naive_size_ == 7 * 4032 );
+        REQUIRE( inference.arena_size_ == 2 * 4032 );
+
+        // training keeps the activations to the backward pass
+        auto const& training = plan_memory( plan );
+        valid( training );
+        REQUIRE( training.buffers_.size() == 7 + 8 );
+        REQUIRE( training.arena_size_ > inference.arena_size_ );
+        REQUIRE( training.arena_size_ < training.naive_size_ );
+    }
+
+    // a small unet from the static shapes, the skip connections live across the bottleneck
+    {
+        auto input = Input( {32, 32, 3} );
+        auto l0 = relu( Conv2D( 8, {3, 3}, "same" )( input ) );
+        auto l1 = max_pooling_2d( 2 )( l0 );
+        auto l2 = relu( Conv2D( 16, {3, 3}, "same" )( l1 ) );
+        auto l3 = max_pooling_2d( 2 )( l2 );
+        auto l4 = relu( Conv2D( 16, {3, 3}, "same" )( l3 ) );
+        auto l5 = l2 + relu( Conv2D( 16, {3, 3}, "same" )( up_sampling_2d( 2 )( l4 ) ) );
+        auto l6 = l0 + relu( Conv2D( 8, {3, 3}, "same" )( up_sampling_2d( 2 )( l5 ) ) );
+        auto output = sigmoid( Conv2D( 3, {3, 3}, "same" )( l6 ) );
+
+        auto const plan = compile_plan( output );
+        REQUIRE( plan.shapes_.back() == std::vector<size_t>{ {1, 32, 32, 3} } );
+        auto const& inference = plan_memory( plan, false );
+        valid( inference );
+        REQUIRE( inference.arena_size_ * 2 < inference.naive_size_ );
+        valid( plan_memory( plan ) );
+
+        // the sizes of the outputs once run
+        auto& s = get_default_session<tensor<float>>();
+        s.bind( input, random<float>( {2, 32, 32, 3} ) );
+        auto& run = s.plan( output );
+        s.run( output );
+        auto const& batched = plan_memory( run, false );
+        valid( batched );
+        REQUIRE( batched.arena_size_ > inference.arena_size_ );
+    }
+
+    // the buffers moved to the arena: the same output and gradients at the next passes, written to the slots planned
+    {
+        auto x = variable{ random<float>( {2, 8, 8, 3}, -1.0f, 1.0f ) };
+        auto k0 = variable{ random<float>( {4, 3, 3, 3}, -0.5f, 0.5f ) };
+        auto k1 = variable{ random<float>( {4, 3, 3, 4}, -0.5f, 0.5f ) };
+        auto w = variable{ random<float>( {256, 5}, -0.5f, 0.5f ) };
+        auto b = variable{ random<float>( {1, 5}, -0.5f, 0.5f ) };
+        auto l0 = relu( conv2d( 8, 8, 1, 1, 1, 1, "same" )( x, k0 ) );
+        auto l1 = max_pooling_2d( 2 )( l0 );
+        auto l2 = l1 + relu( conv2d( 4, 4, 1, 1, 1, 1, "same" )( l1, k1 ) );
+        auto output = sigmoid( dense()( flatten( up_sampling_2d( 2 )( l2 ) ), w, b ) );
+
+        auto plan = compile_plan( output );
+        fuse_elementwise( plan );
+        std::vector<variable<tensor<float>>> variables{ x, k0, k1, w, b };
+        auto const& pass = [&]()
+        {
+            for ( auto& v : variables )
+                v.gradient().reset();
+            std::vector<tensor<float>> ans{ plan.forward().deep_copy() };
+            plan.backward( ones<float>( ans[0].shape() ) );
+            for ( auto& v : variables )
+                ans.push_back( v.gradient().deep_copy() );
+            return ans;
+        };
+        auto const& expected = pass();
+
+        auto const& memory = allocate_memory( plan );
+        valid( memory );
+        REQUIRE( memory.arena_ );
+        REQUIRE( memory.arena_size_ < memory.naive_size_ );
+        REQUIRE( std::any_of( memory.buffers_.begin(), memory.buffers_.end(), []( auto const& buffer ) { return !buffer.aliases_.empty(); } ) );
+
+        for ( [[maybe_unused]] auto repeat : range( 2 ) )
+        {
+            auto const& current = pass();
+            REQUIRE( current.size() == expected.size() );
+            for ( auto idx : range( expected.size() ) )
+            {
+                REQUIRE( current[idx].shape() == expected[idx].shape() );
+                REQUIRE( std::equal( current[idx].begin(), current[idx].end(), expected[idx].begin() ) );
+            }
+            for ( auto const& buffer : memory.buffers_ )
+            {
+                auto const& tsor = buffer.gradient_ ? plan.gradients_[buffer.node_] : plan.outputs_[buffer.node_];
+                REQUIRE( reinterpret_cast<std::byte const*>( tsor.data() ) == memory.arena_.get() + buffer.offset_ );
+            }
+        }
+    }
+}
+
@@ -0,0 +1,79 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "batched_gemm", "[batched_gemm_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    std::vector<std::tuple<size_t, size_t, size_t, size_t>> const shapes{ {1, 3, 5, 7}, {7, 4, 4, 4}, {5, 17, 33, 9}, {3, 67, 129, 43} };
+
+    for ( auto [bs, m, n, k] : shapes )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+                for ( bool a_shared : {false, true} )
+                    for ( bool b_shared : {false, true} )
+                    {
+                        auto A = ceras::random<double>( {a_shared ? 1 : bs, m, n}, -1.0, 1.0 );
+                        auto B = ceras::random<double>( {b_shared ? 1 : bs, n, k}, -1.0, 1.0 );
+                        size_t const stride_a = a_shared ? 0 : m*n;
+                        size_t const stride_b = b_shared ? 0 : n*k;
+
+                        ceras::tensor<double> expected{ {bs, m, k} };
+                        for ( auto idx : ceras::range( bs ) )
+                            ceras::naive_gemm( A.data()+idx*stride_a, a_transposed, B.data()+idx*stride_b, b_transposed, m, n, k, expected.data()+idx*m*k );
+
+                        ceras::tensor<double> ans{ {bs, m, k} };
+                        ceras::batched_gemm( A.data(), stride_a, a_transposed, B.data(), stride_b, b_transposed, bs, m, n, k, ans.data(), m*k );
+                        for ( auto idx : ceras::range( ans.size() ) )
+                            REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-10 * n );
+                    }
+}
+
+TEST_CASE( "batch_matmul", "[batch_matmul_1]" )
+{
+    ceras::random_generator.seed( 42 );
+    size_t const bs = 3, m = 5, n = 7, k = 4;
+
+    // 0: both batched, 1: lhs shared, 2: rhs shared
+    for ( int mode : {0, 1, 2} )
+    {
+        auto const& lhs_shape = ( mode == 1 ) ? std::vector<size_t>{ m, n } : std::vector<size_t>{ bs, m, n };
+        auto const& rhs_shape = ( mode == 2 ) ? std::vector<size_t>{ n, k } : std::vector<size_t>{ bs, n, k };
+        auto a = ceras::variable{ ceras::random<double>( lhs_shape, -1.0, 1.0 ) };
+        auto b = ceras::variable{ ceras::random<double>( rhs_shape, -1.0, 1.0 ) };
+        auto ab = ceras::batch_matmul( a, b );
+
+        auto const& output = ab.forward();
+        REQUIRE( output.shape() == std::vector<size_t>{ bs, m, k } );
+
+        auto const& A = a.data();
+        auto const& B = b.data();
+        auto const& lhs_at = [&]( size_t s, size_t r, size_t c ){ return A[(mode == 1 ? 0 : s*m*n) + r*n + c]; };
+        auto const& rhs_at = [&]( size_t s, size_t r, size_t c ){ return B[(mode == 2 ? 0 : s*n*k) + r*k + c]; };
+
+        for ( auto s : ceras::range( bs ) )
+            for ( auto r : ceras::range( m ) )
+                for ( auto c : ceras::range( k ) )
+                {
+                    double acc = 0.0;
+                    for ( auto j : ceras::range( n ) )
+                        acc += lhs_at( s, r, j ) * rhs_at( s, j, c );
+                    REQUIRE( std::abs( output[(s*m+r)*k+c] - acc ) < 1.0e-10 );
+                }
+
+        // d(sum(ab))/da = sum over columns of b, d(sum(ab))/db = sum over rows of a
+        ab.backward( ceras::ones<double>( {bs, m, k} ) );
+        std::vector<double> expected_a( A.size(), 0.0 ), expected_b( B.size(), 0.0 );
+        for ( auto s : ceras::range( bs ) )
+            for ( auto r : ceras::range( m ) )
+                for ( auto j : ceras::range( n ) )
+                    for ( auto c : ceras::range( k ) )
+                    {
+                        expected_a[(mode == 1 ? 0 : s*m*n) + r*n + j] += rhs_at( s, j, c );
+                        expected_b[(mode == 2 ? 0 : s*n*k) + j*k + c] += lhs_at( s, r, j );
+                    }
+        for ( auto idx : ceras::range( A.size() ) )
+            REQUIRE( std::abs( a.gradient()[idx] - expected_a[idx] ) < 1.0e-10 );
+        for ( auto idx : ceras::range( B.size() ) )
+            REQUIRE( std::abs( b.gradient()[idx] - expected_b[idx] ) < 1.0e-10 );
+    }
+}
@@ -0,0 +1,75 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "dense", "[dense_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    auto const& check = []( auto const& fused_maker, auto const& reference_maker, size_t m, size_t n, size_t k )
+    {
+        auto x = ceras::variable{ ceras::random<float>( {m, n}, -1.0f, 1.0f ) };
+        auto w = ceras::variable{ ceras::random<float>( {n, k}, -1.0f, 1.0f ) };
+        auto b = ceras::variable{ ceras::random<float>( {1, k}, -1.0f, 1.0f ) };
+        auto grad = ceras::random<float>( {m, k}, -1.0f, 1.0f );
+
+        auto fused = fused_maker( x, w, b );
+        auto const fused_output = fused.forward().deep_copy();
+        fused.backward( grad );
+        auto const x_grad = x.gradient().deep_copy();
+        auto const w_grad = w.gradient().deep_copy();
+        auto const b_grad = b.gradient().deep_copy();
+
+        auto reference = reference_maker( x, w, b );
+        auto const reference_output = reference.forward(); // also zeros the gradients of the variables
+        reference.backward( grad );
+
+        REQUIRE( fused_output.shape() == reference_output.shape() );
+        for ( auto idx : ceras::range( fused_output.size() ) )
+            REQUIRE( std::abs( fused_output[idx] - reference_output[idx] ) < 1.0e-4f * n );
+        for ( auto idx : ceras::range( x_grad.size() ) )
+            REQUIRE( std::abs( x_grad[idx] - x.gradient()[idx] ) < 1.0e-4f * k );
+        for ( auto idx : ceras::range( w_grad.size() ) )
+            REQUIRE( std::abs( w_grad[idx] - w.gradient()[idx] ) < 1.0e-4f * m );
+        for ( auto idx : ceras::range( b_grad.size() ) )
+            REQUIRE( std::abs( b_grad[idx] - b.gradient()[idx] ) < 1.0e-4f * m );
+    };
+
+    // small shapes take the plain loop, larger ones the blocked engine with its tile epilogue
+    for ( auto [m, n, k] : std::vector<std::tuple<size_t, size_t, size_t>>{ {3, 5, 7}, {37, 65, 129} } )
+    {
+        check( []( auto x, auto w, auto b ){ return ceras::dense()( x, w, b ); }, []( auto x, auto w, auto b ){ return x * w + b; }, m, n, k );
+        check( []( auto x, auto w, auto b ){ return ceras::dense( "relu" )( x, w, b ); }, []( auto x, auto w, auto b ){ return ceras::relu( x * w + b ); }, m, n, k );
+        check( []( auto x, auto w, auto b ){ return ceras::dense( "sigmoid" )( x, w, b ); }, []( auto x, auto w, auto b ){ return ceras::sigmoid( x * w + b ); }, m, n, k );
+        check( []( auto x, auto w, auto b ){ return ceras::dense( "tanh" )( x, w, b ); }, []( auto x, auto w, auto b ){ return ceras::tanh( x * w + b ); }, m, n, k );
+    }
+
+    // the weights and the bias are nodes of the plan, read in place by the dense operator through the parameters node
+    {
+        auto x = ceras::place_holder<ceras::tensor<float>>{};
+        auto w = ceras::variable{ ceras::random<float>( {5, 7}, -1.0f, 1.0f ) };
+        auto b = ceras::variable{ ceras::random<float>( {7,}, -1.0f, 1.0f ) };
+        x.bind( ceras::random<float>( {3, 5}, -1.0f, 1.0f ) );
+        auto y = ceras::dense( "relu" )( x, w, b );
+        auto plan = ceras::compile_plan( y );
+        REQUIRE( plan.size() == 5 ); // x, w, b, the parameters and the dense
+        REQUIRE( std::count( plan.names_.begin(), plan.names_.end(), "dense_parameters" ) == 1 );
+        REQUIRE( std::count( plan.ids_.begin(), plan.ids_.end(), b.id() ) == 1 );
+        REQUIRE( plan.names_[3] == "dense_parameters" );
+        REQUIRE( plan.shapes_[3] == std::vector<size_t>{ {5, 7} } );
+
+        // the parameters node outputs the weights without copying them, and gets the bias gradient as the last row of its packed gradient
+        auto const output = plan.forward();
+        REQUIRE( output.shape() == std::vector<size_t>{ {3, 7} } );
+        REQUIRE( plan.outputs_[3].data() == w.data().data() );
+        plan.backward( ceras::ones<float>( {3, 7} ) );
+        REQUIRE( plan.gradients_[1].shape() == w.data().shape() );
+        REQUIRE( plan.gradients_[2].shape() == b.data().shape() );
+        for ( auto idx : ceras::range( 7 ) )
+        {
+            float expected = 0.0f;
+            for ( auto r : ceras::range( 3 ) )
+                expected += ( output[r*7+idx] > 0.0f ) ? 1.0f : 0.0f;
+            REQUIRE( plan.gradients_[2][idx] == expected );
+            REQUIRE( plan.gradients_[3][5*7+idx] == expected );
+        }
+    }
+}
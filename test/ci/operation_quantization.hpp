@@ -0,0 +1,157 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "int8_gemm", "[quantization_1]" )
+{
+    ceras::random_generator.seed( 42 );
+    std::uniform_int_distribution<int> byte( 0, 255 );
+
+    // the integer products are exact, with any zero point of A, on the tails of every dimension
+    for ( auto [m, n, k] : std::vector<std::tuple<size_t, size_t, size_t>>{ {1, 1, 1}, {7, 13, 67}, {33, 130, 129}, {70, 1152, 64} } )
+        for ( bool b_transposed : {false, true} )
+        {
+            std::vector<std::uint8_t> A( m*n );
+            std::vector<std::int8_t> B( n*k );
+            for ( auto& a : A ) a = static_cast<std::uint8_t>( byte( ceras::random_generator ) );
+            for ( auto& b : B ) b = static_cast<std::int8_t>( byte( ceras::random_generator ) % 255 - 127 );
+            std::int32_t const zero_point = byte( ceras::random_generator );
+
+            std::vector<std::int32_t> C( m*k );
+            size_t epilogue_rows = 0;
+            ceras::int8_gemm( A.data(), m, ceras::pack_int8( B.data(), b_transposed, n, k ), zero_point, C.data(),
+                              [&]( std::int32_t*, size_t ldc, size_t, size_t col, size_t rows, size_t cols ){ REQUIRE( ldc == k ); REQUIRE( col == 0 ); REQUIRE( cols == k ); epilogue_rows += rows; } );
+            REQUIRE( epilogue_rows == m );
+            for ( auto i : ceras::range( m ) )
+                for ( auto j : ceras::range( k ) )
+                {
+                    std::int32_t expected = 0;
+                    for ( auto p : ceras::range( n ) )
+                        expected += ( static_cast<std::int32_t>( A[i*n+p] ) - zero_point ) * ( b_transposed ? B[j*n+p] : B[p*k+j] );
+                    REQUIRE( C[i*k+j] == expected );
+                }
+        }
+
+    // within half a scale, per tensor and per channel
+    auto const x = ceras::random<float>( {16, 64}, -1.0f, 3.0f );
+    auto const qx = ceras::quantize<std::uint8_t>( x );
+    REQUIRE( !qx.per_channel() );
+    REQUIRE( qx.zero_points_[0] == static_cast<std::int32_t>( std::nearbyint( -*std::min_element( x.begin(), x.end() ) / qx.scales_[0] ) ) );
+    auto const dx = ceras::dequantize( qx );
+    for ( auto idx : ceras::range( x.size() ) )
+        REQUIRE( std::abs( dx[idx] - x[idx] ) <= 0.5001f * qx.scales_[0] );
+
+    auto w = ceras::random<float>( {20, 30}, -1.0f, 1.0f );
+    for ( auto idx : ceras::range( 20UL ) )
+        w[idx*30+7] *= 0.01f; // a channel of small weights keeps its precision
+    auto const qw = ceras::quantize<std::int8_t>( w, 1 );
+    REQUIRE( qw.scales_.size() == 30 );
+    REQUIRE( qw.scales_[7] < 0.02f * qw.scales_[6] );
+    auto const dw = ceras::dequantize( qw );
+    for ( auto idx : ceras::range( w.size() ) )
+    {
+        REQUIRE( qw.zero_points_[idx%30] == 0 );
+        REQUIRE( std::abs( dw[idx] - w[idx] ) <= 0.5001f * qw.scales_[idx%30] );
+    }
+}
+
+TEST_CASE( "quantized_operators", "[quantization_2]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // the quantized operators follow the float ones, within the rounding of the inputs and the weights, relative to the span of the products
+    auto const& check = []( auto const& quantized_output, auto const& float_output, float span )
+    {
+        REQUIRE( quantized_output.shape() == float_output.shape() );
+        float total = 0.0f;
+        for ( auto idx : range( float_output.size() ) )
+        {
+            float const error = std::abs( quantized_output[idx] - float_output[idx] );
+            REQUIRE( error < 0.01f * span );
+            total += error;
+        }
+        REQUIRE( total < 0.001f * span * float_output.size() );
+    };
+    auto const& span_of = []( auto const& x ){ return *std::max_element( x.begin(), x.end() ) - *std::min_element( x.begin(), x.end() ); };
+
+    {
+        auto x = variable{ random<float>( {37, 65}, -1.0f, 1.0f ) };
+        auto w = variable{ random<float>( {65, 129}, -1.0f, 1.0f ) };
+        auto b = variable{ random<float>( {1, 129}, -1.0f, 1.0f ) };
+        float const span = span_of( dense()( x, w, b ).forward() );
+        for ( std::string activation : { "linear", "relu", "tanh" } )
+            check( quantized_dense( quantize<std::int8_t>( w.data(), 1 ), b.data(), activation )( x ).forward().deep_copy(), dense( activation )( x, w, b ).forward(), span );
+        check( quantized_dense( quantize<std::int8_t>( w.data() ), b.data() )( x ).forward().deep_copy(), dense()( x, w, b ).forward(), span );
+    }
+
+    for ( std::string padding : { "valid", "same" } )
+        for ( size_t stride : { 1UL, 2UL } )
+        {
+            auto x = variable{ random<float>( {3, 12, 12, 5}, -1.0f, 1.0f ) };
+            auto w = variable{ random<float>( {7, 3, 3, 5}, -1.0f, 1.0f ) };
+            auto b = variable{ random<float>( {1, 1, 7}, -1.0f, 1.0f ) };
+            auto const y = quantized_conv2d( quantize<std::int8_t>( w.data(), 0 ), b.data(), stride, stride, 1, 1, padding, "relu" )( x ).forward().deep_copy();
+            auto const expected = ( general_conv2d( stride, stride, 1, 1, padding )( x, w ) + b ).forward().deep_copy();
+            check( y, relu( general_conv2d( stride, stride, 1, 1, padding )( x, w ) + b ).forward(), span_of( expected ) );
+        }
+
+    // a conv classifier trained in float keeps its accuracy with int8 weights and activations
+    {
+        size_t const classes = 10;
+        size_t const batch = 64;
+        auto const templates = random<float>( {classes, 12, 12, 1}, -1.0f, 1.0f );
+        auto const& make_samples = [&]( size_t samples )
+        {
+            tensor<float> images = random<float>( {samples, 12, 12, 1}, -0.6f, 0.6f );
+            tensor<float> labels{ {samples, classes} };
+            std::vector<size_t> categories( samples );
+            for ( auto s : range( samples ) )
+            {
+                categories[s] = s % classes;
+                labels[s*classes+categories[s]] = 1.0f;
+                for ( auto idx : range( 144UL ) )
+                    images[s*144+idx] += templates[categories[s]*144+idx];
+            }
+            return std::make_tuple( images, labels, categories );
+        };
+
+        auto x = Input( {12, 12, 1} );
+        auto gt = Input( {classes,} );
+        auto w1 = variable{ glorot_uniform<float>( {8, 3, 3, 1} ) };
+        auto b1 = variable{ zeros<float>( {1, 1, 8} ) };
+        auto w2 = variable{ glorot_uniform<float>( {288, classes} ) };
+        auto b2 = variable{ zeros<float>( {1, classes} ) };
+        auto y = dense()( Flatten()( MaxPooling2D( 2 )( relu( general_conv2d( 1, 1, 1, 1, "same" )( x, w1 ) + b1 ) ) ), w2, b2 );
+        auto loss = CategoricalCrossentropy()( softmax( y ) )( gt );
+
+        auto& s = get_default_session<tensor<float>>();
+        auto optimizer = Adam( batch, 1.0e-2f )( loss );
+        for ( [[maybe_unused]] auto step : range( 300 ) )
+        {
+            auto const [images, labels, _] = make_samples( batch );
+            s.bind( x, images );
+            s.bind( gt, labels );
+            s.run( loss );
+            s.run( optimizer );
+        }
+
+        auto q = quantized_dense( quantize<std::int8_t>( w2.data(), 1 ), b2.data() )( Flatten()( MaxPooling2D( 2 )( quantized_conv2d( quantize<std::int8_t>( w1.data(), 0 ), b1.data(), 1, 1, 1, 1, "same", "relu" )( x ) ) ) );
+
+        auto const [images, labels, categories] = make_samples( 1000 );
+        s.bind( x, images );
+        auto const float_output = s.run( y ).deep_copy();
+        auto const quantized_output = s.run( q ).deep_copy();
+        size_t float_correct = 0, quantized_correct = 0, agreed = 0;
+        for ( auto idx : range( categories.size() ) )
+        {
+            size_t const f = std::max_element( float_output.data() + idx*classes, float_output.data() + (idx+1)*classes ) - ( float_output.data() + idx*classes );
+            size_t const g = std::max_element( quantized_output.data() + idx*classes, quantized_output.data() + (idx+1)*classes ) - ( quantized_output.data() + idx*classes );
+            float_correct += ( f == categories[idx] );
+            quantized_correct += ( g == categories[idx] );
+            agreed += ( f == g );
+        }
+        REQUIRE( float_correct > 800 );
+        REQUIRE( quantized_correct + 10 >= float_correct ); // less than 1% of accuracy lost
+        REQUIRE( agreed >= 990 );
+    }
+}
+
@@ -0,0 +1,61 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "session_forward_cache", "[session_forward_cache_1]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // an identity counting its forward passes
+    int count = 0;
+    auto x = variable{ random<float>( {3, 4}, -1.0f, 1.0f ) };
+    auto c = make_unary_operator( [&count]<Tensor Tsor>( Tsor const& input ) { ++count; return input; },
+                                  []<Tensor Tsor>( Tsor const&, Tsor const&, Tsor const& grad ) { return grad; }, "counted" )( x );
+    auto y = c + c * value<float>{ 2.0f };
+
+    auto& s = get_default_session<tensor<float>>();
+    s.clear_forward_cache();
+    auto const output = y.forward().deep_copy();
+    REQUIRE( count == 1 );
+    for ( auto idx : range( output.size() ) )
+        REQUIRE( std::abs( output[idx] - 3.0f * x.data()[idx] ) < 1.0e-5f );
+
+    // the operators computed in this generation are not computed again
+    y.forward();
+    REQUIRE( count == 1 );
+    s.clear_forward_cache();
+    y.forward();
+    REQUIRE( count == 2 );
+
+    // a slot per operator, shared by its copies
+    size_t const slot = c.state_->slot_.index_;
+    REQUIRE( slot < s.forward_cache_.size() );
+    REQUIRE( c.state_->slot_.session_ == s.id_ );
+    REQUIRE( slot != y.state_->slot_.index_ );
+    auto const d = c;
+    REQUIRE( d.state_->slot_.index_ == slot );
+
+    // a session replacing the one numbering the slots numbers them again, an operator not taking the slot of another one computed already
+    {
+        auto saved = std::move( s );
+        s = ceras_private::session<tensor<float>>{};
+        REQUIRE( s.id_ != saved.id_ );
+        std::vector<decltype( negative( x ) )> others;
+        for ( [[maybe_unused]] auto _ : range( slot + 2 ) ) // as many slots as needed to reach the old slots of c and y
+            others.push_back( negative( x ) );
+        for ( auto& other : others )
+            other.forward();
+        int const computed = count;
+        y.forward();
+        REQUIRE( count == computed + 1 );
+        REQUIRE( c.state_->slot_.session_ == s.id_ );
+        s = std::move( saved );
+        REQUIRE( s.forward_cache_.size() > slot );
+    }
+
+    // a plan computes every node once per run
+    int const forwarded = count;
+    s.run( y );
+    s.run( y );
+    REQUIRE( count == forwarded + 2 );
+}
+
@@ -0,0 +1,124 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "session_run_operators", "[session_run_operators_1]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    auto& s = get_default_session<tensor<float>>();
+
+    // every operator compiles to a plan, runs forward and backward in it, and gives the output of its unplanned forward, its random operators aside
+    auto const& check = [&s]( auto ex, bool deterministic = true )
+    {
+        auto const output = s.run( ex ).deep_copy();
+        s.clear_forward_cache();
+        auto const expected = ex.forward().deep_copy();
+        REQUIRE( output.shape() == expected.shape() );
+        if ( deterministic )
+        {
+            bool ok = true;
+            for ( auto idx : range( output.size() ) )
+                ok = ok && ( ( std::isnan( output[idx] ) && std::isnan( expected[idx] ) ) || std::abs( output[idx] - expected[idx] ) <= 1.0e-4f * ( 1.0f + std::abs( expected[idx] ) ) );
+            REQUIRE( ok );
+        }
+        if constexpr ( requires { ex.state_->plan_; } )
+            s.plan( ex ).backward( ones<float>( output.shape() ) );
+    };
+
+    auto a = variable{ random<float>( {4, 6}, 0.1f, 0.9f ) };
+    auto b = variable{ random<float>( {4, 6}, 0.1f, 0.9f ) };
+    auto w = variable{ random<float>( {6, 5}, -0.5f, 0.5f ) };
+    auto bias = variable{ random<float>( {1, 5}, -0.5f, 0.5f ) };
+    auto x = variable{ random<float>( {2, 8, 8, 3}, -1.0f, 1.0f ) };
+    auto k = variable{ random<float>( {4, 3, 3, 3}, -0.5f, 0.5f ) };
+    auto gamma = variable{ random<float>( {8, 8, 3}, 0.5f, 1.5f ) };
+    auto beta = variable{ random<float>( {8, 8, 3}, -0.5f, 0.5f ) };
+    auto c = value<float>{ 0.5f };
+
+    // arithmetic
+    check( a + b );
+    check( a - b );
+    check( a * w );
+    check( a * c );
+    check( a / b );
+    check( negative( a ) );
+    check( inverse( a ) );
+    check( elementwise_product( a, b ) );
+    check( hadamard_product( a, b ) );
+    check( divide( a, b ) );
+    check( minus( a, b ) );
+    check( square( a ) );
+    check( hypot( a, b ) );
+    check( maximum( a, b ) );
+    check( minimum( a, b ) );
+    check( atan2( a, b ) );
+    check( pow( a, 3.0f ) );
+    check( clip( 0.3f, 0.7f )( a ) );
+    check( equal( a, b ) );
+    check( sign( a - b ) );
+    check( identity( a ) );
+    check( assign( b, a ) );
+    check( batch_matmul( variable{ random<float>( {3, 4, 6}, -1.0f, 1.0f ) }, variable{ random<float>( {3, 6, 2}, -1.0f, 1.0f ) } ) );
+    check( random_normal_like( 0.0f, 1.0f )( a ), false );
+    check( dense()( a, w, bias ) );
+    check( dense( "relu" )( a, w, bias ) );
+
+    // elementwise functions
+    check( abs( a ) ); check( acos( a ) ); check( acosh( a + 1.5f ) ); check( asin( a ) ); check( asinh( a ) ); check( atan( a ) );
+    check( atanh( a ) ); check( cbrt( a ) ); check( ceil( a ) ); check( cos( a ) ); check( cosh( a ) ); check( erf( a ) ); check( erfc( a ) );
+    check( exp( a ) ); check( exp2( a ) ); check( expm1( a ) ); check( fabs( a ) ); check( floor( a ) ); check( llrint( a ) ); check( llround( a ) );
+    check( log( a ) ); check( log10( a ) ); check( log1p( a ) ); check( log2( a ) ); check( lrint( a ) ); check( lround( a ) ); check( nearbyint( a ) );
+    check( rint( a ) ); check( round( a ) ); check( sin( a ) ); check( sinh( a ) ); check( sqrt( a ) ); check( tan( a ) ); check( tanh( a ) ); check( trunc( a ) );
+    check( poisson( a ) );
+
+    // activations
+    check( softmax( a ) ); check( sigmoid( a ) ); check( relu( a - c ) ); check( relu6( a ) ); check( leaky_relu( 0.2f )( a - c ) ); check( negative_relu( a - c ) );
+    check( elu( 1.0f )( a - c ) ); check( swish( a ) ); check( silu( a ) ); check( crelu( a ) ); check( tank_shrink( a ) ); check( mish( a ) ); check( lisht( a ) );
+    check( heaviside_step( 20.0f )( a - c ) ); check( unit_step( a - c ) ); check( soft_sign( a ) ); check( gaussian( a ) );
+
+    // losses
+    check( mse( a, b ) ); check( mae( a, b ) ); check( mean_squared_logarithmic_error( a, b ) ); check( cross_entropy_loss( a, softmax( b ) ) );
+    check( binary_cross_entropy_loss( a, b ) ); check( hinge_loss( a, b ) );
+
+    // reductions and shapes
+    check( sum_reduce( a ) );
+    check( mean_reduce( a ) );
+    check( reduce_sum( 1 )( a ) );
+    check( reduce_sum( 0 )( a ) );
+    check( reduce_min( 1 )( a ) );
+    check( reduce_max( 0 )( a ) );
+    check( reduce_max()( a ) );
+    check( repeat( 3, 1 )( a ) );
+    check( repeat( 2 )( a ) );
+    check( concatenate( 1 )( a, b ) );
+    check( concatenate()( a, b ) );
+    check( concatenate( 0 )( a, b ) );
+    check( transpose( a ) );
+    check( flatten( x ) );
+    check( reshape( {8, 24} )( x ) );
+    check( flip( 1 )( x ) );
+    check( ones_like( a ) + zeros_like( b ) );
+
+    // convolutions, poolings and normalizations
+    check( img2col( 3 )( x ) );
+    check( conv2d( 8, 8, 1, 1, 1, 1, "valid" )( x, k ) );
+    check( conv2d( 8, 8, 1, 1, 1, 1, "same" )( x, k ) );
+    check( general_conv2d( 1, 1, 1, 1, "same" )( x, k ) );
+    check( conv2d_transpose( 3, 3, 2, 2 )( x, k ) );
+    check( max_pooling_2d( 2 )( x ) );
+    check( average_pooling_2d( 2 )( x ) );
+    check( up_sampling_2d( 2 )( x ) );
+    check( zero_padding_2d( {1, 2, 1, 2} )( x ) );
+    check( cropping_2d( {1, 2, 1, 2} )( x ) );
+    check( batch_normalization( 0.9f )( x, gamma, beta ) );
+    check( drop_out( 0.5f )( x ), false );
+    check( sliding_2d( 1 )( x ), false );
+
+    // an expression of float tensors in the session of double tensors runs in the session of float tensors
+    auto y = relu( a * w + bias );
+    auto const output = get_default_session<tensor<double>>().run( y );
+    static_assert( std::is_same_v<std::remove_cvref_t<decltype( output )>, tensor<float>> );
+    REQUIRE( y.state_->plan_ );
+    REQUIRE( output.shape() == std::vector<size_t>{ {4, 5} } );
+}
+
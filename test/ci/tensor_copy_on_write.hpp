@@ -0,0 +1,225 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "tensor_copy_on_write", "[tensor_copy_on_write_1]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    auto const& same = []( auto const& x, auto const& y )
+    {
+        REQUIRE( x.shape() == y.shape() );
+        bool ok = true;
+        for ( auto idx : range( x.size() ) )
+            ok = ok && ( std::abs( x[idx] - y[idx] ) < 1.0e-5f );
+        REQUIRE( ok );
+    };
+
+    // a mutated copy gets a buffer of its own, the tensor it was copied from keeping its values
+    auto const& check = [&same]( auto const& mutate )
+    {
+        tensor<float> a = random<float>( {4, 5}, 0.5f, 1.0f );
+        tensor<float> const expected = a.deep_copy();
+        tensor<float> b = a;
+        REQUIRE( a.is_shared() );
+        mutate( b );
+        REQUIRE( b.data() != a.data() );
+        REQUIRE( !a.is_shared() );
+        same( a, expected );
+
+        // a tensor owning its buffer is mutated in place
+        float const* const buffer = a.data();
+        mutate( a );
+        REQUIRE( a.data() == buffer );
+        same( a, b );
+    };
+
+    auto const other = random<float>( {4, 5}, 0.5f, 1.0f );
+    check( [&]( tensor<float>& x ){ x += other; } );
+    check( [&]( tensor<float>& x ){ x -= other; } );
+    check( [&]( tensor<float>& x ){ x *= other; } );
+    check( [&]( tensor<float>& x ){ x /= other; } );
+    check( []( tensor<float>& x ){ x += 1.0f; } );
+    check( []( tensor<float>& x ){ x -= 1.0f; } );
+    check( []( tensor<float>& x ){ x *= 2.0f; } );
+    check( []( tensor<float>& x ){ x /= 2.0f; } );
+    check( []( tensor<float>& x ){ x.reset( 3.0f ); } );
+    check( []( tensor<float>& x ){ x.map( []( float& v ){ v = v * v; } ); } );
+    check( [&]( tensor<float>& x ){ x.deep_copy( other ); } );
+    check( []( tensor<float>& x ){ x.detach()[0] = 7.0f; } );
+
+    // resizing a shared tensor leaves the other one its size and values
+    {
+        tensor<float> a = random<float>( {4, 5}, 0.5f, 1.0f );
+        tensor<float> const expected = a.deep_copy();
+        tensor<float> b = a;
+        b.resize( {3, 3} );
+        REQUIRE( a.size() == 20 );
+        same( a, expected );
+    }
+
+    // a slice is detached before being mutated, leaving the tensor it views untouched
+    {
+        tensor<float> a = random<float>( {6, 5}, 0.5f, 1.0f );
+        tensor<float> const expected = a.deep_copy();
+        tensor<float> s = slice( a, 2, 4 );
+        s *= 0.0f;
+        same( a, expected );
+        REQUIRE( std::all_of( s.begin(), s.end(), []( float v ){ return v == 0.0f; } ) );
+    }
+
+    // the negation of a temporary owning its buffer is in place
+    {
+        tensor<float> a = random<float>( {4, 5}, -1.0f, 1.0f );
+        tensor<float> const expected = -a;
+        float const* const buffer = a.data();
+        tensor<float> const b = -std::move( a );
+        REQUIRE( b.data() == buffer );
+        same( b, expected );
+        tensor<float> const c = random<float>( {4, 5}, -1.0f, 1.0f );
+        tensor<float> d = c;
+        tensor<float> const e = -std::move( d );
+        REQUIRE( e.data() != c.data() );
+        REQUIRE( e[0] == -c[0] );
+    }
+
+    // a move takes the buffer over without sharing it, and leaves an empty tensor that can be resized
+    {
+        tensor<float> a = random<float>( {3, 4} );
+        float const* const buffer = a.data();
+        tensor<float> b{ std::move( a ) };
+        REQUIRE( b.data() == buffer );
+        REQUIRE( !b.is_shared() );
+        REQUIRE( a.empty() );
+        tensor<float> c;
+        c = std::move( b );
+        REQUIRE( c.data() == buffer );
+        REQUIRE( !c.is_shared() );
+        REQUIRE( c.shape() == std::vector<size_t>{ {3, 4} } );
+        REQUIRE( b.empty() );
+        REQUIRE( b.data() == nullptr );
+        REQUIRE( b.begin() == b.end() );
+        b.resize( {2, 2} );
+        REQUIRE( b.size() == 4 );
+    }
+}
+
+TEST_CASE( "operators_without_copies", "[tensor_copy_on_write_2]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    auto const& same = []( auto const& x, auto const& y )
+    {
+        REQUIRE( x.shape() == y.shape() );
+        bool ok = true;
+        for ( auto idx : range( x.size() ) )
+            ok = ok && ( std::abs( x[idx] - y[idx] ) < 1.0e-5f );
+        REQUIRE( ok );
+    };
+
+    // both operands of a plus share its incoming gradient, the backward action of either leaving it to the other one
+    auto const grad = random<float>( {3, 7}, -1.0f, 1.0f );
+    auto const& check = [&]( auto const& unary, auto const& derivative )
+    {
+        auto x = variable{ random<float>( {3, 7}, -2.0f, 2.0f ) };
+        auto y = variable{ random<float>( {3, 7}, -1.0f, 1.0f ) };
+        auto z = unary( x ) + y;
+        z.forward();
+        z.backward( grad );
+        same( y.gradient(), grad );
+        tensor<float> expected{ grad.shape() };
+        for ( auto idx : range( grad.size() ) )
+            expected[idx] = grad[idx] * derivative( x.data()[idx] );
+        same( x.gradient(), expected );
+    };
+    check( []( auto const& x ){ return relu( x ); }, []( float v ){ return v > 0.0f ? 1.0f : 0.0f; } );
+    check( []( auto const& x ){ return relu6( x ); }, []( float v ){ return ( v > 0.0f && v < 6.0f ) ? 1.0f : 0.0f; } );
+    check( []( auto const& x ){ return leaky_relu( 0.1f )( x ); }, []( float v ){ return v > 0.0f ? 1.0f : 0.1f; } );
+    check( []( auto const& x ){ return exponential( x ); }, []( float v ){ return std::exp( v ); } );
+    check( []( auto const& x ){ return hard_sigmoid( x ); }, []( float v ){ return ( v > 1.0f || v < -1.0f ) ? 0.0f : 0.5f; } );
+    check( []( auto const& x ){ return clip( -0.5f, 0.5f )( x ); }, []( float v ){ return ( v < -0.5f || v > 0.5f ) ? 0.0f : 1.0f; } );
+
+    // the caches the plan shares with the outputs and the gradients of its last pass are written in place, not given a buffer per pass
+    {
+        auto x = variable{ random<float>( {4, 6}, -1.0f, 1.0f ) };
+        auto ex = sum_reduce( reduce_max( 1 )( repeat( 2, 0 )( x ) ) ) + mean_reduce( x );
+        auto& s = get_default_session<tensor<float>>();
+        auto const grad = ones<float>( {1,} );
+        auto const& step = [&]()
+        {
+            s.run( ex );
+            ex.backward( grad );
+        };
+        step();
+        auto const expected = x.gradient().deep_copy();
+        auto const& plan = s.plan( ex );
+        std::vector<float const*> buffers;
+        for ( auto const& gradient : plan.gradients_ )
+            buffers.push_back( gradient.data() );
+        std::size_t const allocations = ceras_test::heap_allocations;
+        step();
+        step();
+        REQUIRE( ceras_test::heap_allocations == allocations );
+        for ( auto node : range( plan.size() ) )
+            REQUIRE( plan.gradients_[node].data() == buffers[node] );
+        same( x.gradient(), expected );
+    }
+
+    // softmax written from its input, into the same cache at every run
+    {
+        auto x = variable{ random<float>( {5, 9}, -3.0f, 3.0f ) };
+        auto const input = x.data().deep_copy();
+        auto y = softmax( x );
+        float const* const buffer = y.forward().data();
+        auto const output = y.forward();
+        REQUIRE( output.data() == buffer );
+        same( x.data(), input );
+        same( output, softmax( input ) );
+        for ( auto r : range( 5UL ) )
+        {
+            float const mx = *std::max_element( input.data() + r*9, input.data() + (r+1)*9 );
+            float total = 0.0f;
+            for ( auto c : range( 9UL ) )
+                total += std::exp( input[r*9+c] - mx );
+            for ( auto c : range( 9UL ) )
+                REQUIRE( std::abs( output[r*9+c] - std::exp( input[r*9+c] - mx ) / total ) < 1.0e-5f );
+        }
+    }
+}
+
+
+TEST_CASE( "variable_gradient_in_place", "[tensor_copy_on_write_3]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+    int const phase = learning_phase;
+    learning_phase = 1; // the gradients cleared by the forward pass
+
+    // `variable::backward` accumulates the gradients of the children of a variable into the buffer of its gradient, the one the optimizer reads
+    auto x = place_holder<tensor<float>>{};
+    auto w = variable{ random<float>( {3, 2}, -1.0f, 1.0f ) };
+    auto loss = sum_reduce( x * w );
+    x.bind( random<float>( {4, 3}, -1.0f, 1.0f ) );
+    auto& s = get_default_session<tensor<float>>();
+    s.run( loss );
+    loss.backward( ones<float>( {1,} ) );
+    auto const child = w.gradient().deep_copy(); // the gradient of the loss
+
+    s.run( loss ); // clearing the gradient in place
+    float const* const buffer = w.gradient().data();
+    w.backward( child ); // a second child of w
+    REQUIRE( w.gradient().data() == buffer );
+    for ( auto idx : range( child.size() ) )
+        REQUIRE( w.gradient()[idx] == child[idx] );
+
+    // the optimizer adds the gradient of the loss into the same buffer, and steps along the sum in the buffer of the weights
+    auto const weights = w.data().deep_copy();
+    float const* const data = w.data().data();
+    auto optimizer = gradient_descent<decltype( loss ), float>{ loss, 1, 0.5f };
+    s.run( optimizer );
+    REQUIRE( w.gradient().data() == buffer );
+    REQUIRE( w.data().data() == data );
+    for ( auto idx : range( weights.size() ) )
+        REQUIRE( std::abs( w.data()[idx] - ( weights[idx] - child[idx] ) ) < 1.0e-6f );
+    learning_phase = phase;
+}
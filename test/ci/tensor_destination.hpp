@@ -0,0 +1,212 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "tensor_destination", "[tensor_destination_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    auto const& same = []( auto const& x, auto const& y )
+    {
+        REQUIRE( x.shape() == y.shape() );
+        bool ok = true;
+        for ( auto idx : ceras::range( x.size() ) )
+            ok = ok && ( std::abs( x[idx] - y[idx] ) < 1.0e-5f );
+        REQUIRE( ok );
+    };
+
+    // the destination-passing overloads agree with the value-returning ones, and a warmed-up destination keeps its buffer
+    auto const& check = [&same]( auto const& value_version, auto const& destination_version )
+    {
+        ceras::tensor<float> ans;
+        destination_version( ans );
+        float const* const buffer = ans.data();
+        destination_version( ans );
+        REQUIRE( ans.data() == buffer );
+        same( ans, value_version() );
+    };
+
+    auto const a = ceras::random<float>( {6, 5}, -1.0f, 1.0f );
+    auto const b = ceras::random<float>( {6, 5}, 0.5f, 1.0f );
+    auto const r = ceras::random<float>( {1, 5}, 0.5f, 1.0f );
+
+    check( [&]{ return ceras::add( a, r ); }, [&]( auto& ans ){ ceras::add( a, r, ans ); } );
+    check( [&]{ return ceras::minus( a, b ); }, [&]( auto& ans ){ ceras::minus( a, b, ans ); } );
+    check( [&]{ return ceras::elementwise_product( a, r ); }, [&]( auto& ans ){ ceras::elementwise_product( a, r, ans ); } );
+    check( [&]{ return ceras::elementwise_divide( a, b ); }, [&]( auto& ans ){ ceras::elementwise_divide( a, b, ans ); } );
+    check( [&]{ return ceras::maximum( a, b ); }, [&]( auto& ans ){ ceras::maximum( a, b, ans ); } );
+    check( [&]{ return ceras::minimum( a, b ); }, [&]( auto& ans ){ ceras::minimum( a, b, ans ); } );
+    check( [&]{ return ceras::atan2( a, b ); }, [&]( auto& ans ){ ceras::atan2( a, b, ans ); } );
+    check( [&]{ return ceras::transpose( a ); }, [&]( auto& ans ){ ceras::transpose( a, ans ); } );
+    check( [&]{ return ceras::repeat( r, 3 ); }, [&]( auto& ans ){ ceras::repeat( r, 3, ans ); } );
+    check( [&]{ return ceras::reduce_sum( a ); }, [&]( auto& ans ){ ceras::reduce_sum( a, ans ); } );
+    check( [&]{ return ceras::reduce_mean( a ); }, [&]( auto& ans ){ ceras::reduce_mean( a, ans ); } );
+    check( [&]{ return ceras::concatenate( a, b, 1 ); }, [&]( auto& ans ){ ceras::concatenate( a, b, 1, ans ); } );
+    check( [&]{ return ceras::repmat( a, 2, 3 ); }, [&]( auto& ans ){ ceras::repmat( a, 2, 3, ans ); } );
+    check( [&]{ return ceras::abs( a ); }, [&]( auto& ans ){ ceras::abs( a, ans ); } );
+    check( [&]{ return ceras::softmax( a ); }, [&]( auto& ans ){ ceras::softmax( a, ans ); } );
+    check( [&]{ return ceras::sum( a, 0, true ); }, [&]( auto& ans ){ ceras::sum( a, 0, true, ans ); } );
+    check( [&]{ return ceras::mean( a, 1, false ); }, [&]( auto& ans ){ ceras::mean( a, 1, false, ans ); } );
+    check( [&]{ return ceras::max( a, 1, true ); }, [&]( auto& ans ){ ceras::max( a, 1, true, ans ); } );
+    check( [&]{ return ceras::min( a, 0, false ); }, [&]( auto& ans ){ ceras::min( a, 0, false, ans ); } );
+    check( [&]{ return ceras::variance( a, 0, true ); }, [&]( auto& ans ){ ceras::variance( a, 0, true, ans ); } );
+    check( [&]{ return ceras::standard_deviation( a, 1 ); }, [&]( auto& ans ){ ceras::standard_deviation( a, 1, false, ans ); } );
+    check( [&]{ return ceras::broadcast_tensor( r, {6, 5} ); }, [&]( auto& ans ){ ceras::broadcast_tensor( r, {6, 5}, ans ); } );
+
+    // the variance is the mean of the squared deviations from the mean
+    {
+        auto const& v = ceras::variance( a, 0 );
+        auto const& m = ceras::mean( a, 0 );
+        for ( auto c : ceras::range( 5 ) )
+        {
+            float expected = 0.0f;
+            for ( auto r : ceras::range( 6 ) )
+                expected += ( a[r*5+c] - m[c] ) * ( a[r*5+c] - m[c] ) / 6.0f;
+            REQUIRE( std::abs( v[c] - expected ) < 1.0e-5f );
+        }
+    }
+
+    // broadcasting along inner and padded dimensions
+    {
+        auto const s = ceras::random<float>( {4, 1, 5}, -1.0f, 1.0f );
+        auto const& bs = ceras::broadcast_tensor( s, {2, 4, 3, 5} );
+        REQUIRE( bs.shape() == std::vector<size_t>{ {2, 4, 3, 5} } );
+        bool ok = true;
+        for ( auto i : ceras::range( 2 ) )
+            for ( auto j : ceras::range( 4 ) )
+                for ( auto k : ceras::range( 3 ) )
+                    for ( auto l : ceras::range( 5 ) )
+                        ok = ok && ( bs[((i*4+j)*3+k)*5+l] == s[j*5+l] );
+        REQUIRE( ok );
+    }
+
+    // sum_to_shape reduces a broadcasted tensor back to the shape of an operand
+    auto const t = ceras::random<float>( {4, 3, 5}, -1.0f, 1.0f );
+    check( [&]{ return ceras::sum( ceras::sum( t, 0 ), 0, true ); }, [&]( auto& ans ){ ceras::sum_to_shape( t, {1, 5}, ans ); } );
+    check( [&]{ return ceras::sum( ceras::sum( t, 2, true ), 0 ); }, [&]( auto& ans ){ ceras::sum_to_shape( t, {3, 1}, ans ); } );
+    check( [&]{ return ceras::sum( t, 1, true ); }, [&]( auto& ans ){ ceras::sum_to_shape( t, {4, 1, 5}, ans ); } );
+    check( [&]{ return t; }, [&]( auto& ans ){ ceras::sum_to_shape( t, t.shape(), ans ); } );
+}
+
+TEST_CASE( "tensor_destination_operators", "[tensor_destination_2]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // repeated training steps reuse the operator caches, and give the same gradients as the first step
+    auto x = ceras::variable{ ceras::random<float>( {4, 3}, -1.0f, 1.0f ) };
+    auto b = ceras::variable{ ceras::random<float>( {1, 3}, -1.0f, 1.0f ) };
+    auto ex = ceras::sum_reduce( ceras::square( ceras::elementwise_product( -( x + b ), b ) ) );
+
+    auto const& step = [&]()
+    {
+        ceras::get_default_session<ceras::tensor<float>>().clear_forward_cache(); // as `session::run` does
+        auto const output = ex.forward();
+        ex.backward( ceras::ones<float>( {1,} ) );
+        return std::make_tuple( output, x.gradient().deep_copy(), b.gradient().deep_copy() );
+    };
+
+    auto const [output_1, x_grad_1, b_grad_1] = step();
+    float const value = output_1[0];
+    auto const [output_2, x_grad_2, b_grad_2] = step();
+    REQUIRE( output_1.data() == output_2.data() );
+    REQUIRE( output_2[0] == value );
+
+    // d/dx ( (x+b) b )^2 = 2 (x+b) b^2, d/db ( (x+b) b )^2 = 2 (x+b) b ( x + 2b ), summed over the rows
+    float reference = 0.0f;
+    for ( auto r : ceras::range( 4 ) )
+        for ( auto c : ceras::range( 3 ) )
+        {
+            float const xv = x.data()[r*3+c];
+            float const bv = b.data()[c];
+            reference += (xv+bv) * (xv+bv) * bv * bv;
+            REQUIRE( std::abs( x_grad_2[r*3+c] - 2.0f * (xv+bv) * bv * bv ) < 1.0e-5f );
+            REQUIRE( x_grad_2[r*3+c] == x_grad_1[r*3+c] );
+        }
+    REQUIRE( std::abs( value - reference ) < 1.0e-4f );
+    for ( auto c : ceras::range( 3 ) )
+    {
+        float expected = 0.0f;
+        for ( auto r : ceras::range( 4 ) )
+        {
+            float const xv = x.data()[r*3+c];
+            float const bv = b.data()[c];
+            expected += 2.0f * (xv+bv) * bv * (xv + 2.0f*bv);
+        }
+        REQUIRE( std::abs( b_grad_2[c] - expected ) < 1.0e-4f );
+        REQUIRE( b_grad_2[c] == b_grad_1[c] );
+    }
+
+
+    // so does the concatenation
+    {
+        auto y = ceras::variable{ ceras::random<float>( {4, 2}, -1.0f, 1.0f ) };
+        auto cat = ceras::concatenate( 1 )( x, y );
+        auto& s = ceras::get_default_session<ceras::tensor<float>>();
+        auto const first = s.run( cat );
+        cat.backward( ceras::ones<float>( {4, 5} ) );
+        float const* const y_grad = y.gradient().data();
+        auto const second = s.run( cat );
+        cat.backward( ceras::ones<float>( {4, 5} ) );
+        REQUIRE( first.data() == second.data() );
+        REQUIRE( second.shape() == std::vector<size_t>{ {4, 5} } );
+        REQUIRE( second[3] == y.data()[0] );
+        REQUIRE( y.gradient().data() == y_grad );
+    }
+}
+
+TEST_CASE( "tensor_destination_training_step", "[tensor_destination_3]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // once warmed up, a training step of a small Dense model -- a run of the loss and its backward pass -- allocates no buffer
+    auto x = place_holder<tensor<float>>{};
+    auto t = place_holder<tensor<float>>{};
+    auto w1 = variable{ random<float>( {8, 16}, -0.5f, 0.5f ) };
+    auto b1 = variable{ zeros<float>( {1, 16} ) };
+    auto w2 = variable{ random<float>( {16, 4}, -0.5f, 0.5f ) };
+    auto b2 = variable{ zeros<float>( {1, 4} ) };
+    auto loss = mean_squared_error( dense( "linear" )( dense( "relu" )( x, w1, b1 ), w2, b2 ), t );
+    x.bind( random<float>( {32, 8}, -1.0f, 1.0f ) );
+    t.bind( random<float>( {32, 4}, -1.0f, 1.0f ) );
+
+    auto& s = get_default_session<tensor<float>>();
+    auto const grad = ones<float>( {1,} );
+    auto const& step = [&]()
+    {
+        auto const output = s.run( loss );
+        loss.backward( grad );
+        return output[0];
+    };
+
+    float const value = step();
+    auto const w1_grad = w1.gradient().deep_copy();
+    std::size_t const allocations = ceras_test::heap_allocations;
+    REQUIRE( step() == value );
+    REQUIRE( step() == value );
+    REQUIRE( ceras_test::heap_allocations == allocations );
+    for ( auto idx : range( w1_grad.size() ) )
+        REQUIRE( w1.gradient()[idx] == w1_grad[idx] );
+}
+
+TEST_CASE( "tensor_destination_batched_training_step", "[tensor_destination_4]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // a weight shared by the batch of a batched product, its gradient summed over the products of the samples kept by the operator
+    auto q = place_holder<tensor<float>>{};
+    auto w = variable{ random<float>( {5, 7}, -0.5f, 0.5f ) };
+    auto loss = sum_reduce( batch_matmul( w, q ) );
+    q.bind( random<float>( {3, 7, 4}, -1.0f, 1.0f ) );
+
+    auto& s = get_default_session<tensor<float>>();
+    auto const grad = ones<float>( {1,} );
+    s.run( loss );
+    loss.backward( grad );
+    auto const w_grad = w.gradient().deep_copy();
+    std::size_t const allocations = ceras_test::heap_allocations;
+    s.run( loss );
+    loss.backward( grad );
+    REQUIRE( ceras_test::heap_allocations == allocations );
+    for ( auto idx : range( w_grad.size() ) )
+        REQUIRE( w.gradient()[idx] == w_grad[idx] );
+}
@@ -0,0 +1,120 @@
+#include "../../include/tensor.hpp"
+
+TEST_CASE( "tensor_expression", "[tensor_expression_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    size_t const n = 100000; // above the parallel threshold
+    auto a = ceras::random<float>( {n/100, 100}, -1.0f, 1.0f );
+    auto b = ceras::random<float>( {n/100, 100}, -1.0f, 1.0f );
+    auto c = ceras::random<float>( {n/100, 100}, -1.0f, 1.0f );
+
+    // nothing is computed until the expression is assigned
+    auto expression = a + b * 2.0f - c / 4.0f + 1.0f;
+    REQUIRE( ceras::is_tensor_expression_v<decltype(expression)> );
+    REQUIRE( expression.shape() == a.shape() );
+
+    ceras::tensor<float> x = expression;
+    REQUIRE( x.shape() == a.shape() );
+    for ( auto idx : ceras::range( n ) )
+        REQUIRE( std::abs( x[idx] - ( a[idx] + b[idx] * 2.0f - c[idx] / 4.0f + 1.0f ) ) < 1.0e-6f );
+    REQUIRE( std::abs( expression[7] - x[7] ) < 1.0e-6f );
+
+    // the operands are left untouched
+    auto const a_0 = a[0];
+    ceras::tensor<float> y = 1.0f - a - 0.5f * a;
+    REQUIRE( a[0] == a_0 );
+    REQUIRE( std::abs( y[0] - ( 1.0f - 1.5f * a_0 ) ) < 1.0e-6f );
+
+    // assigned into the own buffer of the destination, but not into a shared one
+    float const* buffer = y.data();
+    y = a * 3.0f;
+    REQUIRE( y.data() == buffer );
+    ceras::tensor<float> shared = y;
+    y = a * 4.0f;
+    REQUIRE( y.data() != shared.data() );
+    REQUIRE( shared[0] == a_0 * 3.0f );
+    REQUIRE( y[0] == a_0 * 4.0f );
+
+    // fused compound assignments
+    ceras::tensor<float> z = a.deep_copy();
+    z -= 0.5f * b;
+    z += -c;
+    z *= b + 1.0f;
+    z /= c * 0.5f + 2.0f;
+    for ( auto idx : ceras::range( n ) )
+        REQUIRE( std::abs( z[idx] - ( ( a[idx] - 0.5f * b[idx] - c[idx] ) * ( b[idx] + 1.0f ) / ( c[idx] * 0.5f + 2.0f ) ) ) < 1.0e-5f );
+
+    // broadcasting, of a tensor and of an expression
+    ceras::tensor<float> bias{ {100,} };
+    for ( auto idx : ceras::range( 100 ) ) bias[idx] = static_cast<float>( idx );
+    ceras::tensor<float> s = a + bias;
+    ceras::tensor<float> t = a - ( bias * 2.0f );
+    ceras::tensor<float> u = bias * 2.0f - a;
+    REQUIRE( s.shape() == a.shape() );
+    for ( auto idx : ceras::range( n ) )
+    {
+        REQUIRE( s[idx] == a[idx] + bias[idx%100] );
+        REQUIRE( t[idx] == a[idx] - bias[idx%100] * 2.0f );
+        REQUIRE( u[idx] == bias[idx%100] * 2.0f - a[idx] );
+    }
+
+    // a broadcasted leaf is read in place, not expanded to the shape of the expression, along the leading, the inner and the middle dimensions
+    {
+        auto const x = ceras::random<float>( {4, 3, 5, 6}, -1.0f, 1.0f );
+        auto const& check = [&x]( ceras::tensor<float> const& y, std::vector<size_t> const& strides )
+        {
+            auto const expression = x + y * 2.0f;
+            auto const& leaf = std::get<0>( std::get<1>( expression.operands_ ).operands_ );
+            REQUIRE( leaf.is_broadcasted() );
+            REQUIRE( leaf.data_ == y.data() );
+            ceras::tensor<float> const ans = expression;
+            REQUIRE( ans.shape() == x.shape() );
+            bool ok = true;
+            for ( auto i : ceras::range( 4 ) ) for ( auto j : ceras::range( 3 ) ) for ( auto k : ceras::range( 5 ) ) for ( auto l : ceras::range( 6 ) )
+            {
+                size_t const idx = ( ( i * 3 + j ) * 5 + k ) * 6 + l;
+                ok = ok && ( ans[idx] == x[idx] + y[i*strides[0] + j*strides[1] + k*strides[2] + l*strides[3]] * 2.0f );
+            }
+            REQUIRE( ok );
+        };
+        check( ceras::random<float>( {3, 5, 6}, -1.0f, 1.0f ), {0, 30, 6, 1} );
+        check( ceras::random<float>( {6,}, -1.0f, 1.0f ), {0, 0, 0, 1} );
+        check( ceras::random<float>( {4, 1, 1, 1}, -1.0f, 1.0f ), {1, 0, 0, 0} );
+        check( ceras::random<float>( {4, 1, 5, 1}, -1.0f, 1.0f ), {5, 0, 1, 0} );
+        check( ceras::random<float>( {1,}, -1.0f, 1.0f ), {0, 0, 0, 0} );
+
+        // the evaluation loop copies to every chunk a raw view of the tree, copied trivially and pointing into the leaves
+        {
+            auto const y = ceras::random<float>( {3, 5, 6}, -1.0f, 1.0f );
+            auto const expression = x + y * 2.0f;
+            auto const view = expression.reader();
+            typedef std::remove_cvref_t<decltype( view )> view_type;
+            REQUIRE( std::is_trivially_copy_constructible_v<view_type> );
+            REQUIRE( std::is_trivially_destructible_v<view_type> );
+            REQUIRE( std::get<0>( view.operands_ ).data_ == x.data() );
+            REQUIRE( std::get<0>( std::get<1>( view.operands_ ).operands_ ).data_ == y.data() );
+            for ( auto idx : ceras::range( x.size() ) )
+                REQUIRE( view.element( idx ) == expression[idx] );
+        }
+
+        // an evaluated expression broadcasted by a larger one, read in place too
+        auto const bias = ceras::random<float>( {6,}, -1.0f, 1.0f );
+        auto const scaled = bias * 2.0f;
+        scaled.eval();
+        auto const expression = x + scaled;
+        REQUIRE( !std::get<1>( expression.operands_ ).value_ );
+        REQUIRE( std::get<1>( expression.operands_ ).broadcasted_value_ );
+        ceras::tensor<float> const ans = expression;
+        for ( auto idx : ceras::range( x.size() ) )
+            REQUIRE( ans[idx] == x[idx] + bias[idx%6] * 2.0f );
+    }
+
+    // the matrix product still evaluates its expression operands
+    auto m = ceras::random<float>( {100, 3}, -1.0f, 1.0f );
+    ceras::tensor<float> p = ( a + b ) * m;
+    ceras::tensor<float> q = ceras::tensor<float>{ a + b } * m;
+    REQUIRE( p.shape() == std::vector<size_t>{ {n/100, 3} } );
+    for ( auto idx : ceras::range( p.size() ) )
+        REQUIRE( p[idx] == q[idx] );
+}
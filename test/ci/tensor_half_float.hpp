@@ -0,0 +1,122 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "half_float", "[half_float_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    // rounding to nearest, ties to even
+    REQUIRE( static_cast<float>( ceras::bfloat16{ 3.14159f } ) == 3.140625f );
+    REQUIRE( static_cast<float>( ceras::float16{ 3.14159f } ) == 3.140625f );
+    REQUIRE( ceras::bfloat16{ 1.0f + 1.0f / 256.0f }.bits() == ceras::bfloat16{ 1.0f }.bits() );
+    REQUIRE( ceras::float16{ 1.0f + 1.0f / 2048.0f }.bits() == ceras::float16{ 1.0f }.bits() );
+    REQUIRE( static_cast<float>( ceras::float16{ 65504.0f } ) == 65504.0f );
+    REQUIRE( static_cast<float>( ceras::float16{ 1.0e5f } ) == std::numeric_limits<float>::infinity() );
+    REQUIRE( static_cast<float>( ceras::float16{ 5.9604645e-8f } ) == 5.9604645e-8f ); // the smallest subnormal
+
+    // every finite float16 goes through float and back unchanged, with the vectorized conversions as with the scalar ones
+    {
+        std::vector<ceras::float16> halves;
+        for ( std::uint32_t bits = 0; bits != 0x10000; ++bits )
+            if ( ( bits & 0x7c00U ) != 0x7c00U )
+                halves.push_back( ceras::float16::from_bits( static_cast<std::uint16_t>( bits ) ) );
+        std::vector<float> floats( halves.size() );
+        std::vector<ceras::float16> back( halves.size() );
+        ceras::convert( halves.data(), floats.data(), halves.size() );
+        ceras::convert( floats.data(), back.data(), halves.size() );
+        for ( auto idx : ceras::range( halves.size() ) )
+        {
+            REQUIRE( floats[idx] == static_cast<float>( halves[idx] ) );
+            REQUIRE( back[idx].bits() == halves[idx].bits() );
+        }
+    }
+
+    // the vectorized roundings agree with the scalar ones, on the ties too
+    {
+        size_t const n = 4099;
+        auto x = ceras::random<float>( {n,}, -100.0f, 100.0f );
+        for ( size_t idx = 0; idx < n; idx += 7 ) // exactly half way between two bfloat16 values
+            x[idx] = std::bit_cast<float>( std::bit_cast<std::uint32_t>( x[idx] ) & 0xffff8000U );
+        auto const b = x.as_type<ceras::bfloat16>();
+        auto const h = x.as_type<ceras::float16>();
+        for ( auto idx : ceras::range( n ) )
+        {
+            REQUIRE( b[idx].bits() == ceras::bfloat16{ x[idx] }.bits() );
+            REQUIRE( h[idx].bits() == ceras::float16{ x[idx] }.bits() );
+        }
+        auto const y = b.as_type<float>();
+        for ( auto idx : ceras::range( n ) )
+            REQUIRE( std::abs( y[idx] - x[idx] ) <= std::abs( x[idx] ) / 256.0f );
+    }
+
+    // the 16-bit kernels compute in float, rounding the results once
+    {
+        size_t const n = 1000;
+        auto const x = ceras::random<float>( {n,}, -3.0f, 3.0f ).as_type<ceras::bfloat16>();
+        auto const z = ceras::random<float>( {n,}, -3.0f, 3.0f ).as_type<ceras::bfloat16>();
+        ceras::tensor<ceras::bfloat16> y{ {n,} };
+        ceras::vectorized_map( x.data(), y.data(), n, []( auto v ){ return ceras::vmath::tanh( v ); } );
+        for ( auto idx : ceras::range( n ) )
+            REQUIRE( std::abs( y[idx] - std::tanh( static_cast<float>( x[idx] ) ) ) <= 1.0f / 256.0f );
+        ceras::vectorized_map( x.data(), z.data(), y.data(), n, []( auto u, auto v ){ return u * v; } );
+        for ( auto idx : ceras::range( n ) )
+            REQUIRE( y[idx].bits() == ceras::bfloat16{ static_cast<float>( x[idx] ) * static_cast<float>( z[idx] ) }.bits() );
+    }
+
+    // the 16-bit products accumulate in float
+    for ( auto [m, n, k] : std::vector<std::tuple<size_t, size_t, size_t>>{ {3, 5, 7}, {37, 513, 65} } )
+        for ( bool a_transposed : {false, true} )
+            for ( bool b_transposed : {false, true} )
+            {
+                auto const A = ceras::random<float>( {m, n}, -1.0f, 1.0f ).as_type<ceras::bfloat16>();
+                auto const B = ceras::random<float>( {n, k}, -1.0f, 1.0f ).as_type<ceras::bfloat16>();
+                ceras::tensor<ceras::bfloat16> C{ {m, k} };
+                ceras::tensor<float> expected{ {m, k} };
+                ceras::gemm( A.data(), a_transposed, B.data(), b_transposed, m, n, k, C.data() );
+                ceras::naive_gemm( A.as_type<float>().data(), a_transposed, B.as_type<float>().data(), b_transposed, m, n, k, expected.data() );
+                for ( auto idx : ceras::range( m*k ) )
+                    REQUIRE( std::abs( C[idx] - expected[idx] ) <= std::abs( expected[idx] ) / 256.0f + 1.0e-5f * n );
+            }
+}
+
+TEST_CASE( "half_float_model", "[half_float_2]" )
+{
+    using namespace ceras;
+
+    // the same model with float and with bfloat16 weights and activations
+    auto const& train = []<typename T>( T )
+    {
+        random_generator.seed( 42 );
+        auto x = Input<T>( {8, 8, 1} );
+        auto y = Dense( 3 )( Flatten()( MaxPooling2D( 2 )( relu( Conv2D( 4, {3, 3}, "same" )( x ) ) ) ) );
+        auto gt = Input<T>( {3,} );
+        auto loss = MeanSquaredError()( y )( gt );
+
+        auto& s = get_default_session<tensor<T>>();
+        s.bind( x, random<float>( {16, 8, 8, 1} ).as_type<T>() );
+        s.bind( gt, random<float>( {16, 3} ).as_type<T>() );
+        auto optimizer = Adam( 16UL, 1.0e-2f )( loss );
+
+        std::vector<float> errors;
+        for ( [[maybe_unused]] auto idx : range( 40 ) )
+        {
+            errors.push_back( s.run( loss )[0] );
+            s.run( optimizer );
+        }
+
+        auto const output = s.run( y );
+        static_assert( std::is_same_v<std::remove_cv_t<decltype( output )>, tensor<T>> );
+        for ( auto& [id, v] : s.variables_ )
+            static_assert( std::is_same_v<typename std::remove_reference_t<decltype( v )>::value_type, T> );
+        return std::make_tuple( errors, output.size() * sizeof( T ) );
+    };
+
+    auto const [float_errors, float_bytes] = train( 0.0f );
+    auto const [half_errors, half_bytes] = train( bfloat16{} );
+
+    // half the memory for the activations, training as the float model does
+    REQUIRE( 2 * half_bytes == float_bytes );
+    REQUIRE( half_errors.back() < 0.5f * half_errors.front() );
+    for ( auto idx : range( float_errors.size() ) )
+        REQUIRE( std::abs( half_errors[idx] - float_errors[idx] ) <= 0.05f * float_errors[idx] + 1.0e-2f );
+}
+
@@ -0,0 +1,133 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "sparse_tensor", "[sparse_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    for ( auto [block_rows, block_cols] : std::vector<std::tuple<size_t, size_t>>{ {1, 1}, {4, 1}, {2, 8}, {3, 5} } )
+    {
+        size_t const m = 37, n = 53;
+        auto const x = ceras::random<float>( {m, n}, -1.0f, 1.0f );
+        auto const a = ceras::to_sparse( x, 0.9f, block_rows, block_cols );
+        REQUIRE( a.values_.size() == a.blocks() * block_rows * block_cols );
+        REQUIRE( a.density() < 0.1f * block_rows * block_cols + 0.1f );
+
+        // the values above the threshold kept, the others kept only with a block
+        auto const d = ceras::to_dense( a );
+        REQUIRE( d.shape() == x.shape() );
+        for ( auto idx : ceras::range( x.size() ) )
+        {
+            REQUIRE( ( d[idx] == x[idx] || d[idx] == 0.0f ) );
+            if ( std::abs( x[idx] ) > 0.9f )
+                REQUIRE( d[idx] == x[idx] );
+        }
+        if ( block_rows * block_cols == 1 )
+            REQUIRE( a.blocks() == static_cast<size_t>( std::count_if( x.begin(), x.end(), []( float v ){ return std::abs( v ) > 0.9f; } ) ) );
+
+        // the products follow the dense ones, on the tails of the registers too
+        for ( size_t k : { 1UL, 17UL, 64UL, 130UL } )
+        {
+            auto const b = ceras::random<float>( {n, k}, -1.0f, 1.0f );
+            ceras::tensor<float> c{ {m, k} }, expected{ {m, k} };
+            ceras::spmm( a, b.data(), k, c.data() );
+            ceras::naive_gemm( d.data(), false, b.data(), false, m, n, k, expected.data() );
+            for ( auto idx : ceras::range( c.size() ) )
+                REQUIRE( std::abs( c[idx] - expected[idx] ) < 1.0e-5f * n );
+
+            auto const e = ceras::random<float>( {m, k}, -1.0f, 1.0f );
+            ceras::tensor<float> f{ {n, k} }, expected_f{ {n, k} };
+            ceras::spmm_transposed( a, e.data(), k, f.data() );
+            ceras::naive_gemm( d.data(), true, e.data(), false, n, m, k, expected_f.data() );
+            for ( auto idx : ceras::range( f.size() ) )
+                REQUIRE( std::abs( f[idx] - expected_f[idx] ) < 1.0e-5f * m );
+
+            auto const g = ceras::random<float>( {n, k}, -1.0f, 1.0f );
+            ceras::tensor<float> sampled{ a.values_.shape() }, product{ {m, n} };
+            ceras::sampled_gemm( a, e.data(), g.data(), k, sampled.data() );
+            ceras::naive_gemm( e.data(), false, g.data(), true, m, k, n, product.data() );
+            auto sampled_a = a;
+            sampled_a.values_ = sampled;
+            auto const sampled_d = ceras::to_dense( sampled_a );
+            for ( auto idx : ceras::range( product.size() ) )
+                REQUIRE( std::abs( sampled_d[idx] - ( d[idx] == 0.0f ? sampled_d[idx] : product[idx] ) ) < 1.0e-5f * k );
+        }
+    }
+}
+
+TEST_CASE( "sparse_dense", "[sparse_2]" )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // the sparse operator follows the dense one with the pruned weights, the stored values getting the gradient of their weights
+    for ( auto [m, n, k] : std::vector<std::tuple<size_t, size_t, size_t>>{ {3, 5, 7}, {37, 65, 129} } )
+        for ( size_t block_rows : { 1UL, 4UL } )
+            for ( std::string activation : { "linear", "relu", "tanh" } )
+            {
+                auto x = variable{ random<float>( {m, n}, -1.0f, 1.0f ) };
+                auto b = variable{ random<float>( {1, k}, -1.0f, 1.0f ) };
+                auto sw = sparse_variable{ to_sparse( random<float>( {k, n}, -1.0f, 1.0f ), 0.7f, block_rows, 1 ) };
+                auto w = variable{ transpose( to_dense( sw.data() ) ) };
+                auto grad = random<float>( {m, k}, -1.0f, 1.0f );
+
+                auto sparse = dense( activation )( x, sw, b );
+                auto const sparse_output = sparse.forward().deep_copy();
+                sparse.backward( grad );
+                auto const x_grad = x.gradient().deep_copy();
+                auto const b_grad = b.gradient().deep_copy();
+                auto values_grad = sw.data();
+                values_grad.values_ = sw.values_.gradient().deep_copy();
+                auto const w_grad = to_dense( values_grad );
+
+                auto reference = dense( activation )( x, w, b );
+                auto const reference_output = reference.forward(); // also zeros the gradients of the variables
+                reference.backward( grad );
+
+                REQUIRE( sparse_output.shape() == reference_output.shape() );
+                for ( auto idx : range( sparse_output.size() ) )
+                    REQUIRE( std::abs( sparse_output[idx] - reference_output[idx] ) < 1.0e-4f * n );
+                for ( auto idx : range( x_grad.size() ) )
+                    REQUIRE( std::abs( x_grad[idx] - x.gradient()[idx] ) < 1.0e-4f * k );
+                for ( auto idx : range( b_grad.size() ) )
+                    REQUIRE( std::abs( b_grad[idx] - b.gradient()[idx] ) < 1.0e-4f * m );
+                for ( auto r : range( k ) )
+                    for ( auto c : range( n ) )
+                        if ( w.data()[c*k+r] != 0.0f )
+                            REQUIRE( std::abs( w_grad[r*n+c] - w.gradient()[c*k+r] ) < 1.0e-4f * m );
+            }
+
+    // a pruned layer fine-tuned with its pattern fixed
+    {
+        auto x = Input( {32,} );
+        auto gt = Input( {8,} );
+        auto sw = sparse_variable{ to_sparse( random<float>( {8, 32}, -1.0f, 1.0f ), 0.8f ) };
+        auto b = variable{ zeros<float>( {1, 8} ) };
+        auto const pattern = to_dense( sw.data() );
+        auto target_weight = sw.data();
+        target_weight.values_ = random<float>( target_weight.values_.shape(), -1.0f, 1.0f );
+        auto const target = transpose( to_dense( target_weight ) ); // reachable with the pattern of the layer
+        auto y = dense()( x, sw, b );
+        auto loss = MeanSquaredError()( y )( gt );
+
+        auto& s = get_default_session<tensor<float>>();
+        auto optimizer = Adam( 1UL, 2.0e-2f )( loss );
+        std::vector<float> errors;
+        for ( [[maybe_unused]] auto step : range( 200 ) )
+        {
+            auto const input = random<float>( {32, 32}, -1.0f, 1.0f );
+            s.bind( x, input );
+            tensor<float> labels{ {32, 8} };
+            naive_gemm( input.data(), false, target.data(), false, 32, 32, 8, labels.data() );
+            s.bind( gt, labels );
+            errors.push_back( s.run( loss )[0] );
+            s.run( optimizer );
+        }
+        REQUIRE( errors.back() < 0.01f * errors.front() );
+
+        auto const tuned = to_dense( sw.data() );
+        for ( auto idx : range( tuned.size() ) )
+            if ( pattern[idx] == 0.0f )
+                REQUIRE( tuned[idx] == 0.0f );
+    }
+}
+
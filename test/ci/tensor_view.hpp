@@ -0,0 +1,154 @@
+#include "../../include/ceras.hpp"
+
+TEST_CASE( "tensor_slice", "[tensor_view_1]" )
+{
+    ceras::tensor<float> samples{ {10, 3, 2} };
+    for ( auto idx : ceras::range( samples.size() ) )
+        samples[idx] = static_cast<float>( idx );
+
+    // a batch slice shares the buffer
+    auto batch = ceras::slice( samples, 4, 7 );
+    REQUIRE( batch.shape() == std::vector<size_t>{ {3, 3, 2} } );
+    REQUIRE( batch.size() == 18 );
+    REQUIRE( batch.is_slice() );
+    REQUIRE( batch.data() == samples.data() + 24 );
+    for ( auto idx : ceras::range( batch.size() ) )
+        REQUIRE( batch[idx] == static_cast<float>( idx + 24 ) );
+
+    // writing its elements writes the tensor, as for any tensors sharing a buffer
+    batch[0] = -1.0f;
+    REQUIRE( samples[24] == -1.0f );
+    batch.data()[1] = -2.0f;
+    REQUIRE( samples[25] == -2.0f );
+    batch[1] = 25.0f;
+
+    // its mutating members give it a buffer of its own first, copy-on-write, leaving the tensor untouched
+    {
+        auto mutated = ceras::slice( samples, 4, 7 );
+        mutated += 1.0f;
+        REQUIRE( !mutated.is_slice() );
+        REQUIRE( mutated.data() != samples.data() + 24 );
+        REQUIRE( mutated[2] == 27.0f );
+        REQUIRE( samples[26] == 26.0f );
+        auto reset = ceras::slice( samples, 4, 7 );
+        reset.reset( 3.0f );
+        REQUIRE( samples[26] == 26.0f );
+    }
+
+    // a slice of a slice
+    auto sub = ceras::slice( batch, 1, 2 );
+    REQUIRE( sub.data() == samples.data() + 30 );
+    REQUIRE( sub.size() == 6 );
+
+    // the operations of tensors work on slices, without touching the rest of the buffer
+    auto doubled = batch + batch;
+    REQUIRE( doubled.size() == 18 );
+    REQUIRE( doubled[1] == 50.0f );
+    auto reshaped = ceras::copy( batch ).reshape( {9, 2} );
+    REQUIRE( reshaped.size() == 18 );
+
+    // resizing a slice detaches it
+    batch.resize( {4, 3, 2} );
+    REQUIRE( !batch.is_slice() );
+    REQUIRE( batch.size() == 24 );
+    REQUIRE( batch[1] == 25.0f );
+    REQUIRE( batch[23] == 0.0f );
+    batch[1] = 0.0f;
+    REQUIRE( samples[25] == 25.0f );
+    REQUIRE( samples.size() == 60 );
+}
+
+TEST_CASE( "tensor_view", "[tensor_view_2]" )
+{
+    ceras::tensor<double> x{ {2, 3, 4} };
+    for ( auto idx : ceras::range( x.size() ) )
+        x[idx] = static_cast<double>( idx );
+
+    auto v = ceras::as_view( x );
+    REQUIRE( v.is_contiguous() );
+    REQUIRE( v( 1, 2, 3 ) == 23.0 );
+    REQUIRE( v.materialize().data() == x.data() );
+
+    // a channel subset
+    auto channels = ceras::slice( x, 2, 1, 4, 2 ); // channels 1 and 3
+    REQUIRE( channels.shape() == std::vector<size_t>{ {2, 3, 2} } );
+    REQUIRE( !channels.is_contiguous() );
+    REQUIRE( channels( 1, 1, 1 ) == 19.0 );
+    auto const& copied = channels.materialize();
+    REQUIRE( copied.size() == 12 );
+    REQUIRE( copied[0] == 1.0 );
+    REQUIRE( copied[1] == 3.0 );
+    REQUIRE( copied[11] == 23.0 );
+
+    // permute, transpose and flip
+    auto p = v.permute( {2, 0, 1} );
+    REQUIRE( p.shape() == std::vector<size_t>{ {4, 2, 3} } );
+    REQUIRE( p( 3, 1, 2 ) == v( 1, 2, 3 ) );
+    auto f = v.flip( 1 );
+    REQUIRE( f( 0, 0, 0 ) == 8.0 );
+    REQUIRE( f( 1, 2, 3 ) == 15.0 );
+    auto row = v[1];
+    REQUIRE( row.ndim() == 2 );
+    REQUIRE( row( 2, 3 ) == 23.0 );
+    REQUIRE( ceras::tensor<double>{ v.transpose() }.shape() == std::vector<size_t>{ {4, 3, 2} } );
+
+    // a view is read-only, and a copy sharing the buffer of the tensor it views keeps its values
+    static_assert( std::is_same_v<decltype( channels.data() ), double const*> );
+    static_assert( std::is_same_v<decltype( channels( 0, 0, 0 ) ), double const&> );
+    {
+        ceras::tensor<double> y = x;
+        auto const z = y;
+        auto yv = ceras::as_view( y );
+        y += 1.0;
+        REQUIRE( yv( 0, 0, 2 ) == 2.0 );
+        REQUIRE( z[2] == 2.0 );
+        REQUIRE( y[2] == 3.0 );
+    }
+
+    // matrix products of strided operands
+    auto a = ceras::random<double>( {37, 29}, -1.0, 1.0 );
+    auto b = ceras::random<double>( {41, 29}, -1.0, 1.0 );
+    auto bt = ceras::as_view( b ).transpose().copy(); // [29, 41]
+    auto const& expected = a * bt;
+    auto const& ans = a * ceras::as_view( b ).transpose();
+    REQUIRE( ans.shape() == expected.shape() );
+    for ( auto idx : ceras::range( ans.size() ) )
+        REQUIRE( std::abs( ans[idx] - expected[idx] ) < 1.0e-10 );
+
+    // a block of rows and columns, read with its leading dimension
+    auto block = ceras::as_view( a ).slice( 0, 3, 20 ).slice( 1, 5, 25 );
+    auto bt_block = ceras::as_view( bt ).slice( 0, 5, 25 );
+    auto const& block_expected = block.copy() * bt_block.copy();
+    auto const& block_ans = block * bt_block;
+    REQUIRE( block_ans.shape() == std::vector<size_t>{ {17, 41} } );
+    for ( auto idx : ceras::range( block_ans.size() ) )
+        REQUIRE( std::abs( block_ans[idx] - block_expected[idx] ) < 1.0e-10 );
+
+    // the free functions of tensors read views, and the transpose and the flip of a view are views
+    {
+        auto columns = ceras::as_view( a ).slice( 1, 2, 29, 3 ); // [37, 9], strided
+        auto const& columns_copy = columns.copy();
+        REQUIRE( std::abs( ceras::sum( columns ) - ceras::sum( columns_copy ) ) < 1.0e-10 );
+        REQUIRE( std::abs( ceras::mean( columns ) - ceras::mean( columns_copy ) ) < 1.0e-10 );
+        REQUIRE( ceras::max( columns ) == ceras::max( columns_copy ) );
+        auto const& column_sums = ceras::sum( columns, 0 );
+        auto const& column_sums_expected = ceras::sum( columns_copy, 0 );
+        REQUIRE( column_sums.shape() == std::vector<size_t>{ {9,} } );
+        for ( auto idx : ceras::range( 9UL ) )
+            REQUIRE( std::abs( column_sums[idx] - column_sums_expected[idx] ) < 1.0e-10 );
+        REQUIRE( ceras::softmax( columns ).shape() == columns.shape() );
+        REQUIRE( ceras::concatenate( columns, columns_copy, 1 ).shape() == std::vector<size_t>{ {37, 18} } );
+
+        auto const& transposed = ceras::transpose( columns );
+        REQUIRE( transposed.data() == columns.data() );
+        REQUIRE( transposed( 4, 30 ) == columns( 30, 4 ) );
+        auto const& flipped = ceras::flip( columns, 0 );
+        REQUIRE( flipped( 0, 1 ) == columns( 36, 1 ) );
+
+        auto w = ceras::variable{ columns };
+        REQUIRE( w.data().shape() == columns.shape() );
+        REQUIRE( w.data()[10] == columns_copy[10] );
+        auto c = ceras::constant{ transposed };
+        REQUIRE( c.data().shape() == std::vector<size_t>{ {9, 37} } );
+    }
+}
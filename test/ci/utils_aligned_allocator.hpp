@@ -0,0 +1,46 @@
+#include "../../include/tensor.hpp"
+
+TEST_CASE( "aligned_allocator", "[aligned_allocator_1]" )
+{
+    ceras::random_generator.seed( 42 );
+
+    for ( size_t n = 1; n < 300; ++n )
+    {
+        std::vector<float, ceras::aligned_allocator<float>> v( n, 1.0f );
+        REQUIRE( ceras::is_aligned( v.data() ) );
+        std::vector<double, ceras::aligned_allocator<double, 4096>> u( n, 1.0 );
+        REQUIRE( ceras::is_aligned<4096>( u.data() ) );
+        REQUIRE( ceras::aligned_leading_dimension<float>( n ) % 16 == 0 );
+        REQUIRE( ceras::aligned_leading_dimension<float>( n ) - n < 16 );
+        REQUIRE( ceras::aligned_leading_dimension<double>( n ) % 8 == 0 );
+    }
+    REQUIRE( ceras::aligned_allocator<float>::bytes( 1 ) == 64 );
+    REQUIRE( ceras::aligned_allocator<float>::bytes( 17 ) == 128 );
+
+    // the tensors of every origin start on a cache line
+    auto const a = ceras::random<float>( {7, 13}, -1.0f, 1.0f );
+    auto const b = ceras::random<float>( {1, 13}, -1.0f, 1.0f );
+    REQUIRE( a.is_aligned() );
+    REQUIRE( ceras::tensor<float>{ {3,}, {1.0f, 2.0f, 3.0f} }.is_aligned() );
+    REQUIRE( ceras::tensor<double>{ {5, 5}, 1.0 }.is_aligned() );
+    REQUIRE( a.deep_copy().is_aligned() );
+    REQUIRE( ceras::add( a, b ).is_aligned() );
+    REQUIRE( a.as_type<double>().is_aligned() );
+
+    // a slice is aligned if its offset is a whole number of cache lines
+    auto const c = ceras::random<float>( {4, 16}, -1.0f, 1.0f );
+    REQUIRE( ceras::slice( c, 1, 3 ).is_aligned() );
+    REQUIRE( !ceras::slice( a, 1, 3 ).is_aligned() );
+
+    // the aligned and the unaligned paths of the vectorized kernels agree
+    size_t const n = 1000;
+    auto const x = ceras::random<float>( {n+1,}, -3.0f, 3.0f );
+    ceras::tensor<float> y{ {n+1,} };
+    ceras::tensor<float> z{ {n+1,} };
+    auto const& gelu = []( auto v ){ return ceras::vmath::gelu( v ); };
+    ceras::vectorized_map( x.data(), y.data(), n+1, gelu );
+    ceras::vectorized_map( x.data() + 1, z.data() + 1, n, gelu );
+    for ( auto idx : ceras::range( 1UL, n+1 ) )
+        REQUIRE( std::abs( y[idx] - z[idx] ) <= 1.0e-6f * ( 1.0f + std::abs( y[idx] ) ) );
+}
+
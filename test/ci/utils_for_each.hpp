@@ -0,0 +1,22 @@
+#include "../../include/utils/for_each.hpp"
+
+TEST_CASE( "for_each", "[for_each_1]" )
+{
+    for ( std::size_t n : { 0UL, 1UL, 1000UL, ceras::for_each_parallel_threshold-1, ceras::for_each_parallel_threshold, 1000003UL } )
+    {
+        std::vector<double> x( n ), y( n ), z( n, -1.0 );
+        for ( auto idx : ceras::range( n ) )
+        {
+            x[idx] = idx;
+            y[idx] = 2.0 * idx;
+        }
+
+        ceras::for_each( x.begin(), x.end(), y.begin(), z.begin(), []( double a, double b, double& c ){ c = a + b; } );
+        for ( auto idx : ceras::range( n ) )
+            REQUIRE( z[idx] == 3.0 * idx );
+
+        ceras::for_each( z.begin(), z.end(), []( double& c ){ c += 1.0; } );
+        for ( auto idx : ceras::range( n ) )
+            REQUIRE( z[idx] == 3.0 * idx + 1.0 );
+    }
+}
@@ -0,0 +1,44 @@
+#include "../../include/tensor.hpp"
+
+// The aligned allocations of the whole test program, those of the tensor buffers among them, see `aligned_allocator`: the replacements
+// below count them, for the tests to check that a warmed-up training step allocates no buffer.
+namespace ceras_test
+{
+    inline std::atomic<std::size_t> heap_allocations{ 0 };
+}
+
+void* operator new( std::size_t size, std::align_val_t alignment )
+{
+    ++ceras_test::heap_allocations;
+    std::size_t const align = static_cast<std::size_t>( alignment );
+    if ( void* p = std::aligned_alloc( align, ( std::max( size, std::size_t{1} ) + align - 1 ) / align * align ) )
+        return p;
+    throw std::bad_alloc{};
+}
+
+// the buffers of `std::aligned_alloc` above go back to `std::free`: GCC, inlining these into the callers of `operator new`, takes it for a mismatch
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete( void* p, std::align_val_t ) noexcept
+{
+    std::free( p );
+}
+
+void operator delete( void* p, std::size_t, std::align_val_t ) noexcept
+{
+    std::free( p );
+}
+#pragma GCC diagnostic pop
+
+TEST_CASE( "heap_allocations", "[utils_heap_allocations_1]" )
+{
+    std::size_t const before = ceras_test::heap_allocations;
+    ceras::tensor<float> a{ {3, 4} };
+    REQUIRE( ceras_test::heap_allocations == before + 1 );
+    ceras::tensor<float> b = a; // sharing the buffer of a
+    REQUIRE( ceras_test::heap_allocations == before + 1 );
+    b.reset( 1.0f ); // a buffer of its own
+    REQUIRE( ceras_test::heap_allocations == before + 2 );
+    a.fill( 2.0f ); // in place
+    REQUIRE( ceras_test::heap_allocations == before + 2 );
+}
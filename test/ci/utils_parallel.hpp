@@ -0,0 +1,82 @@
+#include "../../include/utils/parallel.hpp"
+
+TEST_CASE( "thread_pool", "[thread_pool_1]" )
+{
+    ceras::thread_pool pool{ 3 };
+    REQUIRE( pool.size() == 4 );
+
+    for ( std::size_t tasks : { 0UL, 1UL, 2UL, 7UL, 64UL, 1000UL } )
+        for ( [[maybe_unused]] auto repeat : ceras::range( 20 ) )
+        {
+            std::vector<int> hits( tasks, 0 );
+            pool.fork_join( tasks, [&hits]( std::size_t idx ){ hits[idx] += 1; } );
+            for ( auto h : hits )
+                REQUIRE( h == 1 );
+        }
+
+    // nested regions share the workers of the pool
+    std::vector<std::atomic<int>> hits( 16*16 );
+    pool.fork_join( 16, [&]( std::size_t outer )
+    {
+        pool.fork_join( 16, [&]( std::size_t inner ){ hits[outer*16+inner] += 1; } );
+    } );
+    for ( auto const& h : hits )
+        REQUIRE( h.load() == 1 );
+
+    // uneven work, three levels deep
+    std::atomic<std::size_t> total{ 0 };
+    pool.parallel_for( 0, 64, 1, [&]( std::size_t outer )
+    {
+        pool.parallel_for( 0, outer*10, 3, [&]( std::size_t )
+        {
+            pool.fork_join( 4, [&]( std::size_t ){ total += 1; } );
+        } );
+    } );
+    REQUIRE( total.load() == 4 * 10 * (63*64/2) );
+}
+
+TEST_CASE( "task_group", "[task_group_1]" )
+{
+    ceras::thread_pool pool{ 3 };
+
+    std::atomic<std::size_t> sum{ 0 };
+    {
+        ceras::task_group group{ pool };
+        for ( auto idx : ceras::range( 1000UL ) )
+            group.run( [&sum, idx, &pool]()
+            {
+                ceras::task_group inner{ pool };
+                inner.run( [&sum, idx](){ sum += idx; } );
+                inner.run( [&sum, idx](){ sum += idx; } );
+                inner.wait();
+            } );
+        group.wait();
+        REQUIRE( sum.load() == 999*1000 );
+    }
+
+    // a pool without workers runs the tasks when waited for
+    ceras::thread_pool serial{ 0 };
+    ceras::task_group group{ serial };
+    int count = 0;
+    group.run( [&count](){ ++count; } );
+    group.run( [&count](){ ++count; } );
+    group.wait();
+    REQUIRE( count == 2 );
+}
+
+TEST_CASE( "parallel", "[parallel_1]" )
+{
+    for ( std::size_t n : { 0UL, 1UL, 9UL, 1000UL, 100003UL } )
+        for ( std::size_t grain : { 0UL, 1UL, 7UL, 4096UL } )
+        {
+            std::vector<int> hits( n, 0 );
+            ceras::parallel( [&hits]( std::size_t idx ){ hits[idx] += 1; }, 0UL, n, 8, grain );
+            for ( auto h : hits )
+                REQUIRE( h == 1 );
+
+            std::vector<int> offset_hits( n+5, 0 );
+            ceras::parallel( [&offset_hits]( std::size_t idx ){ offset_hits[idx] += 1; }, 5UL, n+5, 8, grain );
+            for ( auto idx : ceras::range( n+5 ) )
+                REQUIRE( offset_hits[idx] == ( idx >= 5 ? 1 : 0 ) );
+        }
+}
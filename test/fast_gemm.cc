@@ -0,0 +1,79 @@
+#include "../include/tensor.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// Strassen's algorithm, generated into 'include/backend/fast_gemm_strassen.hpp', against the blocked classical gemm on
+// square products: the time, the effective GFLOP/s (2n^3/time) and the error, measured on sampled rows against a double
+// precision product and compared to the a priori bound of `fast_gemm_error_bound`.
+//
+// Usage: test_fast_gemm [largest dimension]
+int main( int argc, char** argv )
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    size_t const largest = ( argc > 1 ) ? std::stoul( argv[1] ) : 4096;
+
+    auto const& seconds_of = []( auto const& func )
+    {
+        func(); // warm-up
+        double best = std::numeric_limits<double>::max();
+        double total = 0.0;
+        for ( size_t run = 0; run < 3 || ( run < 10 && total < 1.0 ); ++run )
+        {
+            auto const start = std::chrono::steady_clock::now();
+            func();
+            double const seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+            best = std::min( best, seconds );
+            total += seconds;
+        }
+        return best;
+    };
+
+    std::cout << fmt::format( "{} threads\n", thread_pool::instance().size() );
+    for ( size_t dim = 512; dim <= largest; dim *= 2 )
+        for ( size_t const size : { dim, dim + dim / 2 + 1 } ) // a power of 2, and an odd size with peeling at every level
+        {
+            if ( size > largest ) continue;
+            auto A = random<float>( {size, size}, -1.0f, 1.0f );
+            auto B = random<float>( {size, size}, -1.0f, 1.0f );
+            tensor<float> C{ {size, size} };
+            double const gflop = 2.0e-9 * size * size * size;
+
+            // reference rows in double precision
+            std::vector<size_t> rows;
+            for ( size_t row = 0; row < size; row += std::max( size_t{1}, size / 32 ) )
+                rows.push_back( row );
+            std::vector<double> reference( rows.size() * size, 0.0 );
+            for ( auto [idx, row] : enumerate( rows ) )
+                for ( auto p : range( size ) )
+                    for ( auto col : range( size ) )
+                        reference[idx*size+col] += static_cast<double>( A[row*size+p] ) * static_cast<double>( B[p*size+col] );
+            auto const& max_error = [&]()
+            {
+                double ans = 0.0;
+                for ( auto [idx, row] : enumerate( rows ) )
+                    for ( auto col : range( size ) )
+                        ans = std::max( ans, std::abs( static_cast<double>( C[row*size+col] ) - reference[idx*size+col] ) );
+                return ans;
+            };
+
+            double const classical = seconds_of( [&](){ parallel_gemm( A.data(), size, false, B.data(), size, false, size, size, size, C.data(), size ); } );
+            std::cout << fmt::format( "[{}x{}x{}] classical\t{} ms\t{} GFLOP/s\terror {}\tbound {}\n", size, size, size, classical * 1.0e3, gflop / classical, max_error(),
+                                      fast_gemm_error_bound<strassen_fast_gemm, float>( size, size, size, size, 1.0, 1.0 ) );
+
+            for ( size_t cutoff : { 128UL, 256UL, 512UL, 1024UL } )
+            {
+                size_t const levels = fast_gemm_levels<strassen_fast_gemm>( size, size, size, cutoff );
+                if ( levels == 0 ) continue;
+                double const fast = seconds_of( [&](){ fast_gemm<strassen_fast_gemm>( A.data(), size, false, B.data(), size, false, size, size, size, C.data(), size, cutoff ); } );
+                std::cout << fmt::format( "[{}x{}x{}] strassen, cutoff {} ({} levels)\t{} ms\t{} GFLOP/s\terror {}\tbound {}\tspeedup {}\n", size, size, size, cutoff, levels, fast * 1.0e3, gflop / fast, max_error(),
+                                          fast_gemm_error_bound<strassen_fast_gemm, float>( size, size, size, cutoff, 1.0, 1.0 ), classical / fast );
+            }
+        }
+
+    return 0;
+}
+
@@ -0,0 +1,60 @@
+#include "../include/tensor.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// Scaling of the multi-threaded gemm over the number of threads, on the matmul shapes of
+// `test/mnist.cc` (batch 10, 784x256x128x10) and of the dense layers in `examples/vgg16`.
+int main()
+{
+    using namespace ceras;
+    random_generator.seed( 42 );
+
+    // [m x n] * [n x k], with the transpose flags used by the forward and the two backward passes
+    std::vector<std::tuple<std::string, size_t, size_t, size_t, bool, bool>> const shapes
+    {
+        { "mnist l1 forward",        10,   784,   256, false, false },
+        { "mnist l1 backward (w)",  784,    10,   256, true,  false },
+        { "vgg16 conv3x3x256",     3136,  2304,   256, false, false },
+        { "vgg16 fc6 forward",       32, 25088,  4096, false, false },
+        { "vgg16 fc7 forward",       32,  4096,  4096, false, false },
+        { "vgg16 fc7 backward (x)",  32,  4096,  4096, false, true  },
+        { "vgg16 fc7 backward (w)", 4096,   32,  4096, true,  false },
+    };
+
+    size_t const max_threads = std::max( 1U, std::thread::hardware_concurrency() );
+
+    for ( auto const& [name, m, n, k, a_transposed, b_transposed] : shapes )
+    {
+        auto A = random<float>( {m, n}, -1.0f, 1.0f );
+        auto B = random<float>( {n, k}, -1.0f, 1.0f );
+        tensor<float> C{ {m, k} };
+        size_t const lda = a_transposed ? m : n;
+        size_t const ldb = b_transposed ? n : k;
+        double const gflops = 2.0e-9 * m * n * k;
+
+        std::vector<size_t> thread_counts;
+        for ( size_t threads = 1; threads < max_threads; threads *= 2 )
+            thread_counts.push_back( threads );
+        thread_counts.push_back( max_threads );
+
+        double single_thread = 0.0;
+        for ( auto threads : thread_counts )
+        {
+            parallel_gemm( A.data(), lda, a_transposed, B.data(), ldb, b_transposed, m, n, k, C.data(), k, ceras_private::default_gemm_blocking<float>(), threads ); // warm-up
+
+            size_t const repeats = std::max( 1UL, static_cast<size_t>( 2.0 / gflops ) );
+            auto const start = std::chrono::steady_clock::now();
+            for ( size_t r = 0; r != repeats; ++r )
+                parallel_gemm( A.data(), lda, a_transposed, B.data(), ldb, b_transposed, m, n, k, C.data(), k, ceras_private::default_gemm_blocking<float>(), threads );
+            double const seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() / repeats;
+
+            if ( threads == 1 ) single_thread = seconds;
+            std::cout << fmt::format( "{} [{}x{}x{}] threads: {}\t{} GFLOP/s\tspeedup: {}\n", name, m, n, k, threads, gflops / seconds, single_thread / seconds );
+        }
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,97 @@
+#include "../include/utils/parallel.hpp"
+#include "../include/utils/fmt.hpp"
+
+#include <chrono>
+#include <iostream>
+
+// `ceras::parallel` before the thread pool: new threads are started and joined on every call.
+template< typename Function, std::unsigned_integral Integer_Type >
+void spawning_parallel( Function const& func, Integer_Type dim_first, Integer_Type dim_last, size_t threshold = 8 )
+{
+    unsigned int const total_cores = std::thread::hardware_concurrency();
+    if ( (total_cores <= 1) || ((dim_last - dim_first) <= threshold) )
+    {
+        for ( auto a : ceras::range( dim_first, dim_last ) )
+            func( a );
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    if ( dim_last - dim_first <= total_cores )
+    {
+        for ( auto index = dim_first; index != dim_last; ++index )
+            threads.emplace_back( std::thread{[&func, index](){ func( index ); }} );
+        for ( auto& th : threads )
+            th.join();
+        return;
+    }
+
+    auto const& job_slice = [&func]( Integer_Type a, Integer_Type b )
+    {
+        while ( a < b )
+            func(a++);
+    };
+
+    threads.reserve( total_cores-1 );
+    std::uint_least64_t tasks_per_thread = ( dim_last - dim_first + total_cores - 1 ) / total_cores;
+    for ( auto index : ceras::range( total_cores-1 ) )
+    {
+        Integer_Type first = std::min<Integer_Type>( tasks_per_thread * index + dim_first, dim_last );
+        Integer_Type last = std::min<Integer_Type>( first + tasks_per_thread, dim_last );
+        threads.emplace_back( std::thread{ job_slice, first, last } );
+    }
+    job_slice( tasks_per_thread*(total_cores-1) + dim_first, dim_last );
+
+    for ( auto& th : threads )
+        th.join();
+}
+
+// Time per call of `parallel` against the thread-spawning implementation, on a range of n floats.
+int main()
+{
+    std::cout << fmt::format( "hardware threads: {}\n", std::thread::hardware_concurrency() );
+
+    for ( std::size_t n : { 16UL, 256UL, 4096UL, 65536UL, 1048576UL, 16777216UL } )
+    {
+        std::vector<float> v( n, 1.0f );
+        auto const& job = [&v]( std::size_t idx ){ v[idx] = v[idx] * 0.999f + 0.001f; };
+        std::size_t const repeats = std::max( 1UL, 67108864UL / n );
+
+        auto const& time_it = [repeats]( auto const& call )
+        {
+            call(); // warm up, this also starts the thread pool
+            auto const start = std::chrono::steady_clock::now();
+            for ( [[maybe_unused]] auto _ : ceras::range( repeats ) )
+                call();
+            return std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / repeats;
+        };
+
+        double const spawning = time_it( [&](){ spawning_parallel( job, 0UL, n ); } );
+        double const pooled = time_it( [&](){ ceras::parallel( job, 0UL, n ); } );
+        double const pooled_grain = time_it( [&](){ ceras::parallel( job, 0UL, n, 8, 4096 ); } );
+        std::cout << fmt::format( "n = {}\tspawning: {} us\tpool: {} us\tpool (grain 4096): {} us\n", n, spawning, pooled, pooled_grain );
+    }
+
+    // nested regions of uneven size: a parallel batch loop around a parallel loop over the samples
+    for ( std::size_t batches : { 4UL, 32UL } )
+    {
+        std::vector<std::vector<float>> data;
+        for ( auto idx : ceras::range( batches ) )
+            data.emplace_back( 4096 * ( 1 + idx % 7 ), 1.0f );
+
+        auto const& time_it = []( auto const& call )
+        {
+            call();
+            auto const start = std::chrono::steady_clock::now();
+            for ( [[maybe_unused]] auto _ : ceras::range( 100 ) )
+                call();
+            return std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / 100;
+        };
+
+        double const spawning = time_it( [&](){ spawning_parallel( [&]( std::size_t b ){ auto& v = data[b]; spawning_parallel( [&v]( std::size_t idx ){ v[idx] = v[idx] * 0.999f + 0.001f; }, 0UL, v.size() ); }, 0UL, batches ); } );
+        double const pooled = time_it( [&](){ ceras::parallel( [&]( std::size_t b ){ auto& v = data[b]; ceras::parallel( [&v]( std::size_t idx ){ v[idx] = v[idx] * 0.999f + 0.001f; }, 0UL, v.size() ); }, 0UL, batches, 1 ); } );
+        std::cout << fmt::format( "nested, {} uneven batches\tspawning: {} us\tpool: {} us\n", batches, spawning, pooled );
+    }
+
+    return 0;
+}